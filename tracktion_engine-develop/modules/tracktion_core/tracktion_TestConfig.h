@@ -17,15 +17,18 @@
 #define GRAPH_UNIT_TESTS_MIDINODE                       1
 #define GRAPH_UNIT_TESTS_RACKNODE                       1
 #define GRAPH_UNIT_TESTS_EDITNODE                       1
+#define GRAPH_UNIT_TESTS_PLUGINNODE                     1
 
 #define ENGINE_UNIT_TESTS_AUTOMATION                    1
 #define ENGINE_UNIT_TESTS_AUX_SEND                      1
 #define ENGINE_UNIT_TESTS_CLIPBOARD                     1
 #define ENGINE_UNIT_TESTS_CLIPSLOT                      1
+#define ENGINE_UNIT_TESTS_CHUNKED_EDIT_FILE             1
 #define ENGINE_UNIT_TESTS_CONSTRAINED_CACHED_VALUE      1
 #define ENGINE_UNIT_TESTS_DELAY_PLUGIN                  1
 #define ENGINE_UNIT_TESTS_EDIT                          1
 #define ENGINE_UNIT_TESTS_EDIT_TIME                     1
+#define ENGINE_UNIT_TESTS_EDIT_JOURNAL                  1
 #define ENGINE_UNIT_TESTS_FREEZE                        1
 #define ENGINE_UNIT_TESTS_FOLLOW_ACTIONS                1
 #define ENGINE_UNIT_TESTS_LATENCY                       1
@@ -38,7 +41,9 @@
 #define ENGINE_UNIT_TESTS_MODIFIERS                     1
 #define ENGINE_UNIT_TESTS_PAN_LAW                       1
 #define ENGINE_UNIT_TESTS_PLAYBACK                      1
+#define ENGINE_UNIT_TESTS_PLAYBACK_TELEMETRY            1
 #define ENGINE_UNIT_TESTS_PLUGINS                       1
+#define ENGINE_UNIT_TESTS_PROJECT                       1
 #define ENGINE_UNIT_TESTS_PDC                           1
 #define ENGINE_UNIT_TESTS_RECORDING                     1
 #define ENGINE_UNIT_TESTS_TIMESTRETCHER                 1
@@ -46,6 +51,7 @@
 #define ENGINE_UNIT_TESTS_SELECTABLE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE                    1
 #define ENGINE_UNIT_TESTS_AUDIO_FILE_CACHE              1
+#define ENGINE_UNIT_TESTS_THUMBNAILS                    1
 #define ENGINE_UNIT_TESTS_VOLPANPLUGIN                  1
 #define ENGINE_UNIT_TESTS_TEMPO_SEQUENCE                1
 #define ENGINE_UNIT_TESTS_QUANTISATION_TYPE             1
@@ -62,13 +68,22 @@
 #define GRAPH_UNIT_TESTS_AUDIOBUFFERPOOL                1
 #define GRAPH_UNIT_TESTS_SEMAPHORE                      1
 #define GRAPH_UNIT_TESTS_ALLOCATION                     1
+#define GRAPH_UNIT_TESTS_WORKSTEALINGQUEUE              1
+#define GRAPH_UNIT_TESTS_PRIORITYFIFO                   1
+#define GRAPH_UNIT_TESTS_LOCKFREEPLAYER                 1
+#define GRAPH_UNIT_TESTS_STATICSCHEDULEPLAYER           1
+#define GRAPH_UNIT_TESTS_NODEPROCESSTRACER              1
+#define GRAPH_UNIT_TESTS_SUMMINGKERNELS                 1
 
 // Benchmarks
 #define CORE_BENCHMARKS_TEMPO                           1
 
 #define GRAPH_BENCHMARKS_THREADS                        1
+#define GRAPH_BENCHMARKS_NODEPLAYER                     1
+#define GRAPH_BENCHMARKS_SUMMING                        1
 
 #define ENGINE_BENCHMARKS_AUDIOFILECACHE                1
+#define ENGINE_BENCHMARKS_THUMBNAILS                    1
 #define ENGINE_BENCHMARKS_CONTAINERCLIP                 1
 #define ENGINE_BENCHMARKS_MIDICLIP                      1
 #define ENGINE_BENCHMARKS_EDITITEMID                    1
@@ -77,3 +92,5 @@
 #define ENGINE_BENCHMARKS_RACKS                         1
 #define ENGINE_BENCHMARKS_SELECTABLE                    1
 #define ENGINE_BENCHMARKS_PLUGINNODE                    1
+#define ENGINE_BENCHMARKS_EDITNODEBUILDER               1
+#define ENGINE_BENCHMARKS_PROJECT                       1
@@ -86,4 +86,49 @@ private:
 };
 
 
+//==============================================================================
+//==============================================================================
+/**
+    FallbackReader that wraps a BufferedFileReader to stream the file from disk
+    without reading on the audio thread.
+*/
+class StreamingFileReaderWrapper    : public FallbackReader
+{
+public:
+    StreamingFileReaderWrapper (std::unique_ptr<BufferedFileReader> sourceReader)
+        : source (std::move (sourceReader))
+    {
+        sampleRate              = source->sampleRate;
+        bitsPerSample           = source->bitsPerSample;
+        lengthInSamples         = source->lengthInSamples;
+        numChannels             = source->numChannels;
+        usesFloatingPointData   = source->usesFloatingPointData;
+        metadataValues          = source->metadataValues;
+    }
+
+    /** @internal */
+    void setReadTimeout (int timeoutMilliseconds) override
+    {
+        source->setReadTimeout (timeoutMilliseconds);
+    }
+
+    /** @internal */
+    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
+                      juce::int64 startSampleInFile, int numSamples) override
+    {
+        return source->readSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
+                                    startSampleInFile, numSamples);
+    }
+
+    /** Returns the BufferedFileReader being used. */
+    BufferedFileReader& get()
+    {
+        return *source;
+    }
+
+private:
+    std::unique_ptr<BufferedFileReader> source;
+};
+
+
 }} // namespace tracktion { inline namespace engine
@@ -251,21 +251,111 @@ juce::ThreadPoolJob::JobStatus AudioProxyGenerator::GeneratorJob::runJob()
     return jobHasFinished;
 }
 
+//==============================================================================
+AudioProxyGenerator::SegmentRender::SegmentRender (AudioProxyGenerator& g, const AudioFile& f)
+    : segmentFile (f), owner (g)
+{
+}
+
+bool AudioProxyGenerator::SegmentRender::waitUntilFinished (int timeOutMilliseconds)
+{
+    return finishedEvent.wait (timeOutMilliseconds);
+}
+
+bool AudioProxyGenerator::SegmentRender::shouldExit()
+{
+    const juce::ScopedLock sl (owner.jobListLock);
+
+    // The SegmentJob holds one reference so if it's the only one left, no proxies need this segment any more
+    if (! cancelled && getReferenceCount() <= 1)
+    {
+        cancelled = true;
+
+        if (auto found = owner.activeSegments.find (segmentFile.getHash());
+            found != owner.activeSegments.end() && found->second == this)
+            owner.activeSegments.erase (found);
+    }
+
+    return cancelled;
+}
+
+void AudioProxyGenerator::SegmentRender::setFinished (bool wasRendered)
+{
+    succeeded = wasRendered;
+    finished = true;
+    progress = 1.0f;
+    finishedEvent.signal();
+}
+
+//==============================================================================
+class AudioProxyGenerator::SegmentJob  : public juce::ThreadPoolJob
+{
+public:
+    SegmentJob (SegmentRender::Ptr r, SegmentRender::RenderFunction f)
+        : juce::ThreadPoolJob ("Proxy segment"), render (std::move (r)), renderFunction (std::move (f))
+    {
+    }
+
+    ~SegmentJob() override
+    {
+        // Jobs removed from the pool before they've run still need to release any waiting proxies
+        if (! render->isFinished())
+        {
+            render->owner.removeSegment (*render);
+            render->setFinished (false);
+        }
+    }
+
+    JobStatus runJob() override
+    {
+        CRASH_TRACER
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        const bool ok = ! render->shouldExit() && renderFunction (*render);
+
+        if (! ok)
+            render->segmentFile.deleteFile();
+
+        render->owner.removeSegment (*render);
+        render->setFinished (ok && render->segmentFile.getFile().existsAsFile());
+
+        return jobHasFinished;
+    }
+
+private:
+    SegmentRender::Ptr render;
+    SegmentRender::RenderFunction renderFunction;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentJob)
+};
+
 //==============================================================================
 AudioProxyGenerator::AudioProxyGenerator()
+    : segmentPool (juce::ThreadPoolOptions()
+                     .withThreadName ("Proxy segment renderer")
+                     .withNumberOfThreads (std::max (1, juce::SystemStats::getNumCpus() - 1))
+                     .withDesiredThreadPriority (juce::Thread::Priority::low))
 {
 }
 
 AudioProxyGenerator::~AudioProxyGenerator()
 {
     CRASH_TRACER
+
+    {
+        const juce::ScopedLock sl (jobListLock);
+
+        for (auto& segment : activeSegments)
+            segment.second->cancelled = true;
+    }
+
+    segmentPool.removeAllJobs (true, 30000);
 }
 
 AudioProxyGenerator::GeneratorJob* AudioProxyGenerator::findJob (const AudioFile& proxy) const noexcept
 {
-    for (auto j : activeJobs)
-        if (j->proxy == proxy)
-            return j;
+    if (auto found = activeJobs.find (proxy.getHash()); found != activeJobs.end())
+        return found->second;
 
     return {};
 }
@@ -295,7 +385,7 @@ void AudioProxyGenerator::beginJob (GeneratorJob* j)
         if (findJob (job->proxy) == nullptr)
         {
             job->proxy.engine->getBackgroundJobs().addJob (j, true);
-            activeJobs.add (job.release());
+            activeJobs[job->proxy.getHash()] = job.release();
         }
     }
 }
@@ -319,7 +409,9 @@ float AudioProxyGenerator::getProportionComplete (const AudioFile& proxyFile) co
 void AudioProxyGenerator::removeFinishedJob (GeneratorJob* j)
 {
     const juce::ScopedLock sl (jobListLock);
-    activeJobs.removeAllInstancesOf (j);
+
+    if (auto found = activeJobs.find (j->proxy.getHash()); found != activeJobs.end() && found->second == j)
+        activeJobs.erase (found);
 }
 
 void AudioProxyGenerator::deleteProxy (const AudioFile& proxyFile)
@@ -338,6 +430,45 @@ void AudioProxyGenerator::deleteProxy (const AudioFile& proxyFile)
     proxyFile.deleteFile();
 }
 
+AudioProxyGenerator::SegmentRender::Ptr AudioProxyGenerator::renderSegment (const AudioFile& segmentFile,
+                                                                            SegmentRender::RenderFunction renderFunction)
+{
+    CRASH_TRACER
+    const juce::ScopedLock sl (jobListLock);
+
+    if (auto found = activeSegments.find (segmentFile.getHash()); found != activeSegments.end())
+        return found->second;
+
+    SegmentRender::Ptr render (new SegmentRender (*this, segmentFile));
+
+    // Segment files are moved into place once complete so if one exists it can be reused
+    if (segmentFile.getFile().existsAsFile())
+    {
+        render->setFinished (true);
+        return render;
+    }
+
+    activeSegments[segmentFile.getHash()] = render.get();
+    segmentPool.addJob (new SegmentJob (render, std::move (renderFunction)), true);
+
+    return render;
+}
+
+int AudioProxyGenerator::getNumSegmentsBeingRendered() const noexcept
+{
+    const juce::ScopedLock sl (jobListLock);
+    return (int) activeSegments.size();
+}
+
+void AudioProxyGenerator::removeSegment (SegmentRender& render)
+{
+    const juce::ScopedLock sl (jobListLock);
+
+    if (auto found = activeSegments.find (render.segmentFile.getHash());
+        found != activeSegments.end() && found->second == &render)
+        activeSegments.erase (found);
+}
+
 
 //==============================================================================
 AudioFileInfo::AudioFileInfo (Engine& e)
@@ -389,86 +520,6 @@ AudioFileInfo AudioFileInfo::parse (const AudioFile& file)
     return AudioFileInfo (file, nullptr, nullptr);
 }
 
-//==============================================================================
-class TracktionThumbnailCache  : public juce::AudioThumbnailCache
-{
-public:
-    TracktionThumbnailCache (Engine& e)
-       #if JUCE_DEBUG
-        : juce::AudioThumbnailCache (3)
-       #else
-        : juce::AudioThumbnailCache (50)
-       #endif
-        , engine (e)
-    {
-    }
-
-    void saveNewlyFinishedThumbnail (const juce::AudioThumbnailBase& thumb, juce::int64 hash) override
-    {
-        CRASH_TRACER
-        auto st = getActiveSmartThumbnail (thumb);
-        auto thumbFile = getThumbFile (st, hash);
-
-        if (thumbFile.deleteFile())
-        {
-            thumbFile.getParentDirectory().createDirectory();
-
-            juce::FileOutputStream fo (thumbFile);
-
-            if (! fo.openedOk())
-                return;
-
-            thumb.saveTo (fo);
-        }
-    }
-
-    bool loadNewThumb (juce::AudioThumbnailBase& thumb, juce::int64 hash) override
-    {
-        CRASH_TRACER
-        auto st = getActiveSmartThumbnail (thumb);
-        auto thumbFile = getThumbFile (st, hash);
-
-        if (st != nullptr
-              && st->file.getFile().getLastModificationTime() > thumbFile.getLastModificationTime()
-                                                                  + juce::RelativeTime::seconds (0.1))
-        {
-            thumbFile.deleteFile();
-            return false;
-        }
-
-        juce::FileInputStream fin (thumbFile);
-        return fin.openedOk() && thumb.loadFrom (fin);
-    }
-
-private:
-    Engine& engine;
-
-    juce::File getThumbFolder (Edit* edit) const
-    {
-        if (edit != nullptr)
-            return edit->getTempDirectory (false);
-
-        return engine.getTemporaryFileManager().getThumbnailsFolder();
-    }
-
-    SmartThumbnail* getActiveSmartThumbnail (const juce::AudioThumbnailBase& thumb)
-    {
-        auto& map = engine.getAudioFileManager().thumbnailMap;
-
-        if (auto found = map.find (&thumb); found != map.end())
-            return found->second;
-
-        return nullptr;
-    }
-
-    juce::File getThumbFile (const SmartThumbnail* st, HashCode hash) const
-    {
-        auto thumbFolder = getThumbFolder (st != nullptr ? st->edit : nullptr);
-
-        return thumbFolder.getChildFile ("thumbnail_" + juce::String::toHexString (hash) + ".thumb");
-    }
-};
-
 //==============================================================================
 struct AudioFileManager::KnownFile
 {
@@ -526,8 +577,12 @@ SmartThumbnail::~SmartThumbnail()
 bool SmartThumbnail::areThumbnailsFullyLoaded (Engine& engine)
 {
     TRACKTION_ASSERT_MESSAGE_THREAD
+    auto& afm = engine.getAudioFileManager();
+
+    if (afm.getThumbnailService().getNumJobs() > 0)
+        return false;
 
-    for (auto thumb : engine.getAudioFileManager().activeThumbnails)
+    for (auto thumb : afm.activeThumbnails)
         if (! thumb->isFullyLoaded())
             return false;
 
@@ -778,12 +833,13 @@ void SmartThumbnail::timerCallback()
 
 //==============================================================================
 AudioFileManager::AudioFileManager (Engine& e)
-    : engine (e), cache (e), thumbnailCache (std::make_unique<TracktionThumbnailCache> (e))
+    : engine (e), decodedCache (e), cache (e), thumbnailCache (std::make_unique<ThumbnailService> (e))
 {
 }
 
 AudioFileManager::~AudioFileManager()
 {
+    decodedCache.stopDecoding();
     clearFiles();
 }
 
@@ -26,6 +26,7 @@ public:
     void runTest() override
     {
         runFileInfoTest();
+        runProxySegmentTest();
     }
 
 private:
@@ -80,6 +81,82 @@ private:
             expectEquals (info.getLengthInSeconds(), 1.0);
         }
     }
+
+    void runProxySegmentTest()
+    {
+        auto& engine = *Engine::getEngines().getFirst();
+        auto& generator = engine.getAudioFileManager().proxyGenerator;
+
+        juce::WavAudioFormat format;
+        juce::TemporaryFile tempFile1 (format.getFileExtensions()[0]), tempFile2 (format.getFileExtensions()[0]);
+        const AudioFile segmentFile1 (engine, tempFile1.getFile()), segmentFile2 (engine, tempFile2.getFile());
+        std::atomic<int> numRenders { 0 };
+
+        auto writeSegment = [&] (AudioProxyGenerator::SegmentRender& r)
+        {
+            ++numRenders;
+            juce::Thread::sleep (100);
+
+            AudioFileWriter writer (r.segmentFile, &format, 1, 44100.0, 32, {}, 0);
+            juce::AudioBuffer<float> buffer (1, 44100);
+            buffer.clear();
+
+            return writer.isOpen() && writer.appendBuffer (buffer, buffer.getNumSamples());
+        };
+
+        beginTest ("Proxy segments are shared while rendering");
+        {
+            auto render1 = generator.renderSegment (segmentFile1, writeSegment);
+            auto render2 = generator.renderSegment (segmentFile1, writeSegment);
+            expect (render1 == render2);
+            expectEquals (generator.getNumSegmentsBeingRendered(), 1);
+
+            expect (render1->waitUntilFinished (10000));
+            expect (render1->wasSuccessful());
+            expect (segmentFile1.getFile().existsAsFile());
+            expectEquals (numRenders.load(), 1);
+            expectEquals (generator.getNumSegmentsBeingRendered(), 0);
+        }
+
+        beginTest ("Existing proxy segments are reused");
+        {
+            auto render = generator.renderSegment (segmentFile1, writeSegment);
+            expect (render->isFinished());
+            expect (render->wasSuccessful());
+            expectEquals (numRenders.load(), 1);
+        }
+
+        beginTest ("Proxy segments are cancelled when no longer needed");
+        {
+            std::atomic<bool> started { false };
+
+            auto waitForExit = [&] (AudioProxyGenerator::SegmentRender& r)
+            {
+                started = true;
+
+                while (! r.shouldExit())
+                    juce::Thread::sleep (1);
+
+                return false;
+            };
+
+            {
+                auto render = generator.renderSegment (segmentFile2, waitForExit);
+
+                for (int i = 0; i < 1000 && ! started; ++i)
+                    juce::Thread::sleep (10);
+
+                expect (started.load());
+                expect (! render->isFinished());
+            }
+
+            for (int i = 0; i < 1000 && generator.getNumSegmentsBeingRendered() > 0; ++i)
+                juce::Thread::sleep (10);
+
+            expectEquals (generator.getNumSegmentsBeingRendered(), 0);
+            expect (! segmentFile2.getFile().existsAsFile());
+        }
+    }
 };
 
 static AudioFileTests audioFileTests;
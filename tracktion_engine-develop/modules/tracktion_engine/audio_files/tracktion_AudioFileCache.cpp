@@ -28,6 +28,93 @@ static void clearSetOfChannels (int* const* channels, int numChannels, int offse
             juce::FloatVectorOperations::clear (chan + offset, numSamples);
 }
 
+/** Returns a range of bytes in the file that contains the given samples.
+    Uncompressed files are mostly audio data so the range is padded by the size of
+    the other chunks as we don't know where the data starts. Compressed files are
+    assumed to have a constant bit rate.
+*/
+static juce::Range<int64_t> getByteRangeContainingSamples (const AudioFileInfo& info, int64_t fileSize, SampleRange samples)
+{
+    const auto bytesPerFrame = (int64_t) info.numChannels * info.bitsPerSample / 8;
+    const auto numDataBytes = info.lengthInSamples * bytesPerFrame;
+    const juce::Range<int64_t> wholeFile (0, fileSize);
+
+    if (bytesPerFrame > 0 && numDataBytes <= fileSize)
+        return wholeFile.getIntersectionWith ({ samples.getStart() * bytesPerFrame,
+                                                samples.getEnd() * bytesPerFrame + (fileSize - numDataBytes) });
+
+    const auto bytesPerSample = (double) fileSize / (double) info.lengthInSamples;
+
+    return wholeFile.getIntersectionWith ({ (int64_t) (samples.getStart() * bytesPerSample),
+                                            (int64_t) std::ceil (samples.getEnd() * bytesPerSample) });
+}
+
+/** Tells the OS a section of a file will be read soon so it can start reading it
+    in to its cache asynchronously.
+    @returns false if this isn't supported on this platform or failed
+*/
+static bool adviseFileSectionWillBeNeeded ([[ maybe_unused ]] const juce::File& file,
+                                           [[ maybe_unused ]] juce::Range<int64_t> byteRange)
+{
+   #if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+    const auto fd = open (file.getFullPathName().toRawUTF8(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    const auto result = posix_fadvise (fd, (off_t) byteRange.getStart(), (off_t) byteRange.getLength(), POSIX_FADV_WILLNEED);
+    close (fd);
+
+    return result == 0;
+   #elif JUCE_MAC || JUCE_IOS
+    const auto fd = open (file.getFullPathName().toRawUTF8(), O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0)
+        return false;
+
+    bool succeeded = true;
+
+    // F_RDADVISE takes an int count so large sections have to be split up
+    for (auto pos = byteRange.getStart(); pos < byteRange.getEnd() && succeeded;)
+    {
+        radvisory advisory;
+        advisory.ra_offset = (off_t) pos;
+        advisory.ra_count = (int) std::min<int64_t> (byteRange.getEnd() - pos, std::numeric_limits<int>::max());
+        succeeded = fcntl (fd, F_RDADVISE, &advisory) != -1;
+        pos += advisory.ra_count;
+    }
+
+    close (fd);
+
+    return succeeded;
+   #else
+    return false;
+   #endif
+}
+
+/** Reads a section of a file so the OS keeps it in its cache. */
+static void readFileSectionInToCache (const juce::File& file, juce::Range<int64_t> byteRange)
+{
+    juce::FileInputStream in (file);
+
+    if (! in.openedOk() || ! in.setPosition (byteRange.getStart()))
+        return;
+
+    constexpr int bufferSize = 65536;
+    juce::HeapBlock<char> buffer (bufferSize);
+
+    for (auto numBytesLeft = byteRange.getLength(); numBytesLeft > 0;)
+    {
+        const auto numRead = in.read (buffer, (int) std::min<int64_t> (numBytesLeft, bufferSize));
+
+        if (numRead <= 0)
+            break;
+
+        numBytesLeft -= numRead;
+    }
+}
+
+
 //==============================================================================
 //==============================================================================
 struct AudioFileCache::ScopedFileRead
@@ -64,8 +151,8 @@ struct AudioFileCache::ScopedFileRead
 class AudioFileCache::CachedFile
 {
 public:
-    CachedFile (AudioFileCache& c, const AudioFile& f)
-        : cache (c), file (f), info (f.getInfo())
+    CachedFile (AudioFileCache& c, const AudioFile& f, const juce::File& fileToMap)
+        : cache (c), file (f), info (f.getInfo()), mappedFile (fileToMap)
     {
        #if ! JUCE_64BIT
         if (info.lengthInSamples <= cache.cacheSizeSamples)
@@ -279,7 +366,7 @@ public:
     juce::MemoryMappedAudioFormatReader* createNewReader (const SampleRange* range)
     {
         juce::AudioFormat* af;
-        std::unique_ptr<juce::MemoryMappedAudioFormatReader> r (AudioFileUtils::createMemoryMappedReader (cache.engine, file.getFile(), af));
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> r (AudioFileUtils::createMemoryMappedReader (cache.engine, mappedFile, af));
 
         if (r != nullptr
              && (range != nullptr ? r->mapSectionOfFile (juce::Range<juce::int64> (range->getStart(), range->getEnd()))
@@ -394,6 +481,7 @@ public:
         jassert (startOffsetInDestBuffer >= 0);
 
         bool allDataRead = true;
+        numReads.fetch_add (1, std::memory_order_relaxed);
 
         while (numSamples > 0)
         {
@@ -419,6 +507,7 @@ public:
             else
             {
                 allDataRead = false;
+                numMisses.fetch_add (1, std::memory_order_relaxed);
                 clearSetOfChannels (destSamples, numDestChannels, startOffsetInDestBuffer, numSamples);
                 DBG ("*** Cache miss");
                 break;
@@ -487,9 +576,11 @@ public:
     AudioFileCache& cache;
     AudioFile file;
     AudioFileInfo info;
+    const juce::File mappedFile; // The file itself, or a decoded copy if it's compressed
 
     std::atomic<uint32_t> lastReadTime { juce::Time::getApproximateMillisecondCounter() };
     std::atomic<int64_t> totalBytesInUse { 0 };
+    std::atomic<uint64_t> numReads { 0 }, numMisses { 0 }, numPrefetches { 0 };
 
 private:
     juce::OwnedArray<juce::MemoryMappedAudioFormatReader> readers;
@@ -588,11 +679,72 @@ public:
     AudioFileCache& owner;
 };
 
+//==============================================================================
+class AudioFileCache::PrefetchThread   : public juce::Thread
+{
+public:
+    PrefetchThread (AudioFileCache& c)  : juce::Thread ("CachePrefetcher"), owner (c)
+    {
+    }
+
+    ~PrefetchThread()
+    {
+        stopThread (15000);
+    }
+
+    void addRequest (const AudioFile& file, TimeRange sectionOfFile)
+    {
+        {
+            const juce::ScopedLock sl (requestLock);
+            requests.push_back ({ file, sectionOfFile });
+        }
+
+        startThread (juce::Thread::Priority::normal);
+        notify();
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            std::vector<Request> requestsToService;
+
+            {
+                const juce::ScopedLock sl (requestLock);
+                std::swap (requests, requestsToService);
+            }
+
+            for (auto& r : requestsToService)
+            {
+                if (threadShouldExit())
+                    return;
+
+                owner.servicePrefetch (r.file, r.sectionOfFile);
+            }
+
+            if (requestsToService.empty())
+                wait (-1);
+        }
+    }
+
+private:
+    struct Request
+    {
+        AudioFile file;
+        TimeRange sectionOfFile;
+    };
+
+    AudioFileCache& owner;
+    juce::CriticalSection requestLock;
+    std::vector<Request> requests;
+};
+
 //==============================================================================
 AudioFileCache::AudioFileCache (Engine& e)  : engine (e)
 {
     CRASH_TRACER
     const int defaultSize = 6 * 48000;
+    prefetchThread = std::make_unique<PrefetchThread> (*this);
 
     // TODO: when we drop 32-bit support, delete the cache size and related code
     setCacheSizeSamples (static_cast<juce::int64> (engine.getPropertyStorage().getProperty (SettingID::cacheSizeSamples, defaultSize)));
@@ -602,6 +754,7 @@ AudioFileCache::~AudioFileCache()
 {
     CRASH_TRACER
     stopThreads();
+    prefetchThread.reset();
     purgeOrphanReaders();
     jassert (activeFiles.isEmpty());
     activeFiles.clear();
@@ -650,25 +803,39 @@ void AudioFileCache::setCacheSizeSamples (SampleCount samples)
 }
 
 //==============================================================================
-AudioFileCache::CachedFile* AudioFileCache::getOrCreateCachedFile (const AudioFile& f)
+juce::File AudioFileCache::getFileToMap (const AudioFile& f)
+{
+    for (auto af : engine.getAudioFileFormatManager().memoryMappedFormatManager)
+        if (af->canHandleFile (f.getFile()))
+            return f.getFile();
+
+    // Files that can't be mapped are decoded in the background and then read from the decoded copy
+    return engine.getAudioFileManager().decodedCache.getDecodedFile (f);
+}
+
+AudioFileCache::CachedFile* AudioFileCache::getOrCreateCachedFile (const AudioFile& f, const juce::File& fileToMap)
 {
     for (auto s : activeFiles)
         if (s->info.hashCode == f.getHash())
             return s;
 
-    auto& manager = engine.getAudioFileFormatManager().memoryMappedFormatManager;
+    if (fileToMap == juce::File())
+        return {};
 
-    for (auto af : manager)
-    {
-        if (af->canHandleFile (f.getFile()))
-        {
-            auto fs = new CachedFile (*this, f);
-            activeFiles.add (fs);
-            return fs;
-        }
-    }
+    auto fs = new CachedFile (*this, f, fileToMap);
+    activeFiles.add (fs);
+    return fs;
+}
 
-    return {};
+bool AudioFileCache::isMappingFile (const juce::File& file) const
+{
+    const juce::ScopedReadLock sl (fileListLock);
+
+    for (auto f : activeFiles)
+        if (f->mappedFile == file)
+            return true;
+
+    return false;
 }
 
 void AudioFileCache::releaseFile (const AudioFile& file)
@@ -786,13 +953,65 @@ bool AudioFileCache::hasMappedReader (const AudioFile& af, SampleCount c) const
     return false;
 }
 
+//==============================================================================
+void AudioFileCache::prefetch (const AudioFile& file, TimeRange sectionOfFile)
+{
+    if (! file.isNull() && ! sectionOfFile.isEmpty())
+        prefetchThread->addRequest (file, sectionOfFile);
+}
+
+void AudioFileCache::servicePrefetch (const AudioFile& file, TimeRange sectionOfFile)
+{
+    CRASH_TRACER
+    const auto f = file.getFile();
+
+    if (! f.existsAsFile())
+        return;
+
+    const auto info = file.getInfo();
+    const auto samples = toSamples (sectionOfFile, info.sampleRate).getIntersectionWith ({ 0, info.lengthInSamples });
+
+    if (samples.isEmpty())
+        return;
+
+    const auto byteRange = getByteRangeContainingSamples (info, f.getSize(), samples);
+
+    if (! adviseFileSectionWillBeNeeded (f, byteRange))
+        readFileSectionInToCache (f, byteRange);
+
+    // Adding the file to the cache lets the mapper thread map it before it's read
+    const auto fileToMap = getFileToMap (file);
+    const juce::ScopedWriteLock sl (fileListLock);
+
+    if (auto cachedFile = getOrCreateCachedFile (file, fileToMap))
+    {
+        cachedFile->numPrefetches.fetch_add (1, std::memory_order_relaxed);
+        cachedFile->lastReadTime = juce::Time::getApproximateMillisecondCounter();
+    }
+}
+
+std::vector<AudioFileCache::FileStatistics> AudioFileCache::getFileStatistics() const
+{
+    std::vector<FileStatistics> stats;
+    const juce::ScopedReadLock sl (fileListLock);
+
+    for (auto f : activeFiles)
+        stats.push_back ({ f->file,
+                           f->numReads.load (std::memory_order_relaxed),
+                           f->numMisses.load (std::memory_order_relaxed),
+                           f->numPrefetches.load (std::memory_order_relaxed) });
+
+    return stats;
+}
+
 //==============================================================================
 AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file)
 {
     CRASH_TRACER
+    const auto fileToMap = getFileToMap (file);
     const juce::ScopedWriteLock sl (fileListLock);
 
-    if (auto f = getOrCreateCachedFile (file))
+    if (auto f = getOrCreateCachedFile (file, fileToMap))
     {
         auto r = new Reader (*this, f, nullptr);
         f->addClient (r);
@@ -801,10 +1020,15 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file)
 
     if (auto reader = AudioFileUtils::createReaderFor (engine, file.getFile()))
     {
-        backgroundReaderThread.startThread (juce::Thread::Priority::low);
+        // Files that can't be mapped are streamed, sharing a fixed amount of memory
+        if (streamingReaderPool == nullptr)
+        {
+            const auto settings = engine.getEngineBehaviour().getStreamingReaderSettings();
+            streamingReaderPool = std::make_unique<BufferedFileReader::Pool> (settings.maxNumBytes, std::max (1, settings.numThreads));
+        }
 
-        return new Reader (*this, nullptr, std::make_unique<BufferingAudioReaderWrapper> (std::make_unique<juce::BufferingAudioReader> (reader, backgroundReaderThread,
-                                                                                                                                        48000 * 5)));
+        return new Reader (*this, nullptr, std::make_unique<StreamingFileReaderWrapper> (std::make_unique<BufferedFileReader> (reader, *streamingReaderPool,
+                                                                                                                               48000 * 5)));
     }
 
     return {};
@@ -816,9 +1040,10 @@ AudioFileCache::Reader::Ptr AudioFileCache::createReader (const AudioFile& file,
                                                                                                                int samplesToBuffer)>& createFallbackReader)
 {
     CRASH_TRACER
+    const auto fileToMap = getFileToMap (file);
     const juce::ScopedWriteLock sl (fileListLock);
 
-    if (auto f = getOrCreateCachedFile (file))
+    if (auto f = getOrCreateCachedFile (file, fileToMap))
     {
         auto r = new Reader (*this, f, nullptr);
         f->addClient (r);
@@ -1082,7 +1307,10 @@ bool AudioFileCache::Reader::readSamples (int* const* destSamples, int numDestCh
     }
 
     if (! allOk)
+    {
         cache.cacheMissed = true;
+        cache.numCacheMisses.fetch_add (1, std::memory_order_relaxed);
+    }
 
     return allOk;
 }
@@ -105,6 +105,12 @@ public:
 
     bool hasCacheMissed (bool clearMissedFlag);
 
+    /** Returns the number of reads that have missed the cache since it was created.
+        Unlike hasCacheMissed this doesn't clear anything so can be polled by several
+        clients, e.g. to see if a block had a miss by comparing the count before and after it.
+    */
+    uint64_t getNumCacheMisses() const noexcept     { return numCacheMisses.load (std::memory_order_relaxed); }
+
     /** Returns the amount of time spent reading files in the last block. */
     TimeDuration getCpuUsage() const;
 
@@ -114,10 +120,41 @@ public:
     /** @internal */
     bool hasMappedReader (const AudioFile&, SampleCount) const;
 
+    //==============================================================================
+    /** Asks for a section of a file to be loaded in the background so it's in memory
+        before it's read, e.g. for clips that are about to start playing.
+        Where the OS supports it, this hints that the section will be needed so it's
+        read ahead asynchronously, otherwise it's read on a background thread.
+        The range is in seconds from the start of the file. It's converted to samples on
+        the background thread so this doesn't need to read the file's header.
+        [[ thread_safe ]]
+    */
+    void prefetch (const AudioFile&, TimeRange sectionOfFile);
+
+    /** The number of reads and misses for a file in the cache. */
+    struct FileStatistics
+    {
+        AudioFile file;                 /**< The file these are for. */
+        uint64_t numReads = 0;          /**< The number of reads made from the file. */
+        uint64_t numMisses = 0;         /**< The number of reads that couldn't get the data in time so returned silence. */
+        uint64_t numPrefetches = 0;     /**< The number of prefetch requests completed for the file. */
+    };
+
+    /** Returns the statistics for each memory-mapped file currently in the cache.
+        Files are removed from the cache a short while after they're no longer being read.
+    */
+    std::vector<FileStatistics> getFileStatistics() const;
+
+    /** Returns true if a file in the cache is being read from the given file on disk.
+        For compressed files, this will be the decoded copy rather than the original.
+    */
+    bool isMappingFile (const juce::File&) const;
+
 private:
     Engine& engine;
     SampleCount totalBytesUsed = 0, cacheSizeSamples = 0;
     bool cacheMissed = false;
+    std::atomic<uint64_t> numCacheMisses { 0 };
 
     std::atomic<double> blockDurationMs { 0.0 }, lastBlockDurationMs { 0.0 };
     struct ScopedFileRead;
@@ -128,7 +165,8 @@ private:
     int nextFileToService = 0;
     juce::ReadWriteLock fileListLock;
 
-    CachedFile* getOrCreateCachedFile (const AudioFile&);
+    juce::File getFileToMap (const AudioFile&);
+    CachedFile* getOrCreateCachedFile (const AudioFile&, const juce::File& fileToMap);
     bool serviceNextReader();
     void touchReaders();
 
@@ -136,11 +174,15 @@ private:
     std::unique_ptr<MapperThread> mapperThread;
     class RefresherThread;
     std::unique_ptr<RefresherThread> refresherThread;
+    class PrefetchThread;
+    std::unique_ptr<PrefetchThread> prefetchThread;
 
     juce::TimeSliceThread backgroundReaderThread { "Preview Buffer" };
+    std::unique_ptr<BufferedFileReader::Pool> streamingReaderPool;
 
     void stopThreads();
 
+    void servicePrefetch (const AudioFile&, TimeRange);
     void purgeOldFiles();
     void purgeOrphanReaders();
 
@@ -32,6 +32,12 @@ public:
     void runTest() override
     {
         runCacheReadTest();
+        runPrefetchTest();
+        runBufferedFileReaderTest();
+
+       #if JUCE_USE_FLAC
+        runDecodedFileTest();
+       #endif
     }
 
 private:
@@ -60,56 +66,186 @@ private:
         beginTest ("Read a sin wav file");
         expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
     }
-};
 
-static AudioFileCacheTests audioFileCacheTests;
+    void runPrefetchTest()
+    {
+        beginTest ("Prefetching and file statistics");
 
-}} // namespace tracktion { inline namespace engine
+        Engine& engine = *Engine::getEngines().getFirst();
+        auto& cache = engine.getAudioFileManager().cache;
 
-#endif
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::WavAudioFormat> (44100.0, 5.0, 2);
+        const AudioFile audioFile (engine, tempFile->getFile());
 
+        auto getStatistics = [&]() -> std::optional<AudioFileCache::FileStatistics>
+        {
+            for (auto& s : cache.getFileStatistics())
+                if (s.file == audioFile)
+                    return s;
 
-#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_AUDIOFILECACHE
-namespace tracktion { inline namespace engine
-{
+            return {};
+        };
 
-//==============================================================================
-class JUCEBufferingAudioReaderWrapper   : public FallbackReader
-{
-public:
-    JUCEBufferingAudioReaderWrapper (std::unique_ptr<juce::BufferingAudioReader> sourceReader)
-        : source (std::move (sourceReader))
-    {
-        sampleRate              = source->sampleRate;
-        bitsPerSample           = source->bitsPerSample;
-        lengthInSamples         = source->lengthInSamples;
-        numChannels             = source->numChannels;
-        usesFloatingPointData   = source->usesFloatingPointData;
-        metadataValues          = source->metadataValues;
+        expect (! getStatistics());
+
+        // Prefetching should add the file to the cache in the background
+        cache.prefetch (audioFile, TimeRange (1_tp, 2_tp));
+
+        for (int i = 0; i < 500 && (! getStatistics() || getStatistics()->numPrefetches == 0); ++i)
+            juce::Thread::sleep (10);
+
+        auto stats = getStatistics();
+        expect (stats.has_value());
+
+        if (! stats)
+            return;
+
+        expectEquals<int> ((int) stats->numPrefetches, 1);
+        expectEquals<int> ((int) stats->numReads, 0);
+
+        // Reads should then be counted
+        auto cacheReader = cache.createReader (audioFile);
+        juce::AudioBuffer<float> buffer (2, 1024);
+        cacheReader->setReadPosition (44100);
+
+        for (int i = 0; i < 4; ++i)
+            cacheReader->readSamples (buffer.getNumSamples(),
+                                      buffer, juce::AudioChannelSet::stereo(),
+                                      0, juce::AudioChannelSet::stereo(), 5'000);
+
+        stats = getStatistics();
+        expect (stats.has_value());
+
+        if (! stats)
+            return;
+
+        expectGreaterOrEqual<int> ((int) stats->numReads, 4);
+        expectLessOrEqual<int> ((int) stats->numMisses, (int) stats->numReads);
     }
 
-    void setReadTimeout (int timeoutMilliseconds) override
+    void runBufferedFileReaderTest()
     {
-        source->setReadTimeout (timeoutMilliseconds);
+        beginTest ("Read a file with a BufferedFileReader");
+
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSinFile<juce::WavAudioFormat> (44100.0, 5.0, 2);
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+        fileReader->read (&bufferFromFile, 0, (int) fileReader->lengthInSamples, 0, true, true);
+
+        // A pool much smaller than the file so blocks have to be reused as it's read
+        BufferedFileReader::Pool pool (8 * 4096 * 2 * sizeof (float), 2, 4096);
+        BufferedFileReader bufferedReader (AudioFileUtils::createReaderFor (engine, tempFile->getFile()), pool, 4096 * 4);
+        bufferedReader.setReadTimeout (5'000);
+        expectEquals (bufferedReader.lengthInSamples, fileReader->lengthInSamples);
+
+        {
+            juce::AudioBuffer<float> bufferFromReader (bufferFromFile.getNumChannels(), bufferFromFile.getNumSamples());
+
+            for (int i = 0; i < bufferFromReader.getNumSamples(); i += 1000)
+            {
+                const int numToRead = std::min (bufferFromReader.getNumSamples() - i, 1000);
+                expect (bufferedReader.read (&bufferFromReader, i, numToRead, i, true, true));
+            }
+
+            expectAudioBuffer (*this, bufferFromFile, bufferFromReader);
+        }
+
+        // Random reads should also match
+        juce::Random random (42);
+        juce::AudioBuffer<float> bufferFromReader (bufferFromFile.getNumChannels(), 1000), expected (bufferFromFile.getNumChannels(), 1000);
+
+        for (int i = 0; i < 100; ++i)
+        {
+            const int start = random.nextInt (bufferFromFile.getNumSamples() - 1000);
+            bufferedReader.setReadPosition (start);
+            expect (bufferedReader.read (&bufferFromReader, 0, 1000, start, true, true));
+
+            for (int c = 0; c < expected.getNumChannels(); ++c)
+                expected.copyFrom (c, 0, bufferFromFile, c, start, 1000);
+
+            expectAudioBuffer (*this, expected, bufferFromReader);
+        }
+
+        expectEquals<int> ((int) bufferedReader.getNumUnderruns(), 0);
+        expectLessOrEqual (pool.getNumBytesInUse(), pool.getMaxNumBytes());
     }
 
-    bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
-                      juce::int64 startSampleInFile, int numSamples) override
+   #if JUCE_USE_FLAC
+    void runDecodedFileTest()
     {
-        return source->readSamples (destSamples, numDestChannels, startOffsetInDestBuffer,
-                                    startSampleInFile, numSamples);
-    }
+        beginTest ("Read a decoded FLAC file");
 
-private:
-    std::unique_ptr<juce::BufferingAudioReader> source;
+        Engine& engine = *Engine::getEngines().getFirst();
+        auto& decodedCache = engine.getAudioFileManager().decodedCache;
+
+        using namespace graph::test_utilities;
+        auto tempFile = getSquareFile<juce::FlacAudioFormat> (44100.0, 2.0, 2);
+        const AudioFile audioFile (engine, tempFile->getFile());
+
+        auto fileReader = std::unique_ptr<juce::AudioFormatReader> (AudioFileUtils::createReaderFor (engine, tempFile->getFile()));
+        juce::AudioBuffer<float> bufferFromFile ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+        fileReader->read (&bufferFromFile, 0, (int) fileReader->lengthInSamples, 0, true, true);
+
+        // The first request should start the file decoding in the background
+        expect (decodedCache.getDecodedFile (audioFile) == juce::File());
+
+        juce::File decodedFile;
+
+        for (int i = 0; i < 1000 && decodedFile == juce::File(); ++i)
+        {
+            juce::Thread::sleep (10);
+            decodedFile = decodedCache.getDecodedFile (audioFile);
+        }
+
+        expect (decodedFile.existsAsFile());
+        expect (! decodedCache.isDecoding (audioFile));
+
+        // Readers should then be memory-mapped rather than buffered
+        auto& cache = engine.getAudioFileManager().cache;
+        auto cacheReader = cache.createReader (audioFile);
+        expect (cacheReader->getSampleRate() == 44100.0);
+
+        juce::AudioBuffer<float> bufferFromCache ((int) fileReader->numChannels, (int) fileReader->lengthInSamples);
+        cacheReader->setReadPosition (0);
+        expect (cacheReader->readSamples (bufferFromCache.getNumSamples(),
+                                          bufferFromCache, juce::AudioChannelSet::stereo(),
+                                          0, juce::AudioChannelSet::stereo(), 5'000));
+        expect (cache.hasMappedReader (audioFile, 0));
+        expectAudioBuffer (*this, bufferFromFile, bufferFromCache);
+
+        // Clearing the cache shouldn't delete the decoded file whilst it's mapped
+        expect (cache.isMappingFile (decodedFile));
+        decodedCache.clear();
+        expect (decodedFile.existsAsFile());
+
+        cacheReader = nullptr;
+        engine.getAudioFileManager().releaseFile (audioFile);
+        decodedFile.deleteFile();
+    }
+   #endif
 };
 
+static AudioFileCacheTests audioFileCacheTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
+
+
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_AUDIOFILECACHE
+namespace tracktion { inline namespace engine
+{
 
 //==============================================================================
-class TracktionBufferedFileReader   : public FallbackReader
+class JUCEBufferingAudioReaderWrapper   : public FallbackReader
 {
 public:
-    TracktionBufferedFileReader (std::unique_ptr<BufferedFileReader> sourceReader)
+    JUCEBufferingAudioReaderWrapper (std::unique_ptr<juce::BufferingAudioReader> sourceReader)
         : source (std::move (sourceReader))
     {
         sampleRate              = source->sampleRate;
@@ -132,13 +268,8 @@ public:
                                     startSampleInFile, numSamples);
     }
 
-    BufferedFileReader& get()
-    {
-        return *source;
-    }
-
 private:
-    std::unique_ptr<BufferedFileReader> source;
+    std::unique_ptr<juce::BufferingAudioReader> source;
 };
 
 
@@ -155,6 +286,7 @@ public:
     void runTest() override
     {
         runCacheReadBenchmark();
+        runStreamingBenchmark();
     }
 
 private:
@@ -308,38 +440,39 @@ private:
             BenchmarkList::getInstance().addResult (bm.getResult());
         }
 
-        // Read ogg from cached reader
+        // Read ogg from streaming reader
         {
-//xxx            const AudioFile af (engine, tempOggFile->getFile());
-//            const auto lengthInSamples = af.getLengthInSamples();
-//            auto cacheReader = engine.getAudioFileManager().cache.createReader (af,
-//                                                                                [] (juce::AudioFormatReader* sourceReader,
-//                                                                                    juce::TimeSliceThread& timeSliceThread,
-//                                                                                    int samplesToBuffer) -> std::unique_ptr<FallbackReader>
-//                                                                                {
-//                                                                                     return std::make_unique<TracktionBufferedFileReader> (std::make_unique<BufferedFileReader> (sourceReader,
-//                                                                                                                                                                                 timeSliceThread,
-//                                                                                                                                                                                 samplesToBuffer));
-//                                                                                });
-//
-//            auto bm = Benchmark (createBenchmarkDescription ("Files", "Audio file reading",
-//                                                             "Read 1000 random 256 sample blocks from a 10m stereo ogg file at 256 kbps using BufferedFileReader"));
-//            juce::Random r (42);
-//            juce::AudioBuffer<float> destBuffer (numChannels, blockSize);
-//
-//            for (int i = 0; i < 1000; ++i)
-//            {
-//                const auto sourceStartSample = r.nextInt (static_cast<int> (lengthInSamples) - blockSize);
-//
-//                const ScopedMeasurement sm (bm);
-//
-//                cacheReader->setReadPosition (sourceStartSample);
-//                cacheReader->readSamples (blockSize,
-//                                          destBuffer, juce::AudioChannelSet::stereo(),
-//                                          0, juce::AudioChannelSet::stereo(), 5'000);
-//            }
-//
-//            BenchmarkList::getInstance().addResult (bm.getResult());
+            BufferedFileReader::Pool pool (64 * 1024 * 1024, 2);
+            const AudioFile af (engine, tempOggFile->getFile());
+            const auto lengthInSamples = af.getLengthInSamples();
+            auto cacheReader = engine.getAudioFileManager().cache.createReader (af,
+                                                                                [&pool] (juce::AudioFormatReader* sourceReader,
+                                                                                         juce::TimeSliceThread&,
+                                                                                         int samplesToBuffer) -> std::unique_ptr<FallbackReader>
+                                                                                {
+                                                                                     return std::make_unique<StreamingFileReaderWrapper> (std::make_unique<BufferedFileReader> (sourceReader,
+                                                                                                                                                                                pool,
+                                                                                                                                                                                samplesToBuffer));
+                                                                                });
+
+            auto bm = Benchmark (createBenchmarkDescription ("Files", "Audio file reading",
+                                                             "Read 1000 random 256 sample blocks from a 10m stereo ogg file at 256 kbps using BufferedFileReader"));
+            juce::Random r (42);
+            juce::AudioBuffer<float> destBuffer (numChannels, blockSize);
+
+            for (int i = 0; i < 1000; ++i)
+            {
+                const auto sourceStartSample = r.nextInt (static_cast<int> (lengthInSamples) - blockSize);
+
+                const ScopedMeasurement sm (bm);
+
+                cacheReader->setReadPosition (sourceStartSample);
+                cacheReader->readSamples (blockSize,
+                                          destBuffer, juce::AudioChannelSet::stereo(),
+                                          0, juce::AudioChannelSet::stereo(), 5'000);
+            }
+
+            BenchmarkList::getInstance().addResult (bm.getResult());
         }
 
         // Read ogg from memory mapped reader
@@ -410,39 +543,124 @@ private:
             BenchmarkList::getInstance().addResult (bm.getResult());
         }
 
-        // Read ogg from cached reader
+        // Read ogg from streaming reader
+        {
+            BufferedFileReader::Pool pool (64 * 1024 * 1024, 2);
+            const AudioFile af (engine, tempOggFile->getFile());
+            const auto lengthInSamples = af.getLengthInSamples();
+            auto cacheReader = engine.getAudioFileManager().cache.createReader (af,
+                                                                                [&pool] (juce::AudioFormatReader* sourceReader,
+                                                                                         juce::TimeSliceThread&,
+                                                                                         int samplesToBuffer) -> std::unique_ptr<FallbackReader>
+                                                                                {
+                                                                                     return std::make_unique<StreamingFileReaderWrapper> (std::make_unique<BufferedFileReader> (sourceReader,
+                                                                                                                                                                                pool,
+                                                                                                                                                                                samplesToBuffer));
+                                                                                });
+
+            auto bm = Benchmark (createBenchmarkDescription ("Files", "Audio file reading",
+                                                             "Read a 10m stereo ogg file sequentially at 256 kbps using BufferedFileReader"));
+            juce::AudioBuffer<float> destBuffer (numChannels, blockSize);
+
+            for (SampleCount sourceStartSample = 0; sourceStartSample < lengthInSamples; sourceStartSample += blockSize)
+            {
+                const int numThisTime = std::min (blockSize,
+                                                  static_cast<int> (lengthInSamples - sourceStartSample));
+
+                const ScopedMeasurement sm (bm);
+
+                cacheReader->setReadPosition (sourceStartSample);
+                cacheReader->readSamples (numThisTime,
+                                          destBuffer, juce::AudioChannelSet::stereo(),
+                                          0, juce::AudioChannelSet::stereo(), 5'000);
+            }
+
+            BenchmarkList::getInstance().addResult (bm.getResult());
+        }
+    }
+
+    void runStreamingBenchmark()
+    {
+        // Stream 1000 FLAC files at once in real time, reading 256 sample blocks and
+        // occasionally seeking to random positions, and count the reads that underrun.
+        // The files are read from memory so this measures the scheduling and decoding
+        // rather than the disk and doesn't need 1000 file handles
+
+        Engine& engine = *Engine::getEngines().getFirst();
+
+        const double sampleRate = 44100.0;
+        const int numChannels = 2;
+        const int blockSize = 256;
+        const int numStreams = 1000;
+        const int numFiles = 10;
+        const int numBlocksToPlay = (int) (sampleRate * 5.0) / blockSize;
+        const auto blockDurationMs = blockSize * 1000.0 / sampleRate;
+
+        using namespace graph::test_utilities;
+        std::vector<juce::MemoryBlock> fileData (numFiles);
+
+        for (auto& data : fileData)
+            getSquareFile<juce::FlacAudioFormat> (sampleRate, 60.0, numChannels)->getFile().loadFileAsData (data);
+
+        for (int numThreads : { 1, 2, 4 })
         {
-//xxx            const AudioFile af (engine, tempOggFile->getFile());
-//            const auto lengthInSamples = af.getLengthInSamples();
-//            auto cacheReader = engine.getAudioFileManager().cache.createReader (af,
-//                                                                                [] (juce::AudioFormatReader* sourceReader,
-//                                                                                    juce::TimeSliceThread& timeSliceThread,
-//                                                                                    int samplesToBuffer) -> std::unique_ptr<FallbackReader>
-//                                                                                {
-//                                                                                     return std::make_unique<TracktionBufferedFileReader> (std::make_unique<BufferedFileReader> (sourceReader,
-//                                                                                                                                                                                 timeSliceThread,
-//                                                                                                                                                                                 samplesToBuffer));
-//                                                                                });
-//
-//            auto bm = Benchmark (createBenchmarkDescription ("Files", "Audio file reading",
-//                                                             "Read a 10m stereo ogg file sequentially at 256 kbps using BufferedFileReader"));
-//            juce::Random r (42);
-//            juce::AudioBuffer<float> destBuffer (numChannels, blockSize);
-//
-//            for (SampleCount sourceStartSample = 0; sourceStartSample < lengthInSamples; sourceStartSample += blockSize)
-//            {
-//                const int numThisTime = std::min (blockSize,
-//                                                  static_cast<int> (lengthInSamples - sourceStartSample));
-//
-//                const ScopedMeasurement sm (bm);
-//
-//                cacheReader->setReadPosition (sourceStartSample);
-//                cacheReader->readSamples (numThisTime,
-//                                          destBuffer, juce::AudioChannelSet::stereo(),
-//                                          0, juce::AudioChannelSet::stereo(), 5'000);
-//            }
-//
-//            BenchmarkList::getInstance().addResult (bm.getResult());
+            const auto description = juce::String ("1000 streams, random seeks, {threads} threads")
+                                        .replace ("{threads}", juce::String (numThreads));
+            beginTest ("Streaming: " + description);
+
+            BufferedFileReader::Pool pool (256 * 1024 * 1024, numThreads, 8192);
+            std::vector<std::unique_ptr<BufferedFileReader>> readers;
+            std::vector<SampleCount> positions;
+            juce::Random r (42);
+
+            for (int i = 0; i < numStreams; ++i)
+            {
+                auto source = engine.getAudioFileFormatManager().readFormatManager
+                                .createReaderFor (std::make_unique<juce::MemoryInputStream> (fileData[(size_t) (i % numFiles)], false));
+                readers.push_back (std::make_unique<BufferedFileReader> (source, pool, (int) sampleRate));
+                positions.push_back (r.nextInt ((int) readers.back()->lengthInSamples - blockSize * numBlocksToPlay));
+            }
+
+            for (size_t i = 0; i < readers.size(); ++i)
+                readers[i]->setReadPosition (positions[i]);
+
+            // Give the pool a chance to pre-roll before playback starts
+            juce::Thread::sleep (1000);
+
+            auto bm = Benchmark (createBenchmarkDescription ("Files", "Streaming", description.toStdString()));
+            juce::AudioBuffer<float> destBuffer (numChannels, blockSize);
+            uint64_t numReads = 0, numUnderruns = 0;
+            const auto startTime = juce::Time::getMillisecondCounterHiRes();
+
+            for (int block = 0; block < numBlocksToPlay; ++block)
+            {
+                // Wait for the next block as an audio device would
+                const auto blockStartTime = startTime + block * blockDurationMs;
+
+                while (juce::Time::getMillisecondCounterHiRes() < blockStartTime)
+                    juce::Thread::sleep (1);
+
+                const ScopedMeasurement sm (bm);
+
+                for (size_t i = 0; i < readers.size(); ++i)
+                {
+                    auto& reader = *readers[i];
+
+                    if (r.nextInt (2000) == 0)
+                        positions[i] = r.nextInt ((int) reader.lengthInSamples - blockSize * numBlocksToPlay);
+
+                    if (! reader.read (&destBuffer, 0, blockSize, positions[i], true, true))
+                        ++numUnderruns;
+
+                    positions[i] += blockSize;
+                    ++numReads;
+                }
+            }
+
+            BenchmarkList::getInstance().addResult (bm.getResult());
+            logMessage (juce::String (numUnderruns) + " underruns in " + juce::String (numReads) + " reads, "
+                        + juce::String (pool.getNumBytesInUse() / (1024 * 1024)) + " MB in use");
+            expectLessOrEqual (pool.getNumBytesInUse(), pool.getMaxNumBytes());
         }
     }
 };
@@ -11,8 +11,6 @@
 namespace tracktion { inline namespace engine
 {
 
-class TracktionThumbnailCache;
-
 //==============================================================================
 /**
 */
@@ -35,9 +33,11 @@ public:
     void releaseAllFiles();
 
     juce::AudioThumbnailCache& getAudioThumbnailCache()     { return *thumbnailCache; }
+    ThumbnailService& getThumbnailService()                 { return *thumbnailCache; }
 
     Engine& engine;
     AudioProxyGenerator proxyGenerator;
+    DecodedAudioFileCache decodedCache;
     AudioFileCache cache;
 
 private:
@@ -56,9 +56,9 @@ private:
     void callListeners (const AudioFile&);
     void callListenersOnMessageThread (const AudioFile&);
 
-    friend class TracktionThumbnailCache;
+    friend class ThumbnailService;
     friend class SmartThumbnail;
-    std::unique_ptr<juce::AudioThumbnailCache> thumbnailCache;
+    std::unique_ptr<ThumbnailService> thumbnailCache;
     std::set<size_t> thumbnailTypeHashes;
     std::unordered_map<const juce::AudioThumbnailBase*, SmartThumbnail*> thumbnailMap;
     juce::Array<SmartThumbnail*> activeThumbnails;
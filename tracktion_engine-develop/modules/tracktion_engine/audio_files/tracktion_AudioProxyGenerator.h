@@ -11,6 +11,15 @@
 namespace tracktion { inline namespace engine
 {
 
+/**
+    Renders proxy files on background threads.
+
+    Each proxy is rendered by a GeneratorJob on the Engine's BackgroundJobManager.
+    Proxies that are made up of several independent parts, such as the segments of
+    a time-stretched clip, can render those parts as separate segment files on the
+    generator's own pool of worker threads with renderSegment(). Segment files are
+    shared between proxies so any that haven't changed are reused.
+*/
 class AudioProxyGenerator
 {
 public:
@@ -45,12 +54,66 @@ public:
 
     void beginJob (GeneratorJob*);
 
+    //==============================================================================
+    /** A segment file being rendered on the generator's worker pool.
+        Hold on to the Ptr for as long as the segment is needed, once nothing is
+        referencing an unfinished segment its render will be stopped.
+    */
+    struct SegmentRender  : public juce::ReferenceCountedObject
+    {
+        using Ptr = juce::ReferenceCountedObjectPtr<SegmentRender>;
+
+        /** Should write the segment file, returning false if it fails or shouldExit() returns true. */
+        using RenderFunction = std::function<bool (SegmentRender&)>;
+
+        SegmentRender (AudioProxyGenerator&, const AudioFile& segmentFile);
+
+        /** Returns true once the render has either completed or failed. */
+        bool isFinished() const noexcept                { return finished; }
+
+        /** Returns true if the segment file was rendered successfully. */
+        bool wasSuccessful() const noexcept             { return succeeded; }
+
+        /** Waits for the render to finish, returning true if it has. */
+        bool waitUntilFinished (int timeOutMilliseconds);
+
+        /** The render function should regularly check this and stop if it returns true. */
+        bool shouldExit();
+
+        const AudioFile segmentFile;
+        std::atomic<float> progress { 0.0f };
+
+    private:
+        friend class AudioProxyGenerator;
+        AudioProxyGenerator& owner;
+        std::atomic<bool> finished { false }, succeeded { false };
+        bool cancelled = false;
+        juce::WaitableEvent finishedEvent { true };
+
+        void setFinished (bool wasRendered);
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SegmentRender)
+    };
+
+    /** Returns a SegmentRender for a segment file, starting a new render if the file
+        doesn't exist and isn't already being rendered for another proxy.
+    */
+    SegmentRender::Ptr renderSegment (const AudioFile& segmentFile, SegmentRender::RenderFunction);
+
+    /** Returns the number of segment files currently waiting to be, or being, rendered. */
+    int getNumSegmentsBeingRendered() const noexcept;
+
 private:
-    juce::Array<GeneratorJob*> activeJobs;
-    juce::CriticalSection jobListLock;
+    class SegmentJob;
+
+    std::unordered_map<HashCode, GeneratorJob*> activeJobs;
+    std::unordered_map<HashCode, SegmentRender*> activeSegments;
+    mutable juce::CriticalSection jobListLock;
+    juce::ThreadPool segmentPool;
 
     GeneratorJob* findJob (const AudioFile&) const noexcept;
     void removeFinishedJob (GeneratorJob*);
+    void removeSegment (SegmentRender&);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioProxyGenerator)
 };
@@ -11,14 +11,274 @@
 namespace tracktion { inline namespace engine
 {
 
+//==============================================================================
+struct BufferedFileReader::Pool::Block
+{
+    Block (int numChannels, int numSamples)
+        : buffer (numChannels, numSamples)
+    {
+    }
+
+    size_t getNumBytes() const
+    {
+        return (size_t) buffer.getNumChannels() * (size_t) buffer.getNumSamples() * sizeof (float);
+    }
+
+    void read (juce::AudioFormatReader& reader, juce::Range<juce::int64> newSampleRange)
+    {
+        jassert (newSampleRange.getEnd() <= reader.lengthInSamples);
+        range = newSampleRange;
+        allSamplesRead = reader.read (&buffer, 0, (int) range.getLength(), range.getStart(), true, true);
+    }
+
+    juce::AudioBuffer<float> buffer;
+    juce::Range<juce::int64> range;
+    bool allSamplesRead = false;
+
+    // These are only accessed with the Pool's lock held
+    BufferedFileReader* owner = nullptr;
+    size_t slotIndex = 0;
+    bool isBeingRead = false;
+};
+
+//==============================================================================
+class BufferedFileReader::Pool::WorkerThread  : public juce::Thread
+{
+public:
+    WorkerThread (Pool& p, int index)
+        : juce::Thread ("Streaming reader " + juce::String (index)), pool (p)
+    {
+        startThread (juce::Thread::Priority::high);
+    }
+
+    ~WorkerThread() override
+    {
+        stopThread (10000);
+    }
+
+    void run() override
+    {
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        while (! threadShouldExit())
+            if (! pool.readNextBlock())
+                wait (100);
+    }
+
+private:
+    Pool& pool;
+};
+
+//==============================================================================
+BufferedFileReader::Pool::Pool (size_t maxBytes, int numThreads, int numSamplesPerBlock)
+    : maxNumBytes (maxBytes), samplesPerBlock (numSamplesPerBlock)
+{
+    jassert (numThreads > 0);
+    jassert (samplesPerBlock > 0);
+
+    for (int i = 0; i < std::max (1, numThreads); ++i)
+        threads.push_back (std::make_unique<WorkerThread> (*this, i));
+}
+
+BufferedFileReader::Pool::~Pool()
+{
+    // All the readers must be deleted before their Pool
+    jassert (readers.empty());
+    threads.clear();
+}
+
+size_t BufferedFileReader::Pool::getNumBytesInUse() const
+{
+    const juce::ScopedLock sl (lock);
+    return numBytesInUse;
+}
+
+void BufferedFileReader::Pool::addReader (BufferedFileReader& reader)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        readers.push_back (&reader);
+    }
+
+    notifyThreads();
+}
+
+void BufferedFileReader::Pool::removeReader (BufferedFileReader& reader)
+{
+    for (;;)
+    {
+        {
+            const juce::ScopedLock sl (lock);
+
+            // Wait for any block being read for this reader to finish
+            if (! reader.isBeingRead)
+            {
+                readers.erase (std::remove (readers.begin(), readers.end(), &reader), readers.end());
+
+                for (auto& block : blocks)
+                    if (block->owner == &reader)
+                        block->owner = nullptr;
+
+                return;
+            }
+        }
+
+        juce::Thread::sleep (1);
+    }
+}
+
+void BufferedFileReader::Pool::notifyThreads()
+{
+    for (auto& t : threads)
+        t->notify();
+}
+
+bool BufferedFileReader::Pool::readNextBlock()
+{
+    BufferedFileReader* reader = nullptr;
+    Block* block = nullptr;
+    size_t slotIndex = 0;
+
+    {
+        const juce::ScopedLock sl (lock);
+        std::optional<SlotToRead> slotToRead;
+
+        // Find the slot that's needed soonest over all the readers
+        for (auto r : readers)
+        {
+            if (r->isBeingRead)
+                continue;
+
+            if (auto s = r->findNextSlotToRead())
+            {
+                if (! slotToRead || s->priority < slotToRead->priority)
+                {
+                    slotToRead = s;
+                    reader = r;
+                }
+            }
+        }
+
+        if (! slotToRead)
+            return false;
+
+        block = findBlockToUse (*reader, slotToRead->priority);
+
+        if (block == nullptr)
+            return false;
+
+        slotIndex = slotToRead->slotIndex;
+        block->owner = reader;
+        block->slotIndex = slotIndex;
+        block->isBeingRead = true;
+        reader->isBeingRead = true;
+    }
+
+    // The block isn't in a slot so can be read without holding any locks
+    block->read (*reader->source, reader->getSlotRange (slotIndex));
+
+    {
+        const juce::ScopedLock sl (lock);
+        block->isBeingRead = false;
+        reader->isBeingRead = false;
+
+        ScopedSlotAccess (*reader, slotIndex).setBlock (block);
+        ++reader->numBlocksBuffered;
+    }
+
+    return true;
+}
+
+BufferedFileReader::Pool::Block* BufferedFileReader::Pool::findBlockToUse (BufferedFileReader& reader, double priority)
+{
+    const auto numChannels = (int) std::max (1u, reader.numChannels);
+    const auto numBytesNeeded = (size_t) numChannels * (size_t) samplesPerBlock * sizeof (float);
+
+    // Use a free block if there's one the right size
+    for (auto& block : blocks)
+        if (block->owner == nullptr && ! block->isBeingRead && block->buffer.getNumChannels() == numChannels)
+            return block.get();
+
+    // Otherwise delete free blocks that are the wrong size until there's space for a new one
+    for (auto iter = blocks.begin(); iter != blocks.end() && numBytesInUse + numBytesNeeded > maxNumBytes;)
+    {
+        if ((*iter)->owner == nullptr && ! (*iter)->isBeingRead)
+        {
+            numBytesInUse -= (*iter)->getNumBytes();
+            iter = blocks.erase (iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    if (numBytesInUse + numBytesNeeded <= maxNumBytes)
+    {
+        blocks.push_back (std::make_unique<Block> (numChannels, samplesPerBlock));
+        numBytesInUse += numBytesNeeded;
+        return blocks.back().get();
+    }
+
+    // If there's no space left, take the block that will be needed last as long
+    // as that's later than the block that's about to be read
+    auto iter = blocks.end();
+    double blockToUsePriority = priority;
+
+    for (auto i = blocks.begin(); i != blocks.end(); ++i)
+    {
+        auto& block = **i;
+
+        if (block.owner == nullptr || block.isBeingRead)
+            continue;
+
+        if (auto blockPriority = getBlockPriority (block); blockPriority > blockToUsePriority)
+        {
+            iter = i;
+            blockToUsePriority = blockPriority;
+        }
+    }
+
+    if (iter == blocks.end())
+        return {};
+
+    auto& blockToUse = **iter;
+    ScopedSlotAccess (*blockToUse.owner, blockToUse.slotIndex).setBlock (nullptr);
+    --blockToUse.owner->numBlocksBuffered;
+    blockToUse.owner = nullptr;
+
+    if (blockToUse.buffer.getNumChannels() == numChannels)
+        return &blockToUse;
+
+    // If the block is the wrong size, replace it with a new one if there's now space
+    numBytesInUse -= blockToUse.getNumBytes();
+    blocks.erase (iter);
+
+    if (numBytesInUse + numBytesNeeded > maxNumBytes)
+        return {};
+
+    blocks.push_back (std::make_unique<Block> (numChannels, samplesPerBlock));
+    numBytesInUse += numBytesNeeded;
+    return blocks.back().get();
+}
+
+double BufferedFileReader::Pool::getBlockPriority (const Block& block) const
+{
+    jassert (block.owner != nullptr);
+    return block.owner->getPriority (block.range.getStart());
+}
+
+//==============================================================================
 BufferedFileReader::BufferedFileReader (juce::AudioFormatReader* sourceReader,
-                                        juce::TimeSliceThread& timeSliceThread,
+                                        Pool& p,
                                         int samplesToBuffer)
     : juce::AudioFormatReader (nullptr, sourceReader->getFormatName()),
-      source (sourceReader), thread (timeSliceThread),
+      source (sourceReader), pool (p),
+      samplesPerBlock (p.getSamplesPerBlock()),
+      numSamplesToBuffer (std::max (samplesToBuffer, samplesPerBlock)),
       isFullyBuffering (samplesToBuffer < 0)
 {
-    static_assert (std::atomic<BufferedBlock*>::is_always_lock_free);
+    static_assert (std::atomic<Block*>::is_always_lock_free);
     static_assert (std::atomic<bool>::is_always_lock_free);
 
     sampleRate            = source->sampleRate;
@@ -28,33 +288,21 @@ BufferedFileReader::BufferedFileReader (juce::AudioFormatReader* sourceReader,
     bitsPerSample         = 32;
     usesFloatingPointData = true;
 
-    const size_t totalNumSlotsRequired = 1 + (size_t (lengthInSamples) / samplesPerBlock);
-    assert (totalNumSlotsRequired <= std::numeric_limits<int>::max());
-    numBlocksToBuffer = samplesToBuffer > -1 ? static_cast<size_t> (1 + (samplesToBuffer / samplesPerBlock))
-                                             : totalNumSlotsRequired;
+    const size_t totalNumSlotsRequired = 1 + (size_t (lengthInSamples) / (size_t) samplesPerBlock);
+    jassert (totalNumSlotsRequired <= std::numeric_limits<int>::max());
 
-    slots = std::vector<std::atomic<BufferedBlock*>> (totalNumSlotsRequired);
+    slots = std::vector<std::atomic<Block*>> (totalNumSlotsRequired);
     std::fill (slots.begin(), slots.end(), nullptr);
 
     slotsInUse = std::vector<std::atomic<bool>> (totalNumSlotsRequired);
     std::fill (slotsInUse.begin(), slotsInUse.end(), false);
 
-    for (size_t i = 0; i < numBlocksToBuffer; ++i)
-    {
-        // The following code makes the assumption that the pointers are at least 8-bit aligned
-        static_assert (alignof (BufferedBlock*) >= 8);
-        blocks.push_back (std::make_unique<BufferedBlock> (*source));
-
-        // Check the least significant bit is actually 0
-        assert (! std::bitset<sizeof (BufferedBlock*)> (size_t (blocks.back().get()))[0]);
-    }
-
-    timeSliceThread.addTimeSliceClient (this);
+    pool.addReader (*this);
 }
 
 BufferedFileReader::~BufferedFileReader()
 {
-    thread.removeTimeSliceClient (this);
+    pool.removeReader (*this);
 }
 
 void BufferedFileReader::setReadTimeout (int timeoutMilliseconds) noexcept
@@ -62,19 +310,29 @@ void BufferedFileReader::setReadTimeout (int timeoutMilliseconds) noexcept
     timeoutMs = timeoutMilliseconds;
 }
 
+void BufferedFileReader::setReadPosition (juce::int64 samplePosition) noexcept
+{
+    nextReadPosition = samplePosition;
+    pool.notifyThreads();
+}
+
 bool BufferedFileReader::isFullyBuffered() const
 {
     return isFullyBuffering
-        && numBlocksBuffered == numBlocksToBuffer;
+        && numBlocksBuffered == slots.size();
 }
 
 bool BufferedFileReader::readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                                       juce::int64 startSampleInFile, int numSamples)
 {
-    // If a cached block can't be found, update the read position and possibly wait for it
-    nextReadPosition = startSampleInFile;
+    // Let the pool know if this has moved on to a new block so it can start reading further ahead
+    const auto lastReadPosition = nextReadPosition.exchange (startSampleInFile);
+
+    if (getSlotIndexFromSamplePosition (lastReadPosition) != getSlotIndexFromSamplePosition (startSampleInFile))
+        pool.notifyThreads();
 
-    auto startTime = juce::Time::getMillisecondCounter();
+    const auto startTime = juce::Time::getMillisecondCounter();
+    const auto timeout = timeoutMs.load();
     clearSamplesBeyondAvailableLength (destSamples, numDestChannels, startOffsetInDestBuffer,
                                        startSampleInFile, numSamples, lengthInSamples);
 
@@ -84,15 +342,12 @@ bool BufferedFileReader::readSamples (int* const* destSamples, int numDestChanne
     while (numSamples > 0)
     {
         {
-            auto ssa = ScopedSlotAccess::fromPosition (*this, startSampleInFile);
+            ScopedSlotAccess ssa (*this, getSlotIndexFromSamplePosition (startSampleInFile));
 
             if (auto block = ssa.getBlock())
             {
                 jassert (block->range.contains (startSampleInFile));
 
-                // This isn't exact but will be ok for finding the oldest block
-                block->lastUseTime = startTime;
-
                 auto offset = (int) (startSampleInFile - block->range.getStart());
                 auto numToDo = std::min (numSamples, (int) (block->range.getEnd() - startSampleInFile));
 
@@ -121,52 +376,32 @@ bool BufferedFileReader::readSamples (int* const* destSamples, int numDestChanne
         }
 
         if (! std::exchange (hasNotified, true))
-            thread.moveToFrontOfQueue (this);
+            pool.notifyThreads();
 
         // If the timeout has expired, clear the dest buffer and return
-        if (timeoutMs >= 0 && juce::Time::getMillisecondCounter() >= startTime + (juce::uint32) timeoutMs)
+        if (timeout >= 0 && juce::Time::getMillisecondCounter() >= startTime + (juce::uint32) timeout)
         {
             for (int j = 0; j < numDestChannels; ++j)
                 if (auto dest = (float*) destSamples[j])
                     juce::FloatVectorOperations::clear (dest + startOffsetInDestBuffer, numSamples);
 
+            ++numUnderruns;
             allSamplesRead = false;
             break;
         }
-        else
-        {
-            // Otherwise wait and try again
-            juce::Thread::yield();
-        }
+
+        // Otherwise wait and try again
+        juce::Thread::yield();
     }
 
     return allSamplesRead;
 }
 
-BufferedFileReader::BufferedBlock::BufferedBlock (juce::AudioFormatReader& reader)
-    : buffer ((int) reader.numChannels, samplesPerBlock)
-{
-}
-
-void BufferedFileReader::BufferedBlock::update (juce::AudioFormatReader& reader, juce::Range<juce::int64> newSampleRange, size_t currentSlotIndex)
-{
-    assert (newSampleRange.getEnd() <= reader.lengthInSamples);
-    const int numSamples = (int) newSampleRange.getLength();
-    range = newSampleRange;
-    buffer.setSize ((int) reader.numChannels,
-                    numSamples,
-                    false, false, true);
-    allSamplesRead = reader.read (&buffer, 0, numSamples, (int) range.getStart(), true, true);
-    assert (slotIndex == static_cast<int> (currentSlotIndex));
-    slotIndex = static_cast<int> (currentSlotIndex);
-    lastUseTime = juce::Time::getMillisecondCounter();
-    DBG(slotIndex);
-}
-
+//==============================================================================
 BufferedFileReader::ScopedSlotAccess::ScopedSlotAccess (BufferedFileReader& reader_, size_t slotIndex_)
     : reader (reader_), slotIndex (slotIndex_)
 {
-    assert (slotIndex < reader.slots.size());
+    jassert (slotIndex < reader.slots.size());
 
     reader.markSlotUseState (slotIndex, true);
     block = reader.slots[slotIndex];
@@ -178,177 +413,60 @@ BufferedFileReader::ScopedSlotAccess::~ScopedSlotAccess()
     reader.markSlotUseState (slotIndex, false);
 }
 
-BufferedFileReader::ScopedSlotAccess BufferedFileReader::ScopedSlotAccess::fromPosition (BufferedFileReader& reader, juce::int64 position)
+void BufferedFileReader::ScopedSlotAccess::setBlock (Block* blockToReferTo)
 {
-    return { reader, static_cast<size_t> (position / (float) samplesPerBlock) };
-}
-
-void BufferedFileReader::ScopedSlotAccess::setBlock (BufferedBlock* blockToReferTo)
-{
-    if (block)
-        block->slotIndex = -1;
-
     block = blockToReferTo;
-
-    if (block)
-        block->slotIndex = static_cast<int> (slotIndex);
-
     reader.slots[slotIndex] = block;
 }
 
-int BufferedFileReader::useTimeSlice()
-{
-    for (;;)
-    {
-        switch (readNextBufferChunk())
-        {
-            case PositionStatus::positionChangedByAudioThread:  break;
-            case PositionStatus::nextChunkScheduled:            return 1;
-            case PositionStatus::blocksFull:                    return 5;
-            case PositionStatus::fullyLoaded:                   return 100;
-        }
-    }
-}
-
-BufferedFileReader::PositionStatus BufferedFileReader::readNextBufferChunk()
+//==============================================================================
+std::optional<BufferedFileReader::SlotToRead> BufferedFileReader::findNextSlotToRead() const
 {
-    if (isFullyBuffered())
-        return PositionStatus::fullyLoaded;
-
-    // First find the slot the audio thread is trying to read
-    // If that needs reading, set the next-slot-to-read to this
-    // If it's already read, use the current next-slot-to-read value
-    const auto currentReadPosition = nextReadPosition.load();
-    const auto currentSlotIndex = getSlotIndexFromSamplePosition (currentReadPosition);
+    const auto readPosition = std::clamp<juce::int64> (nextReadPosition.load(), 0, lengthInSamples);
+    const auto firstSlot = getSlotIndexFromSamplePosition (readPosition);
+    const auto numSlotsToBuffer = isFullyBuffering ? slots.size()
+                                                   : std::min (slots.size(), 1 + (size_t) (numSamplesToBuffer / samplesPerBlock));
 
-    // Check if the slot being read by the audio thread is buffered
+    // Fully buffering readers wrap around to read the blocks before the read position last
+    for (size_t i = 0; i < numSlotsToBuffer; ++i)
     {
-        // Take exclusive control of the current slot
-        ScopedSlotAccess currentSlot (*this, currentSlotIndex);
-
-        if (auto currentBlockInCurrentSlot = currentSlot.getBlock())
-        {
-            // If the slot has a valid block, it should have the correct range
-            assert (currentBlockInCurrentSlot->range == getSlotRange (currentSlotIndex));
+        const auto slotIndex = firstSlot + i;
 
-            // If the block contains invalid data, we need to re-read this
-            if (! currentBlockInCurrentSlot->allSamplesRead)
-                nextSlotScheduled = currentSlotIndex;
-        }
-    }
-
-    const auto slotToReadIndex = nextSlotScheduled.load();
-    bool readScheduledSlot = true;
-
-    {
-        // Take exclusive control of the scheduled slot
-        ScopedSlotAccess scheduledSlot (*this, slotToReadIndex);
+        if (slotIndex >= slots.size() && ! isFullyBuffering)
+            break;
 
-        // If that block is inthe correct slot with all the samples read, don't re-read
-        if (auto currentBlockInScheduledSlot = scheduledSlot.getBlock())
-            if (currentBlockInScheduledSlot->allSamplesRead)
-                readScheduledSlot = false;
+        if (slots[slotIndex % slots.size()].load() == nullptr)
+            return SlotToRead { slotIndex % slots.size(), getPriority (getSlotRange (slotIndex % slots.size()).getStart()) };
     }
 
-    // Read the next scheduled slot if its out of date
-    if (readScheduledSlot)
-    {
-        // This can be done without taking any exclusive access as the
-        // blocks won't move around and their time stamps are atomic
-        juce::uint32 oldestTime = std::numeric_limits<juce::uint32>::max();
-        BufferedBlock* blockToUse = nullptr;
-
-        for (size_t i = 0; i < blocks.size(); ++i)
-        {
-            auto& block = blocks[i];
-            const auto useTime = block->lastUseTime.load (std::memory_order_relaxed);
-
-            if (useTime > oldestTime)
-                continue;
-
-            blockToUse = block.get();
-            oldestTime = useTime;
-
-            const int curentBlockSlotIndex = block->slotIndex.load (std::memory_order_relaxed);
-
-            // If the block is free, we can simply use it
-            if (curentBlockSlotIndex < 0)
-                break;
-        }
-
-        assert (blockToUse != nullptr);
-        const int blockToUseSlotIndex = blockToUse->slotIndex.load (std::memory_order_relaxed);
-        ScopedSlotAccess desiredSlot (*this, slotToReadIndex);
-
-        if (blockToUseSlotIndex < 0)
-        {
-            // If the block isn't in use, just set its slot
-            desiredSlot.setBlock (blockToUse);
-        }
-        else
-        {
-            // Take exclusive control of the slot the oldest block is in
-            ScopedSlotAccess slotWithOldestBlock (*this, static_cast<size_t> (blockToUseSlotIndex));
-            assert (blockToUse == slotWithOldestBlock.getBlock());
-
-            // Swap the blocks
-            slotWithOldestBlock.setBlock (nullptr);
-            desiredSlot.setBlock (blockToUse);
-        }
-
-        // Update the block's data
-        const juce::Range<juce::int64> slotSampleRange = getSlotRange (slotToReadIndex);
-        blockToUse->update (*source, slotSampleRange, slotToReadIndex);
+    return {};
+}
 
-        // Increment the number of blocks in use if this was a fresh block
-        if (blockToUseSlotIndex < 0 && blockToUse->allSamplesRead)
-            ++numBlocksBuffered;
-    }
+double BufferedFileReader::getPriority (juce::int64 samplePosition) const
+{
+    // This is how long it will be before the given position is read.
+    // Positions that have already been passed won't be needed again so have the lowest priority
+    const auto readPosition = std::clamp<juce::int64> (nextReadPosition.load(), 0, lengthInSamples);
+    const auto slotStart = getSlotRange (getSlotIndexFromSamplePosition (readPosition)).getStart();
 
-    // If all the slots are in use, free the oldest slot from the current read position so a future one can be queued up
-//ddd    if (numBlocksBuffered == blocks.size() && slotToReadIndex > 0)
-//    {
-//        for (auto& block : blocks)
-//        {
-//            // This won't change during this function
-//            const auto blockSlotIndex = block->slotIndex.load();
-//
-//            if (blockSlotIndex < 0)
-//                continue;
-//
-//            if (blockSlotIndex < int (slotToReadIndex) - 1)
-//            {
-//                ScopedSlotAccess slotAccess (*this, size_t (blockSlotIndex));
-//                slotAccess.setBlock (nullptr);
-//                --numBlocksBuffered;
-//            }
-//        }
-//
-//        return PositionStatus::nextChunkScheduled;
-//    }
-
-    // If the read position hasn't changed by the audio thread let the thread reschedule us
-    if (nextReadPosition == currentReadPosition)
-    {
-        assert (blocks.size() > 0);
-        const auto startSlot = std::max (size_t (0), getSlotIndexFromSamplePosition (currentReadPosition));
-        nextSlotScheduled = (startSlot + 1) % slots.size();
+    if (samplePosition >= slotStart)
+        return (double) (samplePosition - readPosition) / sampleRate;
 
-        return PositionStatus::nextChunkScheduled;
-    }
+    if (isFullyBuffering)
+        return (double) (lengthInSamples - readPosition + samplePosition) / sampleRate;
 
-    // Otherwise, the audio thread has changed the position so read the block asap
-    return PositionStatus::positionChangedByAudioThread;
+    return std::numeric_limits<double>::max();
 }
 
-size_t BufferedFileReader::getSlotIndexFromSamplePosition (juce::int64 samplePos)
+size_t BufferedFileReader::getSlotIndexFromSamplePosition (juce::int64 samplePos) const
 {
-    return static_cast<size_t> (samplePos / (float) samplesPerBlock);
+    return std::min (static_cast<size_t> (std::max<juce::int64> (samplePos, 0) / samplesPerBlock),
+                     slots.size() - 1);
 }
 
-juce::Range<juce::int64> BufferedFileReader::getSlotRange (size_t slotIndex)
+juce::Range<juce::int64> BufferedFileReader::getSlotRange (size_t slotIndex) const
 {
-    const juce::int64 slotStartSamplePos = static_cast<juce::int64> (slotIndex * samplesPerBlock);
+    const juce::int64 slotStartSamplePos = static_cast<juce::int64> (slotIndex) * samplesPerBlock;
     const juce::int64 slotEndSamplePos = std::min (slotStartSamplePos + samplesPerBlock, lengthInSamples);
 
     return { slotStartSamplePos, slotEndSamplePos };
@@ -356,7 +474,7 @@ juce::Range<juce::int64> BufferedFileReader::getSlotRange (size_t slotIndex)
 
 void BufferedFileReader::markSlotUseState (size_t slotIndex, bool isInUse)
 {
-    assert (slotIndex < slotsInUse.size());
+    jassert (slotIndex < slotsInUse.size());
     auto& slotInUseState = slotsInUse[slotIndex];
     auto expected = ! isInUse;
 
@@ -12,30 +12,92 @@ namespace tracktion { inline namespace engine
 {
 
 //==============================================================================
-/** @internal
+/**
+    An AudioFormatReader that streams data from another reader, reading it ahead of
+    the current read position on a set of background threads.
 
-    An AudioFormatReader that uses a background thread to pre-read data from
-    another reader.
+    All the readers using the same Pool share its memory budget and threads so any
+    number of files can be streamed at once without the memory used growing with them.
+    The source is read in fixed-size blocks and the blocks that are needed soonest,
+    i.e. those closest to their reader's read position, are always read first.
 
-    N.B. This class is in development and not ready for public use yet!!
+    readSamples can be called from the audio thread as long as the timeout is 0.
 */
-class BufferedFileReader    : public juce::AudioFormatReader,
-                              private juce::TimeSliceClient
+class BufferedFileReader    : public juce::AudioFormatReader
 {
 public:
+    //==============================================================================
+    /**
+        Reads blocks for a set of BufferedFileReaders on a number of background
+        threads, sharing a fixed amount of memory between them.
+
+        When all the memory is in use, blocks behind their reader's read position are
+        reused first, followed by those furthest ahead of it. A block is only reused
+        if the one being read will be needed sooner.
+    */
+    class Pool
+    {
+    public:
+        /** Creates a Pool.
+
+            @param maxNumBytes      the maximum number of bytes all the blocks can use
+            @param numThreads       the number of threads to read blocks on
+            @param samplesPerBlock  the number of samples in each block
+        */
+        Pool (size_t maxNumBytes, int numThreads, int samplesPerBlock = 32768);
+
+        /** Destructor.
+            All the readers using this must be deleted first.
+        */
+        ~Pool();
+
+        /** Returns the maximum number of bytes the blocks can use. */
+        size_t getMaxNumBytes() const noexcept              { return maxNumBytes; }
+
+        /** Returns the number of bytes the blocks are currently using. */
+        size_t getNumBytesInUse() const;
+
+        /** Returns the number of samples in each block. */
+        int getSamplesPerBlock() const noexcept             { return samplesPerBlock; }
+
+    private:
+        friend class BufferedFileReader;
+        struct Block;
+        class WorkerThread;
+
+        const size_t maxNumBytes;
+        const int samplesPerBlock;
+
+        juce::CriticalSection lock;
+        std::vector<std::unique_ptr<Block>> blocks;
+        std::vector<BufferedFileReader*> readers;
+        size_t numBytesInUse = 0;
+        std::vector<std::unique_ptr<WorkerThread>> threads;
+
+        void addReader (BufferedFileReader&);
+        void removeReader (BufferedFileReader&);
+        void notifyThreads();
+        bool readNextBlock();
+
+        Block* findBlockToUse (BufferedFileReader&, double priority);
+        double getBlockPriority (const Block&) const;
+
+        JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Pool)
+    };
+
+    //==============================================================================
     /** Creates a reader.
 
-        @param sourceReader     the source reader to wrap. This BufferingAudioReader
+        @param sourceReader     the source reader to wrap. This BufferedFileReader
                                 takes ownership of this object and will delete it later
                                 when no longer needed
-        @param timeSliceThread  the thread that should be used to do the background reading.
-                                Make sure that the thread you supply is running, and won't
-                                be deleted while the reader object still exists.
+        @param pool             the Pool to read blocks with. This must not be deleted
+                                while the reader object still exists.
         @param samplesToBuffer  the total number of samples to buffer ahead.
                                 Pass -1 to buffer the whole source
     */
     BufferedFileReader (juce::AudioFormatReader* sourceReader,
-                        juce::TimeSliceThread& timeSliceThread,
+                        Pool& pool,
                         int samplesToBuffer);
 
     /** Destructor. */
@@ -49,75 +111,70 @@ public:
     */
     void setReadTimeout (int timeoutMilliseconds) noexcept;
 
+    /** Tells the reader where the next read will be from so it can start buffering
+        from there. Reads update this automatically so this only needs to be called
+        to start buffering before reading starts or after seeking.
+    */
+    void setReadPosition (juce::int64 samplePosition) noexcept;
+
     /** Returns true if this has been initialised to buffer the whole file
         once that is complete, false otherwise.
     */
     bool isFullyBuffered() const;
 
+    /** Returns the number of reads that couldn't be completed before the timeout
+        and so returned silence.
+    */
+    uint64_t getNumUnderruns() const noexcept               { return numUnderruns; }
+
     //==============================================================================
     /** @internal */
     bool readSamples (int* const* destSamples, int numDestChannels, int startOffsetInDestBuffer,
                       juce::int64 startSampleInFile, int numSamples) override;
 
 private:
-    struct BufferedBlock
-    {
-        BufferedBlock (juce::AudioFormatReader&);
-
-        void update (juce::AudioFormatReader&, juce::Range<juce::int64> range, size_t slotIndex);
-
-        juce::Range<juce::int64> range;
-        juce::AudioBuffer<float> buffer;
-        bool allSamplesRead = false;
-        std::atomic<juce::uint32> lastUseTime { 0 };
-        std::atomic<int> slotIndex { -1 };
-    };
+    using Block = Pool::Block;
 
     struct ScopedSlotAccess
     {
         ScopedSlotAccess (BufferedFileReader&, size_t slotIndex);
         ~ScopedSlotAccess();
 
-        static ScopedSlotAccess fromPosition (BufferedFileReader&, juce::int64 position);
-
-        BufferedBlock* getBlock() const     { return block; }
-        void setBlock (BufferedBlock*);
+        Block* getBlock() const     { return block; }
+        void setBlock (Block*);
 
     private:
         BufferedFileReader& reader;
         const size_t slotIndex = 0;
-        BufferedBlock* block = nullptr;
+        Block* block = nullptr;
     };
 
-    int useTimeSlice() override;
-
-    enum class PositionStatus
-    {
-        positionChangedByAudioThread,
-        nextChunkScheduled,
-        blocksFull,
-        fullyLoaded
-    };
-
-    PositionStatus readNextBufferChunk();
-
-    static constexpr int samplesPerBlock = 32768;
-
     std::unique_ptr<juce::AudioFormatReader> source;
-    juce::TimeSliceThread& thread;
+    Pool& pool;
+    const int samplesPerBlock;
+    const juce::int64 numSamplesToBuffer;
+    const bool isFullyBuffering = false;
     std::atomic<juce::int64> nextReadPosition { 0 };
-    int timeoutMs = 0;
+    std::atomic<int> timeoutMs { 0 };
+    std::atomic<uint64_t> numUnderruns { 0 };
 
-    std::vector<std::unique_ptr<BufferedBlock>> blocks;
-    std::vector<std::atomic<BufferedBlock*>> slots;
+    std::vector<std::atomic<Block*>> slots;
     std::vector<std::atomic<bool>> slotsInUse;
+    std::atomic<size_t> numBlocksBuffered { 0 };
 
-    size_t numBlocksToBuffer = 0;
-    std::atomic<size_t> numBlocksBuffered { 0 }, nextSlotScheduled { 0 };
-    const bool isFullyBuffering = false;
+    // This is only accessed by the Pool with its lock held
+    bool isBeingRead = false;
+
+    struct SlotToRead
+    {
+        size_t slotIndex = 0;
+        double priority = 0.0;
+    };
 
-    size_t getSlotIndexFromSamplePosition (juce::int64 samplePos);
-    juce::Range<juce::int64> getSlotRange (size_t slotIndex);
+    std::optional<SlotToRead> findNextSlotToRead() const;
+    double getPriority (juce::int64 samplePosition) const;
+    size_t getSlotIndexFromSamplePosition (juce::int64 samplePos) const;
+    juce::Range<juce::int64> getSlotRange (size_t slotIndex) const;
     void markSlotUseState (size_t slotIndex, bool isInUse);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BufferedFileReader)
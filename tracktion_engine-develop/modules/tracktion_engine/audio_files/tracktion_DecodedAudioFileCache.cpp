@@ -0,0 +1,298 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+class DecodedAudioFileCache::DecoderThread   : public juce::Thread
+{
+public:
+    DecoderThread (DecodedAudioFileCache& c)  : juce::Thread ("Audio Decoder"), owner (c)
+    {
+    }
+
+    ~DecoderThread()
+    {
+        stopThread (15000);
+    }
+
+    void addJob (const AudioFile& file, const juce::File& destFile)
+    {
+        {
+            const juce::ScopedLock sl (jobLock);
+
+            if (isQueued (file))
+                return;
+
+            jobs.push_back ({ file, destFile });
+        }
+
+        startThread (juce::Thread::Priority::low);
+        notify();
+    }
+
+    bool isQueued (const AudioFile& file) const
+    {
+        const juce::ScopedLock sl (jobLock);
+
+        if (currentJob == file.getHash())
+            return true;
+
+        return std::any_of (jobs.begin(), jobs.end(),
+                            [&file] (auto& j) { return j.file == file; });
+    }
+
+    void run()
+    {
+        while (! threadShouldExit())
+        {
+            std::optional<Job> job;
+
+            {
+                const juce::ScopedLock sl (jobLock);
+
+                if (! jobs.empty())
+                {
+                    job = jobs.front();
+                    jobs.erase (jobs.begin());
+                    currentJob = job->file.getHash();
+                }
+            }
+
+            if (! job)
+            {
+                wait (-1);
+                continue;
+            }
+
+            owner.decode (job->file, job->destFile, [this] { return threadShouldExit(); });
+
+            const juce::ScopedLock sl (jobLock);
+            currentJob.reset();
+        }
+    }
+
+private:
+    struct Job
+    {
+        AudioFile file;
+        juce::File destFile;
+    };
+
+    DecodedAudioFileCache& owner;
+    juce::CriticalSection jobLock;
+    std::vector<Job> jobs;
+    std::optional<HashCode> currentJob;
+};
+
+//==============================================================================
+DecodedAudioFileCache::DecodedAudioFileCache (Engine& e)
+    : engine (e)
+{
+    decoderThread = std::make_unique<DecoderThread> (*this);
+}
+
+DecodedAudioFileCache::~DecodedAudioFileCache()
+{
+    decoderThread.reset();
+}
+
+void DecodedAudioFileCache::stopDecoding()
+{
+    decoderThread->stopThread (15000);
+}
+
+juce::File DecodedAudioFileCache::getDecodedFile (const AudioFile& file)
+{
+    CRASH_TRACER
+
+    if (file.isNull())
+        return {};
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (failedFiles.count (file.getHash()) > 0)
+            return {};
+    }
+
+    auto decodedFile = getDecodedFileFor (file);
+
+    if (decodedFile == juce::File())
+        return {};
+
+    if (decodedFile.existsAsFile())
+    {
+        decodedFile.setLastAccessTime (juce::Time::getCurrentTime());
+        return decodedFile;
+    }
+
+    decoderThread->addJob (file, decodedFile);
+    return {};
+}
+
+bool DecodedAudioFileCache::isDecoding (const AudioFile& file) const
+{
+    return decoderThread->isQueued (file);
+}
+
+//==============================================================================
+void DecodedAudioFileCache::setMaximumSize (int64_t numBytes)
+{
+    maximumSize = numBytes;
+    trimToSize (numBytes);
+}
+
+int64_t DecodedAudioFileCache::getMaximumSize() const
+{
+    return maximumSize;
+}
+
+juce::File DecodedAudioFileCache::getDirectory() const
+{
+    const juce::ScopedLock sl (lock);
+
+    // This is worked out the first time it's needed as the TemporaryFileManager is
+    // created after this and can be deleted before the decoder thread has stopped
+    if (directory == juce::File())
+        directory = engine.getTemporaryFileManager().getTempDirectory().getChildFile ("decoded");
+
+    return directory;
+}
+
+void DecodedAudioFileCache::clear()
+{
+    trimToSize (0);
+}
+
+//==============================================================================
+juce::File DecodedAudioFileCache::getDecodedFileFor (const AudioFile& file) const
+{
+    const auto sourceFile = file.getFile();
+
+    if (! sourceFile.existsAsFile())
+        return {};
+
+    size_t hash = 0;
+    hash_combine (hash, file.getHash());
+    hash_combine (hash, sourceFile.getSize());
+    hash_combine (hash, sourceFile.getLastModificationTime().toMilliseconds());
+
+    return getDirectory().getChildFile ("decoded_" + juce::String::toHexString ((juce::int64) hash))
+                         .withFileExtension (".trkaudio");
+}
+
+bool DecodedAudioFileCache::decode (const AudioFile& file, const juce::File& destFile, const std::function<bool()>& shouldExit)
+{
+    CRASH_TRACER
+    auto markAsFailed = [this, &file]
+    {
+        const juce::ScopedLock sl (lock);
+        failedFiles.insert (file.getHash());
+        return false;
+    };
+
+    std::unique_ptr<juce::AudioFormatReader> reader (AudioFileUtils::createReaderFor (engine, file.getFile()));
+
+    if (reader == nullptr || reader->lengthInSamples <= 0)
+        return markAsFailed();
+
+    // Decode to a temporary file first so a partially written one is never mapped
+    const auto tempFile = destFile.withFileExtension (".partial");
+    destFile.getParentDirectory().createDirectory();
+
+    {
+        auto out = tempFile.createOutputStream();
+
+        if (out == nullptr)
+            return markAsFailed();
+
+        std::unique_ptr<juce::AudioFormatWriter> writer (FloatAudioFormat().createWriterFor (out.get(), reader->sampleRate,
+                                                                                             reader->numChannels, 32, {}, 0));
+
+        if (writer == nullptr)
+            return markAsFailed();
+
+        out.release();
+
+        constexpr int blockSize = 65536;
+        juce::AudioBuffer<float> buffer ((int) reader->numChannels, blockSize);
+
+        for (SampleCount pos = 0; pos < reader->lengthInSamples; pos += blockSize)
+        {
+            if (shouldExit())
+            {
+                writer.reset();
+                tempFile.deleteFile();
+                return false;
+            }
+
+            const auto numToDo = (int) std::min<SampleCount> (blockSize, reader->lengthInSamples - pos);
+
+            if (! reader->read (&buffer, 0, numToDo, pos, true, true)
+                || ! writer->writeFromAudioSampleBuffer (buffer, 0, numToDo))
+            {
+                writer.reset();
+                tempFile.deleteFile();
+                return markAsFailed();
+            }
+        }
+    }
+
+    if (! tempFile.moveFileTo (destFile))
+    {
+        tempFile.deleteFile();
+        return markAsFailed();
+    }
+
+    trimToSize (getMaximumSize());
+    return true;
+}
+
+void DecodedAudioFileCache::trimToSize (int64_t maxBytes)
+{
+    CRASH_TRACER
+    auto files = getDirectory().findChildFiles (juce::File::findFiles, false, "*.trkaudio");
+
+    int64_t totalBytes = 0;
+
+    for (auto& f : files)
+        totalBytes += f.getSize();
+
+    if (totalBytes <= maxBytes)
+        return;
+
+    std::sort (files.begin(), files.end(),
+               [] (const juce::File& first, const juce::File& second)
+               {
+                   return first.getLastAccessTime() < second.getLastAccessTime();
+               });
+
+    // Files that are still mapped by the AudioFileCache are left alone and will be
+    // tried again next time
+    auto& cache = engine.getAudioFileManager().cache;
+
+    for (auto& f : files)
+    {
+        if (totalBytes <= maxBytes)
+            break;
+
+        if (cache.isMappingFile (f))
+            continue;
+
+        const auto size = f.getSize();
+
+        if (f.deleteFile())
+            totalBytes -= size;
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
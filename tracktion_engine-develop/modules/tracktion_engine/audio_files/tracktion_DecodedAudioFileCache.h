@@ -0,0 +1,83 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+/**
+    Keeps decoded copies of compressed audio files on disk so they can be
+    memory-mapped by the AudioFileCache.
+
+    Files such as FLAC, Ogg or MP3 can't be memory-mapped so would otherwise have
+    to be decoded on the fly while they're played. The first time one of these is
+    requested it gets decoded in the background to a FloatAudioFormat file in the
+    temp directory. Once that's finished, the AudioFileCache reads from the decoded
+    copy in the same way it does for WAV or AIFF files.
+
+    Decoded files are named by a hash of the source file's path, size and
+    modification time so they're re-decoded if the source changes. When the total
+    size goes over the limit, the least recently used files are deleted.
+*/
+class DecodedAudioFileCache
+{
+public:
+    /** Creates a DecodedAudioFileCache for an Engine. */
+    DecodedAudioFileCache (Engine&);
+
+    /** Destructor. */
+    ~DecodedAudioFileCache();
+
+    //==============================================================================
+    /** Returns the decoded copy of a file if there is one.
+        If there isn't, this starts decoding it in the background and returns an empty File.
+        This should only be used for files that can't be memory-mapped directly.
+    */
+    juce::File getDecodedFile (const AudioFile&);
+
+    /** Returns true if the file is waiting to be, or being, decoded. */
+    bool isDecoding (const AudioFile&) const;
+
+    //==============================================================================
+    /** Sets the maximum number of bytes the decoded files can use on disk. */
+    void setMaximumSize (int64_t numBytes);
+
+    /** Returns the maximum number of bytes the decoded files can use on disk. */
+    int64_t getMaximumSize() const;
+
+    /** Returns the directory the decoded files are kept in. */
+    juce::File getDirectory() const;
+
+    /** Deletes the decoded files that aren't in use. */
+    void clear();
+
+    /** Stops any decoding in progress.
+        This is called before the AudioFileCache is deleted as the decoder thread checks
+        which files it's using when trimming the cache.
+    */
+    void stopDecoding();
+
+private:
+    Engine& engine;
+    class DecoderThread;
+    std::unique_ptr<DecoderThread> decoderThread;
+
+    mutable juce::CriticalSection lock;
+    mutable juce::File directory;
+    std::atomic<int64_t> maximumSize { 2LL * 1024 * 1024 * 1024 };
+    std::unordered_set<HashCode> failedFiles;
+
+    juce::File getDecodedFileFor (const AudioFile&) const;
+    bool decode (const AudioFile&, const juce::File& destFile, const std::function<bool()>& shouldExit);
+    void trimToSize (int64_t maxBytes);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedAudioFileCache)
+};
+
+}} // namespace tracktion { inline namespace engine
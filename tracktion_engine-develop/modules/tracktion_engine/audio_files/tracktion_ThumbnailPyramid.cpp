@@ -0,0 +1,432 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#elif JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
+namespace tracktion { inline namespace engine
+{
+
+namespace thumbnail_scan
+{
+    // Finds the min, max and sum of squares of a block in a single pass
+    static void findLevels (const float* data, int numSamples,
+                            float& minValue, float& maxValue, float& sumSquares) noexcept
+    {
+        float mn = std::numeric_limits<float>::max();
+        float mx = std::numeric_limits<float>::lowest();
+        float sq = 0.0f;
+        int i = 0;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        if (numSamples >= 4)
+        {
+            auto vMin = _mm_loadu_ps (data);
+            auto vMax = vMin;
+            auto vSq = _mm_mul_ps (vMin, vMin);
+
+            for (i = 4; i + 4 <= numSamples; i += 4)
+            {
+                const auto v = _mm_loadu_ps (data + i);
+                vMin = _mm_min_ps (vMin, v);
+                vMax = _mm_max_ps (vMax, v);
+                vSq = _mm_add_ps (vSq, _mm_mul_ps (v, v));
+            }
+
+            float mins[4], maxs[4], sqs[4];
+            _mm_storeu_ps (mins, vMin);
+            _mm_storeu_ps (maxs, vMax);
+            _mm_storeu_ps (sqs, vSq);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                mn = std::min (mn, mins[j]);
+                mx = std::max (mx, maxs[j]);
+                sq += sqs[j];
+            }
+        }
+       #elif JUCE_USE_ARM_NEON
+        if (numSamples >= 4)
+        {
+            auto vMin = vld1q_f32 (data);
+            auto vMax = vMin;
+            auto vSq = vmulq_f32 (vMin, vMin);
+
+            for (i = 4; i + 4 <= numSamples; i += 4)
+            {
+                const auto v = vld1q_f32 (data + i);
+                vMin = vminq_f32 (vMin, v);
+                vMax = vmaxq_f32 (vMax, v);
+                vSq = vmlaq_f32 (vSq, v, v);
+            }
+
+            float mins[4], maxs[4], sqs[4];
+            vst1q_f32 (mins, vMin);
+            vst1q_f32 (maxs, vMax);
+            vst1q_f32 (sqs, vSq);
+
+            for (int j = 0; j < 4; ++j)
+            {
+                mn = std::min (mn, mins[j]);
+                mx = std::max (mx, maxs[j]);
+                sq += sqs[j];
+            }
+        }
+       #endif
+
+        for (; i < numSamples; ++i)
+        {
+            const auto v = data[i];
+            mn = std::min (mn, v);
+            mx = std::max (mx, v);
+            sq += v * v;
+        }
+
+        minValue = mn;
+        maxValue = mx;
+        sumSquares = sq;
+    }
+}
+
+//==============================================================================
+size_t ThumbnailPyramid::getNumPoints (int level) const
+{
+    jassert (juce::isPositiveAndBelow (level, numLevels));
+    return levels[(size_t) level].numPoints;
+}
+
+const ThumbnailPyramid::Point* ThumbnailPyramid::getPoints (int level, int channel) const
+{
+    jassert (juce::isPositiveAndBelow (level, numLevels));
+    jassert (juce::isPositiveAndBelow (channel, numChannels));
+    return levels[(size_t) level].channels[(size_t) channel];
+}
+
+int ThumbnailPyramid::getLevelForSamplesPerPixel (double samplesPerPixel)
+{
+    int level = 0;
+
+    while (level + 1 < numLevels && getSamplesPerPoint (level + 1) <= samplesPerPixel)
+        ++level;
+
+    return level;
+}
+
+std::optional<ThumbnailPyramid::Levels> ThumbnailPyramid::getLevels (int level, int channel,
+                                                                     SampleCount startSample, SampleCount endSample) const
+{
+    if (! juce::isPositiveAndBelow (level, numLevels)
+        || ! juce::isPositiveAndBelow (channel, numChannels)
+        || startSample >= lengthInSamples || endSample <= 0)
+        return {};
+
+    auto& l = levels[(size_t) level];
+    const auto samplesPerPoint = getSamplesPerPoint (level);
+    const auto firstPoint = (size_t) (std::max<SampleCount> (0, startSample) / samplesPerPoint);
+
+    if (firstPoint >= l.numPoints)
+        return {};
+
+    const auto lastPoint = std::clamp ((size_t) ((endSample + samplesPerPoint - 1) / samplesPerPoint),
+                                       firstPoint + 1, l.numPoints);
+    auto points = l.channels[(size_t) channel];
+
+    int minValue = 127, maxValue = -128;
+    uint64_t sumSquares = 0;
+
+    for (auto i = firstPoint; i < lastPoint; ++i)
+    {
+        auto& p = points[i];
+        minValue = std::min (minValue, (int) p.minValue);
+        maxValue = std::max (maxValue, (int) p.maxValue);
+        sumSquares += (uint64_t) p.rms * p.rms;
+    }
+
+    const auto rms = std::sqrt ((double) sumSquares / (double) (lastPoint - firstPoint));
+    return Levels { minValue / 127.0f, maxValue / 127.0f, (float) (rms / 255.0) };
+}
+
+float ThumbnailPyramid::getPeak() const
+{
+    int peak = 0;
+
+    // The coarsest level has the same peak as the others with the fewest points
+    auto& l = levels.back();
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        auto points = l.channels[(size_t) chan];
+
+        for (size_t i = 0; i < l.numPoints; ++i)
+            peak = std::max ({ peak, std::abs ((int) points[i].minValue), std::abs ((int) points[i].maxValue) });
+    }
+
+    return std::min (1.0f, peak / 127.0f);
+}
+
+//==============================================================================
+size_t ThumbnailPyramid::getNumBytesToWrite() const
+{
+    size_t numBytes = sizeof (int32_t) * 2 + sizeof (double) + sizeof (int64_t) * (1 + numLevels);
+
+    for (auto& l : levels)
+        numBytes += l.numPoints * (size_t) numChannels * sizeof (Point);
+
+    return numBytes;
+}
+
+bool ThumbnailPyramid::writeTo (juce::OutputStream& out) const
+{
+    static_assert (sizeof (Point) == 3, "Points are written as bytes and read back in place");
+
+    bool ok = out.writeInt (numChannels)
+           && out.writeInt (numLevels)
+           && out.writeDouble (sampleRate)
+           && out.writeInt64 (lengthInSamples);
+
+    for (auto& l : levels)
+        ok = ok && out.writeInt64 ((juce::int64) l.numPoints);
+
+    for (auto& l : levels)
+        for (int chan = 0; chan < numChannels; ++chan)
+            ok = ok && out.write (l.channels[(size_t) chan], l.numPoints * sizeof (Point));
+
+    return ok;
+}
+
+std::shared_ptr<const ThumbnailPyramid> ThumbnailPyramid::createFrom (const void* data, size_t numBytes,
+                                                                      std::shared_ptr<const void> storage)
+{
+    juce::MemoryInputStream in (data, numBytes, false);
+
+    auto pyramid = std::make_shared<ThumbnailPyramid>();
+    pyramid->numChannels = in.readInt();
+    const auto numLevelsInData = in.readInt();
+    pyramid->sampleRate = in.readDouble();
+    pyramid->lengthInSamples = in.readInt64();
+
+    if (! juce::isPositiveAndBelow (pyramid->numChannels, 256)
+        || numLevelsInData != numLevels
+        || pyramid->sampleRate <= 0.0
+        || pyramid->lengthInSamples < 0)
+        return {};
+
+    for (auto& l : pyramid->levels)
+    {
+        const auto numPoints = in.readInt64();
+
+        if (numPoints < 0 || numPoints > (juce::int64) numBytes)
+            return {};
+
+        l.numPoints = (size_t) numPoints;
+    }
+
+    auto offset = (size_t) in.getPosition();
+
+    for (auto& l : pyramid->levels)
+    {
+        for (int chan = 0; chan < pyramid->numChannels; ++chan)
+        {
+            if (offset + l.numPoints * sizeof (Point) > numBytes)
+                return {};
+
+            l.channels.push_back (reinterpret_cast<const Point*> (static_cast<const char*> (data) + offset));
+            offset += l.numPoints * sizeof (Point);
+        }
+    }
+
+    pyramid->storage = std::move (storage);
+    return pyramid;
+}
+
+//==============================================================================
+struct ThumbnailPyramid::Builder::Accumulator
+{
+    void add (float minToAdd, float maxToAdd, double sumSquaresToAdd, int numSamplesToAdd) noexcept
+    {
+        minValue = std::min (minValue, minToAdd);
+        maxValue = std::max (maxValue, maxToAdd);
+        sumSquares += sumSquaresToAdd;
+        numSamples += numSamplesToAdd;
+    }
+
+    Point toPoint() const noexcept
+    {
+        jassert (numSamples > 0);
+        const auto rms = std::sqrt (sumSquares / numSamples);
+
+        return { (int8_t) juce::jlimit (-127, 127, juce::roundToInt (minValue * 127.0f)),
+                 (int8_t) juce::jlimit (-127, 127, juce::roundToInt (maxValue * 127.0f)),
+                 (uint8_t) juce::jlimit (0, 255, juce::roundToInt (rms * 255.0)) };
+    }
+
+    float minValue = std::numeric_limits<float>::max();
+    float maxValue = std::numeric_limits<float>::lowest();
+    double sumSquares = 0.0;
+    int numSamples = 0;
+};
+
+struct ThumbnailPyramid::Builder::Storage
+{
+    // [level][channel][point]
+    std::array<std::vector<std::vector<Point>>, numLevels> points;
+};
+
+ThumbnailPyramid::Builder::Builder (int numChans, double rate)
+    : numChannels (numChans), sampleRate (rate),
+      storage (std::make_shared<Storage>())
+{
+    jassert (numChannels > 0);
+
+    for (auto& l : storage->points)
+        l.resize ((size_t) numChannels);
+
+    accumulators.resize ((size_t) (numLevels * numChannels));
+}
+
+ThumbnailPyramid::Builder::~Builder() = default;
+
+ThumbnailPyramid::Builder::Accumulator& ThumbnailPyramid::Builder::getAccumulator (int level, int channel)
+{
+    return accumulators[(size_t) (level * numChannels + channel)];
+}
+
+void ThumbnailPyramid::Builder::addPoint (int level, int channel, Accumulator& acc)
+{
+    storage->points[(size_t) level][(size_t) channel].push_back (acc.toPoint());
+
+    if (level + 1 < numLevels)
+    {
+        auto& next = getAccumulator (level + 1, channel);
+        next.add (acc.minValue, acc.maxValue, acc.sumSquares, acc.numSamples);
+        acc = {};
+
+        if (next.numSamples >= getSamplesPerPoint (level + 1))
+            addPoint (level + 1, channel, next);
+    }
+    else
+    {
+        acc = {};
+    }
+}
+
+void ThumbnailPyramid::Builder::addBlock (const float* const* channels, int numSourceChannels, int numSamples)
+{
+    jassert (storage != nullptr);
+
+    for (int chan = 0; chan < numChannels; ++chan)
+    {
+        // Missing channels are treated as silent
+        const auto* source = chan < numSourceChannels ? channels[chan] : nullptr;
+        auto& acc = getAccumulator (0, chan);
+
+        for (int pos = 0; pos < numSamples;)
+        {
+            const auto numToDo = std::min (numSamples - pos, baseSamplesPerPoint - acc.numSamples);
+            float minValue = 0.0f, maxValue = 0.0f, sumSquares = 0.0f;
+
+            if (source != nullptr)
+                thumbnail_scan::findLevels (source + pos, numToDo, minValue, maxValue, sumSquares);
+
+            acc.add (minValue, maxValue, sumSquares, numToDo);
+            pos += numToDo;
+
+            if (acc.numSamples >= baseSamplesPerPoint)
+                addPoint (0, chan, acc);
+        }
+    }
+
+    numSamplesAdded += numSamples;
+}
+
+ThumbnailPyramid ThumbnailPyramid::Builder::getView() const
+{
+    jassert (storage != nullptr);
+
+    ThumbnailPyramid view;
+    view.numChannels = numChannels;
+    view.sampleRate = sampleRate;
+    view.lengthInSamples = numSamplesAdded;
+
+    for (int level = 0; level < numLevels; ++level)
+    {
+        auto& source = storage->points[(size_t) level];
+        auto& dest = view.levels[(size_t) level];
+        dest.numPoints = source.front().size();
+
+        for (auto& chan : source)
+            dest.channels.push_back (chan.data());
+    }
+
+    return view;
+}
+
+std::shared_ptr<const ThumbnailPyramid> ThumbnailPyramid::Builder::build()
+{
+    // Complete any partial points, finest first so they're included in the coarser ones
+    for (int level = 0; level < numLevels; ++level)
+    {
+        for (int chan = 0; chan < numChannels; ++chan)
+        {
+            auto& acc = getAccumulator (level, chan);
+
+            if (acc.numSamples == 0)
+                continue;
+
+            storage->points[(size_t) level][(size_t) chan].push_back (acc.toPoint());
+
+            if (level + 1 < numLevels)
+                getAccumulator (level + 1, chan).add (acc.minValue, acc.maxValue, acc.sumSquares, acc.numSamples);
+
+            acc = {};
+        }
+    }
+
+    auto pyramid = std::make_shared<ThumbnailPyramid> (getView());
+    pyramid->storage = std::move (storage);
+    return pyramid;
+}
+
+//==============================================================================
+std::shared_ptr<const ThumbnailPyramid> ThumbnailPyramid::createFor (juce::AudioFormatReader& reader,
+                                                                     const std::function<bool()>& shouldExit,
+                                                                     std::atomic<SampleCount>& progress)
+{
+    CRASH_TRACER
+
+    if (reader.numChannels == 0 || reader.lengthInSamples <= 0 || reader.sampleRate <= 0.0)
+        return {};
+
+    Builder builder ((int) reader.numChannels, reader.sampleRate);
+
+    constexpr int blockSize = 65536;
+    juce::AudioBuffer<float> buffer ((int) reader.numChannels, blockSize);
+
+    for (SampleCount pos = 0; pos < reader.lengthInSamples; pos += blockSize)
+    {
+        if (shouldExit())
+            return {};
+
+        const auto numToDo = (int) std::min<SampleCount> (blockSize, reader.lengthInSamples - pos);
+
+        if (! reader.read (&buffer, 0, numToDo, pos, true, true))
+            return {};
+
+        builder.addBlock (buffer.getArrayOfReadPointers(), buffer.getNumChannels(), numToDo);
+        progress = pos + numToDo;
+    }
+
+    return builder.build();
+}
+
+}} // namespace tracktion { inline namespace engine
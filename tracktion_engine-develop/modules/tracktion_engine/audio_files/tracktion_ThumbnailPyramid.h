@@ -0,0 +1,169 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Min, max and RMS levels of an audio source at several resolutions.
+
+    Each level summarises the source with one point per getSamplesPerPoint (level)
+    samples, each level being 4 times coarser than the one below it. Drawing picks
+    the coarsest level that still has at least one point per pixel so the cost of
+    drawing doesn't depend on the length of the source.
+
+    The points are stored as bytes so a pyramid can be read directly from a
+    memory-mapped file without being copied or aligned.
+
+    @see ThumbnailService, TracktionThumbnail
+*/
+class ThumbnailPyramid
+{
+public:
+    //==============================================================================
+    /** A single point, with the min and max scaled to +/- 127 and the RMS to 0-255. */
+    struct Point
+    {
+        int8_t minValue = 0, maxValue = 0;
+        uint8_t rms = 0;
+    };
+
+    /** The levels of a Point converted back to floats. */
+    struct Levels
+    {
+        float minValue = 0.0f, maxValue = 0.0f, rms = 0.0f;
+    };
+
+    /** The number of levels in each pyramid. */
+    static constexpr int numLevels = 5;
+
+    /** The number of samples summarised by each point of the finest level. */
+    static constexpr int baseSamplesPerPoint = 64;
+
+    /** Returns the number of source samples summarised by each point of a level. */
+    static constexpr int getSamplesPerPoint (int level)     { return baseSamplesPerPoint << (2 * level); }
+
+    //==============================================================================
+    /** Creates an empty pyramid. */
+    ThumbnailPyramid() = default;
+
+    /** Returns the number of channels. */
+    int getNumChannels() const noexcept                     { return numChannels; }
+
+    /** Returns the sample rate of the source. */
+    double getSampleRate() const noexcept                   { return sampleRate; }
+
+    /** Returns the number of source samples the pyramid covers. */
+    SampleCount getLengthInSamples() const noexcept         { return lengthInSamples; }
+
+    /** Returns the number of points in a level. */
+    size_t getNumPoints (int level) const;
+
+    /** Returns the points of one of the channels of a level. */
+    const Point* getPoints (int level, int channel) const;
+
+    /** Returns the coarsest level that has at least one point for a given number of samples. */
+    static int getLevelForSamplesPerPixel (double samplesPerPixel);
+
+    /** Returns the combined levels of a range of source samples from one of the levels.
+        If the range is smaller than a single point, the point containing its start is used.
+        Returns nullopt if the range is outside the source.
+    */
+    std::optional<Levels> getLevels (int level, int channel, SampleCount startSample, SampleCount endSample) const;
+
+    /** Returns the largest absolute level over all the channels. */
+    float getPeak() const;
+
+    //==============================================================================
+    /** Writes the pyramid to a stream in a form that can be read with createFrom. */
+    bool writeTo (juce::OutputStream&) const;
+
+    /** Returns the number of bytes writeTo will write. */
+    size_t getNumBytesToWrite() const;
+
+    /** Creates a pyramid that refers to data written by writeTo.
+        The data isn't copied so the storage must keep it valid for as long as the
+        returned pyramid exists. Returns nullptr if the data isn't valid.
+    */
+    static std::shared_ptr<const ThumbnailPyramid> createFrom (const void* data, size_t numBytes,
+                                                               std::shared_ptr<const void> storage);
+
+    //==============================================================================
+    /**
+        Builds a ThumbnailPyramid from blocks of source audio.
+        All the levels are built in a single pass over the source.
+    */
+    class Builder
+    {
+    public:
+        /** Creates a Builder for a given source format. */
+        Builder (int numChannels, double sampleRate);
+
+        /** Destructor. */
+        ~Builder();
+
+        /** Adds the next block of source samples. */
+        void addBlock (const float* const* channels, int numChannels, int numSamples);
+
+        /** Returns the number of samples that have been added. */
+        SampleCount getNumSamplesAdded() const noexcept     { return numSamplesAdded; }
+
+        /** Returns a pyramid of the points completed so far.
+            This refers to the Builder's data so can only be used until more samples are added.
+        */
+        ThumbnailPyramid getView() const;
+
+        /** Completes any partially filled points and returns the finished pyramid.
+            The Builder can't be used after this.
+        */
+        std::shared_ptr<const ThumbnailPyramid> build();
+
+    private:
+        struct Accumulator;
+        struct Storage;
+
+        const int numChannels;
+        const double sampleRate;
+        SampleCount numSamplesAdded = 0;
+        std::shared_ptr<Storage> storage;
+        std::vector<Accumulator> accumulators;
+
+        Accumulator& getAccumulator (int level, int channel);
+        void addPoint (int level, int channel, Accumulator&);
+
+        JUCE_DECLARE_NON_COPYABLE (Builder)
+    };
+
+    /** Reads a whole source and returns its pyramid.
+        Returns nullptr if the source couldn't be read or shouldExit returned true.
+        The progress is updated with the number of samples read so far.
+    */
+    static std::shared_ptr<const ThumbnailPyramid> createFor (juce::AudioFormatReader&,
+                                                              const std::function<bool()>& shouldExit,
+                                                              std::atomic<SampleCount>& progress);
+
+private:
+    //==============================================================================
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    SampleCount lengthInSamples = 0;
+
+    struct Level
+    {
+        size_t numPoints = 0;
+        std::vector<const Point*> channels;
+    };
+
+    std::array<Level, numLevels> levels;
+    std::shared_ptr<const void> storage;
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,881 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+namespace thumbnail_cache_file
+{
+    constexpr juce::int64 magicNumber = 0x3142485448435254; // "TRCHTHB1"
+    constexpr juce::int64 headerSize = sizeof (juce::int64);
+    constexpr juce::int64 entryHeaderSize = 3 * sizeof (juce::int64);
+
+    static juce::int64 readInt64 (const void* data, juce::int64 offset)
+    {
+        return (juce::int64) juce::ByteOrder::littleEndianInt64 (static_cast<const char*> (data) + offset);
+    }
+
+    static HashCode getVersion (const juce::File& source)
+    {
+        size_t version = 0;
+        hash_combine (version, source.getSize());
+        hash_combine (version, source.getLastModificationTime().toMilliseconds());
+        return static_cast<HashCode> (version);
+    }
+}
+
+//==============================================================================
+ThumbnailCacheFile::ThumbnailCacheFile (const juce::File& f)
+    : file (f)
+{
+    const juce::ScopedLock sl (lock);
+    load();
+}
+
+ThumbnailCacheFile::~ThumbnailCacheFile()
+{
+}
+
+std::shared_ptr<const ThumbnailPyramid> ThumbnailCacheFile::get (HashCode key, HashCode version) const
+{
+    const juce::ScopedLock sl (lock);
+
+    if (auto found = index.find (key); found != index.end() && found->second.version == version)
+        return getEntry (found->second);
+
+    return {};
+}
+
+std::shared_ptr<const ThumbnailPyramid> ThumbnailCacheFile::add (HashCode key, HashCode version, const ThumbnailPyramid& pyramid)
+{
+    CRASH_TRACER
+    const juce::ScopedLock sl (lock);
+
+    if (! append (key, version, &pyramid))
+        return {};
+
+    remap();
+    return getEntry (index[key]);
+}
+
+void ThumbnailCacheFile::remove (HashCode key)
+{
+    const juce::ScopedLock sl (lock);
+
+    if (index.find (key) != index.end())
+        append (key, 0, nullptr);
+}
+
+size_t ThumbnailCacheFile::getNumEntries() const
+{
+    const juce::ScopedLock sl (lock);
+    return index.size();
+}
+
+juce::int64 ThumbnailCacheFile::getNumBytesWasted() const
+{
+    const juce::ScopedLock sl (lock);
+    return std::max<juce::int64> (0, fileSize - thumbnail_cache_file::headerSize - numBytesInUse);
+}
+
+//==============================================================================
+void ThumbnailCacheFile::load()
+{
+    CRASH_TRACER
+    using namespace thumbnail_cache_file;
+
+    index.clear();
+    mappedFile.reset();
+    fileSize = 0;
+    numBytesInUse = 0;
+
+    if (! file.existsAsFile())
+        return;
+
+    remap();
+
+    if (mappedFile == nullptr
+        || (juce::int64) mappedFile->getSize() < headerSize
+        || readInt64 (mappedFile->getData(), 0) != magicNumber)
+    {
+        mappedFile.reset();
+        file.deleteFile();
+        return;
+    }
+
+    const auto data = mappedFile->getData();
+    const auto size = (juce::int64) mappedFile->getSize();
+    auto pos = headerSize;
+
+    // Later entries replace earlier ones, and an empty entry means it's been removed
+    while (pos + entryHeaderSize <= size)
+    {
+        const auto key = readInt64 (data, pos);
+        const auto version = readInt64 (data, pos + 8);
+        const auto numBytes = readInt64 (data, pos + 16);
+
+        if (numBytes < 0 || pos + entryHeaderSize + numBytes > size)
+            break;
+
+        if (auto found = index.find (key); found != index.end())
+        {
+            numBytesInUse -= entryHeaderSize + found->second.numBytes;
+            index.erase (found);
+        }
+
+        if (numBytes > 0)
+        {
+            index[key] = { pos + entryHeaderSize, numBytes, version };
+            numBytesInUse += entryHeaderSize + numBytes;
+        }
+
+        pos += entryHeaderSize + numBytes;
+    }
+
+    fileSize = pos;
+
+    // If the last entry wasn't completely written, remove it so new ones can be appended
+    if (pos < size)
+    {
+        mappedFile.reset();
+
+        {
+            juce::FileOutputStream out (file);
+
+            if (out.openedOk())
+            {
+                out.setPosition (pos);
+                out.truncate();
+            }
+        }
+
+        remap();
+    }
+
+    if (fileSize > 1024 * 1024 && getNumBytesWasted() > fileSize / 2)
+        compact();
+}
+
+void ThumbnailCacheFile::compact()
+{
+    CRASH_TRACER
+    using namespace thumbnail_cache_file;
+
+    if (mappedFile == nullptr)
+        return;
+
+    const auto tempFile = file.withFileExtension ("tmp");
+    bool ok = false;
+
+    {
+        juce::FileOutputStream out (tempFile);
+
+        if (out.openedOk())
+        {
+            out.setPosition (0);
+            out.truncate();
+            ok = out.writeInt64 (magicNumber);
+
+            for (auto& [key, entry] : index)
+            {
+                ok = ok && out.writeInt64 (key)
+                        && out.writeInt64 (entry.version)
+                        && out.writeInt64 (entry.numBytes)
+                        && out.write (static_cast<const char*> (mappedFile->getData()) + entry.offset, (size_t) entry.numBytes);
+            }
+
+            out.flush();
+            ok = ok && out.getStatus().wasOk();
+        }
+    }
+
+    // This can fail on Windows if any of the pyramids are still mapped, in which case
+    // it will be tried again the next time the file is opened
+    if (ok && tempFile.moveFileTo (file))
+        load();
+    else
+        tempFile.deleteFile();
+}
+
+void ThumbnailCacheFile::remap()
+{
+    mappedFile = std::make_shared<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly, false);
+
+    if (mappedFile->getData() == nullptr)
+        mappedFile.reset();
+}
+
+bool ThumbnailCacheFile::append (HashCode key, HashCode version, const ThumbnailPyramid* pyramid)
+{
+    using namespace thumbnail_cache_file;
+
+    if (! file.getParentDirectory().createDirectory())
+        return false;
+
+    const auto numBytes = pyramid != nullptr ? (juce::int64) pyramid->getNumBytesToWrite() : 0;
+    juce::int64 entryStart = 0;
+
+    {
+        juce::FileOutputStream out (file);
+
+        if (! out.openedOk())
+            return false;
+
+        if (fileSize == 0)
+        {
+            out.setPosition (0);
+            out.truncate();
+
+            if (! out.writeInt64 (magicNumber))
+                return false;
+        }
+        else
+        {
+            out.setPosition (fileSize);
+        }
+
+        entryStart = out.getPosition();
+
+        bool ok = out.writeInt64 (key)
+               && out.writeInt64 (version)
+               && out.writeInt64 (numBytes)
+               && (pyramid == nullptr || pyramid->writeTo (out));
+
+        out.flush();
+
+        if (! ok || out.getStatus().failed() || out.getPosition() != entryStart + entryHeaderSize + numBytes)
+        {
+            out.setPosition (entryStart);
+            out.truncate();
+            fileSize = entryStart;
+            return false;
+        }
+
+        fileSize = out.getPosition();
+    }
+
+    if (auto found = index.find (key); found != index.end())
+    {
+        numBytesInUse -= entryHeaderSize + found->second.numBytes;
+        index.erase (found);
+    }
+
+    if (pyramid != nullptr)
+    {
+        index[key] = { entryStart + entryHeaderSize, numBytes, version };
+        numBytesInUse += entryHeaderSize + numBytes;
+    }
+
+    return true;
+}
+
+std::shared_ptr<const ThumbnailPyramid> ThumbnailCacheFile::getEntry (const Entry& entry) const
+{
+    if (mappedFile == nullptr || entry.offset + entry.numBytes > (juce::int64) mappedFile->getSize())
+        return {};
+
+    return ThumbnailPyramid::createFrom (static_cast<const char*> (mappedFile->getData()) + entry.offset,
+                                         (size_t) entry.numBytes, mappedFile);
+}
+
+
+//==============================================================================
+class ThumbnailService::GeneratorJob  : public juce::ThreadPoolJob
+{
+public:
+    GeneratorJob (ThumbnailService& s, std::unique_ptr<juce::AudioFormatReader> r,
+                  std::shared_ptr<ThumbnailCacheFile> f, HashCode k, HashCode h, HashCode v)
+        : juce::ThreadPoolJob ("Thumbnail generator"),
+          owner (s), reader (std::move (r)), cacheFile (std::move (f)),
+          key (k), hash (h), version (v)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        CRASH_TRACER
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        auto pyramid = ThumbnailPyramid::createFor (*reader, [this] { return shouldExit(); }, *progress);
+        reader.reset();
+
+        // Use the copy in the cache file so the generated one can be freed
+        if (pyramid != nullptr)
+            if (auto cachedPyramid = cacheFile->add (hash, version, *pyramid))
+                pyramid = std::move (cachedPyramid);
+
+        // Don't keep the file open until the pool gets round to deleting this job
+        cacheFile.reset();
+
+        owner.jobFinished (*this, std::move (pyramid));
+        return jobHasFinished;
+    }
+
+    ThumbnailService& owner;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    std::shared_ptr<ThumbnailCacheFile> cacheFile;
+    const HashCode key, hash, version;
+    const std::shared_ptr<std::atomic<SampleCount>> progress = std::make_shared<std::atomic<SampleCount>> (0);
+
+    // These are only accessed with the ThumbnailService's lock held
+    std::vector<TracktionThumbnail*> thumbnails;
+};
+
+//==============================================================================
+ThumbnailService::ThumbnailService (Engine& e)
+   #if JUCE_DEBUG
+    : juce::AudioThumbnailCache (3),
+   #else
+    : juce::AudioThumbnailCache (50),
+   #endif
+      engine (e),
+      pool (juce::ThreadPoolOptions()
+              .withThreadName ("Thumbnail generator")
+              .withNumberOfThreads (std::max (1, juce::SystemStats::getNumCpus() - 1))
+              .withDesiredThreadPriority (juce::Thread::Priority::low))
+{
+}
+
+ThumbnailService::~ThumbnailService()
+{
+    pool.removeAllJobs (true, 10000);
+}
+
+int ThumbnailService::getNumJobs() const
+{
+    const juce::ScopedLock sl (lock);
+    return (int) jobs.size();
+}
+
+std::shared_ptr<ThumbnailCacheFile> ThumbnailService::getCacheFile (Edit* edit)
+{
+    const auto f = getThumbFolder (edit).getChildFile (getCacheFileName());
+
+    const juce::ScopedLock sl (lock);
+
+    // Forget the files that are no longer being used, e.g. those of closed Edits
+    for (auto iter = cacheFiles.begin(); iter != cacheFiles.end();)
+    {
+        if (iter->second.expired())
+            iter = cacheFiles.erase (iter);
+        else
+            ++iter;
+    }
+
+    auto& weakCacheFile = cacheFiles[f];
+    auto cacheFile = weakCacheFile.lock();
+
+    if (cacheFile == nullptr)
+    {
+        cacheFile = std::make_shared<ThumbnailCacheFile> (f);
+        weakCacheFile = cacheFile;
+    }
+
+    return cacheFile;
+}
+
+//==============================================================================
+void ThumbnailService::saveNewlyFinishedThumbnail (const juce::AudioThumbnailBase& thumb, juce::int64 hash)
+{
+    CRASH_TRACER
+    auto st = getActiveSmartThumbnail (thumb);
+    auto thumbFile = getThumbFile (st, hash);
+
+    if (thumbFile.deleteFile())
+    {
+        thumbFile.getParentDirectory().createDirectory();
+
+        juce::FileOutputStream fo (thumbFile);
+
+        if (! fo.openedOk())
+            return;
+
+        thumb.saveTo (fo);
+    }
+}
+
+bool ThumbnailService::loadNewThumb (juce::AudioThumbnailBase& thumb, juce::int64 hash)
+{
+    CRASH_TRACER
+    auto st = getActiveSmartThumbnail (thumb);
+    auto thumbFile = getThumbFile (st, hash);
+
+    if (st != nullptr
+          && st->file.getFile().getLastModificationTime() > thumbFile.getLastModificationTime()
+                                                              + juce::RelativeTime::seconds (0.1))
+    {
+        thumbFile.deleteFile();
+        return false;
+    }
+
+    juce::FileInputStream fin (thumbFile);
+    return fin.openedOk() && thumb.loadFrom (fin);
+}
+
+//==============================================================================
+void ThumbnailService::requestPyramid (TracktionThumbnail& thumb, juce::AudioFormatReader* newReader, juce::int64 hash)
+{
+    CRASH_TRACER
+    std::unique_ptr<juce::AudioFormatReader> reader (newReader);
+
+    // The SmartThumbnail tells us which Edit the cache file belongs to and the source
+    // file to check for changes. Without one, the hash has to be trusted on its own
+    auto st = getActiveSmartThumbnail (thumb);
+    auto cacheFile = getCacheFile (st != nullptr ? st->edit : nullptr);
+    const auto version = st != nullptr ? thumbnail_cache_file::getVersion (st->file.getFile()) : HashCode();
+
+    {
+        const juce::ScopedLock tsl (thumb.lock);
+        thumb.cacheFile = cacheFile;
+    }
+
+    size_t key = 0;
+    hash_combine (key, hash);
+    hash_combine (key, version);
+
+    const juce::ScopedLock sl (lock);
+
+    if (auto found = loadedPyramids.find ((HashCode) key); found != loadedPyramids.end())
+    {
+        if (auto pyramid = found->second.lock())
+        {
+            thumb.setPyramid (std::move (pyramid));
+            return;
+        }
+    }
+
+    // Share any job that's already generating this source. This is checked before the cache
+    // file as a job adds its pyramid to the file just before it finishes
+    auto& job = jobs[(HashCode) key];
+
+    if (job == nullptr || job->shouldExit())
+    {
+        if (auto pyramid = cacheFile->get (hash, version))
+        {
+            jobs.erase ((HashCode) key);
+            loadedPyramids[(HashCode) key] = pyramid;
+            thumb.setPyramid (std::move (pyramid));
+            return;
+        }
+
+        if (reader == nullptr)
+        {
+            jobs.erase ((HashCode) key);
+            thumb.setPyramid (nullptr);
+            return;
+        }
+
+        job = new GeneratorJob (*this, std::move (reader), cacheFile, (HashCode) key, hash, version);
+        pool.addJob (job, true);
+    }
+
+    job->thumbnails.push_back (&thumb);
+    thumb.setPending (job->progress);
+}
+
+void ThumbnailService::cancelRequest (TracktionThumbnail& thumb)
+{
+    const juce::ScopedLock sl (lock);
+
+    for (auto& [key, job] : jobs)
+    {
+        auto& thumbs = job->thumbnails;
+        thumbs.erase (std::remove (thumbs.begin(), thumbs.end(), &thumb), thumbs.end());
+
+        if (thumbs.empty())
+            job->signalJobShouldExit();
+    }
+}
+
+void ThumbnailService::jobFinished (GeneratorJob& job, std::shared_ptr<const ThumbnailPyramid> pyramid)
+{
+    const juce::ScopedLock sl (lock);
+
+    if (auto found = jobs.find (job.key); found != jobs.end() && found->second == &job)
+        jobs.erase (found);
+
+    for (auto iter = loadedPyramids.begin(); iter != loadedPyramids.end();)
+    {
+        if (iter->second.expired())
+            iter = loadedPyramids.erase (iter);
+        else
+            ++iter;
+    }
+
+    if (pyramid != nullptr)
+        loadedPyramids[job.key] = pyramid;
+
+    for (auto thumb : job.thumbnails)
+        thumb->setPyramid (pyramid);
+
+    job.thumbnails.clear();
+}
+
+//==============================================================================
+SmartThumbnail* ThumbnailService::getActiveSmartThumbnail (const juce::AudioThumbnailBase& thumb)
+{
+    auto& map = engine.getAudioFileManager().thumbnailMap;
+
+    if (auto found = map.find (&thumb); found != map.end())
+        return found->second;
+
+    return nullptr;
+}
+
+juce::File ThumbnailService::getThumbFolder (Edit* edit) const
+{
+    if (edit != nullptr)
+        return edit->getTempDirectory (false);
+
+    return engine.getTemporaryFileManager().getThumbnailsFolder();
+}
+
+juce::File ThumbnailService::getThumbFile (const SmartThumbnail* st, HashCode hash) const
+{
+    auto thumbFolder = getThumbFolder (st != nullptr ? st->edit : nullptr);
+
+    return thumbFolder.getChildFile ("thumbnail_" + juce::String::toHexString (hash) + ".thumb");
+}
+
+
+//==============================================================================
+TracktionThumbnail::TracktionThumbnail (ThumbnailService& s)
+    : service (s)
+{
+}
+
+TracktionThumbnail::~TracktionThumbnail()
+{
+    service.cancelRequest (*this);
+}
+
+std::shared_ptr<const ThumbnailPyramid> TracktionThumbnail::getPyramid() const
+{
+    const juce::ScopedLock sl (lock);
+    return pyramid;
+}
+
+void TracktionThumbnail::clear()
+{
+    clearInternal();
+    sendChangeMessage();
+}
+
+void TracktionThumbnail::clearInternal()
+{
+    service.cancelRequest (*this);
+
+    const juce::ScopedLock sl (lock);
+    pyramid.reset();
+    cacheFile.reset();
+    builder.reset();
+    progress.reset();
+    numChannels = 0;
+    sampleRate = 0.0;
+    totalSamples = 0;
+    hashCode = 0;
+}
+
+bool TracktionThumbnail::setSource (juce::InputSource* newSource)
+{
+    std::unique_ptr<juce::InputSource> source (newSource);
+    clear();
+
+    if (source == nullptr)
+        return false;
+
+    auto& formatManager = service.engine.getAudioFileFormatManager().readFormatManager;
+
+    if (auto reader = formatManager.createReaderFor (std::unique_ptr<juce::InputStream> (source->createInputStream())))
+    {
+        setReader (reader, source->hashCode());
+        return true;
+    }
+
+    return false;
+}
+
+void TracktionThumbnail::setReader (juce::AudioFormatReader* newReader, juce::int64 newHashCode)
+{
+    clearInternal();
+
+    {
+        const juce::ScopedLock sl (lock);
+        hashCode = newHashCode;
+
+        if (newReader != nullptr)
+        {
+            numChannels = (int) newReader->numChannels;
+            sampleRate = newReader->sampleRate;
+            totalSamples = newReader->lengthInSamples;
+        }
+    }
+
+    service.requestPyramid (*this, newReader, newHashCode);
+    sendChangeMessage();
+}
+
+bool TracktionThumbnail::loadFrom (juce::InputStream& input)
+{
+    auto data = std::make_shared<juce::MemoryBlock>();
+    input.readIntoMemoryBlock (*data);
+
+    if (auto newPyramid = ThumbnailPyramid::createFrom (data->getData(), data->getSize(), data))
+    {
+        clearInternal();
+        setPyramid (std::move (newPyramid));
+        return true;
+    }
+
+    return false;
+}
+
+void TracktionThumbnail::saveTo (juce::OutputStream& output) const
+{
+    const juce::ScopedLock sl (lock);
+
+    if (pyramid != nullptr)
+        pyramid->writeTo (output);
+}
+
+int TracktionThumbnail::getNumChannels() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+    return numChannels;
+}
+
+double TracktionThumbnail::getTotalLength() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+
+    if (sampleRate <= 0.0)
+        return 0.0;
+
+    if (builder != nullptr)
+        return std::max (totalSamples, builder->getNumSamplesAdded()) / sampleRate;
+
+    return totalSamples / sampleRate;
+}
+
+void TracktionThumbnail::drawChannel (juce::Graphics& g, const juce::Rectangle<int>& area,
+                                      double startTimeSeconds, double endTimeSeconds,
+                                      int channelNum, float verticalZoomFactor)
+{
+    if (area.isEmpty() || endTimeSeconds <= startTimeSeconds)
+        return;
+
+    const juce::ScopedLock sl (lock);
+
+    std::optional<ThumbnailPyramid> builderView;
+    auto source = pyramid.get();
+
+    if (builder != nullptr)
+    {
+        builderView = builder->getView();
+        source = &*builderView;
+    }
+
+    if (source == nullptr || ! juce::isPositiveAndBelow (channelNum, source->getNumChannels()))
+        return;
+
+    const auto samplesPerPixel = (endTimeSeconds - startTimeSeconds) * source->getSampleRate() / area.getWidth();
+    const auto level = ThumbnailPyramid::getLevelForSamplesPerPixel (samplesPerPixel);
+    const auto startSample = startTimeSeconds * source->getSampleRate();
+
+    const auto midY = (float) area.getCentreY();
+    const auto halfHeight = area.getHeight() * 0.5f * verticalZoomFactor;
+    const auto top = (float) area.getY(), bottom = (float) area.getBottom();
+
+    juce::RectangleList<float> waveform;
+    waveform.ensureStorageAllocated (area.getWidth());
+
+    for (int x = 0; x < area.getWidth(); ++x)
+    {
+        const auto s1 = (SampleCount) (startSample + x * samplesPerPixel);
+        const auto s2 = (SampleCount) (startSample + (x + 1) * samplesPerPixel);
+
+        if (auto levels = source->getLevels (level, channelNum, s1, std::max (s2, s1 + 1)))
+        {
+            const auto y1 = juce::jlimit (top, bottom, midY - levels->maxValue * halfHeight);
+            const auto y2 = juce::jlimit (top, bottom, midY - levels->minValue * halfHeight);
+
+            waveform.addWithoutMerging ({ (float) (area.getX() + x), y1, 1.0f, std::max (1.0f, y2 - y1) });
+        }
+    }
+
+    g.fillRectList (waveform);
+}
+
+void TracktionThumbnail::drawChannels (juce::Graphics& g, const juce::Rectangle<int>& area,
+                                       double startTimeSeconds, double endTimeSeconds,
+                                       float verticalZoomFactor)
+{
+    const auto numChans = getNumChannels();
+
+    for (int i = 0; i < numChans; ++i)
+    {
+        const auto y1 = juce::roundToInt ((i * area.getHeight()) / (double) numChans);
+        const auto y2 = juce::roundToInt (((i + 1) * area.getHeight()) / (double) numChans);
+
+        drawChannel (g, { area.getX(), area.getY() + y1, area.getWidth(), y2 - y1 },
+                     startTimeSeconds, endTimeSeconds, i, verticalZoomFactor);
+    }
+}
+
+bool TracktionThumbnail::isFullyLoaded() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+
+    if (builder != nullptr)
+        return builder->getNumSamplesAdded() >= totalSamples;
+
+    return progress == nullptr;
+}
+
+juce::int64 TracktionThumbnail::getNumSamplesFinished() const noexcept
+{
+    const juce::ScopedLock sl (lock);
+
+    if (builder != nullptr)
+        return builder->getNumSamplesAdded();
+
+    if (progress != nullptr)
+        return progress->load();
+
+    return pyramid != nullptr ? pyramid->getLengthInSamples() : 0;
+}
+
+float TracktionThumbnail::getApproximatePeak() const
+{
+    const juce::ScopedLock sl (lock);
+
+    if (builder != nullptr)
+        return builder->getView().getPeak();
+
+    return pyramid != nullptr ? pyramid->getPeak() : 0.0f;
+}
+
+void TracktionThumbnail::getApproximateMinMax (double startTime, double endTime, int channelIndex,
+                                               float& minValue, float& maxValue) const noexcept
+{
+    minValue = 0.0f;
+    maxValue = 0.0f;
+
+    const juce::ScopedLock sl (lock);
+
+    std::optional<ThumbnailPyramid> builderView;
+    auto source = pyramid.get();
+
+    if (builder != nullptr)
+    {
+        builderView = builder->getView();
+        source = &*builderView;
+    }
+
+    if (source == nullptr)
+        return;
+
+    const auto rate = source->getSampleRate();
+    const auto startSample = (SampleCount) (startTime * rate);
+    const auto endSample = std::max (startSample + 1, (SampleCount) (endTime * rate));
+    const auto level = ThumbnailPyramid::getLevelForSamplesPerPixel ((double) (endSample - startSample));
+
+    if (auto levels = source->getLevels (level, channelIndex, startSample, endSample))
+    {
+        minValue = levels->minValue;
+        maxValue = levels->maxValue;
+    }
+}
+
+juce::int64 TracktionThumbnail::getHashCode() const
+{
+    const juce::ScopedLock sl (lock);
+    return hashCode;
+}
+
+void TracktionThumbnail::reset (int newNumChannels, double newSampleRate, juce::int64 totalSamplesInSource)
+{
+    clearInternal();
+
+    {
+        const juce::ScopedLock sl (lock);
+        numChannels = newNumChannels;
+        sampleRate = newSampleRate;
+        totalSamples = totalSamplesInSource;
+
+        if (numChannels > 0 && sampleRate > 0.0)
+        {
+            builder = std::make_unique<ThumbnailPyramid::Builder> (numChannels, sampleRate);
+            channelPointers.resize ((size_t) numChannels);
+        }
+    }
+
+    sendChangeMessage();
+}
+
+void TracktionThumbnail::addBlock (juce::int64 sampleNumberInSource, const juce::AudioBuffer<float>& buffer,
+                                   int startOffsetInBuffer, int numSamples)
+{
+    {
+        const juce::ScopedLock sl (lock);
+
+        if (builder == nullptr || numSamples <= 0)
+            return;
+
+        // Blocks must be added in order, any gaps are left silent
+        if (const auto gap = sampleNumberInSource - builder->getNumSamplesAdded(); gap > 0)
+        {
+            std::fill (channelPointers.begin(), channelPointers.end(), nullptr);
+
+            for (auto remaining = gap; remaining > 0;)
+            {
+                const auto numToDo = (int) std::min<SampleCount> (remaining, std::numeric_limits<int>::max());
+                builder->addBlock (channelPointers.data(), 0, numToDo);
+                remaining -= numToDo;
+            }
+        }
+
+        jassert (sampleNumberInSource >= builder->getNumSamplesAdded());
+        const auto numSourceChannels = std::min (numChannels, buffer.getNumChannels());
+
+        for (int i = 0; i < numSourceChannels; ++i)
+            channelPointers[(size_t) i] = buffer.getReadPointer (i, startOffsetInBuffer);
+
+        builder->addBlock (channelPointers.data(), numSourceChannels, numSamples);
+    }
+
+    sendChangeMessage();
+}
+
+void TracktionThumbnail::setPending (std::shared_ptr<std::atomic<SampleCount>> newProgress)
+{
+    const juce::ScopedLock sl (lock);
+    progress = std::move (newProgress);
+}
+
+void TracktionThumbnail::setPyramid (std::shared_ptr<const ThumbnailPyramid> newPyramid)
+{
+    {
+        const juce::ScopedLock sl (lock);
+        pyramid = std::move (newPyramid);
+        progress.reset();
+
+        if (pyramid != nullptr)
+        {
+            numChannels = pyramid->getNumChannels();
+            sampleRate = pyramid->getSampleRate();
+            totalSamples = pyramid->getLengthInSamples();
+        }
+    }
+
+    sendChangeMessage();
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,235 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+class SmartThumbnail;
+class TracktionThumbnail;
+
+//==============================================================================
+/**
+    A single file holding the ThumbnailPyramids for any number of sources.
+
+    New pyramids are appended to the end of the file along with their key, and an
+    index of where each one is gets built when the file is opened. The file is
+    memory-mapped so pyramids are read in place rather than being loaded.
+
+    Each entry also stores a version, usually derived from the source file's size
+    and modification time, so out of date entries can be ignored. Replaced entries
+    are left in the file until it's compacted the next time it's opened.
+*/
+class ThumbnailCacheFile
+{
+public:
+    /** Opens, or prepares to create, a cache file. */
+    ThumbnailCacheFile (const juce::File&);
+
+    /** Destructor. */
+    ~ThumbnailCacheFile();
+
+    /** Returns the file being used. */
+    const juce::File& getFile() const noexcept          { return file; }
+
+    /** Returns the pyramid for a key if there's one with a matching version. */
+    std::shared_ptr<const ThumbnailPyramid> get (HashCode key, HashCode version) const;
+
+    /** Appends a pyramid to the file, replacing any existing one with the same key.
+        Returns the pyramid as read back from the file, or nullptr if it couldn't be written.
+    */
+    std::shared_ptr<const ThumbnailPyramid> add (HashCode key, HashCode version, const ThumbnailPyramid&);
+
+    /** Removes the pyramid for a key. */
+    void remove (HashCode key);
+
+    /** Returns the number of pyramids in the file. */
+    size_t getNumEntries() const;
+
+    /** Returns the number of bytes in the file used by replaced or removed entries. */
+    juce::int64 getNumBytesWasted() const;
+
+private:
+    struct Entry
+    {
+        juce::int64 offset = 0, numBytes = 0;
+        HashCode version = 0;
+    };
+
+    const juce::File file;
+    mutable juce::CriticalSection lock;
+    std::unordered_map<HashCode, Entry> index;
+    std::shared_ptr<juce::MemoryMappedFile> mappedFile;
+    juce::int64 fileSize = 0, numBytesInUse = 0;
+
+    void load();
+    void compact();
+    void remap();
+    bool append (HashCode key, HashCode version, const ThumbnailPyramid*);
+    std::shared_ptr<const ThumbnailPyramid> getEntry (const Entry&) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThumbnailCacheFile)
+};
+
+
+//==============================================================================
+/**
+    Generates and caches the thumbnails for an Engine.
+
+    TracktionThumbnails ask this for their ThumbnailPyramids, which are generated
+    in parallel on a pool of background threads and stored in a ThumbnailCacheFile
+    in the Edit's temp directory. Thumbnails of the same source share a single
+    pyramid which is read directly from the cache file after it's first generated.
+
+    This is also the juce::AudioThumbnailCache that the AudioFileManager passes to
+    UIBehaviour::createAudioThumbnail so any other juce::AudioThumbnailBase types
+    are still saved to individual files in the thumbnails folder.
+*/
+class ThumbnailService  : public juce::AudioThumbnailCache
+{
+public:
+    //==============================================================================
+    /** Creates a ThumbnailService for an Engine. */
+    ThumbnailService (Engine&);
+
+    /** Destructor. */
+    ~ThumbnailService() override;
+
+    /** Returns the number of thumbnails waiting to be, or being, generated. */
+    int getNumJobs() const;
+
+    /** Returns the cache file for an Edit's thumbnails or the shared one if nullptr is passed.
+        Each thumbnail keeps its cache file open, so an Edit's file is closed once all the
+        thumbnails using it, and any other references returned here, have been deleted.
+    */
+    std::shared_ptr<ThumbnailCacheFile> getCacheFile (Edit*);
+
+    /** Returns the name of the cache file created in each directory. */
+    static juce::String getCacheFileName()              { return "thumbnails.trkthumbs"; }
+
+    //==============================================================================
+    /** @internal */
+    void saveNewlyFinishedThumbnail (const juce::AudioThumbnailBase&, juce::int64 hash) override;
+    /** @internal */
+    bool loadNewThumb (juce::AudioThumbnailBase&, juce::int64 hash) override;
+
+    Engine& engine;
+
+private:
+    //==============================================================================
+    friend class TracktionThumbnail;
+    class GeneratorJob;
+
+    juce::ThreadPool pool;
+    mutable juce::CriticalSection lock;
+    std::map<juce::File, std::weak_ptr<ThumbnailCacheFile>> cacheFiles;
+    std::unordered_map<HashCode, GeneratorJob*> jobs;
+    std::unordered_map<HashCode, std::weak_ptr<const ThumbnailPyramid>> loadedPyramids;
+
+    void requestPyramid (TracktionThumbnail&, juce::AudioFormatReader*, juce::int64 hash);
+    void cancelRequest (TracktionThumbnail&);
+    void jobFinished (GeneratorJob&, std::shared_ptr<const ThumbnailPyramid>);
+
+    SmartThumbnail* getActiveSmartThumbnail (const juce::AudioThumbnailBase&);
+    juce::File getThumbFolder (Edit*) const;
+    juce::File getThumbFile (const SmartThumbnail*, HashCode) const;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThumbnailService)
+};
+
+
+//==============================================================================
+/**
+    A juce::AudioThumbnailBase that draws from a ThumbnailPyramid.
+
+    When given a reader, the pyramid is found in or generated by the ThumbnailService.
+    When given blocks with reset and addBlock, such as while recording, it's built
+    as the blocks arrive.
+
+    This is the thumbnail type the default UIBehaviour::createAudioThumbnail creates.
+*/
+class TracktionThumbnail  : public juce::AudioThumbnailBase
+{
+public:
+    //==============================================================================
+    /** Creates a TracktionThumbnail that gets its pyramids from a ThumbnailService. */
+    TracktionThumbnail (ThumbnailService&);
+
+    /** Destructor. */
+    ~TracktionThumbnail() override;
+
+    /** Returns the current pyramid, or nullptr if it hasn't been loaded yet.
+        This will also be nullptr while the thumbnail is being built with addBlock.
+    */
+    std::shared_ptr<const ThumbnailPyramid> getPyramid() const;
+
+    //==============================================================================
+    /** @internal */
+    void clear() override;
+    /** @internal */
+    bool setSource (juce::InputSource*) override;
+    /** @internal */
+    void setReader (juce::AudioFormatReader*, juce::int64 hashCode) override;
+    /** @internal */
+    bool loadFrom (juce::InputStream&) override;
+    /** @internal */
+    void saveTo (juce::OutputStream&) const override;
+    /** @internal */
+    int getNumChannels() const noexcept override;
+    /** @internal */
+    double getTotalLength() const noexcept override;
+    /** @internal */
+    void drawChannel (juce::Graphics&, const juce::Rectangle<int>& area,
+                      double startTimeSeconds, double endTimeSeconds,
+                      int channelNum, float verticalZoomFactor) override;
+    /** @internal */
+    void drawChannels (juce::Graphics&, const juce::Rectangle<int>& area,
+                       double startTimeSeconds, double endTimeSeconds,
+                       float verticalZoomFactor) override;
+    /** @internal */
+    bool isFullyLoaded() const noexcept override;
+    /** @internal */
+    juce::int64 getNumSamplesFinished() const noexcept override;
+    /** @internal */
+    float getApproximatePeak() const override;
+    /** @internal */
+    void getApproximateMinMax (double startTime, double endTime, int channelIndex,
+                               float& minValue, float& maxValue) const noexcept override;
+    /** @internal */
+    juce::int64 getHashCode() const override;
+    /** @internal */
+    void reset (int numChannels, double sampleRate, juce::int64 totalSamplesInSource) override;
+    /** @internal */
+    void addBlock (juce::int64 sampleNumberInSource, const juce::AudioBuffer<float>&,
+                   int startOffsetInBuffer, int numSamples) override;
+
+private:
+    //==============================================================================
+    friend class ThumbnailService;
+
+    ThumbnailService& service;
+    mutable juce::CriticalSection lock;
+    std::shared_ptr<const ThumbnailPyramid> pyramid;
+    std::shared_ptr<ThumbnailCacheFile> cacheFile;
+    std::unique_ptr<ThumbnailPyramid::Builder> builder;
+    std::vector<const float*> channelPointers;
+    std::shared_ptr<std::atomic<SampleCount>> progress;
+    int numChannels = 0;
+    double sampleRate = 0.0;
+    SampleCount totalSamples = 0;
+    juce::int64 hashCode = 0;
+
+    void setPending (std::shared_ptr<std::atomic<SampleCount>>);
+    void setPyramid (std::shared_ptr<const ThumbnailPyramid>);
+    void clearInternal();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TracktionThumbnail)
+};
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,361 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+
+#include <tracktion_graph/tracktion_graph.h>
+#include "../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
+#include <tracktion_core/utilities/tracktion_Benchmark.h>
+
+namespace tracktion { inline namespace engine
+{
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_THUMBNAILS
+
+//==============================================================================
+//==============================================================================
+class ThumbnailTests    : public juce::UnitTest
+{
+public:
+    ThumbnailTests()
+        : juce::UnitTest ("Thumbnails", "tracktion_engine")
+    {
+    }
+
+    void runTest() override
+    {
+        runPyramidTest();
+        runCacheFileTest();
+        runServiceTest();
+    }
+
+private:
+    static juce::AudioBuffer<float> createNoise (int numChannels, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (numChannels, numSamples);
+        juce::Random r (42);
+
+        for (int chan = 0; chan < numChannels; ++chan)
+            for (int i = 0; i < numSamples; ++i)
+                buffer.setSample (chan, i, (r.nextFloat() * 2.0f - 1.0f) / (float) (chan + 1));
+
+        return buffer;
+    }
+
+    static std::shared_ptr<const ThumbnailPyramid> createPyramid (const juce::AudioBuffer<float>& buffer)
+    {
+        ThumbnailPyramid::Builder builder (buffer.getNumChannels(), 44100.0);
+
+        // Add the samples in blocks that don't line up with the points
+        for (int pos = 0; pos < buffer.getNumSamples();)
+        {
+            const auto numToDo = std::min (1000, buffer.getNumSamples() - pos);
+            std::vector<const float*> channels;
+
+            for (int chan = 0; chan < buffer.getNumChannels(); ++chan)
+                channels.push_back (buffer.getReadPointer (chan, pos));
+
+            builder.addBlock (channels.data(), (int) channels.size(), numToDo);
+            pos += numToDo;
+        }
+
+        return builder.build();
+    }
+
+    void expectPyramidsEqual (const ThumbnailPyramid* p1, const ThumbnailPyramid* p2)
+    {
+        expect (p1 != nullptr && p2 != nullptr);
+
+        if (p1 == nullptr || p2 == nullptr)
+            return;
+
+        expectEquals (p1->getNumChannels(), p2->getNumChannels());
+        expectEquals (p1->getLengthInSamples(), p2->getLengthInSamples());
+
+        for (int level = 0; level < ThumbnailPyramid::numLevels; ++level)
+        {
+            expectEquals (p1->getNumPoints (level), p2->getNumPoints (level));
+
+            for (int chan = 0; chan < p1->getNumChannels(); ++chan)
+                expect (std::memcmp (p1->getPoints (level, chan), p2->getPoints (level, chan),
+                                     p1->getNumPoints (level) * sizeof (ThumbnailPyramid::Point)) == 0);
+        }
+    }
+
+    void runPyramidTest()
+    {
+        beginTest ("Pyramid levels");
+
+        const int numSamples = 100'000;
+        auto buffer = createNoise (2, numSamples);
+        auto pyramid = createPyramid (buffer);
+
+        expectEquals (pyramid->getNumChannels(), 2);
+        expectEquals<SampleCount> (pyramid->getLengthInSamples(), numSamples);
+
+        // Each point should match the source, to within the quantisation
+        for (int level = 0; level < ThumbnailPyramid::numLevels; ++level)
+        {
+            const auto samplesPerPoint = ThumbnailPyramid::getSamplesPerPoint (level);
+            expectEquals<int> ((int) pyramid->getNumPoints (level), (numSamples + samplesPerPoint - 1) / samplesPerPoint);
+
+            for (int chan = 0; chan < 2; ++chan)
+            {
+                for (int i = 0; i < (int) pyramid->getNumPoints (level); i += 7)
+                {
+                    const auto start = i * samplesPerPoint;
+                    const auto num = std::min (samplesPerPoint, numSamples - start);
+                    const auto range = buffer.findMinMax (chan, start, num);
+                    const auto levels = pyramid->getLevels (level, chan, start, start + num);
+
+                    expect (levels.has_value());
+
+                    if (! levels)
+                        continue;
+
+                    expectWithinAbsoluteError (levels->minValue, range.getStart(), 1.0f / 127.0f);
+                    expectWithinAbsoluteError (levels->maxValue, range.getEnd(), 1.0f / 127.0f);
+
+                    if (level == 0)
+                        expectWithinAbsoluteError (levels->rms, buffer.getRMSLevel (chan, start, num), 1.0f / 255.0f);
+                }
+            }
+        }
+
+        expectWithinAbsoluteError (pyramid->getPeak(), buffer.getMagnitude (0, numSamples), 1.0f / 127.0f);
+        expect (! pyramid->getLevels (0, 0, numSamples, numSamples + 100));
+        expect (! pyramid->getLevels (0, 2, 0, 100));
+
+        beginTest ("Pyramid serialisation");
+        {
+            juce::MemoryOutputStream out;
+            expect (pyramid->writeTo (out));
+            expectEquals<int> ((int) out.getDataSize(), (int) pyramid->getNumBytesToWrite());
+
+            auto data = std::make_shared<juce::MemoryBlock> (out.getMemoryBlock());
+            auto copy = ThumbnailPyramid::createFrom (data->getData(), data->getSize(), data);
+            expectPyramidsEqual (pyramid.get(), copy.get());
+            expect (ThumbnailPyramid::createFrom (data->getData(), data->getSize() - 1, data) == nullptr);
+        }
+    }
+
+    void runCacheFileTest()
+    {
+        beginTest ("Cache file");
+
+        juce::TemporaryFile tempFile ("trkthumbs");
+        auto p1 = createPyramid (createNoise (2, 50'000));
+        auto p2 = createPyramid (createNoise (1, 20'000));
+
+        {
+            ThumbnailCacheFile cacheFile (tempFile.getFile());
+            expectEquals<int> ((int) cacheFile.getNumEntries(), 0);
+
+            auto c1 = cacheFile.add (1, 10, *p1);
+            expectPyramidsEqual (p1.get(), c1.get());
+            expectPyramidsEqual (p2.get(), cacheFile.add (2, 20, *p2).get());
+            expect (cacheFile.get (1, 11) == nullptr);
+            expect (cacheFile.get (3, 10) == nullptr);
+
+            // Pyramids should still be valid after the file has been extended and remapped
+            expectPyramidsEqual (p1.get(), c1.get());
+        }
+
+        // Reopening should rebuild the index
+        {
+            ThumbnailCacheFile cacheFile (tempFile.getFile());
+            expectEquals<int> ((int) cacheFile.getNumEntries(), 2);
+            expectPyramidsEqual (p1.get(), cacheFile.get (1, 10).get());
+            expectPyramidsEqual (p2.get(), cacheFile.get (2, 20).get());
+
+            cacheFile.add (1, 11, *p2);
+            expect (cacheFile.get (1, 10) == nullptr);
+            expectPyramidsEqual (p2.get(), cacheFile.get (1, 11).get());
+
+            cacheFile.remove (2);
+            expect (cacheFile.get (2, 20) == nullptr);
+            expectEquals<int> ((int) cacheFile.getNumEntries(), 1);
+            expectGreaterThan (cacheFile.getNumBytesWasted(), (juce::int64) 0);
+        }
+
+        // A partially written entry should be ignored and then overwritten
+        {
+            {
+                juce::FileOutputStream out (tempFile.getFile());
+                out.writeInt64 (3);
+                out.writeInt64 (30);
+                out.writeInt64 (1000);
+            }
+
+            ThumbnailCacheFile cacheFile (tempFile.getFile());
+            expectEquals<int> ((int) cacheFile.getNumEntries(), 1);
+            expect (cacheFile.get (3, 30) == nullptr);
+            expectPyramidsEqual (p2.get(), cacheFile.get (1, 11).get());
+            cacheFile.add (3, 30, *p1);
+        }
+
+        {
+            ThumbnailCacheFile cacheFile (tempFile.getFile());
+            expectEquals<int> ((int) cacheFile.getNumEntries(), 2);
+            expectPyramidsEqual (p1.get(), cacheFile.get (3, 30).get());
+        }
+    }
+
+    void runServiceTest()
+    {
+        beginTest ("Parallel generation");
+
+        auto& engine = *Engine::getEngines().getFirst();
+        auto& service = engine.getAudioFileManager().getThumbnailService();
+
+        using namespace graph::test_utilities;
+        std::vector<std::unique_ptr<juce::TemporaryFile>> files;
+        std::vector<std::unique_ptr<TracktionThumbnail>> thumbnails;
+
+        auto createThumbnail = [&] (const juce::File& f)
+        {
+            auto thumb = std::make_unique<TracktionThumbnail> (service);
+            thumb->setReader (AudioFileUtils::createReaderFor (engine, f), AudioFile (engine, f).getHash());
+            return thumb;
+        };
+
+        auto waitForThumbnails = [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (std::all_of (thumbnails.begin(), thumbnails.end(), [] (auto& t) { return t->isFullyLoaded(); }))
+                    return true;
+
+                juce::Thread::sleep (10);
+            }
+
+            return false;
+        };
+
+        // Two thumbnails of each file should share a single pyramid
+        for (int i = 0; i < 8; ++i)
+        {
+            files.push_back (getSquareFile<juce::WavAudioFormat> (44100.0, 10.0, 2));
+            thumbnails.push_back (createThumbnail (files.back()->getFile()));
+            thumbnails.push_back (createThumbnail (files.back()->getFile()));
+        }
+
+        expect (waitForThumbnails());
+        expectEquals (service.getNumJobs(), 0);
+
+        for (size_t i = 0; i < thumbnails.size(); i += 2)
+        {
+            expect (thumbnails[i]->getPyramid() != nullptr);
+            expect (thumbnails[i]->getPyramid() == thumbnails[i + 1]->getPyramid());
+            expectWithinAbsoluteError (thumbnails[i]->getTotalLength(), 10.0, 0.001);
+            expectEquals (thumbnails[i]->getNumChannels(), 2);
+            expectGreaterThan (thumbnails[i]->getApproximatePeak(), 0.0f);
+        }
+
+        // Once generated, they should be read straight from the cache file
+        thumbnails.clear();
+        thumbnails.push_back (createThumbnail (files.front()->getFile()));
+        expect (thumbnails.front()->isFullyLoaded());
+        expect (thumbnails.front()->getPyramid() != nullptr);
+        expectEquals (service.getNumJobs(), 0);
+
+        // The cache file should be closed once none of the thumbnails are using it
+        std::weak_ptr<ThumbnailCacheFile> cacheFile = service.getCacheFile (nullptr);
+        expect (! cacheFile.expired());
+        thumbnails.clear();
+        expect (cacheFile.expired());
+
+        beginTest ("Building while recording");
+        {
+            auto buffer = createNoise (2, 44100);
+            TracktionThumbnail thumb (service);
+            thumb.reset (2, 44100.0, buffer.getNumSamples());
+
+            for (int pos = 0; pos < buffer.getNumSamples(); pos += 512)
+            {
+                expect (! thumb.isFullyLoaded());
+                thumb.addBlock (pos, buffer, pos, std::min (512, buffer.getNumSamples() - pos));
+            }
+
+            expect (thumb.isFullyLoaded());
+            expectEquals<int> ((int) thumb.getNumSamplesFinished(), buffer.getNumSamples());
+
+            float minValue = 0.0f, maxValue = 0.0f;
+            thumb.getApproximateMinMax (0.0, 1.0, 0, minValue, maxValue);
+            const auto range = buffer.findMinMax (0, 0, buffer.getNumSamples());
+            expectWithinAbsoluteError (minValue, range.getStart(), 1.0f / 127.0f);
+            expectWithinAbsoluteError (maxValue, range.getEnd(), 1.0f / 127.0f);
+        }
+    }
+};
+
+static ThumbnailTests thumbnailTests;
+
+#endif
+
+
+//==============================================================================
+//==============================================================================
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_THUMBNAILS
+
+class ThumbnailBenchmarks   : public juce::UnitTest
+{
+public:
+    ThumbnailBenchmarks()
+        : juce::UnitTest ("Thumbnails", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        // Generate the thumbnails for a set of files as opening a large Edit would
+        auto& engine = *Engine::getEngines().getFirst();
+
+        using namespace graph::test_utilities;
+        std::vector<std::unique_ptr<juce::TemporaryFile>> files;
+
+        for (int i = 0; i < 32; ++i)
+            files.push_back (getSquareFile<juce::WavAudioFormat> (44100.0, 30.0, 2));
+
+        auto generateThumbnails = [&] (auto createThumbnail, const std::string& description)
+        {
+            beginTest (description);
+            std::vector<std::unique_ptr<juce::AudioThumbnailBase>> thumbnails;
+
+            auto bm = Benchmark (createBenchmarkDescription ("Files", "Thumbnails", description));
+            bm.start();
+
+            for (auto& f : files)
+            {
+                thumbnails.push_back (createThumbnail());
+                thumbnails.back()->setReader (AudioFileUtils::createReaderFor (engine, f->getFile()),
+                                              juce::Random::getSystemRandom().nextInt64());
+            }
+
+            while (! std::all_of (thumbnails.begin(), thumbnails.end(), [] (auto& t) { return t->isFullyLoaded(); }))
+                juce::Thread::sleep (1);
+
+            bm.stop();
+            BenchmarkList::getInstance().addResult (bm.getResult());
+        };
+
+        juce::AudioThumbnailCache juceCache (100);
+        generateThumbnails ([&] { return std::make_unique<juce::AudioThumbnail> (256, engine.getAudioFileFormatManager().readFormatManager, juceCache); },
+                            "32 files, juce::AudioThumbnail");
+
+        generateThumbnails ([&] { return std::make_unique<TracktionThumbnail> (engine.getAudioFileManager().getThumbnailService()); },
+                            "32 files, TracktionThumbnail");
+    }
+};
+
+static ThumbnailBenchmarks thumbnailBenchmarks;
+
+#endif
+
+}} // namespace tracktion { inline namespace engine
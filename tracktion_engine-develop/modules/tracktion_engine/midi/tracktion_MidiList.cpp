@@ -2003,4 +2003,34 @@ juce::MidiMessageSequence MidiList::createDefaultPlaybackMidiSequence (const Mid
     return destSequence;
 }
 
+//==============================================================================
+PlaybackMidiSequenceCache::Sequences PlaybackMidiSequenceCache::getOrCreate (HashCode contextHash, const std::function<Sequences()>& createSequences)
+{
+    const juce::ScopedLock sl (lock);
+
+    // Read this before creating the sequences so any changes made whilst they're being created invalidate them
+    const auto currentGeneration = generation.load (std::memory_order_acquire);
+
+    if (hash != contextHash || sequencesGeneration != currentGeneration)
+    {
+        sequences = createSequences();
+        hash = contextHash;
+        sequencesGeneration = currentGeneration;
+    }
+
+    return sequences;
+}
+
+void PlaybackMidiSequenceCache::invalidate() noexcept
+{
+    generation.fetch_add (1, std::memory_order_release);
+}
+
+void PlaybackMidiSequenceCache::clear()
+{
+    const juce::ScopedLock sl (lock);
+    hash.reset();
+    sequences.clear();
+}
+
 }} // namespace tracktion { inline namespace engine
@@ -252,12 +252,14 @@ private:
 
         const juce::Array<EventType*>& getSortedList()
         {
-            TRACKTION_ASSERT_MESSAGE_THREAD
-
             const juce::ScopedLock sl (lock);
 
             if (needsSorting)
             {
+                // Once sorted, the list can be read from a background thread whilst the
+                // message thread is blocked, e.g. when building the playback graph
+                TRACKTION_ASSERT_MESSAGE_THREAD
+
                 needsSorting = false;
                 sortedEvents = ValueTreeObjectList<EventType>::objects;
                 sortMidiEventsByTime (sortedEvents);
@@ -281,4 +283,42 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiList)
 };
 
+
+//==============================================================================
+/**
+    Holds the playback sequences last created for a clip. These only need creating
+    again when the clip calls invalidate() because its state has changed or the
+    hash of whatever else they depend on (e.g. the tempo sequence) changes, rather
+    than every time the playback graph is rebuilt.
+*/
+class PlaybackMidiSequenceCache
+{
+public:
+    PlaybackMidiSequenceCache() = default;
+
+    using Sequences = std::vector<juce::MidiMessageSequence>;
+
+    /** Returns a copy of the cached sequences if they're still valid and were created
+        with the same context hash, otherwise calls createSequences and caches the result.
+    */
+    Sequences getOrCreate (HashCode contextHash, const std::function<Sequences()>& createSequences);
+
+    /** Marks the cached sequences as out of date so they'll be created again next time.
+        This can be called whilst another thread is in getOrCreate.
+    */
+    void invalidate() noexcept;
+
+    /** Removes any cached sequences. */
+    void clear();
+
+private:
+    juce::CriticalSection lock;
+    std::atomic<uint64_t> generation { 0 };
+    uint64_t sequencesGeneration = 0;
+    std::optional<HashCode> hash;
+    Sequences sequences;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PlaybackMidiSequenceCache)
+};
+
 }} // namespace tracktion { inline namespace engine
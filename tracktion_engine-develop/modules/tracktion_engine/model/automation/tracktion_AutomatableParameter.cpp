@@ -196,7 +196,9 @@ public:
 
         if (curve.getNumPoints() > 0)
         {
-            auto s = std::make_unique<AutomationIterator> (parameter);
+            // The stream is only replaced on this thread so it's safe to read from without the lock
+            auto s = parameterStream != nullptr ? std::make_unique<AutomationIterator> (parameter, *parameterStream)
+                                                : std::make_unique<AutomationIterator> (parameter);
 
             if (! s->isEmpty())
                 newStream = std::move (s);
@@ -234,10 +236,8 @@ public:
 
     void setPosition (TimePosition time) override
     {
-        if (! parameter.getEdit().getAutomationRecordManager().isReadingAutomation())
-            if (auto plugin = parameter.getPlugin())
-                if (! plugin->isClipEffectPlugin())
-                    return;
+        if (! shouldReadAutomation())
+            return;
 
         const juce::ScopedLock sl (parameterStreamLock);
 
@@ -245,6 +245,15 @@ public:
             parameterStream->setPosition (time);
     }
 
+    bool getValues (TimeRange editTime, float* dest, int numSamples)
+    {
+        if (! shouldReadAutomation())
+            return false;
+
+        const juce::ScopedLock sl (parameterStreamLock);
+        return parameterStream != nullptr && parameterStream->getValues (editTime, dest, numSamples);
+    }
+
     bool isEnabled() override
     {
         return true;
@@ -266,6 +275,16 @@ private:
     std::atomic<bool> automationActive { false };
     std::atomic<TimePosition> lastTime { TimePosition::fromSeconds (-1.0) };
 
+    bool shouldReadAutomation() const
+    {
+        if (! parameter.getEdit().getAutomationRecordManager().isReadingAutomation())
+            if (auto plugin = parameter.getPlugin())
+                if (! plugin->isClipEffectPlugin())
+                    return false;
+
+        return true;
+    }
+
     static juce::ValueTree getState (AutomatableParameter& ap)
     {
         auto v = ap.parentState.getChildWithProperty (IDs::paramID, ap.paramID);
@@ -849,6 +868,8 @@ void AutomatableParameter::updateFromAutomationSources (TimePosition time)
                                    return currentParameterValue.load();
                                }();
 
+    currentNormalisedModifierValue.store (newModifierValue, std::memory_order_relaxed);
+
     if (newModifierValue != 0.0f)
     {
         auto normalisedBase = valueRange.convertTo0to1 (newBaseValue);
@@ -862,6 +883,21 @@ void AutomatableParameter::updateFromAutomationSources (TimePosition time)
     setParameterValue (newBaseValue, true);
 }
 
+bool AutomatableParameter::getValuesForBlock (TimeRange editTime, float* dest, int numSamples)
+{
+    if (! curveSource->isActive())
+        return false;
+
+    if (! curveSource->getValues (editTime, dest, numSamples))
+        return false;
+
+    if (const auto modifierValue = currentNormalisedModifierValue.load (std::memory_order_relaxed); modifierValue != 0.0f)
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = valueRange.convertFrom0to1 (juce::jlimit (0.0f, 1.0f, valueRange.convertTo0to1 (dest[i]) + modifierValue));
+
+    return true;
+}
+
 //==============================================================================
 void AutomatableParameter::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i)
 {
@@ -1275,7 +1311,17 @@ AutomationIterator::AutomationIterator (const AutomatableParameter& p)
     if (hiRes)
         copy (p);
     else
-        interpolate (p);
+        interpolate (p, nullptr);
+}
+
+AutomationIterator::AutomationIterator (const AutomatableParameter& p, const AutomationIterator& previous)
+{
+    hiRes = ! p.automatableEditElement.edit.engine.getEngineBehaviour().interpolateAutomation();
+
+    if (hiRes)
+        copy (p);
+    else
+        interpolate (p, previous.hiRes ? nullptr : &previous);
 }
 
 void AutomationIterator::copy (const AutomatableParameter& param)
@@ -1297,18 +1343,94 @@ void AutomationIterator::copy (const AutomatableParameter& param)
     }
 }
 
-void AutomationIterator::interpolate (const AutomatableParameter& param)
+void AutomationIterator::interpolate (const AutomatableParameter& param, const AutomationIterator* previous)
 {
     const auto& curve = param.getCurve();
 
     jassert (curve.getNumPoints() > 0);
 
-    const auto timeDelta        = TimeDuration::fromSeconds (1.0 / 100.0);
+    for (int i = 0; i < curve.getNumPoints(); ++i)
+    {
+        auto src = curve.getPoint (i);
+        curvePoints.add ({ src.time, src.value, src.curve });
+    }
+
+    // The grid times are calculated from the step number rather than accumulated so that
+    // a partial re-interpolation lands on exactly the same times as a full one would
+    constexpr double timeDeltaSeconds = 1.0 / 100.0;
+    const auto timeDelta        = TimeDuration::fromSeconds (timeDeltaSeconds);
     const double minValueDelta  = (param.getValueRange().getLength()) / 256.0;
 
+    auto getStepTime = [] (int64_t step)    { return TimePosition::fromSeconds ((double) step * timeDeltaSeconds); };
+
+    auto getFirstStepAtOrAfter = [&] (TimePosition time)
+    {
+        auto step = std::max ((int64_t) 0, (int64_t) std::ceil (time.inSeconds() / timeDeltaSeconds));
+
+        while (getStepTime (step) < time)
+            ++step;
+
+        while (step > 0 && getStepTime (step - 1) >= time)
+            --step;
+
+        return step;
+    };
+
+    // If there's a previous iterator, only the steps between the unchanged points either side
+    // of the edited ones need to be interpolated again, the rest can be copied over
+    int64_t firstStep = 0;
+    std::optional<int64_t> lastStep;
+
+    if (previous != nullptr && ! previous->curvePoints.isEmpty())
+    {
+        auto& oldCurvePoints = previous->curvePoints;
+        const int numOld = oldCurvePoints.size();
+        const int numNew = curvePoints.size();
+        const int numCommon = std::min (numOld, numNew);
+
+        auto isSame = [] (const AutoPoint& p1, const AutoPoint& p2)
+        {
+            return p1.time == p2.time && p1.value == p2.value && p1.curve == p2.curve;
+        };
+
+        int numSameAtStart = 0;
+
+        while (numSameAtStart < numCommon && isSame (oldCurvePoints[numSameAtStart], curvePoints[numSameAtStart]))
+            ++numSameAtStart;
+
+        if (numSameAtStart == numOld && numSameAtStart == numNew)
+        {
+            points = previous->points;
+            return;
+        }
+
+        int numSameAtEnd = 0;
+
+        while (numSameAtEnd < numCommon - numSameAtStart
+               && isSame (oldCurvePoints[numOld - 1 - numSameAtEnd], curvePoints[numNew - 1 - numSameAtEnd]))
+            ++numSameAtEnd;
+
+        // Crossing any point but the last forces a point to be added, which resets the interpolation
+        // state, so start from the last unchanged point before the edit and stop at the first after it
+        if (const int startIndex = std::min (numSameAtStart - 1, numNew - 2); startIndex >= 0)
+            firstStep = getFirstStepAtOrAfter (curvePoints[startIndex].time);
+
+        if (numSameAtEnd >= 2)
+            lastStep = getFirstStepAtOrAfter (curvePoints[numNew - numSameAtEnd].time);
+
+        const auto firstStepTime = getStepTime (firstStep);
+
+        for (auto& p : previous->points)
+        {
+            if (p.time >= firstStepTime)
+                break;
+
+            points.add (p);
+        }
+    }
+
     int curveIndex = 0;
     int lastCurveIndex = -1;
-    TimePosition t;
     float lastValue = 1.0e10;
     auto lastTime = curve.getPointTime (curve.getNumPoints() - 1) + TimeDuration::fromSeconds (1.0);
     TimePosition t1;
@@ -1323,9 +1445,17 @@ void AutomationIterator::interpolate (const AutomatableParameter& param)
     float y1end = 0;
     float y2end = 0;
 
-    while (t < lastTime)
+    // When starting part way through, the step before is evaluated without adding a point to find the previous value
+    for (auto step = std::max ((int64_t) 0, firstStep - 1);; ++step)
     {
-        while (t >= t2)
+        const auto t = getStepTime (step);
+
+        if (t >= lastTime || (lastStep && step > *lastStep))
+            break;
+
+        // A step that lands exactly on a point still belongs to the segment before it,
+        // as it does in AutomationCurve::getValueAt
+        while (t > t2)
         {
             if (curveIndex >= curve.getNumPoints() - 1)
             {
@@ -1374,7 +1504,7 @@ void AutomationIterator::interpolate (const AutomatableParameter& param)
             }
         }
 
-        if (std::abs (v - lastValue) >= minValueDelta || curveIndex != lastCurveIndex)
+        if (step >= firstStep && (std::abs (v - lastValue) >= minValueDelta || curveIndex != lastCurveIndex))
         {
             jassert (t >= t1 && t <= t2);
 
@@ -1394,7 +1524,19 @@ void AutomationIterator::interpolate (const AutomatableParameter& param)
         }
 
         vp = v;
-        t = t + timeDelta;
+    }
+
+    // After the last step interpolated, the state matches the previous iterator so its remaining points can be used
+    if (lastStep)
+    {
+        jassert (previous != nullptr);
+        const auto lastStepTime = getStepTime (*lastStep);
+        auto& oldPoints = previous->points;
+
+        auto first = std::upper_bound (oldPoints.begin(), oldPoints.end(), lastStepTime,
+                                       [] (TimePosition time, const AutoPoint& p) { return time < p.time; });
+
+        points.addArray (first, (int) std::distance (first, oldPoints.end()));
     }
 }
 
@@ -1426,53 +1568,9 @@ void AutomationIterator::setPositionHiRes (TimePosition newTime) noexcept
         return;
     }
 
-    const auto& p1 = points.getReference (newIndex);
-    const auto& p2 = points.getReference (newIndex + 1);
-
-    const auto t = newTime;
-
-    const auto t1 = p1.time;
-    const auto t2 = p2.time;
-
-    const auto v1 = p1.value;
-    const auto v2 = p2.value;
-
-    const auto c = p1.curve;
-
-    float v = p2.value;
-
-    if (t2 != t1)
-    {
-        if (c == 0.0f)
-        {
-            v = v1 + (v2 - v1) * (float) ((t - t1) / (t2 - t1));
-        }
-        else if (c >= -0.5 && c <= 0.5)
-        {
-            auto bp = getBezierPoint (p1.time.inSeconds(), p1.value, p2.time.inSeconds(), p2.value, p1.curve);
-            v = float (getBezierYFromX (t.inSeconds(), t1.inSeconds(), v1, bp.first, bp.second, t2.inSeconds(), v2));
-        }
-        else
-        {
-            double x1end = 0, x2end = 0;
-            double y1end = 0, y2end = 0;
-
-            auto bp = getBezierPoint (p1.time.inSeconds(), p1.value, p2.time.inSeconds(), p2.value, p1.curve);
-            getBezierEnds (p1.time.inSeconds(), p1.value,
-                           p2.time.inSeconds(), p2.value,
-                           p1.curve,
-                           x1end, y1end, x2end, y2end);
-
-            if (t >= t1 && t <= TimePosition::fromSeconds (x1end))
-                v = v1;
-            else if (t >= TimePosition::fromSeconds (x2end) && t <= t2)
-                v = v2;
-            else
-                v = float (getBezierYFromX (t.inSeconds(), x1end, y1end, bp.first, bp.second, x2end, y2end));
-        }
-    }
+    const Segment segment (points.getReference (newIndex), points.getReference (newIndex + 1));
     currentIndex = newIndex;
-    currentValue = v;
+    currentValue = segment.getValueAt (newTime.inSeconds());
 }
 
 void AutomationIterator::setPositionInterpolated (TimePosition newTime) noexcept
@@ -1505,6 +1603,70 @@ void AutomationIterator::setPositionInterpolated (TimePosition newTime) noexcept
     }
 }
 
+bool AutomationIterator::getValues (TimeRange editTime, float* dest, int numSamples) const noexcept
+{
+    // When interpolating, the points are only a 10ms grid so evaluate the source curve
+    // directly to get the actual shape at each sample
+    const auto& curve = hiRes ? points : curvePoints;
+    jassert (curve.size() > 0);
+
+    if (numSamples <= 0 || editTime.isEmpty())
+        return false;
+
+    const auto numPoints = curve.size();
+    const double startTime = editTime.getStart().inSeconds();
+    const double sampleDuration = editTime.getLength().inSeconds() / numSamples;
+    const double lastSampleTime = startTime + sampleDuration * (numSamples - 1);
+
+    // Find the first point after the start of the block
+    auto pointIndex = (int) std::distance (curve.begin(),
+                                           std::upper_bound (curve.begin(), curve.end(), startTime,
+                                                             [] (double t, const AutoPoint& p) { return t < p.time.inSeconds(); }));
+
+    // Check for a constant value so the buffer only needs to be used when the curve changes
+    if (pointIndex == numPoints)
+        return false;
+
+    if (curve.getReference (pointIndex).time.inSeconds() > lastSampleTime
+        && (pointIndex == 0 || curve.getReference (pointIndex - 1).value == curve.getReference (pointIndex).value))
+        return false;
+
+    for (int sample = 0; sample < numSamples;)
+    {
+        const double time = startTime + sample * sampleDuration;
+
+        while (pointIndex < numPoints && curve.getReference (pointIndex).time.inSeconds() <= time)
+            ++pointIndex;
+
+        // The number of samples before the next point
+        auto getNumSamplesBefore = [&] (double pointTime)
+        {
+            return juce::jlimit (1, numSamples - sample, (int) std::ceil ((pointTime - time) / sampleDuration));
+        };
+
+        if (pointIndex == 0)
+        {
+            const auto numThisTime = getNumSamplesBefore (curve.getReference (0).time.inSeconds());
+            std::fill_n (dest + sample, numThisTime, curve.getReference (0).value);
+            sample += numThisTime;
+        }
+        else if (pointIndex == numPoints)
+        {
+            std::fill_n (dest + sample, numSamples - sample, curve.getLast().value);
+            break;
+        }
+        else
+        {
+            const Segment segment (curve.getReference (pointIndex - 1), curve.getReference (pointIndex));
+            const auto numThisTime = getNumSamplesBefore (segment.t2);
+            segment.getValues (time, sampleDuration, dest + sample, numThisTime);
+            sample += numThisTime;
+        }
+    }
+
+    return true;
+}
+
 int AutomationIterator::updateIndex (TimePosition newTime)
 {
     auto newIndex = currentIndex;
@@ -1527,6 +1689,122 @@ int AutomationIterator::updateIndex (TimePosition newTime)
     return newIndex;
 }
 
+AutomationIterator::Segment::Segment (const AutoPoint& p1, const AutoPoint& p2) noexcept
+    : t1 (p1.time.inSeconds()), t2 (p2.time.inSeconds()),
+      v1 (p1.value), v2 (p2.value), c (p1.curve)
+{
+    if (c != 0.0f)
+    {
+        // This matches AutomationCurve::getBezierPoint so the values follow the curve
+        bezierPoint = getBezierPoint (t1, v1, t2, v2, juce::jlimit (-1.0f, 1.0f, c * 2.0f));
+
+        if (c < -0.5 || c > 0.5)
+            getBezierEnds (t1, v1, t2, v2, c, x1end, y1end, x2end, y2end);
+    }
+}
+
+float AutomationIterator::Segment::getValueAt (double t) const noexcept
+{
+    if (t2 == t1)
+        return v2;
+
+    if (c == 0.0f)
+        return v1 + (v2 - v1) * (float) ((t - t1) / (t2 - t1));
+
+    if (c >= -0.5 && c <= 0.5)
+        return float (getBezierYFromX (t, t1, v1, bezierPoint.first, bezierPoint.second, t2, v2));
+
+    if (t >= t1 && t <= x1end)
+        return v1;
+
+    if (t >= x2end && t <= t2)
+        return v2;
+
+    return float (getBezierYFromX (t, x1end, y1end, bezierPoint.first, bezierPoint.second, x2end, y2end));
+}
+
+void AutomationIterator::Segment::getValues (double startTime, double sampleDuration, float* dest, int numSamples) const noexcept
+{
+    if (t2 == t1)
+    {
+        std::fill_n (dest, numSamples, v2);
+        return;
+    }
+
+    if (c == 0.0f)
+    {
+        // Linear segments are a simple ramp which the compiler can vectorise
+        const auto startValue = getValueAt (startTime);
+        const auto delta = (float) ((v2 - v1) * sampleDuration / (t2 - t1));
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] = startValue + delta * (float) i;
+
+        return;
+    }
+
+    // Steep curves are flat at each end with a bezier between them
+    const bool hasFlatEnds = c < -0.5f || c > 0.5f;
+    int start = 0, end = numSamples;
+
+    if (hasFlatEnds)
+    {
+        while (start < numSamples && startTime + start * sampleDuration <= x1end)
+            dest[start++] = v1;
+
+        while (end > start && startTime + (end - 1) * sampleDuration >= x2end)
+            dest[--end] = v2;
+    }
+
+    const auto x1 = hasFlatEnds ? x1end : t1;
+    const auto x2 = hasFlatEnds ? x2end : t2;
+    const auto y1 = hasFlatEnds ? y1end : (double) v1;
+    const auto y2 = hasFlatEnds ? y2end : (double) v2;
+
+    if (x1 == x2 || y1 == y2)
+    {
+        std::fill (dest + start, dest + end, (float) y1);
+        return;
+    }
+
+    // The bezier's t is found for each x by solving its quadratic. As the curve is monotonic
+    // in time, the same root is always the one in [0, 1] so it can be chosen once here,
+    // leaving a branchless loop which the compiler can vectorise
+    const auto [xb, yb] = bezierPoint;
+    const auto a = x1 - 2.0 * xb + x2;
+    const auto b = 2.0 * (xb - x1);
+    const auto yc1 = 2.0 * (yb - y1);
+    const auto yc2 = y1 - 2.0 * yb + y2;
+
+    auto getValue = [=] (double t) { return (float) (y1 + t * (yc1 + t * yc2)); };
+
+    if (a == 0.0)
+    {
+        for (int i = start; i < end; ++i)
+        {
+            const auto x = startTime + i * sampleDuration;
+            dest[i] = getValue (std::clamp ((x - x1) / b, 0.0, 1.0));
+        }
+
+        return;
+    }
+
+    const auto rootSign = [&]
+    {
+        const auto t = (-b + std::sqrt (std::max (0.0, b * b + 2.0 * a * (x2 - x1)))) / (2.0 * a);
+        return t >= 0.0 && t <= 1.0 ? 1.0 : -1.0;
+    }();
+
+    const auto bSquared = b * b, fourA = 4.0 * a, oneOverTwoA = 1.0 / (2.0 * a);
+
+    for (int i = start; i < end; ++i)
+    {
+        const auto x = startTime + i * sampleDuration;
+        const auto t = (-b + rootSign * std::sqrt (std::max (0.0, bSquared + fourA * (x - x1)))) * oneOverTwoA;
+        dest[i] = getValue (std::clamp (t, 0.0, 1.0));
+    }
+}
+
 //==============================================================================
 const char* AutomationDragDropTarget::automatableDragString = "automatableParamDrag";
 
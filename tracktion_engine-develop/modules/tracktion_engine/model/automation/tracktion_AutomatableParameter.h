@@ -169,6 +169,16 @@ public:
     /** Updates the parameter and modifier values from its current automation sources. */
     void updateFromAutomationSources (TimePosition);
 
+    /** Fills a buffer with the value of the parameter at each sample of a block for
+        sample-accurate automation.
+        This only fills the buffer if the automation curve changes during the block,
+        otherwise it returns false and getCurrentValue() can be used for the whole block.
+        Any modifiers are applied with the value they had at the last call to
+        updateFromAutomationSources so call that for the start of the block first.
+        [[ audio_thread ]]
+    */
+    bool getValuesForBlock (TimeRange editTime, float* dest, int numSamples);
+
     //==============================================================================
     virtual bool isParameterActive() const                          { return true; }
     virtual bool isDiscrete() const                                 { return false; }
@@ -240,6 +250,7 @@ protected:
     MacroParameterList* macroOwner = nullptr;
     std::unique_ptr<AutomationCurveSource> curveSource;
     std::atomic<float> currentValue { 0.0f }, currentParameterValue { 0.0f },  currentBaseValue { 0.0f }, currentModifierValue { 0.0f };
+    std::atomic<float> currentNormalisedModifierValue { 0.0f };
     std::atomic<bool> isRecording { false };
     bool updateParametersRecursionCheck = false;
     AsyncCaller parameterChangedCaller { [this] { listeners.call (&Listener::currentValueChanged, *this); } };
@@ -397,13 +408,28 @@ struct AutomationIterator
 {
     AutomationIterator (const AutomatableParameter&);
 
+    /** Creates an iterator for the parameter's current curve, re-using the interpolated points
+        from a previous iterator for the parts of the curve that haven't changed since it was created.
+        This makes rebuilding the iterator after an edit proportional to the length of the edited region.
+    */
+    AutomationIterator (const AutomatableParameter&, const AutomationIterator& previous);
+
     bool isEmpty() const noexcept               { return points.size() <= 1; }
 
     void setPosition (TimePosition) noexcept;
     float getCurrentValue() noexcept            { return currentValue; }
 
+    /** Fills a buffer with the value at each sample of a block, spread evenly over the time range.
+        If the value doesn't change during the block, this returns false without filling the
+        buffer so the value at the start of the block can be used instead.
+        The values are evaluated from the curve itself, even when the iterator is
+        interpolating, so bezier segments keep their shape within the block.
+        This doesn't change the current position.
+    */
+    bool getValues (TimeRange, float* dest, int numSamples) const noexcept;
+
 private:
-    void interpolate (const AutomatableParameter&);
+    void interpolate (const AutomatableParameter&, const AutomationIterator* previous);
     void copy (const AutomatableParameter&);
     int updateIndex (TimePosition newTime);
     
@@ -416,8 +442,23 @@ private:
         float value = 0.0f;
         float curve = 0.0f;
     };
+
+    // The shape between two points, with any bezier control points pre-calculated
+    struct Segment
+    {
+        Segment (const AutoPoint&, const AutoPoint&) noexcept;
+
+        float getValueAt (double time) const noexcept;
+        void getValues (double startTime, double sampleDuration, float* dest, int numSamples) const noexcept;
+
+        double t1, t2;
+        float v1, v2, c;
+        std::pair<double, double> bezierPoint;
+        double x1end = 0, y1end = 0, x2end = 0, y2end = 0;
+    };
     
     juce::Array<AutoPoint> points;
+    juce::Array<AutoPoint> curvePoints; // The source curve, used to find what's changed when interpolating
     int currentIndex = -1;
     float currentValue = 0.0f;
     bool hiRes = false;
@@ -106,7 +106,19 @@ public:
         setName (TRANS("Creating Proxy") + ": " + acb.getName());
 
         if (renderTimestretched)
+        {
             proxyInfo = acb.createProxyRenderingInfo();
+
+            // Rebuild the playback graph as segments finish so the clip can start playing them
+            proxyInfo->onSegmentsRendered = [clipRef = makeSafeRef (acb)]
+            {
+                juce::MessageManager::callAsync ([clipRef]
+                                                 {
+                                                     if (auto clip = clipRef.get())
+                                                         clip->edit.restartPlayback();
+                                                 });
+            };
+        }
     }
 
     ~ProxyGeneratorJob() override
@@ -1910,11 +1922,11 @@ struct StretchSegment
     static constexpr int maxNumChannels = 8;
 
     StretchSegment (Engine& engine, const AudioFile& file,
-                    const AudioClipBase::ProxyRenderingInfo& info,
-                    double sampleRate, const AudioSegmentList::Segment& s)
+                    TimeStretcher::Mode mode, TimeStretcher::ElastiqueProOptions options,
+                    int crossfadeLengthSamples, const AudioSegmentList::Segment& s)
         : segment (s),
           fileInfo (file.getInfo()),
-          crossfadeSamples ((int) tracktion::toSamples (info.audioSegmentList->getCrossfadeLength(), sampleRate)),
+          crossfadeSamples (crossfadeLengthSamples),
           numChannelsToUse (juce::jlimit (1, maxNumChannels, fileInfo.numChannels))
     {
         CRASH_TRACER
@@ -1935,7 +1947,7 @@ struct StretchSegment
             }
 
             timestretcher.initialise (fileInfo.sampleRate, outputBufferSize, numChannelsToUse,
-                                      info.mode, info.options, false);
+                                      mode, options, false);
             jassert (timestretcher.isInitialised()); // Have you enabled a TimeStretcher mode?
 
             timestretcher.setSpeedAndPitch ((float) (1.0 / segment.getStretchRatio()),
@@ -1943,30 +1955,23 @@ struct StretchSegment
         }
     }
 
+    bool isValid() const noexcept       { return reader != nullptr; }
+
     void renderNextBlock (juce::AudioBuffer<float>& buffer, TimeRange editTime, int numSamples)
     {
         if (reader == nullptr)
             return;
 
-        CRASH_TRACER
-
-        auto loopRange = segment.getRange();
+        auto samples = getSamplesInBlock (segment.getRange(), editTime, numSamples);
 
-        if (! editTime.overlaps (loopRange))
-            return;
-
-        int start = 0;
-
-        if (loopRange.getEnd() < editTime.getEnd())
-            numSamples = std::max (0, (int) (numSamples * (loopRange.getEnd() - editTime.getStart()).inSeconds()
-                                              / editTime.getLength().inSeconds()));
+        if (! samples.isEmpty())
+            readNextSamples (buffer, samples.getStart(), samples.getLength());
+    }
 
-        if (loopRange.getStart() > editTime.getStart())
-        {
-            auto skip = juce::jlimit (0, numSamples, (int) (numSamples * (loopRange.getStart() - editTime.getStart()).inSeconds() / editTime.getLength().inSeconds()));
-            start += skip;
-            numSamples -= skip;
-        }
+    /** Adds the next samples of the stretched segment to a buffer. */
+    void readNextSamples (juce::AudioBuffer<float>& buffer, int start, int numSamples)
+    {
+        CRASH_TRACER
 
         while (numSamples > 0)
         {
@@ -1993,6 +1998,28 @@ struct StretchSegment
         }
     }
 
+    /** Returns the samples in a block covering an edit time range that a segment's output should be added to. */
+    static juce::Range<int> getSamplesInBlock (TimeRange segmentRange, TimeRange editTime, int numSamples)
+    {
+        if (! editTime.overlaps (segmentRange))
+            return {};
+
+        int start = 0;
+
+        if (segmentRange.getEnd() < editTime.getEnd())
+            numSamples = std::max (0, (int) (numSamples * (segmentRange.getEnd() - editTime.getStart()).inSeconds()
+                                              / editTime.getLength().inSeconds()));
+
+        if (segmentRange.getStart() > editTime.getStart())
+        {
+            auto skip = juce::jlimit (0, numSamples, (int) (numSamples * (segmentRange.getStart() - editTime.getStart()).inSeconds() / editTime.getLength().inSeconds()));
+            start += skip;
+            numSamples -= skip;
+        }
+
+        return juce::Range<int>::withStartAndLength (start, std::max (0, numSamples));
+    }
+
     int fillNextBlock()
     {
         CRASH_TRACER
@@ -2089,7 +2116,7 @@ struct StretchSegment
         }
     }
 
-    const AudioSegmentList::Segment& segment;
+    const AudioSegmentList::Segment segment;
     TimeStretcher timestretcher;
 
     AudioFileInfo fileInfo;
@@ -2104,6 +2131,102 @@ struct StretchSegment
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StretchSegment)
 };
 
+//==============================================================================
+/** Plays back a segment that's been rendered to its own file by renderSegmentFile. */
+struct RenderedSegment
+{
+    RenderedSegment (Engine& engine, const AudioFile& segmentFile, const AudioSegmentList::Segment& s)
+        : segment (s),
+          reader (AudioFileUtils::createReaderFor (engine, segmentFile.getFile()))
+    {
+    }
+
+    bool isValid() const noexcept       { return reader != nullptr; }
+
+    void renderNextBlock (juce::AudioBuffer<float>& buffer, TimeRange editTime, int numSamples)
+    {
+        if (reader == nullptr)
+            return;
+
+        auto samples = StretchSegment::getSamplesInBlock (segment.getRange(), editTime, numSamples);
+
+        if (samples.isEmpty())
+            return;
+
+        CRASH_TRACER
+        AudioScratchBuffer scratch ((int) reader->numChannels, samples.getLength());
+        reader->read (&scratch.buffer, 0, samples.getLength(), readPosition, true, true);
+        readPosition += samples.getLength();
+
+        for (int i = 0; i < buffer.getNumChannels(); ++i)
+            buffer.addFrom (i, samples.getStart(), scratch.buffer,
+                            std::min (i, scratch.buffer.getNumChannels() - 1),
+                            0, samples.getLength());
+    }
+
+    const AudioSegmentList::Segment segment;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    SampleCount readPosition = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderedSegment)
+};
+
+static constexpr int proxySamplesPerBlock = 1024;
+
+/** Renders a single stretched segment to a file so it can be mixed in to any proxy that uses it. */
+static bool renderSegmentFile (Engine& engine, const AudioFile& sourceFile,
+                               TimeStretcher::Mode mode, TimeStretcher::ElastiqueProOptions options,
+                               int crossfadeSamples, const AudioSegmentList::Segment& segment,
+                               AudioProxyGenerator::SegmentRender& render)
+{
+    CRASH_TRACER
+    StretchSegment stretchSegment (engine, sourceFile, mode, options, crossfadeSamples, segment);
+
+    if (! stretchSegment.isValid())
+        return false;
+
+    // Render an extra block to allow for the rounding when the segment is placed in a proxy
+    const auto sampleRate = sourceFile.getSampleRate();
+    const auto numSamples = (SampleCount) std::ceil (segment.getRange().getLength().inSeconds() * sampleRate) + proxySamplesPerBlock;
+
+    AudioFile tempFile (engine, render.segmentFile.getFile()
+                                  .getSiblingFile ("temp_segment_" + juce::String::toHexString (juce::Random().nextInt64()))
+                                  .withFileExtension ("wav"));
+
+    bool ok = false;
+
+    {
+        // Segments are stored as floats so the mixed proxy matches one rendered in a single pass
+        AudioFileWriter writer (tempFile, engine.getAudioFileFormatManager().getWavFormat(),
+                                stretchSegment.numChannelsToUse, sampleRate, 32, {}, 0);
+        juce::AudioBuffer<float> buffer (stretchSegment.numChannelsToUse, proxySamplesPerBlock);
+        ok = writer.isOpen();
+
+        for (SampleCount numDone = 0; ok && numDone < numSamples;)
+        {
+            if (render.shouldExit())
+            {
+                ok = false;
+                break;
+            }
+
+            auto numThisTime = (int) std::min ((SampleCount) proxySamplesPerBlock, numSamples - numDone);
+            buffer.clear();
+            stretchSegment.readNextSamples (buffer, 0, numThisTime);
+
+            ok = writer.appendBuffer (buffer, numThisTime);
+            numDone += numThisTime;
+            render.progress = (float) (numDone / (double) numSamples);
+        }
+    }
+
+    if (ok)
+        ok = tempFile.getFile().moveFileTo (render.segmentFile.getFile());
+
+    tempFile.deleteFile();
+    return ok;
+}
+
 //==============================================================================
 std::unique_ptr<AudioClipBase::ProxyRenderingInfo> AudioClipBase::createProxyRenderingInfo()
 {
@@ -2116,6 +2239,9 @@ std::unique_ptr<AudioClipBase::ProxyRenderingInfo> AudioClipBase::createProxyRen
                  : TimeStretcher::defaultMode;
     p->options = elastiqueProOptions;
 
+    for (int i = 0; i < p->audioSegmentList->getSegments().size(); ++i)
+        p->segmentFiles.add (TemporaryFileManager::getFileForCachedSegmentRender (edit, getProxyHash (*p->audioSegmentList, i)));
+
     return p;
 }
 
@@ -2127,18 +2253,73 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
     if (audioSegmentList->getSegments().isEmpty() || ! sourceFile.isValid())
         return false;
 
+    auto& segmentList = audioSegmentList->getSegments();
+    auto sampleRate = sourceFile.getSampleRate();
+    auto crossfadeSamples = (int) tracktion::toSamples (audioSegmentList->getCrossfadeLength(), sampleRate);
+    const bool useSegmentFiles = segmentFiles.size() == segmentList.size();
+
     juce::OwnedArray<StretchSegment> segments;
+    juce::ReferenceCountedArray<AudioProxyGenerator::SegmentRender> segmentRenders;
+    std::vector<std::unique_ptr<RenderedSegment>> renderedSegments ((size_t) segmentList.size());
 
-    auto sampleRate = sourceFile.getSampleRate();
+    if (useSegmentFiles)
+    {
+        // These are queued in playback order so the earliest segments finish first and can be mixed
+        // while the later ones are still rendering
+        auto& generator = engine.getAudioFileManager().proxyGenerator;
 
-    for (auto& segment : audioSegmentList->getSegments())
-        segments.add (new StretchSegment (engine, sourceFile, *this, sampleRate, segment));
+        for (int i = 0; i < segmentList.size(); ++i)
+            segmentRenders.add (generator.renderSegment (segmentFiles.getReference (i),
+                                                         [&engine, sourceFile, m = mode, o = options, crossfadeSamples,
+                                                          segment = segmentList.getReference (i)] (auto& r)
+                                                         {
+                                                             return renderSegmentFile (engine, sourceFile, m, o, crossfadeSamples, segment, r);
+                                                         }));
+    }
+    else
+    {
+        for (auto& segment : segmentList)
+            segments.add (new StretchSegment (engine, sourceFile, mode, options, crossfadeSamples, segment));
+    }
 
-    const int samplesPerBlock = 1024;
-    juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), samplesPerBlock);
+    juce::AudioBuffer<float> buffer (sourceFile.getNumChannels(), proxySamplesPerBlock);
     double time = 0.0;
 
-    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / samplesPerBlock);
+    auto numBlocks = 1 + (int) (clipTime.getLength().inSeconds() * sampleRate / proxySamplesPerBlock);
+
+    int numSegmentsRendered = 0;
+
+    auto updateProgress = [&] (int blockIndex)
+    {
+        auto mixProgress = blockIndex / (float) numBlocks;
+
+        if (! useSegmentFiles)
+        {
+            progress = mixProgress;
+            return;
+        }
+
+        float segmentProgress = 0.0f;
+        int numRendered = 0;
+
+        for (auto r : segmentRenders)
+        {
+            segmentProgress += r->progress;
+
+            if (r->isFinished() && r->wasSuccessful())
+                ++numRendered;
+        }
+
+        progress = 0.9f * segmentProgress / (float) segmentRenders.size() + 0.1f * mixProgress;
+
+        if (numRendered > numSegmentsRendered)
+        {
+            numSegmentsRendered = numRendered;
+
+            if (onSegmentsRendered)
+                onSegmentsRendered();
+        }
+    };
 
     for (int i = 0; i < numBlocks; ++i)
     {
@@ -2147,17 +2328,63 @@ bool AudioClipBase::ProxyRenderingInfo::render (Engine& engine, const AudioFile&
 
         buffer.clear();
 
-        auto endTime = time + samplesPerBlock / sampleRate;
+        auto endTime = time + proxySamplesPerBlock / sampleRate;
         const auto editTime = TimeRange (TimePosition::fromSeconds (time), TimePosition::fromSeconds (endTime));
         time = endTime;
 
-        for (auto s : segments)
-            s->renderNextBlock (buffer, editTime, samplesPerBlock);
+        if (useSegmentFiles)
+        {
+            for (int j = 0; j < segmentList.size(); ++j)
+            {
+                auto& segment = segmentList.getReference (j);
+                auto& renderedSegment = renderedSegments[(size_t) j];
+
+                if (segment.getRange().getEnd() < editTime.getStart())
+                {
+                    renderedSegment.reset();
+                    continue;
+                }
+
+                if (! editTime.overlaps (segment.getRange()))
+                    continue;
 
-        if (! writer.appendBuffer (buffer, samplesPerBlock))
+                if (renderedSegment == nullptr)
+                {
+                    auto& segmentRender = *segmentRenders.getUnchecked (j);
+
+                    while (! segmentRender.waitUntilFinished (50))
+                    {
+                        if (job != nullptr && job->shouldExit())
+                            return false;
+
+                        updateProgress (i);
+                    }
+
+                    if (! segmentRender.wasSuccessful())
+                        return false;
+
+                    renderedSegment = std::make_unique<RenderedSegment> (engine, segmentRender.segmentFile, segment);
+
+                    if (! renderedSegment->isValid())
+                    {
+                        segmentRender.segmentFile.deleteFile();
+                        return false;
+                    }
+                }
+
+                renderedSegment->renderNextBlock (buffer, editTime, proxySamplesPerBlock);
+            }
+        }
+        else
+        {
+            for (auto s : segments)
+                s->renderNextBlock (buffer, editTime, proxySamplesPerBlock);
+        }
+
+        if (! writer.appendBuffer (buffer, proxySamplesPerBlock))
             return false;
 
-        progress = i / (float) numBlocks;
+        updateProgress (i);
     }
 
     return true;
@@ -2211,16 +2438,56 @@ HashCode AudioClipBase::getProxyHash()
 
     if (getAutoTempo() || getAutoPitch() || needsPlainStretch())
     {
-        auto& segmentList = getAudioSegmentList();
-        int i = 0;
+        auto seed = static_cast<size_t> (hash);
 
-        for (auto& segment : segmentList.getSegments())
-            hash ^= static_cast<HashCode> (segment.getHashCode() * (i++ + 0.1));
+        for (auto& segment : getAudioSegmentList().getSegments())
+        {
+            hash_combine (seed, segment.getHashCode());
+            hash_combine (seed, segment.getRange().getStart().inSeconds());
+        }
+
+        hash = static_cast<HashCode> (seed);
     }
 
     return hash;
 }
 
+HashCode AudioClipBase::getProxyHash (const AudioSegmentList& segmentList, int segmentIndex)
+{
+    auto& segment = segmentList.getSegments().getReference (segmentIndex);
+
+    size_t hash = 0;
+    hash_combine (hash, getHash());
+    hash_combine (hash, static_cast<int> (timeStretchMode.get()));
+    hash_combine (hash, elastiqueProOptions.get().toString().hashCode64());
+    hash_combine (hash, segment.getHashCode());
+    hash_combine (hash, segmentList.getCrossfadeLength().inSeconds());
+
+    return static_cast<HashCode> (hash);
+}
+
+std::vector<AudioClipBase::RenderedProxySegment> AudioClipBase::getRenderedProxySegments()
+{
+    std::vector<RenderedProxySegment> renderedSegments;
+
+    if (! usesTimeStretchedProxy())
+        return renderedSegments;
+
+    auto segmentList = AudioSegmentList::create (*this, true, true);
+
+    for (int i = 0; i < segmentList->getSegments().size(); ++i)
+    {
+        const auto hash = getProxyHash (*segmentList, i);
+        auto file = TemporaryFileManager::getFileForCachedSegmentRender (edit, hash);
+
+        // Segment files are only moved in to place once they're complete
+        if (file.getFile().existsAsFile())
+            renderedSegments.push_back ({ std::move (file), segmentList->getSegments().getReference (i).getRange(), hash });
+    }
+
+    return renderedSegments;
+}
+
 void AudioClipBase::beginRenderingNewProxyIfNeeded()
 {
     if (! canUseProxy())
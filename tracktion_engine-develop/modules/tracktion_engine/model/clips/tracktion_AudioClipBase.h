@@ -446,6 +446,18 @@ public:
         TimeStretcher::Mode mode;
         TimeStretcher::ElastiqueProOptions options;
 
+        /** If there's one of these for each segment, the segments will be rendered to these files
+            in parallel by the AudioProxyGenerator and any that already exist will be reused.
+            If not, the segments are rendered together on the calling thread.
+        */
+        juce::Array<AudioFile> segmentFiles;
+
+        /** If set, this is called from the rendering thread each time more of the segmentFiles
+            have finished rendering, so the clip can play them before the whole proxy is ready.
+            @see AudioClipBase::getRenderedProxySegments
+        */
+        std::function<void()> onSegmentsRendered;
+
         /** Renders this audio segment list to an AudioFile. */
         bool render (Engine&, const AudioFile&, AudioFileWriter&, juce::ThreadPoolJob* const&, std::atomic<float>& progress) const;
 
@@ -480,6 +492,27 @@ public:
     /** Returns a hash identifying the proxy settings. */
     HashCode getProxyHash();
 
+    /** Returns a hash identifying the proxy settings for a single segment of an AudioSegmentList.
+        This only depends on the segment itself and the clip's stretch settings so it stays
+        the same as long as the segment's source range, length, stretch and fades are unchanged,
+        even if the segment has moved.
+    */
+    HashCode getProxyHash (const AudioSegmentList&, int segmentIndex);
+
+    /** A segment of the time-stretched proxy that has been rendered to its own file. */
+    struct RenderedProxySegment
+    {
+        AudioFile file;         /**< The rendered segment, starting at the start of its range. */
+        TimeRange range;        /**< The segment's range, relative to the start of the proxy. */
+        HashCode hash = 0;      /**< The segment's hash. @see getProxyHash */
+    };
+
+    /** Returns the segments of the time-stretched proxy whose files have finished rendering.
+        While the proxy is still being generated, these can be played in its place as the
+        proxy is just these segments mixed together.
+    */
+    std::vector<RenderedProxySegment> getRenderedProxySegments();
+
     /** Triggers creation of a new proxy file if one is required. */
     void beginRenderingNewProxyIfNeeded();
 
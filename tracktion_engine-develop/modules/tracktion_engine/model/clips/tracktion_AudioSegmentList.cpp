@@ -42,11 +42,20 @@ bool AudioSegmentList::Segment::isFollowedBySilence() const                    {
 
 HashCode AudioSegmentList::Segment::getHashCode() const
 {
-    return startSample
-             ^ (lengthSample * 127)
-             ^ (followedBySilence ? 1234 : 5432)
-             ^ static_cast<HashCode> (stretchRatio * 1003.0f)
-             ^ static_cast<HashCode> (transpose * 117.0f);
+    // This doesn't include the start so a segment that's only moved, e.g. by an earlier
+    // tempo change, can reuse its proxy segment. The length is worked out from positions
+    // on the tempo sequence so it's rounded to stop it changing when the segment moves.
+    size_t hash = 0;
+    hash_combine (hash, (juce::int64) std::llround (length.inSeconds() * 1.0e6));
+    hash_combine (hash, startSample);
+    hash_combine (hash, lengthSample);
+    hash_combine (hash, stretchRatio);
+    hash_combine (hash, transpose);
+    hash_combine (hash, fadeIn);
+    hash_combine (hash, fadeOut);
+    hash_combine (hash, followedBySilence);
+
+    return static_cast<HashCode> (hash);
 }
 
 bool AudioSegmentList::Segment::operator== (const Segment& other) const
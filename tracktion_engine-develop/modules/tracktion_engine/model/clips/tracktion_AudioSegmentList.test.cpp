@@ -0,0 +1,179 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_CLIPS
+
+#include "../../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
+#include "../../utilities/tracktion_TestUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class AudioSegmentListTests  : public juce::UnitTest
+{
+public:
+    AudioSegmentListTests()
+        : juce::UnitTest ("AudioSegmentList", "tracktion_engine")
+    {}
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, 8.0);
+
+        // An auto-tempo clip over three tempo sections, each stretched differently
+        auto clip = insertWaveClip (*getAudioTracks (*edit)[0], {}, sinFile->getFile(), { { 0_tp, 8_tp } }, DeleteExistingClips::no);
+        clip->getLoopInfo().setBpm (120.0, clip->getWaveInfo());
+        clip->setAutoTempo (true);
+
+        // A curve of 1 keeps each section at a constant tempo rather than ramping to the next
+        edit->tempoSequence.insertTempo (4_bp, 100.0, 1.0f);
+        edit->tempoSequence.insertTempo (8_bp, 140.0, 1.0f);
+
+        runSegmentKeyTest (*edit, *clip);
+        runSegmentedProxyTest (engine, *clip);
+    }
+
+private:
+    // The source is 120 BPM so each beat is 22050 samples
+    static constexpr SampleCount secondSectionStart = 4 * 22050, thirdSectionStart = 8 * 22050;
+
+    static int findSegment (const AudioSegmentList& list, SampleCount startSample)
+    {
+        for (int i = 0; i < list.getSegments().size(); ++i)
+            if (list.getSegments().getReference (i).startSample == startSample)
+                return i;
+
+        return -1;
+    }
+
+    void runSegmentKeyTest (Edit& edit, WaveAudioClip& clip)
+    {
+        beginTest ("Proxy segment keys after a tempo change");
+
+        auto original = AudioSegmentList::create (clip, true, true);
+        const auto firstIndex = findSegment (*original, 0);
+        const auto secondIndex = findSegment (*original, secondSectionStart);
+        expect (firstIndex >= 0 && secondIndex >= 0 && findSegment (*original, thirdSectionStart) >= 0);
+
+        if (firstIndex < 0 || secondIndex < 0)
+            return;
+
+        // Changing the last section shouldn't change the keys of the segments before it
+        edit.tempoSequence.getTempos()[2]->setBpm (150.0);
+        auto afterLastChange = AudioSegmentList::create (clip, true, true);
+
+        for (int i = 0; i < original->getSegments().size(); ++i)
+        {
+            const auto startSample = original->getSegments().getReference (i).startSample;
+
+            if (startSample >= thirdSectionStart)
+                continue;
+
+            const auto index = findSegment (*afterLastChange, startSample);
+            expect (index >= 0);
+
+            if (index >= 0)
+                expectEquals (clip.getProxyHash (*afterLastChange, index), clip.getProxyHash (*original, i));
+        }
+
+        // Changing the first section moves the later segments but shouldn't change their keys
+        edit.tempoSequence.getTempos()[0]->setBpm (90.0);
+        auto afterFirstChange = AudioSegmentList::create (clip, true, true);
+        const auto movedIndex = findSegment (*afterFirstChange, secondSectionStart);
+        expect (movedIndex >= 0);
+
+        if (movedIndex < 0)
+            return;
+
+        expect (afterFirstChange->getSegments().getReference (movedIndex).getRange().getStart()
+                 != afterLastChange->getSegments().getReference (secondIndex).getRange().getStart());
+        expectEquals (clip.getProxyHash (*afterFirstChange, movedIndex), clip.getProxyHash (*afterLastChange, secondIndex));
+        expect (clip.getProxyHash (*afterFirstChange, findSegment (*afterFirstChange, 0))
+                 != clip.getProxyHash (*afterLastChange, firstIndex));
+    }
+
+    void runSegmentedProxyTest (Engine& engine, WaveAudioClip& clip)
+    {
+        beginTest ("Segmented proxy matches a single pass render");
+
+        auto renderProxy = [&] (bool useSegmentFiles) -> std::optional<juce::AudioBuffer<float>>
+        {
+            auto info = clip.createProxyRenderingInfo();
+
+            if (! useSegmentFiles)
+                info->segmentFiles.clear();
+
+            juce::TemporaryFile proxyFile (".wav");
+            const auto source = clip.getAudioFile();
+            std::atomic<float> progress { 0.0f };
+            juce::ThreadPoolJob* job = nullptr;
+
+            {
+                AudioFileWriter writer (AudioFile (engine, proxyFile.getFile()),
+                                        engine.getAudioFileFormatManager().getWavFormat(),
+                                        source.getNumChannels(), source.getSampleRate(), 32, {}, 0);
+
+                if (! (writer.isOpen() && info->render (engine, source, writer, job, progress)))
+                    return {};
+            }
+
+            return test_utilities::loadFileInToBuffer (engine, proxyFile.getFile());
+        };
+
+        auto segmented = renderProxy (true);
+        auto singlePass = renderProxy (false);
+        expect (segmented.has_value() && singlePass.has_value());
+
+        if (! (segmented && singlePass))
+            return;
+
+        expectEquals (segmented->getNumChannels(), singlePass->getNumChannels());
+        expectEquals (segmented->getNumSamples(), singlePass->getNumSamples());
+
+        const auto numChannels = std::min (segmented->getNumChannels(), singlePass->getNumChannels());
+        const auto numSamples = std::min (segmented->getNumSamples(), singlePass->getNumSamples());
+        int numDifferentSamples = 0;
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                if (segmented->getSample (c, i) != singlePass->getSample (c, i))
+                    ++numDifferentSamples;
+
+        expectEquals (numDifferentSamples, 0);
+
+        beginTest ("Rendered proxy segments");
+
+        // The segment files are kept so they can be played before the proxy has been mixed
+        auto segmentList = AudioSegmentList::create (clip, true, true);
+        auto renderedSegments = clip.getRenderedProxySegments();
+        expectEquals ((int) renderedSegments.size(), segmentList->getSegments().size());
+
+        for (size_t i = 0; i < std::min (renderedSegments.size(), (size_t) segmentList->getSegments().size()); ++i)
+        {
+            expect (renderedSegments[i].range == segmentList->getSegments().getReference ((int) i).getRange());
+            expect (renderedSegments[i].file.getSampleRate() > 0.0);
+        }
+
+        for (auto& segment : renderedSegments)
+            segment.file.deleteFile();
+
+        expect (clip.getRenderedProxySegments().empty());
+    }
+};
+
+static AudioSegmentListTests audioSegmentListTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
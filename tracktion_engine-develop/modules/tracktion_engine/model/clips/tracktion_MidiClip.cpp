@@ -777,6 +777,8 @@ LiveClipLevel MidiClip::getLiveClipLevel()
 
 void MidiClip::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& id)
 {
+    playbackSequenceCache.invalidate();
+
     if (tree == state)
     {
         if (id == IDs::mute)
@@ -835,6 +837,8 @@ void MidiClip::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Iden
 
 void MidiClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 {
+    playbackSequenceCache.invalidate();
+
     if (p.hasType (IDs::SEQUENCE))
         clearCachedLoopSequence();
     else if ((p == state || p.getParent() == state) && c.hasType (IDs::SEQUENCE))
@@ -846,6 +850,8 @@ void MidiClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 
 void MidiClip::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, int)
 {
+    playbackSequenceCache.invalidate();
+
     if (p.hasType (IDs::SEQUENCE))
     {
         clearCachedLoopSequence();
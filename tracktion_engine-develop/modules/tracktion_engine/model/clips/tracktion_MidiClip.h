@@ -159,6 +159,9 @@ public:
     PatternGenerator* getPatternGenerator() override;
     void pitchTempoTrackChanged() override;
 
+    /** @internal */
+    PlaybackMidiSequenceCache& getPlaybackSequenceCache() noexcept  { return playbackSequenceCache; }
+
     //==============================================================================
     /** Temporarily limits the notes to use. */
     struct ScopedEventsList
@@ -200,6 +203,7 @@ private:
     SelectedMidiEvents* selectedEvents = nullptr;
 
     mutable std::unique_ptr<MidiList> cachedLoopedSequence;
+    PlaybackMidiSequenceCache playbackSequenceCache;
     MidiCompManager::Ptr midiCompManager;
 
     //==============================================================================
@@ -160,6 +160,7 @@ void StepClip::updatePatternList()
 
 void StepClip::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& i)
 {
+    playbackSequenceCache.invalidate();
     Clip::valueTreePropertyChanged (v, i);
 
     if (i == IDs::sequence || i == IDs::repeatSequence)
@@ -183,6 +184,7 @@ void StepClip::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identif
 
 void StepClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 {
+    playbackSequenceCache.invalidate();
     Clip::valueTreeChildAdded (p, c);
 
     if (p.hasType (IDs::PATTERN))
@@ -191,6 +193,7 @@ void StepClip::valueTreeChildAdded (juce::ValueTree& p, juce::ValueTree& c)
 
 void StepClip::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, int oldIndex)
 {
+    playbackSequenceCache.invalidate();
     Clip::valueTreeChildRemoved (p, c, oldIndex);
 
     if (p.hasType (IDs::PATTERN))
@@ -199,6 +202,7 @@ void StepClip::valueTreeChildRemoved (juce::ValueTree& p, juce::ValueTree& c, in
 
 void StepClip::valueTreeChildOrderChanged (juce::ValueTree& p, int o, int n)
 {
+    playbackSequenceCache.invalidate();
     Clip::valueTreeChildOrderChanged (p, o, n);
 
     changed();
@@ -324,6 +328,10 @@ void StepClip::generateMidiSequenceForChannels (juce::MidiMessageSequence& resul
     juce::OwnedArray<Pattern::CachedPattern> caches;
     caches.ensureStorageAllocated (numChannels);
 
+    // N.B. This can be called from multiple threads when building the playback graph
+    // so don't use the system Random
+    juce::Random random;
+
     for (int f = 0; f < numChannels; ++f)
         caches.add (new Pattern::CachedPattern (pattern, f));
 
@@ -350,7 +358,7 @@ void StepClip::generateMidiSequenceForChannels (juce::MidiMessageSequence& resul
                 {
                     auto prob = cache->getProbability (i);
 
-                    if (juce::Random::getSystemRandom().nextFloat() >= prob)
+                    if (random.nextFloat() >= prob)
                         continue;
 
                     auto gate = cache->getGate (i);
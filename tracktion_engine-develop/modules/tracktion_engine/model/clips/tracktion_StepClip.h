@@ -296,6 +296,8 @@ public:
     LaunchQuantisation* getLaunchQuantisation() override;
     /** @internal */
     FollowActions* getFollowActions() override;
+    /** @internal */
+    PlaybackMidiSequenceCache& getPlaybackSequenceCache() noexcept  { return playbackSequenceCache; }
 
 private:
     void generateMidiSequenceForChannels (juce::MidiMessageSequence&, bool convertToSeconds,
@@ -313,6 +315,7 @@ private:
     juce::CachedValue<bool> useClipLaunchQuantisation;
     std::unique_ptr<LaunchQuantisation> launchQuantisation;
     std::unique_ptr<FollowActions> followActions;
+    PlaybackMidiSequenceCache playbackSequenceCache;
 
     const PatternInstance::Ptr getPatternInstance (int index, bool repeatSequence) const;
     void updatePatternList();
@@ -0,0 +1,428 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+static const char* chunkedEditMagicNumber = "TEC1";
+
+// The file is laid out as:
+//  - the magic number and version
+//  - the root chunk, then the other chunks in document order, deferred ones last
+//  - the index of chunks
+//  - the offset of the index as an int64
+//
+// The paths of the chunks that aren't deferred refer to the tree without any of the
+// deferred chunks in it. The paths of the deferred chunks refer to the full tree.
+// This means each chunk's parent will exist when the chunks are added in order.
+
+//==============================================================================
+namespace chunked_edit_file
+{
+    using ChunkType = ChunkedEditFile::ChunkType;
+
+    static std::optional<ChunkType> getChunkType (const juce::ValueTree& v)
+    {
+        if (TrackList::isTrack (v))             return ChunkType::track;
+        if (v.hasType (IDs::SEQUENCE))          return ChunkType::midiSequence;
+        if (v.hasType (IDs::AUTOMATIONCURVE))   return ChunkType::automationCurve;
+        if (v.hasType (IDs::TAKES))             return ChunkType::clipTakes;
+
+        return {};
+    }
+
+    static bool isDeferred (const juce::ValueTree& v, ChunkType type)
+    {
+        // MIDI clips keep their sequences in their takes and audio clips playing a comp
+        // need their takes when they're initialised to use the comp file
+        if (type == ChunkType::clipTakes)
+        {
+            auto clip = v.getParent();
+
+            if (! clip.hasType (IDs::AUDIOCLIP))
+                return false;
+
+            for (const auto& take : v)
+                if (take[IDs::source] == clip[IDs::source] && take[IDs::isComp])
+                    return false;
+
+            return true;
+        }
+
+        return type == ChunkType::track && ! v.getProperty (IDs::process, true);
+    }
+
+    struct PendingChunk
+    {
+        ChunkedEditFile::Chunk chunk;
+        juce::ValueTree state;
+    };
+
+    static void findChunks (const juce::ValueTree& parent, bool findDeferred,
+                            std::vector<int>& path, std::vector<juce::String>& pathIDs,
+                            std::vector<PendingChunk>& found)
+    {
+        for (int i = 0; i < parent.getNumChildren(); ++i)
+        {
+            auto v = parent.getChild (i);
+
+            if (auto type = getChunkType (v); type && isDeferred (v, *type) == findDeferred)
+            {
+                ChunkedEditFile::Chunk chunk;
+                chunk.type = *type;
+                chunk.deferred = findDeferred;
+                chunk.itemID = v[IDs::id].toString();
+                chunk.path = path;
+                chunk.pathIDs = pathIDs;
+                chunk.index = i;
+
+                found.push_back ({ std::move (chunk), v });
+
+                // Deferred chunks are stored whole
+                if (findDeferred)
+                    continue;
+            }
+
+            path.push_back (i);
+            pathIDs.push_back (v[IDs::id].toString());
+            findChunks (v, findDeferred, path, pathIDs, found);
+            path.pop_back();
+            pathIDs.pop_back();
+        }
+    }
+
+    static std::vector<PendingChunk> extractChunks (const juce::ValueTree& root, bool findDeferred)
+    {
+        std::vector<PendingChunk> found;
+        std::vector<int> path;
+        std::vector<juce::String> pathIDs;
+        findChunks (root, findDeferred, path, pathIDs, found);
+
+        for (auto& c : found)
+            c.state.getParent().removeChild (c.state, nullptr);
+
+        return found;
+    }
+
+    static void writeChunk (juce::OutputStream& out, juce::int64 start, PendingChunk& c)
+    {
+        c.chunk.offset = out.getPosition() - start;
+        c.state.writeToStream (out);
+        c.chunk.numBytes = out.getPosition() - start - c.chunk.offset;
+    }
+
+    static EditItemID findHighestItemID (const juce::ValueTree& v)
+    {
+        const auto ids = EditItemID::findAllIDs (v);
+        const auto highest = std::max_element (ids.begin(), ids.end());
+
+        return highest != ids.end() ? *highest : EditItemID();
+    }
+
+    static void writeIndexEntry (juce::OutputStream& out, const ChunkedEditFile::Chunk& c)
+    {
+        jassert (c.path.size() == c.pathIDs.size());
+
+        out.writeByte ((char) c.type);
+        out.writeBool (c.deferred);
+        out.writeString (c.itemID);
+        out.writeCompressedInt ((int) c.path.size());
+
+        for (size_t i = 0; i < c.path.size(); ++i)
+        {
+            out.writeCompressedInt (c.path[i]);
+            out.writeString (c.pathIDs[i]);
+        }
+
+        out.writeCompressedInt (c.index);
+        out.writeInt64 (c.offset);
+        out.writeInt64 (c.numBytes);
+        out.writeInt64 ((juce::int64) c.highestItemID.getRawID());
+    }
+
+    static bool readIndexEntry (juce::InputStream& in, ChunkedEditFile::Chunk& c)
+    {
+        c.type = (ChunkType) in.readByte();
+        c.deferred = in.readBool();
+        c.itemID = in.readString();
+
+        auto pathSize = in.readCompressedInt();
+
+        if (pathSize < 0 || pathSize > in.getNumBytesRemaining())
+            return false;
+
+        for (int i = 0; i < pathSize; ++i)
+        {
+            c.path.push_back (in.readCompressedInt());
+            c.pathIDs.push_back (in.readString());
+        }
+
+        c.index = in.readCompressedInt();
+        c.offset = in.readInt64();
+        c.numBytes = in.readInt64();
+        c.highestItemID = EditItemID::fromRawID ((uint64_t) in.readInt64());
+
+        return c.type >= ChunkType::root && c.type <= ChunkType::clipTakes
+                && ! in.isExhausted();
+    }
+
+    static juce::ValueTree findChild (const juce::ValueTree& parent, int index, const juce::String& itemID)
+    {
+        auto v = parent.getChild (index);
+
+        // The tree may have changed since it was read so if the ID doesn't match, look for it
+        if (itemID.isNotEmpty() && v[IDs::id].toString() != itemID)
+            for (const auto& child : parent)
+                if (child[IDs::id].toString() == itemID)
+                    return child;
+
+        return v;
+    }
+}
+
+//==============================================================================
+bool ChunkedEditFile::isChunkedEditFile (const juce::File& f)
+{
+    if (juce::FileInputStream in (f); in.openedOk())
+    {
+        char magic[4] = {};
+        return in.read (magic, 4) == 4 && memcmp (magic, chunkedEditMagicNumber, 4) == 0;
+    }
+
+    return false;
+}
+
+bool ChunkedEditFile::write (const juce::ValueTree& editState, juce::OutputStream& out)
+{
+    CRASH_TRACER
+    using namespace chunked_edit_file;
+
+    if (! editState.isValid())
+        return false;
+
+    auto root = editState.createCopy();
+    auto deferredChunks = extractChunks (root, true);
+    auto chunksToLoad = extractChunks (root, false);
+
+    const auto start = out.getPosition();
+    out.write (chunkedEditMagicNumber, 4);
+    out.writeInt (currentVersion);
+
+    PendingChunk rootChunk { {}, root };
+    writeChunk (out, start, rootChunk);
+
+    for (auto& c : chunksToLoad)
+        writeChunk (out, start, c);
+
+    for (auto& c : deferredChunks)
+    {
+        c.chunk.highestItemID = findHighestItemID (c.state);
+        writeChunk (out, start, c);
+    }
+
+    const auto indexOffset = out.getPosition() - start;
+    out.writeCompressedInt ((int) (1 + chunksToLoad.size() + deferredChunks.size()));
+    writeIndexEntry (out, rootChunk.chunk);
+
+    for (auto& c : chunksToLoad)
+        writeIndexEntry (out, c.chunk);
+
+    for (auto& c : deferredChunks)
+        writeIndexEntry (out, c.chunk);
+
+    out.writeInt64 (indexOffset);
+    return true;
+}
+
+bool ChunkedEditFile::write (const juce::ValueTree& editState, const juce::File& f)
+{
+    // Like XmlElement::writeTo, this writes to a temporary file first so the existing
+    // file isn't lost if the write fails part way through
+    juce::TemporaryFile tempFile (f);
+
+    {
+        juce::FileOutputStream out (tempFile.getFile());
+
+        if (! out.openedOk())
+            return false;
+
+        if (! write (editState, out))
+            return false;
+
+        out.flush(); // (called explicitly to force an fsync on posix)
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return tempFile.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+ChunkedEditFile::ChunkedEditFile (const juce::File& f)
+{
+    if (f.getSize() > 0)
+    {
+        mappedFile = std::make_unique<juce::MemoryMappedFile> (f, juce::MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr || ! readIndex())
+        {
+            mappedFile.reset();
+            chunks.clear();
+        }
+    }
+}
+
+ChunkedEditFile::~ChunkedEditFile()
+{
+}
+
+bool ChunkedEditFile::readIndex()
+{
+    const auto size = (juce::int64) mappedFile->getSize();
+    juce::MemoryInputStream in (mappedFile->getData(), mappedFile->getSize(), false);
+
+    if (size < 16)
+        return false;
+
+    char magic[4] = {};
+    in.read (magic, 4);
+    version = in.readInt();
+
+    if (memcmp (magic, chunkedEditMagicNumber, 4) != 0 || version < 1 || version > currentVersion)
+        return false;
+
+    in.setPosition (size - 8);
+    const auto indexOffset = in.readInt64();
+
+    if (indexOffset < 8 || indexOffset >= size - 8)
+        return false;
+
+    in.setPosition (indexOffset);
+    const auto num = in.readCompressedInt();
+
+    if (num <= 0 || num > (size - indexOffset))
+        return false;
+
+    chunks.resize ((size_t) num);
+
+    for (auto& c : chunks)
+        if (! chunked_edit_file::readIndexEntry (in, c)
+             || c.offset < 8 || c.numBytes <= 0 || c.offset + c.numBytes > indexOffset)
+            return false;
+
+    return chunks.front().type == ChunkType::root;
+}
+
+bool ChunkedEditFile::hasDeferredChunks() const
+{
+    return std::any_of (chunks.begin(), chunks.end(), [] (auto& c) { return c.deferred; });
+}
+
+std::vector<EditItemID> ChunkedEditFile::getDeferredItemIDs() const
+{
+    std::vector<EditItemID> ids;
+
+    for (auto& c : chunks)
+        if (c.deferred && c.highestItemID.isValid())
+            ids.push_back (c.highestItemID);
+
+    return ids;
+}
+
+juce::ValueTree ChunkedEditFile::readChunk (size_t chunkIndex) const
+{
+    if (! isValid() || chunkIndex >= chunks.size())
+        return {};
+
+    auto& c = chunks[chunkIndex];
+    return juce::ValueTree::readFromData (juce::addBytesToPointer (mappedFile->getData(), c.offset),
+                                          (size_t) c.numBytes);
+}
+
+juce::ValueTree ChunkedEditFile::findParent (juce::ValueTree root, const Chunk& c)
+{
+    for (size_t i = 0; i < c.path.size() && root.isValid(); ++i)
+        root = chunked_edit_file::findChild (root, c.path[i], c.pathIDs[i]);
+
+    return root;
+}
+
+juce::ValueTree ChunkedEditFile::readState (bool includeDeferredChunks) const
+{
+    CRASH_TRACER
+    auto root = readChunk (0);
+
+    if (! root.isValid())
+        return {};
+
+    for (size_t i = 1; i < chunks.size(); ++i)
+    {
+        auto& c = chunks[i];
+
+        if (c.deferred)
+            continue;
+
+        auto parent = findParent (root, c);
+        jassert (parent.isValid());
+
+        if (parent.isValid())
+            parent.addChild (readChunk (i), std::min (c.index, parent.getNumChildren()), nullptr);
+    }
+
+    if (includeDeferredChunks)
+        addDeferredChunks (root, nullptr);
+
+    return root;
+}
+
+void ChunkedEditFile::addDeferredChunks (juce::ValueTree& state, juce::UndoManager* um) const
+{
+    CRASH_TRACER
+
+    for (size_t i = 1; i < chunks.size(); ++i)
+    {
+        auto& c = chunks[i];
+
+        if (! c.deferred)
+            continue;
+
+        auto parent = findParent (state, c);
+        jassert (parent.isValid());
+
+        if (! parent.isValid())
+            continue;
+
+        auto v = readChunk (i);
+
+        // Clips create an empty takes list if there isn't one, so merge with that instead of adding another
+        if (c.type == ChunkType::clipTakes)
+        {
+            if (auto existing = parent.getChildWithName (v.getType()); existing.isValid())
+            {
+                if (existing.getNumProperties() == 0)
+                    existing.copyPropertiesFrom (v, um);
+
+                while (v.getNumChildren() > 0)
+                {
+                    auto child = v.getChild (0);
+                    v.removeChild (0, nullptr);
+                    existing.appendChild (child, um);
+                }
+
+                continue;
+            }
+        }
+
+        parent.addChild (v, std::min (c.index, parent.getNumChildren()), um);
+    }
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,114 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    A binary Edit file made up of separately addressable chunks.
+
+    The Edit's state is split into a root chunk plus a chunk for each track, MIDI
+    sequence and automation curve. An index at the end of the file says where each
+    chunk is stored and where it goes in the tree, so any chunk can be read on its own.
+
+    Sections that aren't needed to start playback, i.e. disabled tracks and the takes
+    of audio clips that aren't playing a comp, are stored as deferred chunks. These can be
+    left out when the state is read and added to it later with addDeferredChunks.
+
+    @see EditFileOperations, EngineBehaviour::saveEditsAsChunkedBinary
+*/
+class ChunkedEditFile
+{
+public:
+    //==============================================================================
+    /** The types of chunk. */
+    enum class ChunkType
+    {
+        root,               /**< The Edit state without any of the other chunks. */
+        track,              /**< A track, without any of its nested chunks. */
+        midiSequence,       /**< A MIDI clip's sequence. */
+        automationCurve,    /**< A parameter's automation curve. */
+        clipTakes           /**< The takes of a clip. */
+    };
+
+    /** Describes a chunk in the file's index. */
+    struct Chunk
+    {
+        ChunkType type = ChunkType::root;
+        bool deferred = false;          /**< True if the chunk isn't needed for playback. */
+        juce::String itemID;            /**< The IDs::id property of the chunk, if it has one. */
+        std::vector<int> path;          /**< The child indexes from the root to the chunk's parent. */
+        std::vector<juce::String> pathIDs;  /**< The IDs::id properties of the nodes in the path. */
+        int index = 0;                  /**< The index of the chunk in its parent. */
+        juce::int64 offset = 0, numBytes = 0;
+        EditItemID highestItemID;       /**< The highest EditItemID used in a deferred chunk. */
+    };
+
+    /** The version written by this class. */
+    static constexpr int currentVersion = 1;
+
+    //==============================================================================
+    /** Returns true if the file starts with a ChunkedEditFile header. */
+    static bool isChunkedEditFile (const juce::File&);
+
+    /** Writes an Edit's state to a stream. */
+    static bool write (const juce::ValueTree& editState, juce::OutputStream&);
+
+    /** Writes an Edit's state to a file, replacing any existing contents. */
+    static bool write (const juce::ValueTree& editState, const juce::File&);
+
+    //==============================================================================
+    /** Opens a file and reads its index. */
+    ChunkedEditFile (const juce::File&);
+
+    /** Destructor. */
+    ~ChunkedEditFile();
+
+    /** Returns true if the file was opened and its index read successfully. */
+    bool isValid() const noexcept                       { return mappedFile != nullptr; }
+
+    /** Returns the version of the format the file was written with. */
+    int getVersion() const noexcept                     { return version; }
+
+    /** Returns the index of chunks. */
+    const std::vector<Chunk>& getChunks() const noexcept    { return chunks; }
+
+    /** Returns true if any of the chunks are deferred. */
+    bool hasDeferredChunks() const;
+
+    /** Returns the highest EditItemID used in each of the deferred chunks.
+        Pass these to the Edit so it doesn't create new items with these IDs before the
+        deferred chunks are added. @see Edit::Options::deferredItemIDs
+    */
+    std::vector<EditItemID> getDeferredItemIDs() const;
+
+    /** Reads a single chunk. N.B. this won't contain any of the chunks nested in it. */
+    juce::ValueTree readChunk (size_t chunkIndex) const;
+
+    /** Reads the whole Edit state, optionally leaving out the deferred chunks. */
+    juce::ValueTree readState (bool includeDeferredChunks) const;
+
+    /** Adds the deferred chunks to a state read with readState (false). */
+    void addDeferredChunks (juce::ValueTree& state, juce::UndoManager*) const;
+
+private:
+    //==============================================================================
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    std::vector<Chunk> chunks;
+    int version = 0;
+
+    bool readIndex();
+    static juce::ValueTree findParent (juce::ValueTree root, const Chunk&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ChunkedEditFile)
+};
+
+}} // namespace tracktion { inline namespace engine
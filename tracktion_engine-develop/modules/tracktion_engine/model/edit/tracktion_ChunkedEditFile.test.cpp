@@ -0,0 +1,226 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_CHUNKED_EDIT_FILE
+
+#include "../../utilities/tracktion_TestUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ChunkedEditFileTests  : public juce::UnitTest
+{
+public:
+    ChunkedEditFileTests()
+        : juce::UnitTest ("ChunkedEditFile", "tracktion_engine")
+    {}
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 3);
+        auto tracks = getAudioTracks (*edit);
+
+        auto mc = tracks[0]->insertMIDIClip ({ 0_tp, 4_tp }, nullptr);
+
+        for (int i = 0; i < 8; ++i)
+            mc->getSequence().addNote (60 + i, BeatPosition::fromBeats (i), 0.5_bd, 100, 0, nullptr);
+
+        tracks[1]->getVolumePlugin()->volParam->getCurve().addPoint (1_tp, 0.5f, 0.0f);
+        tracks[2]->setProcessing (false);
+        edit->flushState();
+
+        beginTest ("Index");
+        juce::TemporaryFile tempFile (editFileSuffix);
+        expect (ChunkedEditFile::write (edit->state, tempFile.getFile()));
+        expect (ChunkedEditFile::isChunkedEditFile (tempFile.getFile()));
+
+        {
+            ChunkedEditFile file (tempFile.getFile());
+            expect (file.isValid());
+            expectEquals (file.getVersion(), ChunkedEditFile::currentVersion);
+            expect (file.hasDeferredChunks());
+
+            auto countChunks = [&file] (ChunkedEditFile::ChunkType type, bool deferred)
+            {
+                return (int) std::count_if (file.getChunks().begin(), file.getChunks().end(),
+                                            [&] (auto& c) { return c.type == type && c.deferred == deferred; });
+            };
+
+            expectEquals (countChunks (ChunkedEditFile::ChunkType::root, false), 1);
+            expectEquals (countChunks (ChunkedEditFile::ChunkType::midiSequence, false), 1);
+            expectGreaterOrEqual (countChunks (ChunkedEditFile::ChunkType::automationCurve, false), 1);
+            expectEquals (countChunks (ChunkedEditFile::ChunkType::track, true), 1);
+
+            for (size_t i = 0; i < file.getChunks().size(); ++i)
+            {
+                if (file.getChunks()[i].type == ChunkedEditFile::ChunkType::midiSequence)
+                {
+                    auto sequence = file.readChunk (i);
+                    expect (sequence.hasType (IDs::SEQUENCE));
+                    expectEquals (sequence.getNumChildren(), 8);
+                }
+            }
+        }
+
+        beginTest ("Read state");
+        {
+            ChunkedEditFile file (tempFile.getFile());
+            expect (file.readState (true).isEquivalentTo (edit->state));
+
+            auto state = file.readState (false);
+            expect (! state.isEquivalentTo (edit->state));
+            expect (! state.getChildWithProperty (IDs::id, tracks[2]->itemID.toVar()).isValid());
+
+            file.addDeferredChunks (state, nullptr);
+            expect (state.isEquivalentTo (edit->state));
+        }
+
+        beginTest ("Load Edit with deferred chunks");
+        {
+            auto loadedEdit = loadEditFromFile (engine, tempFile.getFile(), Edit::forRendering);
+            expect (loadedEdit != nullptr);
+            expect (loadedEdit->hasDeferredState());
+            expectEquals (getAudioTracks (*loadedEdit).size(), 2);
+
+            // New IDs mustn't clash with the ones in the deferred tracks
+            const auto existingIDs = EditItemID::findAllIDs (edit->state);
+            const auto newID = loadedEdit->createNewItemID();
+            expect (std::none_of (existingIDs.begin(), existingIDs.end(), [newID] (auto id) { return ! (id < newID); }));
+
+            loadedEdit->loadDeferredState();
+            expect (! loadedEdit->hasDeferredState());
+            expect (! loadedEdit->hasChangedSinceSaved());
+            expectEquals (getAudioTracks (*loadedEdit).size(), 3);
+            expect (findTrackForID (*loadedEdit, tracks[2]->itemID) != nullptr);
+        }
+
+        beginTest ("MIDI clip takes");
+        {
+            auto takesEdit = test_utilities::createTestEdit (engine, 1);
+            auto takesClip = getAudioTracks (*takesEdit)[0]->insertMIDIClip ({ 0_tp, 4_tp }, nullptr);
+            takesClip->getSequence().addNote (40, 0_bp, 0.5_bd, 100, 0, nullptr);
+
+            // Each take has one more note than the last, starting at a different pitch
+            for (int take = 1; take < 3; ++take)
+            {
+                juce::MidiMessageSequence ms;
+
+                for (int i = 0; i <= take; ++i)
+                {
+                    ms.addEvent (juce::MidiMessage::noteOn (1, 40 + take * 10 + i, 0.8f), i * 0.5);
+                    ms.addEvent (juce::MidiMessage::noteOff (1, 40 + take * 10 + i), i * 0.5 + 0.25);
+                }
+
+                ms.updateMatchedPairs();
+                takesClip->addTake (ms, MidiList::NoteAutomationType::none);
+            }
+
+            expect (takesClip->hasAnyTakes());
+            takesEdit->flushState();
+
+            juce::TemporaryFile takesFile (editFileSuffix);
+            expect (ChunkedEditFile::write (takesEdit->state, takesFile.getFile()));
+
+            {
+                ChunkedEditFile file (takesFile.getFile());
+
+                for (auto& c : file.getChunks())
+                    if (c.type == ChunkedEditFile::ChunkType::clipTakes)
+                        expect (! c.deferred);
+            }
+
+            // The takes should be there without having to load the deferred state
+            auto loadedEdit = loadEditFromFile (engine, takesFile.getFile(), Edit::forRendering);
+            expect (loadedEdit != nullptr);
+
+            auto loadedClip = dynamic_cast<MidiClip*> (findClipForID (*loadedEdit, takesClip->itemID));
+            expect (loadedClip != nullptr);
+            expect (loadedClip->hasAnyTakes());
+
+            for (int take = 0; take < 3; ++take)
+            {
+                loadedClip->setCurrentTake (take);
+                auto& notes = loadedClip->getSequence().getNotes();
+                expectEquals (notes.size(), take + 1);
+
+                for (int i = 0; i < notes.size(); ++i)
+                {
+                    expectEquals (notes[i]->getNoteNumber(), 40 + take * 10 + i);
+                    expectEquals (notes[i]->getStartBeat(), BeatPosition::fromBeats (i * 0.5));
+                }
+            }
+        }
+
+        beginTest ("Audio clip comps");
+        {
+            auto compEdit = test_utilities::createTestEdit (engine, 1);
+            auto track = getAudioTracks (*compEdit)[0];
+            auto squareFile = graph::test_utilities::getSquareFile<juce::WavAudioFormat> (44100.0, 4.0, 1, 220.0f);
+
+            auto compClip = insertWaveClip (*track, {}, squareFile->getFile(), { { 0_tp, 4_tp } }, DeleteExistingClips::no);
+            auto takesClip = insertWaveClip (*track, {}, squareFile->getFile(), { { 4_tp, 8_tp } }, DeleteExistingClips::no);
+
+            for (auto clip : { compClip.get(), takesClip.get() })
+            {
+                clip->addTake (squareFile->getFile());
+                clip->addTake (squareFile->getFile());
+            }
+
+            compClip->getCompManager().addNewComp();
+            expect (compClip->isCurrentTakeComp());
+            expect (! takesClip->isCurrentTakeComp());
+            compEdit->flushState();
+
+            juce::TemporaryFile compFile (editFileSuffix);
+            expect (ChunkedEditFile::write (compEdit->state, compFile.getFile()));
+
+            {
+                // Only the takes of the clip that isn't playing a comp can be deferred
+                ChunkedEditFile file (compFile.getFile());
+
+                for (auto& c : file.getChunks())
+                    if (c.type == ChunkedEditFile::ChunkType::clipTakes)
+                        expect (c.deferred == (c.pathIDs.back() == takesClip->itemID.toString()));
+            }
+
+            auto loadedEdit = loadEditFromFile (engine, compFile.getFile(), Edit::forRendering);
+            expect (loadedEdit != nullptr);
+            expect (loadedEdit->hasDeferredState());
+
+            auto loadedCompClip = dynamic_cast<WaveAudioClip*> (findClipForID (*loadedEdit, compClip->itemID));
+            auto loadedTakesClip = dynamic_cast<WaveAudioClip*> (findClipForID (*loadedEdit, takesClip->itemID));
+            expect (loadedCompClip != nullptr && loadedTakesClip != nullptr);
+
+            // The comp clip should be playing its comp file as soon as it's loaded
+            const auto compSourceFile = loadedCompClip->getCurrentSourceFile();
+            expect (loadedCompClip->isCurrentTakeComp());
+            expect (compSourceFile != squareFile->getFile());
+            expect (compSourceFile == loadedCompClip->getCompManager().getCurrentCompFile());
+            expectEquals (loadedCompClip->getNumTakes (true), 3);
+
+            expect (loadedTakesClip->getCurrentSourceFile() == squareFile->getFile());
+            expectEquals (loadedTakesClip->getNumTakes (true), 0);
+
+            loadedEdit->loadDeferredState();
+            expectEquals (loadedTakesClip->getNumTakes (true), 2);
+            expect (loadedTakesClip->getCurrentSourceFile() == squareFile->getFile());
+            expect (loadedCompClip->getCurrentSourceFile() == compSourceFile);
+        }
+    }
+};
+
+static ChunkedEditFileTests chunkedEditFileTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
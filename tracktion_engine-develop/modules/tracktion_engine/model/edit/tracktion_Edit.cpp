@@ -624,8 +624,14 @@ Edit::Edit (Options options)
 
     undoManager.setMaxNumberOfStoredUnits (1000 * options.numUndoLevelsToStore, options.numUndoLevelsToStore);
 
+    // These need to be known before any new IDs are created during initialisation
+    deferredItemIDs = std::move (options.deferredItemIDs);
+
     initialise (options);
 
+    if (options.deferredStateLoader)
+        setDeferredStateLoader (std::move (options.deferredStateLoader));
+
     undoTransactionTimer = std::make_unique<UndoTransactionTimer> (*this);
 
     if (loadContext != nullptr && ! loadContext->shouldExit)
@@ -1131,6 +1137,35 @@ bool Edit::hasChangedSinceSaved() const
     return hasChanged;
 }
 
+void Edit::setDeferredStateLoader (std::function<void (juce::ValueTree&)> loader)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    deferredStateLoader = std::move (loader);
+
+    if (deferredStateLoader)
+        juce::MessageManager::callAsync ([ref = makeSafeRef (*this)]
+                                         {
+                                             if (auto e = ref.get())
+                                                 e->loadDeferredState();
+                                         });
+}
+
+void Edit::loadDeferredState()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    if (auto loader = std::exchange (deferredStateLoader, nullptr))
+    {
+        CRASH_TRACER
+        const bool wasChanged = hasChangedSinceSaved();
+
+        loader (state);
+
+        if (! wasChanged)
+            resetChangedStatus();
+    }
+}
+
 void Edit::restartPlayback()
 {
     shouldRestartPlayback = true;
@@ -1213,6 +1248,7 @@ EditItemID Edit::createNewItemID (const std::vector<EditItemID>& idsToAvoid) con
         auto existingIDs = EditItemID::findAllIDs (state);
 
         existingIDs.insert (existingIDs.end(), idsToAvoid.begin(), idsToAvoid.end());
+        existingIDs.insert (existingIDs.end(), deferredItemIDs.begin(), deferredItemIDs.end());
 
         trackCache.visitItems ([&] (auto i)  { existingIDs.push_back (i->itemID); });
         clipCache.visitItems ([&] (auto i)   { existingIDs.push_back (i->itemID); });
@@ -105,6 +105,9 @@ public:
         std::function<juce::File (const juce::String&)> filePathResolver = {};  ///< An optional filePathResolver to use.
 
         uint32_t numAudioTracks = 1;                                            ///< If non-zero, will ensure the edit has this many audio tracks
+
+        std::function<void (juce::ValueTree&)> deferredStateLoader = {};        ///< An optional function to add sections left out of the editState. @see setDeferredStateLoader
+        std::vector<EditItemID> deferredItemIDs = {};                           ///< Any IDs used in the sections the deferredStateLoader will add.
     };
 
     /// Creates an Edit from a set of Options.
@@ -197,6 +200,22 @@ public:
     /** Returns true if the Edit's not yet fully loaded */
     bool isLoading() const                                              { return isLoadInProgress; }
 
+    /** Sets a function that will add any sections of the state that were left out
+        when the Edit was loaded, e.g. the deferred chunks of a ChunkedEditFile.
+        This gets called asynchronously, or sooner if loadDeferredState is called.
+        If those sections contain any EditItemIDs, pass the loader in the Options along
+        with Options::deferredItemIDs instead so new items can't be given the same IDs.
+    */
+    void setDeferredStateLoader (std::function<void (juce::ValueTree&)>);
+
+    /** Adds any sections of the state that haven't been loaded yet.
+        This is called before the Edit is saved so they don't get lost.
+    */
+    void loadDeferredState();
+
+    /** Returns true if there are sections of the state that haven't been loaded yet. */
+    bool hasDeferredState() const noexcept                              { return deferredStateLoader != nullptr; }
+
     //==============================================================================
     /** Creates an Edit for the given options. */
     static std::unique_ptr<Edit> createEdit (Options);
@@ -872,6 +891,8 @@ private:
     bool hasChanged = false;
     bool ignoreLeftViewLimit;
     LoadContext* loadContext = nullptr;
+    std::function<void (juce::ValueTree&)> deferredStateLoader;
+    std::vector<EditItemID> deferredItemIDs;
     juce::UndoManager undoManager;
     int numUndoTransactionInhibitors = 0;
     mutable juce::File tempDirectory;
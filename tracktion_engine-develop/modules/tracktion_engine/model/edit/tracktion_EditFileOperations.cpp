@@ -25,10 +25,26 @@ struct ThreadedEditFileWriter   : private juce::Thread
 
     void writeTreeToFile (juce::ValueTree&& v, const juce::File& f)
     {
-        TRACKTION_ASSERT_MESSAGE_THREAD
-        pending.add (std::pair<juce::ValueTree, juce::File> (v, f));
-        waiter.signal();
-        startThread();
+        addJob ([v = std::move (v), f]
+                {
+                    f.deleteFile();
+                    juce::FileOutputStream os (f);
+                    v.writeToStream (os);
+                });
+    }
+
+    void appendToFile (juce::MemoryBlock&& data, const juce::File& f)
+    {
+        addJob ([data = std::move (data), f]
+                {
+                    juce::FileOutputStream os (f);
+                    os.write (data.getData(), data.getSize());
+                });
+    }
+
+    void deleteFile (const juce::File& f)
+    {
+        addJob ([f] { f.deleteFile(); });
     }
 
     void flushAllFiles()
@@ -42,25 +58,27 @@ struct ThreadedEditFileWriter   : private juce::Thread
     }
 
 private:
+    void addJob (std::function<void()> job)
+    {
+        TRACKTION_ASSERT_MESSAGE_THREAD
+        pending.add (std::move (job));
+        waiter.signal();
+        startThread();
+    }
+
     void run() override
     {
         while (! threadShouldExit())
         {
+            // Jobs are run in order so a journal is always appended to the snapshot it was started with
             while (! pending.isEmpty())
-                writeToFile (pending.removeAndReturn (0));
+                pending.removeAndReturn (0)();
 
             waiter.wait (1000);
         }
     }
 
-    void writeToFile (std::pair<juce::ValueTree, juce::File> item)
-    {
-        item.second.deleteFile();
-        juce::FileOutputStream os (item.second);
-        item.first.writeToStream (os);
-    }
-
-    juce::Array<std::pair<juce::ValueTree, juce::File>, juce::CriticalSection> pending;
+    juce::Array<std::function<void()>, juce::CriticalSection> pending;
     juce::WaitableEvent waiter;
 };
 
@@ -79,9 +97,15 @@ struct SharedEditFileDataCache
         {
             jassert (Selectable::isSelectableValid (&edit));
 
+            journal.reset();
+
             // If we managed to shutdown cleanly (i.e. without crashing) then delete the temp file
             if (auto item = getProjectItemForEdit (edit))
-                EditFileOperations::getTempVersionOfEditFile (item->getSourceFile()).deleteFile();
+            {
+                auto tempFile = EditFileOperations::getTempVersionOfEditFile (item->getSourceFile());
+                tempFile.deleteFile();
+                EditJournal::getJournalFile (tempFile).deleteFile();
+            }
         }
 
         void refresh()
@@ -92,6 +116,9 @@ struct SharedEditFileDataCache
         Edit& edit;
         juce::Time timeOfLastSave { juce::Time::getCurrentTime() };
         EditSnapshot::Ptr editSnapshot { EditSnapshot::getEditSnapshot (edit.engine, edit.getProjectItemID()) };
+
+        std::unique_ptr<EditJournal> journal;
+        juce::File journalSnapshotFile;
     };
 
     SharedEditFileDataCache() = default;
@@ -145,6 +172,40 @@ struct EditFileOperations::SharedDataPimpl
         editFileWriter->writeTreeToFile (std::move (v), f);
     }
 
+    /** Appends the changes since the last call to the journal for a snapshot file,
+        first writing a new snapshot if there isn't a valid one.
+    */
+    void writeJournalToDisk (const juce::ValueTree& state, const juce::File& snapshotFile)
+    {
+        auto& journal = data->journal;
+        const auto journalFile = EditJournal::getJournalFile (snapshotFile);
+
+        if (journal == nullptr)
+            journal = std::make_unique<EditJournal> (state);
+
+        if (journal->needsSnapshot() || data->journalSnapshotFile != snapshotFile)
+        {
+            editFileWriter->deleteFile (journalFile);
+            editFileWriter->writeTreeToFile (state.createCopy(), snapshotFile);
+            editFileWriter->appendToFile (journal->startNewJournal(), journalFile);
+            data->journalSnapshotFile = snapshotFile;
+        }
+        else if (journal->hasPendingChanges())
+        {
+            editFileWriter->appendToFile (journal->takePendingChanges(), journalFile);
+        }
+    }
+
+    /** Deletes the journal after the snapshot has been replaced or removed. */
+    void resetJournal()
+    {
+        if (data->journalSnapshotFile != juce::File())
+        {
+            editFileWriter->deleteFile (EditJournal::getJournalFile (data->journalSnapshotFile));
+            data->journalSnapshotFile = juce::File();
+        }
+    }
+
     juce::SharedResourcePointer<SharedEditFileDataCache> cache;
     std::shared_ptr<SharedEditFileDataCache::Data> data;
     juce::SharedResourcePointer<ThreadedEditFileWriter> editFileWriter;
@@ -182,20 +243,30 @@ bool EditFileOperations::writeToFile (const juce::File& file, bool writeQuickBin
         sharedDataPimpl->editFileWriter->flushAllFiles();
     }
 
+    // Make sure nothing that was left out when the Edit was loaded gets lost
+    edit.loadDeferredState();
+
     if (file.hasWriteAccess() && ! file.isDirectory())
     {
         if (writeQuickBinaryVersion)
         {
-            sharedDataPimpl->writeValueTreeToDisk (edit.state.createCopy(), file);
+            if (edit.engine.getEngineBehaviour().useJournalForEditAutosaves())
+                sharedDataPimpl->writeJournalToDisk (edit.state, file);
+            else
+                sharedDataPimpl->writeValueTreeToDisk (edit.state.createCopy(), file);
         }
         else
         {
+            // This replaces the snapshot so any journal for it is no longer valid
+            sharedDataPimpl->resetJournal();
             edit.flushState();
 
             if (editSnapshot != nullptr)
                 editSnapshot->setState (edit.state, edit.getLength());
 
-            if (auto xml = edit.state.createXml())
+            if (edit.engine.getEngineBehaviour().saveEditsAsChunkedBinary())
+                ok = ChunkedEditFile::write (edit.state, file);
+            else if (auto xml = edit.state.createXml())
                 ok = xml->writeTo (file);
 
             jassert (ok);
@@ -405,6 +476,9 @@ juce::File EditFileOperations::getTempVersionFile() const
 
 void EditFileOperations::deleteTempVersion()
 {
+    sharedDataPimpl->resetJournal();
+    sharedDataPimpl->editFileWriter->flushAllFiles();
+
     getTempVersionFile().deleteFile();
 }
 
@@ -428,12 +502,24 @@ std::unique_ptr<Edit> loadEditForExamining (ProjectManager& pm, ProjectItemID it
     return Edit::createEditForExamining (pm.engine, loadEditFromProjectManager (pm, itemID), role);
 }
 
-juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID itemID)
+static juce::ValueTree loadEditStateFromFile (Engine& e, const juce::File& f, ProjectItemID itemID,
+                                              std::shared_ptr<ChunkedEditFile>* fileWithDeferredChunks)
 {
     CRASH_TRACER
     juce::ValueTree state;
 
-    if (auto xml = juce::parseXML (f))
+    if (ChunkedEditFile::isChunkedEditFile (f))
+    {
+        auto chunkedFile = std::make_shared<ChunkedEditFile> (f);
+        const bool deferChunks = fileWithDeferredChunks != nullptr && chunkedFile->hasDeferredChunks();
+
+        // These are only written from loaded Edits so don't need any legacy conversion
+        if (state = chunkedFile->readState (! deferChunks); ! state.hasType (IDs::EDIT))
+            state = {};
+        else if (deferChunks)
+            *fileWithDeferredChunks = chunkedFile;
+    }
+    else if (auto xml = juce::parseXML (f))
     {
         updateLegacyEdit (*xml);
         state = juce::ValueTree::fromXml (*xml);
@@ -444,9 +530,17 @@ juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID
         if (juce::FileInputStream is (f); is.openedOk())
         {
             if (state = juce::ValueTree::readFromStream (is); state.hasType (IDs::EDIT))
+            {
+                // Temp versions may have a journal of the changes made since they were written
+                if (auto journalFile = EditJournal::getJournalFile (f); journalFile.existsAsFile())
+                    EditJournal::applyJournal (state, journalFile);
+
                 state = updateLegacyEdit (state);
+            }
             else
+            {
                 state = {};
+            }
         }
     }
 
@@ -465,6 +559,11 @@ juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID
     return state;
 }
 
+juce::ValueTree loadEditFromFile (Engine& e, const juce::File& f, ProjectItemID itemID)
+{
+    return loadEditStateFromFile (e, f, itemID, nullptr);
+}
+
 juce::ValueTree createEmptyEdit (Engine& e)
 {
     return loadEditFromFile (e, {}, ProjectItemID::createNewID (0));
@@ -472,7 +571,8 @@ juce::ValueTree createEmptyEdit (Engine& e)
 
 std::unique_ptr<Edit> loadEditFromFile (Engine& engine, const juce::File& editFile, Edit::EditRole role)
 {
-    auto editState = loadEditFromFile (engine, editFile, ProjectItemID{});
+    std::shared_ptr<ChunkedEditFile> fileWithDeferredChunks;
+    auto editState = loadEditStateFromFile (engine, editFile, ProjectItemID{}, &fileWithDeferredChunks);
 
     if (! editState.isValid())
         return {};
@@ -482,7 +582,7 @@ std::unique_ptr<Edit> loadEditFromFile (Engine& engine, const juce::File& editFi
     if (! id.isValid())
         id = ProjectItemID::createNewID (0);
 
-    return Edit::createEdit (Edit::Options
+    Edit::Options options
     {
         engine,
         editState,
@@ -492,7 +592,19 @@ std::unique_ptr<Edit> loadEditFromFile (Engine& engine, const juce::File& editFi
         Edit::getDefaultNumUndoLevels(),
         [editFile] { return editFile; },
         {}
-    });
+    };
+
+    // Let playback start before the sections that aren't needed for it are loaded
+    if (fileWithDeferredChunks != nullptr)
+    {
+        options.deferredStateLoader = [fileWithDeferredChunks] (juce::ValueTree& state)
+                                      {
+                                          fileWithDeferredChunks->addDeferredChunks (state, nullptr);
+                                      };
+        options.deferredItemIDs = fileWithDeferredChunks->getDeferredItemIDs();
+    }
+
+    return Edit::createEdit (std::move (options));
 }
 
 std::unique_ptr<Edit> createEmptyEdit (Engine& engine, const juce::File& editFile)
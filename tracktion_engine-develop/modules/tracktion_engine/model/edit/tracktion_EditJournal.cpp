@@ -0,0 +1,447 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+static const char* editJournalMagicNumber = "TEJ1";
+
+// Each change is stored as its size, a checksum and then the change itself so
+// if the last one was only partly written it can be detected and ignored.
+static int getJournalChecksum (const void* data, size_t numBytes)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < numBytes; ++i)
+        hash = (hash ^ static_cast<const uint8_t*> (data)[i]) * 16777619u;
+
+    return (int) hash;
+}
+
+//==============================================================================
+EditJournal::EditJournal (const juce::ValueTree& stateToWatch)
+    : state (stateToWatch)
+{
+    state.addListener (this);
+}
+
+EditJournal::~EditJournal()
+{
+    state.removeListener (this);
+}
+
+juce::File EditJournal::getJournalFile (const juce::File& snapshotFile)
+{
+    return snapshotFile != juce::File() ? snapshotFile.getSiblingFile (snapshotFile.getFileName() + ".journal")
+                                        : juce::File();
+}
+
+bool EditJournal::needsSnapshot() const noexcept
+{
+    return snapshotNeeded || journalSize + pendingChanges.getSize() > maxJournalSize;
+}
+
+juce::MemoryBlock EditJournal::takePendingChanges()
+{
+    juce::MemoryBlock changes;
+    changes.swapWith (pendingChanges);
+    journalSize += changes.getSize();
+    lastChangedTree = {};
+
+    return changes;
+}
+
+juce::MemoryBlock EditJournal::startNewJournal()
+{
+    pendingChanges.reset();
+    replayedState = createReplayedTree (state);
+    lastChangedTree = {};
+    snapshotNeeded = false;
+
+    juce::MemoryBlock header (editJournalMagicNumber, 4);
+    journalSize = header.getSize();
+
+    return header;
+}
+
+//==============================================================================
+int EditJournal::applyJournal (juce::ValueTree& stateToUpdate, juce::InputStream& journal)
+{
+    CRASH_TRACER
+    char magic[4] = {};
+
+    if (journal.read (magic, 4) != 4 || memcmp (magic, editJournalMagicNumber, 4) != 0)
+        return 0;
+
+    int numChanges = 0;
+
+    while (! journal.isExhausted())
+    {
+        const auto numBytes = journal.readInt();
+        const auto checksum = journal.readInt();
+
+        if (numBytes <= 0 || numBytes > journal.getNumBytesRemaining())
+            break;
+
+        juce::MemoryBlock change;
+
+        if (journal.readIntoMemoryBlock (change, numBytes) != (size_t) numBytes
+             || getJournalChecksum (change.getData(), change.getSize()) != checksum)
+            break;
+
+        juce::MemoryInputStream in (change, false);
+
+        if (! applyChange (stateToUpdate, in))
+        {
+            jassertfalse; // The journal doesn't match the snapshot
+            break;
+        }
+
+        ++numChanges;
+    }
+
+    return numChanges;
+}
+
+int EditJournal::applyJournal (juce::ValueTree& stateToUpdate, const juce::File& journalFile)
+{
+    if (juce::FileInputStream in (journalFile); in.openedOk())
+        return applyJournal (stateToUpdate, in);
+
+    return 0;
+}
+
+bool EditJournal::applyChange (juce::ValueTree& stateToUpdate, juce::InputStream& in)
+{
+    const auto type = (ChangeType) in.readByte();
+    const auto pathSize = in.readCompressedInt();
+    auto v = stateToUpdate;
+
+    if (pathSize < 0)
+        return false;
+
+    for (int i = 0; i < pathSize && v.isValid(); ++i)
+        v = v.getChild (in.readCompressedInt());
+
+    if (! v.isValid())
+        return false;
+
+    switch (type)
+    {
+        case ChangeType::propertyChanged:
+        case ChangeType::propertyRemoved:
+        {
+            const auto name = in.readString();
+
+            if (name.isEmpty())
+                return false;
+
+            if (type == ChangeType::propertyRemoved)
+                v.removeProperty (juce::Identifier (name), nullptr);
+            else
+                v.setProperty (juce::Identifier (name), juce::var::readFromStream (in), nullptr);
+
+            return true;
+        }
+
+        case ChangeType::childAdded:
+        {
+            const auto index = in.readCompressedInt();
+            auto child = juce::ValueTree::readFromStream (in);
+
+            if (! child.isValid() || ! juce::isPositiveAndNotGreaterThan (index, v.getNumChildren()))
+                return false;
+
+            v.addChild (child, index, nullptr);
+            return true;
+        }
+
+        case ChangeType::childRemoved:
+        {
+            const auto index = in.readCompressedInt();
+
+            if (! juce::isPositiveAndBelow (index, v.getNumChildren()))
+                return false;
+
+            v.removeChild (index, nullptr);
+            return true;
+        }
+
+        case ChangeType::childMoved:
+        {
+            const auto oldIndex = in.readCompressedInt();
+            const auto newIndex = in.readCompressedInt();
+
+            if (! (juce::isPositiveAndBelow (oldIndex, v.getNumChildren())
+                    && juce::isPositiveAndBelow (newIndex, v.getNumChildren())))
+                return false;
+
+            v.moveChild (oldIndex, newIndex, nullptr);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//==============================================================================
+EditJournal::ReplayedTree EditJournal::createReplayedTree (const juce::ValueTree& v)
+{
+    ReplayedTree replayed { v, {} };
+    replayed.children.reserve ((size_t) v.getNumChildren());
+
+    for (const auto& child : v)
+        replayed.children.push_back (createReplayedTree (child));
+
+    return replayed;
+}
+
+int EditJournal::indexOfReplayedChild (const ReplayedTree& parent, const juce::ValueTree& child, int indexInState)
+{
+    const auto& children = parent.children;
+
+    // The replayed children are usually in the same order so try there first
+    if (juce::isPositiveAndBelow (indexInState, (int) children.size())
+         && children[(size_t) indexInState].tree == child)
+        return indexInState;
+
+    for (size_t i = 0; i < children.size(); ++i)
+        if (children[i].tree == child)
+            return (int) i;
+
+    return -1;
+}
+
+EditJournal::ReplayedTree* EditJournal::findReplayedTree (const juce::ValueTree& v, std::vector<int>& path)
+{
+    std::vector<juce::ValueTree> ancestors;
+
+    for (auto node = v; node != state; node = node.getParent())
+    {
+        if (! node.isValid())
+            return nullptr;
+
+        ancestors.push_back (node);
+    }
+
+    auto replayed = &replayedState;
+    path.clear();
+
+    for (auto node = ancestors.rbegin(); node != ancestors.rend(); ++node)
+    {
+        const auto index = indexOfReplayedChild (*replayed, *node, node->getParent().indexOf (*node));
+
+        // This is inside a child that the journal hasn't been told has been added yet.
+        // That child will be written with its current state so this doesn't need recording.
+        if (index < 0)
+            return nullptr;
+
+        path.push_back (index);
+        replayed = &replayed->children[(size_t) index];
+    }
+
+    return replayed;
+}
+
+int EditJournal::getReplayedIndex (const ReplayedTree& parent, const juce::ValueTree& child)
+{
+    // Keeps the child after the same sibling as in the state, ignoring any siblings the
+    // journal hasn't been told about yet
+    for (int i = parent.tree.indexOf (child); --i >= 0;)
+        if (auto index = indexOfReplayedChild (parent, parent.tree.getChild (i), i); index >= 0)
+            return index + 1;
+
+    return 0;
+}
+
+void EditJournal::writePath (juce::OutputStream& out, const std::vector<int>& path)
+{
+    out.writeCompressedInt ((int) path.size());
+
+    for (auto index : path)
+        out.writeCompressedInt (index);
+}
+
+void EditJournal::addChange (const juce::MemoryOutputStream& change)
+{
+    // If this much has changed, it's quicker to just write a new snapshot
+    if (pendingChanges.getSize() > maxJournalSize)
+    {
+        resetJournal();
+        return;
+    }
+
+    juce::MemoryOutputStream out (pendingChanges, true);
+    out.writeInt ((int) change.getDataSize());
+    out.writeInt (getJournalChecksum (change.getData(), change.getDataSize()));
+    out.write (change.getData(), change.getDataSize());
+}
+
+void EditJournal::resetJournal()
+{
+    pendingChanges.reset();
+    replayedState = {};
+    lastChangedTree = {};
+    snapshotNeeded = true;
+}
+
+void EditJournal::valueTreePropertyChanged (juce::ValueTree& v, const juce::Identifier& id)
+{
+    // Nothing needs recording until the next snapshot has been taken
+    if (snapshotNeeded)
+        return;
+
+    std::vector<int> path;
+
+    if (findReplayedTree (v, path) == nullptr)
+        return;
+
+    const bool removed = ! v.hasProperty (id);
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) (removed ? ChangeType::propertyRemoved : ChangeType::propertyChanged));
+    writePath (change, path);
+    change.writeString (id.toString());
+
+    if (! removed)
+        v[id].writeToStream (change);
+
+    // Properties that keep changing, e.g. whilst dragging, only need their latest value
+    if (v == lastChangedTree && id == lastChangedProperty)
+        pendingChanges.setSize (lastPropertyChangeStart);
+
+    lastPropertyChangeStart = pendingChanges.getSize();
+    lastChangedTree = v;
+    lastChangedProperty = id;
+    addChange (change);
+}
+
+void EditJournal::valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child)
+{
+    if (snapshotNeeded)
+        return;
+
+    lastChangedTree = {};
+
+    // A nearer listener may have already removed it again
+    if (child.getParent() != parent)
+        return;
+
+    std::vector<int> path;
+    auto replayedParent = findReplayedTree (parent, path);
+
+    if (replayedParent == nullptr
+         || indexOfReplayedChild (*replayedParent, child, parent.indexOf (child)) >= 0)
+        return;
+
+    const auto index = getReplayedIndex (*replayedParent, child);
+    replayedParent->children.insert (replayedParent->children.begin() + index, createReplayedTree (child));
+
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) ChangeType::childAdded);
+    writePath (change, path);
+    change.writeCompressedInt (index);
+    child.writeToStream (change);
+    addChange (change);
+}
+
+void EditJournal::valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree& child, int indexRemovedFrom)
+{
+    if (snapshotNeeded)
+        return;
+
+    lastChangedTree = {};
+    std::vector<int> path;
+    auto replayedParent = findReplayedTree (parent, path);
+
+    if (replayedParent == nullptr)
+        return;
+
+    const auto index = indexOfReplayedChild (*replayedParent, child, indexRemovedFrom);
+
+    if (index < 0)
+        return;
+
+    replayedParent->children.erase (replayedParent->children.begin() + index);
+
+    juce::MemoryOutputStream change;
+    change.writeByte ((char) ChangeType::childRemoved);
+    writePath (change, path);
+    change.writeCompressedInt (index);
+    addChange (change);
+}
+
+void EditJournal::valueTreeChildOrderChanged (juce::ValueTree& parent, int, int newIndex)
+{
+    if (snapshotNeeded)
+        return;
+
+    lastChangedTree = {};
+    std::vector<int> path;
+    auto replayedParent = findReplayedTree (parent, path);
+
+    if (replayedParent == nullptr)
+        return;
+
+    auto& children = replayedParent->children;
+
+    auto moveChild = [&] (int oldIndex, int newIndexInReplayed)
+    {
+        auto moved = std::move (children[(size_t) oldIndex]);
+        children.erase (children.begin() + oldIndex);
+        children.insert (children.begin() + newIndexInReplayed, std::move (moved));
+
+        juce::MemoryOutputStream change;
+        change.writeByte ((char) ChangeType::childMoved);
+        writePath (change, path);
+        change.writeCompressedInt (oldIndex);
+        change.writeCompressedInt (newIndexInReplayed);
+        addChange (change);
+    };
+
+    if (const auto child = parent.getChild (newIndex); child.isValid())
+    {
+        if (const auto oldIndex = indexOfReplayedChild (*replayedParent, child, newIndex); oldIndex >= 0)
+        {
+            auto moved = std::move (children[(size_t) oldIndex]);
+            children.erase (children.begin() + oldIndex);
+            const auto index = getReplayedIndex (*replayedParent, child);
+            children.insert (children.begin() + oldIndex, std::move (moved));
+
+            if (index != oldIndex)
+                moveChild (oldIndex, index);
+        }
+    }
+
+    // Nearer listeners may have moved other children too so this puts any others in the
+    // same order as the state. Any that haven't been added yet are skipped and any that
+    // haven't been removed yet end up at the end.
+    int numInOrder = 0;
+
+    for (const auto& child : parent)
+    {
+        const auto oldIndex = indexOfReplayedChild (*replayedParent, child, numInOrder);
+
+        if (oldIndex < 0)
+            continue;
+
+        if (oldIndex != numInOrder)
+            moveChild (oldIndex, numInOrder);
+
+        ++numInOrder;
+    }
+}
+
+void EditJournal::valueTreeRedirected (juce::ValueTree&)
+{
+    resetJournal();
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,122 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+/**
+    Records the changes made to an Edit's state so they can be appended to a journal
+    file instead of writing the whole state every time it's autosaved.
+
+    The journal is stored alongside a snapshot of the state, i.e. the Edit's temp file.
+    Once the journal gets too big, a new snapshot should be written and the journal
+    started again. To recover the state, load the snapshot and then call applyJournal.
+
+    @see EditFileOperations::saveTempVersion, EngineBehaviour::useJournalForEditAutosaves
+*/
+class EditJournal  : private juce::ValueTree::Listener
+{
+public:
+    //==============================================================================
+    /** Starts recording the changes made to a state. */
+    EditJournal (const juce::ValueTree& stateToWatch);
+
+    /** Destructor. */
+    ~EditJournal() override;
+
+    /** The size the journal can get to before a new snapshot should be written. */
+    static constexpr size_t maxJournalSize = 4 * 1024 * 1024;
+
+    /** Returns the journal file to use alongside a snapshot file. */
+    static juce::File getJournalFile (const juce::File& snapshotFile);
+
+    //==============================================================================
+    /** Returns true if there are changes that haven't been taken yet. */
+    bool hasPendingChanges() const noexcept             { return pendingChanges.getSize() > 0; }
+
+    /** Returns true if the journal has got too big or couldn't record a change so
+        a new snapshot should be written.
+    */
+    bool needsSnapshot() const noexcept;
+
+    /** Returns the changes recorded since this was last called as entries to append
+        to the journal file.
+    */
+    juce::MemoryBlock takePendingChanges();
+
+    /** Call when a snapshot of the state has been taken.
+        This discards any pending changes and returns the header to start the new
+        journal file with.
+    */
+    juce::MemoryBlock startNewJournal();
+
+    //==============================================================================
+    /** Applies the changes in a journal to the state loaded from its snapshot.
+        If the end of the journal is incomplete, e.g. after a crash, the changes up
+        to there are applied.
+        @returns the number of changes applied
+    */
+    static int applyJournal (juce::ValueTree& state, juce::InputStream& journal);
+
+    /** Applies the changes in a journal file to the state loaded from its snapshot. */
+    static int applyJournal (juce::ValueTree& state, const juce::File& journalFile);
+
+private:
+    //==============================================================================
+    enum class ChangeType
+    {
+        propertyChanged = 1,
+        propertyRemoved,
+        childAdded,
+        childRemoved,
+        childMoved
+    };
+
+    /** The structure of the state as it will be after applying the journal to the
+        snapshot. Listeners nearer to a change than the journal can make further
+        changes before the journal is told about it, so the paths to write are worked
+        out from this rather than the state itself.
+    */
+    struct ReplayedTree
+    {
+        juce::ValueTree tree;
+        std::vector<ReplayedTree> children;
+    };
+
+    juce::ValueTree state;
+    ReplayedTree replayedState;
+    juce::MemoryBlock pendingChanges;
+    size_t journalSize = 0;
+    bool snapshotNeeded = true;
+
+    juce::ValueTree lastChangedTree;
+    juce::Identifier lastChangedProperty;
+    size_t lastPropertyChangeStart = 0;
+
+    static ReplayedTree createReplayedTree (const juce::ValueTree&);
+    ReplayedTree* findReplayedTree (const juce::ValueTree&, std::vector<int>& path);
+    static int indexOfReplayedChild (const ReplayedTree& parent, const juce::ValueTree& child, int indexInState);
+    static int getReplayedIndex (const ReplayedTree& parent, const juce::ValueTree& child);
+    static void writePath (juce::OutputStream&, const std::vector<int>& path);
+    void addChange (const juce::MemoryOutputStream&);
+    void resetJournal();
+    static bool applyChange (juce::ValueTree& state, juce::InputStream&);
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+    void valueTreeRedirected (juce::ValueTree&) override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (EditJournal)
+};
+
+}} // namespace tracktion { inline namespace engine
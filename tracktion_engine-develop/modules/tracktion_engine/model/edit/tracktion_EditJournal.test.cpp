@@ -0,0 +1,165 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_EDIT_JOURNAL
+
+#include "../../utilities/tracktion_TestUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class EditJournalTests  : public juce::UnitTest
+{
+public:
+    EditJournalTests()
+        : juce::UnitTest ("EditJournal", "tracktion_engine")
+    {}
+
+    void runTest() override
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, 3);
+
+        beginTest ("Replay changes");
+        EditJournal journal (edit->state);
+        expect (journal.needsSnapshot());
+
+        auto snapshot = edit->state.createCopy();
+        juce::MemoryOutputStream journalData;
+        journalData << journal.startNewJournal();
+        expect (! journal.needsSnapshot());
+        expect (! journal.hasPendingChanges());
+
+        {
+            auto tracks = getAudioTracks (*edit);
+            auto mc = tracks[0]->insertMIDIClip ({ 0_tp, 4_tp }, nullptr);
+
+            for (int i = 0; i < 8; ++i)
+                mc->getSequence().addNote (60 + i, BeatPosition::fromBeats (i), 0.5_bd, 100, 0, nullptr);
+
+            tracks[1]->setName ("Renamed");
+            edit->deleteTrack (tracks[2]);
+            edit->state.moveChild (edit->state.indexOf (tracks[1]->state),
+                                   edit->state.indexOf (tracks[0]->state), nullptr);
+            tracks[0]->state.removeProperty (IDs::colour, nullptr);
+
+            expect (journal.hasPendingChanges());
+            journalData << journal.takePendingChanges();
+            expect (! journal.hasPendingChanges());
+
+            juce::MemoryInputStream in (journalData.getData(), journalData.getDataSize(), false);
+            expectGreaterThan (EditJournal::applyJournal (snapshot, in), 0);
+            expect (snapshot.isEquivalentTo (edit->state));
+        }
+
+        beginTest ("Repeated property changes");
+        {
+            auto track = getAudioTracks (*edit)[0];
+
+            for (int i = 0; i < 100; ++i)
+                track->state.setProperty (IDs::height, 50 + i, nullptr);
+
+            auto changes = journal.takePendingChanges();
+            auto state = snapshot.createCopy();
+
+            juce::MemoryOutputStream out;
+            out << journal.startNewJournal() << changes;
+            juce::MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expectEquals (EditJournal::applyJournal (state, in), 1);
+            expect (state.isEquivalentTo (edit->state));
+            snapshot = state;
+        }
+
+        beginTest ("Replay clip inserts and track deletions");
+        {
+            // Clips add children to themselves whilst being created, before the journal
+            // is told they've been added
+            auto state = snapshot.createCopy();
+            juce::MemoryOutputStream out;
+            out << journal.startNewJournal();
+
+            auto tracks = getAudioTracks (*edit);
+
+            for (auto track : tracks)
+            {
+                track->insertMIDIClip ({ 0_tp, 2_tp }, nullptr);
+                track->insertNewClip (TrackItem::Type::step, { 2_tp, 4_tp }, nullptr);
+            }
+
+            out << journal.takePendingChanges();
+
+            auto newTrack = edit->insertNewAudioTrack (TrackInsertPoint (nullptr, tracks.getLast()), nullptr);
+            newTrack->insertMIDIClip ({ 1_tp, 3_tp }, nullptr);
+            edit->deleteTrack (tracks[0]);
+            tracks[1]->insertMIDIClip ({ 4_tp, 6_tp }, nullptr);
+            out << journal.takePendingChanges();
+
+            juce::MemoryInputStream in (out.getData(), out.getDataSize(), false);
+            expectGreaterThan (EditJournal::applyJournal (state, in), 0);
+            expect (state.isEquivalentTo (edit->state));
+            snapshot = state;
+        }
+
+        beginTest ("Incomplete journal");
+        {
+            auto state = snapshot.createCopy();
+            auto tracks = getAudioTracks (*edit);
+            juce::MemoryOutputStream out;
+            out << journal.startNewJournal();
+
+            tracks[0]->state.setProperty (IDs::name, "First", nullptr);
+            tracks[1]->state.setProperty (IDs::name, "Second", nullptr);
+            out << journal.takePendingChanges();
+            tracks[1]->state.setProperty (IDs::name, "Third", nullptr);
+            out << journal.takePendingChanges();
+
+            // Chop off the end of the last change as if it had been interrupted by a crash
+            juce::MemoryInputStream in (out.getData(), out.getDataSize() - 3, false);
+            expectEquals (EditJournal::applyJournal (state, in), 2);
+            expectEquals (state.getChildWithProperty (IDs::id, tracks[1]->itemID.toVar())[IDs::name].toString(),
+                          juce::String ("Second"));
+        }
+
+        beginTest ("Load Edit from snapshot and journal");
+        {
+            juce::TemporaryFile snapshotFile;
+            const auto journalFile = EditJournal::getJournalFile (snapshotFile.getFile());
+
+            {
+                juce::FileOutputStream os (snapshotFile.getFile());
+                edit->state.writeToStream (os);
+            }
+
+            auto header = journal.startNewJournal();
+            getAudioTracks (*edit)[0]->setName ("Recovered");
+            edit->ensureNumberOfAudioTracks (getAudioTracks (*edit).size() + 1);
+
+            {
+                juce::FileOutputStream os (journalFile);
+                os << header << journal.takePendingChanges();
+            }
+
+            auto state = loadEditFromFile (engine, snapshotFile.getFile(), ProjectItemID::createNewID (0));
+            journalFile.deleteFile();
+
+            expectEquals (state.getChildWithProperty (IDs::id, getAudioTracks (*edit)[0]->itemID.toVar())[IDs::name].toString(),
+                          juce::String ("Recovered"));
+            expect (state.getChildWithProperty (IDs::id, getAudioTracks (*edit).getLast()->itemID.toVar()).isValid());
+        }
+    }
+};
+
+static EditJournalTests editJournalTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
@@ -69,6 +69,8 @@ public:
         bool addAntiDenormalisationNoise = false;
         bool checkNodesForAudio = true;             /**< If true, attempting to render an Edit that doesn't produce audio will fail. */
         bool addAcidMetadata = false;
+        bool useStaticSchedule = false;             /**< If true, the graph is partitioned between threads once before rendering rather than scheduled every block.
+                                                         This reduces the per-block overhead for large renders. @see tracktion::graph::StaticScheduleNodePlayer */
 
         int quality = 0;
         juce::StringPairArray metadata;
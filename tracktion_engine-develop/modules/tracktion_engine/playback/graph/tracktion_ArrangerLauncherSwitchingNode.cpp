@@ -152,6 +152,7 @@ void ArrangerLauncherSwitchingNode::process (ProcessContext& pc)
                                             editBeatRange,
                                             getProcessState().getSyncPoint().monotonicBeat);
 
+    const bool wasFading = launcherSampleFader->isFading() || arrangerSampleFader->isFading();
     launcherSampleFader->apply (destAudioView, SampleFader::FadeType::fadeOut);
     arrangerSampleFader->apply (destAudioView, SampleFader::FadeType::fadeOut);
 
@@ -159,6 +160,12 @@ void ArrangerLauncherSwitchingNode::process (ProcessContext& pc)
 
      if (playArranger)
         processArranger (pc, slotStatus);
+
+    // If only a silent arranger is playing, pass that on so later Nodes can skip processing
+    if (playArranger && arrangerNode && ! wasFading
+        && ! (slotStatus.anyClipsPlaying || slotStatus.anyClipsQueued)
+        && arrangerNode->getProcessedOutput().audioContent == tracktion::graph::AudioContent::silent)
+        pc.buffers.audioContent = tracktion::graph::AudioContent::silent;
 }
 
 //==============================================================================
@@ -46,6 +46,11 @@ public:
         currentFadeFrameCountDown = numFramesToFade;
     }
 
+    bool isFading() const
+    {
+        return currentFadeFrameCountDown > 0 && numFramesToFade > 0;
+    }
+
     enum class FadeType
     {
         fadeOut,
@@ -304,6 +304,8 @@ void CombiningNode::process (ProcessContext& pc)
     pc.buffers.midi.mergeFromAndClear (noteOffEventsToSend);
 
     // Then process the list
+    bool hasProcessedAnyNodes = false;
+
     if (auto g = groups[combining_node_utils::timeToGroupIndex (getEditTimeRange().getStart())])
     {
         for (auto tan : *g)
@@ -319,10 +321,15 @@ void CombiningNode::process (ProcessContext& pc)
                 // Then process the buffer.
                 // This will use the local buffer for the Nodes in the TimedNode and put the result in pc.buffers
                 tan->process (pc);
+                hasProcessedAnyNodes = true;
             }
         }
     }
 
+    // If there are no clips at this time the cleared buffer can be marked as silent
+    if (! hasProcessedAnyNodes)
+        pc.buffers.audioContent = tracktion::graph::AudioContent::silent;
+
     if (pc.buffers.midi.size() > initialEvents)
         pc.buffers.midi.sortByTimestamp();
 }
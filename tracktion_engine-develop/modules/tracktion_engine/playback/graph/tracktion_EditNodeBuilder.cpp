@@ -18,6 +18,13 @@
 namespace tracktion { inline namespace engine
 {
 
+//==============================================================================
+/** The MIDI sequences generated for clips before their Nodes are built, keyed by clip ID. */
+struct PreparedMidiSequences
+{
+    std::map<EditItemID, std::vector<juce::MidiMessageSequence>> arrangerSequences, launcherSequences;
+};
+
 //==============================================================================
 //==============================================================================
 namespace
@@ -400,6 +407,44 @@ std::unique_ptr<tracktion::graph::Node> createFadeNodeForClip (AudioClipBase& cl
     return node;
 }
 
+/** While a time-stretched proxy is being generated, this plays the segments of it that have already been rendered. */
+std::unique_ptr<tracktion::graph::Node> createNodeForRenderedProxySegments (AudioClipBase& clip, EditItemID idToUse, TimeRange clipTime,
+                                                                            const CreateNodeParams& params)
+{
+    std::vector<std::unique_ptr<Node>> nodes;
+
+    for (auto& segment : clip.getRenderedProxySegments())
+    {
+        // Proxies start at the start of the clip so the segments are placed relative to that
+        const auto segmentTime = segment.range + toDuration (clipTime.getStart());
+        const auto editTime = segmentTime.getIntersectionWith (clipTime);
+
+        if (editTime.isEmpty())
+            continue;
+
+        // Each segment needs its own ID so its playback state is kept when the graph is rebuilt
+        auto segmentID = static_cast<size_t> (idToUse.getRawID());
+        hash_combine (segmentID, segment.hash);
+
+        nodes.push_back (tracktion::graph::makeNode<WaveNode> (segment.file,
+                                                               editTime,
+                                                               editTime.getStart() - segmentTime.getStart(),
+                                                               TimeRange(),
+                                                               clip.getLiveClipLevel(),
+                                                               1.0,
+                                                               clip.getActiveChannels(),
+                                                               juce::AudioChannelSet::canonicalChannelSet (std::max (2, clip.getActiveChannels().size())),
+                                                               params.processState,
+                                                               EditItemID::fromRawID (static_cast<uint64_t> (segmentID)),
+                                                               params.forRendering));
+    }
+
+    if (nodes.empty())
+        return {};
+
+    return std::make_unique<SummingNode> (std::move (nodes));
+}
+
 //==============================================================================
 std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& clip, EditItemID idToUse, EditTimeRange clipTimeRangeToUse,
                                                                 bool includeMelodyne, const CreateNodeParams& params, ClipRole role)
@@ -485,6 +530,14 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
                                                                   params.forRendering,
                                                                   desc);
         }
+        else if (clip.usesTimeStretchedProxy() && ! params.forRendering && ! playFile.getFile().existsAsFile())
+        {
+            node = createNodeForRenderedProxySegments (clip, idToUse, toTime (clipTimeRangeToUse, clip.edit.tempoSequence), params);
+
+            // Nothing can be played until the first segment has been rendered
+            if (! node)
+                return {};
+        }
         else
         {
             node = tracktion::graph::makeNode<WaveNode> (playFile,
@@ -648,21 +701,118 @@ std::unique_ptr<tracktion::graph::Node> createNodeForAudioClip (AudioClipBase& c
     return createNodeForAudioClip (clip, clip.itemID, clip.getEditTimeRange(), includeMelodyne, params, role);
 }
 
+MidiList::TimeBase getPlaybackTimeBase (const MidiClip& clip)
+{
+    return clip.canUseProxy() ? MidiList::TimeBase::seconds
+                              : MidiList::TimeBase::beatsRaw;
+}
+
+const MidiList& getPlaybackSequence (MidiClip& clip)
+{
+    return getPlaybackTimeBase (clip) == MidiList::TimeBase::seconds ? clip.getSequenceLooped()
+                                                                     : clip.getSequence();
+}
+
+/** Returns a hash of the things outside a clip's state that its playback sequences are created from.
+    Changes to the clip's state itself (its MidiList, quantisation, loop range etc.) invalidate
+    its PlaybackMidiSequenceCache directly.
+*/
+HashCode getPlaybackSequenceContextHash (const Clip& clip, ClipRole role, const GrooveTemplate* groove)
+{
+    auto h = hash (static_cast<size_t> (role), clip.edit.engine.getEngineBehaviour().lengthOfOneBeatDependsOnTimeSignature());
+    h = hash (h, clip.edit.tempoSequence.getInternalSequence().hash());
+
+    if (groove != nullptr)
+    {
+        h = hash (h, groove->isParameterized());
+        h = hash (h, groove->getNotesPerBeat());
+
+        for (int i = 0; i < groove->getNumberOfNotes(); ++i)
+            h = hash (h, groove->getLatenessProportion (i, 1.0f));
+    }
+
+    return static_cast<HashCode> (h);
+}
+
+std::vector<juce::MidiMessageSequence> createPlaybackSequences (MidiClip& clip, const MidiList& list, ClipRole role)
+{
+    auto createSequences = [&clip, &list]
+    {
+        std::vector<juce::MidiMessageSequence> sequences;
+        sequences.emplace_back (list.exportToPlaybackMidiSequence (clip, getPlaybackTimeBase (clip), clip.getMPEMode()));
+
+        return sequences;
+    };
+
+    // A limited set of events are only played temporarily so don't cache them
+    if (clip.getSelectedEvents() != nullptr)
+        return createSequences();
+
+    auto groove = clip.edit.engine.getGrooveTemplateManager().getTemplateByName (clip.getGrooveTemplate());
+
+    return clip.getPlaybackSequenceCache().getOrCreate (getPlaybackSequenceContextHash (clip, role, groove),
+                                                        createSequences);
+}
+
+std::vector<juce::MidiMessageSequence> createPlaybackSequences (StepClip& clip, ClipRole role)
+{
+    auto createSequences = [&clip, role]
+    {
+        std::vector<juce::MidiMessageSequence> sequences;
+
+        for (int i = clip.usesProbability() ? 64 : 1; --i >= 0;)
+        {
+            if (role == ClipRole::launcher)
+            {
+                sequences.push_back (clip.generateMidiSequence (MidiList::TimeBase::beatsRaw));
+            }
+            else
+            {
+                juce::MidiMessageSequence sequence;
+                clip.generateMidiSequence (sequence);
+                sequences.push_back (std::move (sequence));
+            }
+        }
+
+        return sequences;
+    };
+
+    return clip.getPlaybackSequenceCache().getOrCreate (getPlaybackSequenceContextHash (clip, role, nullptr),
+                                                        createSequences);
+}
+
+/** Returns the sequences generated for a clip by prepareMidiSequences, or an empty vector if there aren't any. */
+std::vector<juce::MidiMessageSequence> takePreparedSequences (Clip& clip, const CreateNodeParams& params, ClipRole role)
+{
+    if (auto prepared = params.preparedMidiSequences)
+    {
+        auto& sequences = role == ClipRole::launcher ? prepared->launcherSequences
+                                                     : prepared->arrangerSequences;
+
+        if (auto found = sequences.extract (clip.itemID))
+            return std::move (found.mapped());
+    }
+
+    return {};
+}
+
 std::unique_ptr<tracktion::graph::Node> createNodeForMidiClip (MidiClip& clip, const TrackMuteState& trackMuteState,
                                                                const CreateNodeParams& params, ClipRole role)
 {
     CRASH_TRACER
     const bool generateMPE = clip.getMPEMode();
-    const auto timeBase = clip.canUseProxy() ? MidiList::TimeBase::seconds
-                                             : MidiList::TimeBase::beatsRaw;
+    const auto timeBase = getPlaybackTimeBase (clip);
 
     const auto channels = generateMPE ? juce::Range<int> (2, 15)
                                       : juce::Range<int>::withStartAndLength (clip.getMidiChannel().getChannelNumber(), 1);
 
+    auto sequences = takePreparedSequences (clip, params, role);
+
+    if (sequences.empty())
+        sequences = createPlaybackSequences (clip, getPlaybackSequence (clip), role);
+
     if (timeBase == MidiList::TimeBase::beatsRaw)
     {
-        std::vector<juce::MidiMessageSequence> sequences;
-        sequences.emplace_back (clip.getSequence().exportToPlaybackMidiSequence (clip, timeBase, generateMPE));
         const auto clipBeatRange = role == ClipRole::launcher ? BeatRange (0_bp, BeatPosition::fromBeats (std::numeric_limits<double>::max()))
                                                               : BeatRange (clip.getStartBeat(), clip.getEndBeat());
 
@@ -692,9 +842,6 @@ std::unique_ptr<tracktion::graph::Node> createNodeForMidiClip (MidiClip& clip, c
     const auto clipTimeRange = clip.getEditTimeRange();
     const juce::Range<double> editTimeRange { clipTimeRange.getStart().inSeconds(), clipTimeRange.getEnd().inSeconds() };
 
-    std::vector<juce::MidiMessageSequence> sequences;
-    sequences.emplace_back (clip.getSequenceLooped().exportToPlaybackMidiSequence (clip, timeBase, generateMPE));
-
     return graph::makeNode<MidiNode> (std::move (sequences),
                                       timeBase,
                                       channels,
@@ -718,14 +865,13 @@ std::unique_ptr<tracktion::graph::Node> createNodeForStepClip (StepClip& clip, c
     CRASH_TRACER
 
     std::unique_ptr<tracktion::graph::Node> node;
+    auto sequences = takePreparedSequences (clip, params, role);
+
+    if (sequences.empty())
+        sequences = createPlaybackSequences (clip, role);
 
     if (role == ClipRole::launcher)
     {
-        std::vector<juce::MidiMessageSequence> sequences;
-
-        for (int i = clip.usesProbability() ? 64 : 1; --i >= 0;)
-            sequences.push_back (clip.generateMidiSequence (MidiList::TimeBase::beatsRaw));
-
         const auto clipBeatRange = BeatRange (0_bp, BeatPosition::fromBeats (std::numeric_limits<double>::max()));
         node = graph::makeNode<LoopingMidiNode> (std::move (sequences),
                                                  juce::Range<int> (1, 16),
@@ -749,15 +895,6 @@ std::unique_ptr<tracktion::graph::Node> createNodeForStepClip (StepClip& clip, c
     }
     else
     {
-        std::vector<juce::MidiMessageSequence> sequences;
-
-        for (int i = clip.usesProbability() ? 64 : 1; --i >= 0;)
-        {
-            juce::MidiMessageSequence sequence;
-            clip.generateMidiSequence (sequence);
-            sequences.push_back (sequence);
-        }
-
         const auto clipRange = clip.getEditTimeRange ();
         const juce::Range<double> editTimeRange (clipRange.getStart ().inSeconds (), clipRange.getEnd ().inSeconds ());
         node = graph::makeNode<MidiNode> (std::move (sequences),
@@ -1780,12 +1917,169 @@ std::unique_ptr<tracktion::graph::Node> createMasterFadeInOutNode (Edit& edit,
     return node;
 }
 
+//==============================================================================
+/** Calls a function for each index in parallel, sharing the work between the calling
+    thread and a ThreadPool. Returns once the function has been called for every index.
+*/
+void callInParallel (juce::ThreadPool& pool, size_t numItems, std::function<void (size_t)> fn)
+{
+    if (numItems == 0)
+        return;
+
+    // This is shared with the pool jobs as they might not start until the work is done
+    struct State
+    {
+        std::function<void (size_t)> fn;
+        size_t numItems = 0;
+        std::atomic<size_t> nextIndex { 0 }, numFinished { 0 };
+        juce::WaitableEvent finished;
+
+        void run()
+        {
+            for (;;)
+            {
+                const auto index = nextIndex++;
+
+                if (index >= numItems)
+                    return;
+
+                fn (index);
+
+                if (++numFinished == numItems)
+                    finished.signal();
+            }
+        }
+    };
+
+    auto state = std::make_shared<State>();
+    state->fn = std::move (fn);
+    state->numItems = numItems;
+
+    for (auto i = std::min (numItems - 1, (size_t) pool.getNumThreads()); i > 0; --i)
+        pool.addJob ([state] { state->run(); });
+
+    state->run();
+    state->finished.wait();
+}
+
+/** Generates the MIDI sequences for the clips of each top-level track on the params' ThreadPool.
+    Anything that has to happen on the message thread, like sorting the MidiLists, is done
+    first so the sequences can then be generated while the message thread waits.
+    The results are merged in track order so the same sequences are used whichever thread
+    created them.
+*/
+std::unique_ptr<PreparedMidiSequences> prepareMidiSequences (Edit& edit, const CreateNodeParams& params)
+{
+    CRASH_TRACER
+    TRACKTION_ASSERT_MESSAGE_THREAD
+    jassert (params.threadPool != nullptr);
+
+    struct ClipToPrepare
+    {
+        Clip* clip = nullptr;
+        ClipRole role = ClipRole::arranger;
+        const MidiList* list = nullptr;
+        std::vector<juce::MidiMessageSequence> sequences;
+    };
+
+    auto addClip = [&params] (std::vector<ClipToPrepare>& clips, Clip* clip, ClipRole role)
+    {
+        if (clip == nullptr || (params.allowedClips != nullptr && ! params.allowedClips->contains (clip)))
+            return;
+
+        if (auto mc = dynamic_cast<MidiClip*> (clip))
+        {
+            auto& list = getPlaybackSequence (*mc);
+            list.getNotes();
+            list.getControllerEvents();
+            list.getSysexEvents();
+
+            clips.push_back ({ clip, role, &list, {} });
+        }
+        else if (dynamic_cast<StepClip*> (clip) != nullptr)
+        {
+            clips.push_back ({ clip, role, nullptr, {} });
+        }
+    };
+
+    // Make sure these are up to date before they're used from the pool
+    edit.tempoSequence.getBpmAt (0_tp);
+    edit.engine.getGrooveTemplateManager();
+
+    std::vector<std::vector<ClipToPrepare>> clipsForTopLevelTracks;
+
+    for (auto topLevelTrack : getTopLevelTracks (edit))
+    {
+        auto tracks = topLevelTrack->getAllSubTracks (true);
+        tracks.insert (0, topLevelTrack);
+
+        std::vector<ClipToPrepare> clips;
+
+        for (auto t : tracks)
+        {
+            if (params.allowedTracks != nullptr && ! params.allowedTracks->contains (t))
+                continue;
+
+            if (auto at = dynamic_cast<AudioTrack*> (t))
+            {
+                if (! params.forRendering && at->isFrozen (Track::anyFreeze))
+                    continue;
+
+                for (auto clip : at->getClips())
+                    addClip (clips, clip, ClipRole::arranger);
+
+                if (params.allowClipSlots)
+                    for (auto slot : at->getClipSlotList().getClipSlots())
+                        addClip (clips, slot->getClip(), ClipRole::launcher);
+            }
+        }
+
+        if (! clips.empty())
+            clipsForTopLevelTracks.push_back (std::move (clips));
+    }
+
+    callInParallel (*params.threadPool, clipsForTopLevelTracks.size(),
+                    [&clipsForTopLevelTracks] (size_t index)
+                    {
+                        for (auto& c : clipsForTopLevelTracks[index])
+                        {
+                            if (c.list != nullptr)
+                                c.sequences = createPlaybackSequences (static_cast<MidiClip&> (*c.clip), *c.list, c.role);
+                            else
+                                c.sequences = createPlaybackSequences (static_cast<StepClip&> (*c.clip), c.role);
+                        }
+                    });
+
+    auto prepared = std::make_unique<PreparedMidiSequences>();
+
+    for (auto& clips : clipsForTopLevelTracks)
+    {
+        for (auto& c : clips)
+        {
+            auto& sequences = c.role == ClipRole::launcher ? prepared->launcherSequences
+                                                           : prepared->arrangerSequences;
+            sequences[c.clip->itemID] = std::move (c.sequences);
+        }
+    }
+
+    return prepared;
+}
+
 }
 
 //==============================================================================
-std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext& epc, std::atomic<double>& audibleTimeToUpdate, const CreateNodeParams& params)
+std::unique_ptr<tracktion::graph::Node> createNodeForEdit (EditPlaybackContext& epc, std::atomic<double>& audibleTimeToUpdate, const CreateNodeParams& originalParams)
 {
     Edit& edit = epc.edit;
+    auto params = originalParams;
+    std::unique_ptr<PreparedMidiSequences> preparedMidiSequences;
+
+    if (params.threadPool != nullptr)
+    {
+        preparedMidiSequences = prepareMidiSequences (edit, params);
+        params.preparedMidiSequences = preparedMidiSequences.get();
+    }
+
     auto& playHeadState = params.processState.playHeadState;
     auto insertPlugins = getAllPluginsOfType<InsertPlugin> (edit);
 
@@ -1945,6 +2239,14 @@ std::unique_ptr<tracktion::graph::Node> createNodeForEdit (Edit& edit, const Cre
     if (params.implicitlyIncludeSubmixChildTracks && params.allowedTracks != nullptr)
         *params.allowedTracks = addImplicitSubmixChildTracks (*params.allowedTracks);
 
+    std::unique_ptr<PreparedMidiSequences> preparedMidiSequences;
+
+    if (params.threadPool != nullptr)
+    {
+        preparedMidiSequences = prepareMidiSequences (edit, params);
+        params.preparedMidiSequences = preparedMidiSequences.get();
+    }
+
     for (auto t : getAllTracks (edit))
     {
         if (params.allowedTracks != nullptr && ! params.allowedTracks->contains (t))
@@ -14,6 +14,7 @@ namespace tracktion { inline namespace engine
 {
 
 class TrackMuteState;
+struct PreparedMidiSequences;
 
 //==============================================================================
 /**
@@ -34,6 +35,8 @@ struct CreateNodeParams
     bool implicitlyIncludeSubmixChildTracks = true;     /**< If true, child track in submixes will be included regardless of the allowedTracks param. Only relevent when forRendering is also true. */
     bool allowClipSlots = true;                         /**< If true, track's clip slots will be included, set to false to disable these (which will use a slightly more efficient Node). */
     bool readAheadTimeStretchNodes = false;             /**< TEMPORARY: If true, real-time time-stretch Nodes will use a larger buffer and background thread to reduce audio CPU use. */
+    juce::ThreadPool* threadPool = nullptr;             /**< If set, the MIDI sequences for each top-level track will be generated in parallel on this pool before the Nodes are built. */
+    PreparedMidiSequences* preparedMidiSequences = nullptr; /**< @internal */
 };
 
 //==============================================================================
@@ -50,11 +50,184 @@ public:
 
         runClipFade (ts, 3.0s, 2, false);
         runClipFade (ts, 3.0s, 2, true);
+
+        runParallelMidiSequences();
+        runPlaybackSequenceCaching();
     }
 
 private:
     //==============================================================================
     //==============================================================================
+    void runParallelMidiSequences()
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+        edit->ensureNumberOfAudioTracks (8);
+
+        beginTest ("Parallel MIDI sequence generation");
+        {
+            juce::Array<Clip*> clips;
+            const auto grooveNames = engine.getGrooveTemplateManager().getTemplateNames();
+
+            for (int t = 0; t < 8; ++t)
+            {
+                auto track = getAudioTracks (*edit)[t];
+
+                if (t == 7)
+                {
+                    auto sc = dynamic_cast<StepClip*> (insertNewClip (*track, TrackItem::Type::step, { 0_tp, 4_tp }));
+                    expect (sc != nullptr);
+
+                    for (int i = 0; i < 16; i += 3)
+                        sc->getPattern (0).setNote (0, i, true);
+
+                    clips.add (sc);
+                    continue;
+                }
+
+                auto mc = track->insertMIDIClip ({ 0_tp, 8_tp }, nullptr);
+
+                for (int i = 0; i < 64; ++i)
+                    mc->getSequence().addNote (36 + (i * 7 + t) % 48, BeatPosition::fromBeats (i * 0.25), 0.2_bd, 40 + i, 0, nullptr);
+
+                // Looped clips, quantisation and grooves are all applied when the sequences are generated
+                if (t % 2 == 1)
+                    mc->setLoopRangeBeats ({ 0_bp, 4_bp });
+
+                if (t % 3 == 1)
+                    mc->getQuantisation().setType ("1/16");
+
+                if (t % 3 == 2 && ! grooveNames.isEmpty())
+                    mc->setGrooveTemplate (grooveNames[t % grooveNames.size()]);
+
+                clips.add (mc.get());
+            }
+
+            auto clearCaches = [&clips]
+            {
+                for (auto c : clips)
+                {
+                    if (auto mc = dynamic_cast<MidiClip*> (c))
+                        mc->getPlaybackSequenceCache().clear();
+                    else if (auto sc = dynamic_cast<StepClip*> (c))
+                        sc->getPlaybackSequenceCache().clear();
+                }
+            };
+
+            // Generate the sequences one at a time on this thread
+            clearCaches();
+            std::map<EditItemID, std::vector<juce::MidiMessageSequence>> serialSequences;
+
+            for (auto c : clips)
+            {
+                if (auto mc = dynamic_cast<MidiClip*> (c))
+                    serialSequences[c->itemID] = createPlaybackSequences (*mc, getPlaybackSequence (*mc), ClipRole::arranger);
+                else if (auto sc = dynamic_cast<StepClip*> (c))
+                    serialSequences[c->itemID] = createPlaybackSequences (*sc, ClipRole::arranger);
+            }
+
+            // And then on the pool
+            clearCaches();
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState { playHead };
+            ProcessState processState { playHeadState, edit->tempoSequence };
+
+            juce::ThreadPool pool (4);
+            CreateNodeParams params { processState };
+            params.threadPool = &pool;
+            auto prepared = prepareMidiSequences (*edit, params);
+
+            expectEquals ((int) prepared->arrangerSequences.size(), clips.size());
+
+            for (auto c : clips)
+            {
+                auto& serial = serialSequences[c->itemID];
+                auto& parallel = prepared->arrangerSequences[c->itemID];
+                expectEquals (parallel.size(), serial.size());
+
+                for (size_t i = 0; i < std::min (parallel.size(), serial.size()); ++i)
+                {
+                    expectEquals (parallel[i].getNumEvents(), serial[i].getNumEvents());
+                    expectGreaterThan (serial[i].getNumEvents(), 0);
+
+                    for (int e = 0; e < std::min (parallel[i].getNumEvents(), serial[i].getNumEvents()); ++e)
+                    {
+                        auto& m1 = parallel[i].getEventPointer (e)->message;
+                        auto& m2 = serial[i].getEventPointer (e)->message;
+                        expectEquals (m1.getTimeStamp(), m2.getTimeStamp());
+                        expect (m1.getDescription() == m2.getDescription());
+                    }
+                }
+            }
+        }
+    }
+
+    void runPlaybackSequenceCaching()
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine);
+        auto& grooveManager = engine.getGrooveTemplateManager();
+
+        beginTest ("Playback MIDI sequence caching");
+        {
+            auto track = getAudioTracks (*edit)[0];
+            auto mc = track->insertMIDIClip ({ 0_tp, 8_tp }, nullptr);
+
+            for (int i = 0; i < 32; ++i)
+                mc->getSequence().addNote (48 + i % 12, BeatPosition::fromBeats (i * 0.25), 0.2_bd, 100, 0, nullptr);
+
+            auto getDescription = [&mc]
+            {
+                juce::String desc;
+
+                for (auto& sequence : createPlaybackSequences (*mc, getPlaybackSequence (*mc), ClipRole::arranger))
+                    for (auto e : sequence)
+                        desc << e->message.getTimeStamp() << " " << e->message.getDescription() << "\n";
+
+                return desc;
+            };
+
+            const auto original = getDescription();
+            expect (original.isNotEmpty());
+            expectEquals (getDescription(), original);
+
+            // Editing a note should invalidate the cache
+            mc->getSequence().getNotes()[0]->setNoteNumber (72, nullptr);
+            const auto afterNoteEdit = getDescription();
+            expect (afterNoteEdit != original);
+            expectEquals (getDescription(), afterNoteEdit);
+
+            // As should changing the tempo
+            edit->tempoSequence.getTempo (0)->setBpm (90.0);
+            edit->tempoSequence.updateTempoData();
+            const auto afterTempoEdit = getDescription();
+            expect (afterTempoEdit != afterNoteEdit);
+            expectEquals (getDescription(), afterTempoEdit);
+
+            // And the clip's groove or the groove template it uses
+            if (grooveManager.getNumTemplates() > 0)
+            {
+                mc->setGrooveTemplate (grooveManager.getTemplateName (0));
+                mc->setGrooveStrength (1.0f);
+                const auto afterGrooveChange = getDescription();
+                expect (afterGrooveChange != afterTempoEdit);
+                expectEquals (getDescription(), afterGrooveChange);
+
+                const GrooveTemplate originalGroove (*grooveManager.getTemplate (0));
+                GrooveTemplate newGroove (originalGroove);
+
+                for (int i = 0; i < newGroove.getNumberOfNotes(); ++i)
+                    newGroove.setLatenessProportion (i, originalGroove.getLatenessProportion (i, 1.0f) > 0.25f ? 0.0f : 0.5f, 1.0f);
+
+                grooveManager.updateTemplate (0, newGroove);
+                expect (getDescription() != afterGrooveChange);
+
+                grooveManager.updateTemplate (0, originalGroove);
+                expectEquals (getDescription(), afterGrooveChange);
+            }
+        }
+    }
+
     void runRackRendering (graph::test_utilities::TestSetup ts,
                            TimeDuration durationInSeconds,
                            int numChannels,
@@ -565,3 +738,138 @@ static EditNodeBuilderTests editNodeBuilderTests;
 #endif
 
 }} // namespace tracktion { inline namespace engine
+
+
+//==============================================================================
+//==============================================================================
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_EDITNODEBUILDER
+#include "../../../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h"
+#include "tracktion_BenchmarkUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class EditNodeBuilderBenchmarks : public juce::UnitTest
+{
+public:
+    EditNodeBuilderBenchmarks()
+        : juce::UnitTest ("Edit Node Builder", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (int numTracks : { 25, 50, 100, 250 })
+            runBuildBenchmark (numTracks);
+    }
+
+private:
+    BenchmarkDescription getDescription (std::string bmName)
+    {
+        const auto bmCategory = (getName() + "/" + getCategory()).toStdString();
+        const auto bmDescription = bmName;
+
+        return { std::hash<std::string>{} (bmName + bmCategory + bmDescription),
+                 bmCategory, bmName, bmDescription };
+    }
+
+    void runBuildBenchmark (int numTracks)
+    {
+        //- Create an Edit with a MIDI clip and a step clip on each track
+        //- Time how long the Node takes to build on the message thread and with a ThreadPool
+        //- Check both build the same number of Nodes
+        //- Time a rebuild after changing a single clip, which should reuse the other clips' sequences
+
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = test_utilities::createTestEdit (engine, numTracks);
+        juce::Random r (42);
+
+        for (auto at : getAudioTracks (*edit))
+        {
+            auto mc = at->insertMIDIClip ({ 0_tp, 60_tp }, nullptr);
+            const auto sequence = graph::test_utilities::createRandomMidiMessageSequence (60.0, r, { 0.031, 0.062 });
+            mc->getSequence().importMidiSequence (sequence, nullptr, 0s, nullptr);
+
+            at->insertNewClip (TrackItem::Type::step, { 60_tp, 68_tp }, nullptr);
+        }
+
+        beginTest ("Benchmark: Build " + juce::String (numTracks) + " tracks");
+        {
+            tracktion::graph::PlayHead playHead;
+            tracktion::graph::PlayHeadState playHeadState { playHead };
+            ProcessState processState { playHeadState, edit->tempoSequence };
+            CreateNodeParams cnp { processState, 44100.0, 256 };
+
+            const auto numTracksString = juce::String (numTracks).toStdString();
+            size_t numSerialNodes = 0, numParallelNodes = 0;
+
+            auto clearSequenceCaches = [&edit]
+            {
+                for (auto at : getAudioTracks (*edit))
+                {
+                    for (auto c : at->getClips())
+                    {
+                        if (auto mc = dynamic_cast<MidiClip*> (c))
+                            mc->getPlaybackSequenceCache().clear();
+                        else if (auto sc = dynamic_cast<StepClip*> (c))
+                            sc->getPlaybackSequenceCache().clear();
+                    }
+                }
+            };
+
+            {
+                clearSequenceCaches();
+                auto description = getDescription ("Build " + numTracksString + " tracks on message thread");
+                std::unique_ptr<graph::Node> node;
+
+                {
+                    const ScopedBenchmark sb (std::move (description));
+                    node = createNodeForEdit (*edit, cnp);
+                }
+
+                numSerialNodes = graph::getNodes (*node, graph::VertexOrdering::postordering).size();
+            }
+
+            {
+                clearSequenceCaches();
+                cnp.threadPool = &engine.getNodeBuilderThreadPool();
+                auto description = getDescription ("Build " + numTracksString + " tracks with ThreadPool");
+                std::unique_ptr<graph::Node> node;
+
+                {
+                    const ScopedBenchmark sb (std::move (description));
+                    node = createNodeForEdit (*edit, cnp);
+                }
+
+                numParallelNodes = graph::getNodes (*node, graph::VertexOrdering::postordering).size();
+            }
+
+            expectEquals (numParallelNodes, numSerialNodes);
+
+            {
+                // Only the changed clip's sequence should be created again
+                auto mc = dynamic_cast<MidiClip*> (getAudioTracks (*edit)[0]->getClips()[0]);
+                mc->getSequence().addNote (60, 1_bp, 1_bd, 100, 0, nullptr);
+
+                cnp.threadPool = nullptr;
+                auto description = getDescription ("Rebuild " + numTracksString + " tracks after changing one clip");
+                std::unique_ptr<graph::Node> node;
+
+                {
+                    const ScopedBenchmark sb (std::move (description));
+                    node = createNodeForEdit (*edit, cnp);
+                }
+
+                expectEquals (graph::getNodes (*node, graph::VertexOrdering::postordering).size(), numSerialNodes);
+            }
+        }
+    }
+};
+
+static EditNodeBuilderBenchmarks editNodeBuilderBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif
@@ -104,10 +104,13 @@ public:
             copyIfNotAliased (pc.buffers.audio, sourceBuffers.audio);
         }
 
+        pc.buffers.audioContent = sourceBuffers.audioContent;
+
         // If we have no latency, simply process the meter
         if (! latencyProcessor)
         {
-            processLevelMeasurer (meterPlugin.measurer, sourceBuffers.audio, pc.buffers.midi);
+            processLevelMeasurer (meterPlugin.measurer, sourceBuffers.audio, pc.buffers.midi,
+                                  sourceBuffers.audioContent == tracktion::graph::AudioContent::silent);
             return;
         }
 
@@ -123,7 +126,7 @@ public:
         latencyProcessor->readAudioOverwriting (tempBlock);
         latencyProcessor->readMIDI (tempMidiBuffer, (int) numFrames);
 
-        processLevelMeasurer (meterPlugin.measurer, tempBlock, tempMidiBuffer);
+        processLevelMeasurer (meterPlugin.measurer, tempBlock, tempMidiBuffer, false);
     }
 
 private:
@@ -145,10 +148,17 @@ private:
         isInitialised = true;
     }
 
-    void processLevelMeasurer (LevelMeasurer& measurer, choc::buffer::ChannelArrayView<float> block, MidiMessageArray& midi)
+    void processLevelMeasurer (LevelMeasurer& measurer, choc::buffer::ChannelArrayView<float> block, MidiMessageArray& midi, bool isSilent)
     {
-        auto buffer = tracktion::graph::toAudioBuffer (block);
-        measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        if (isSilent)
+        {
+            measurer.processSilentBuffer ((int) block.getNumChannels());
+        }
+        else
+        {
+            auto buffer = tracktion::graph::toAudioBuffer (block);
+            measurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        }
 
         measurer.setShowMidi (meterPlugin.showMidiActivity);
         measurer.processMidi (midi, nullptr);
@@ -26,6 +26,7 @@ void LevelMeasuringNode::process (tracktion::graph::Node::ProcessContext& pc)
 
     // Just pass out input on to our output
     setAudioOutput (input.get(), sourceBuffers.audio);
+    pc.buffers.audioContent = sourceBuffers.audioContent;
 
     // If the source only outputs to this node, we can steal its data
     if (input->numOutputNodes == 1)
@@ -36,8 +37,15 @@ void LevelMeasuringNode::process (tracktion::graph::Node::ProcessContext& pc)
     // Then update the levels
     if (sourceBuffers.audio.getNumChannels() > 0)
     {
-        auto buffer = tracktion::graph::toAudioBuffer (sourceBuffers.audio);
-        levelMeasurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        if (sourceBuffers.audioContent == tracktion::graph::AudioContent::silent)
+        {
+            levelMeasurer.processSilentBuffer ((int) sourceBuffers.audio.getNumChannels());
+        }
+        else
+        {
+            auto buffer = tracktion::graph::toAudioBuffer (sourceBuffers.audio);
+            levelMeasurer.processBuffer (buffer, 0, buffer.getNumSamples());
+        }
     }
 
     levelMeasurer.processMidi (pc.buffers.midi, nullptr);
@@ -68,6 +68,7 @@ void LiveMidiInjectingNode::process (ProcessContext& pc)
 
     destMidiBlock.copyFrom (sourceBuffers.midi);
     setAudioOutput (input.get(), sourceBuffers.audio);
+    pc.buffers.audioContent = sourceBuffers.audioContent;
 
     const juce::ScopedLock sl (liveMidiLock);
 
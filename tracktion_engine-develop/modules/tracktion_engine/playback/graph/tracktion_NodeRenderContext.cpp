@@ -32,6 +32,28 @@ namespace
         plugins.addArray (insideRacks);
         return plugins;
     }
+
+    static std::unique_ptr<TracktionNodePlayer> createNodePlayer (std::unique_ptr<tracktion::graph::Node> node, ProcessState& processState,
+                                                                  const Renderer::Parameters& r)
+    {
+        const auto numThreads = (size_t) r.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1;
+
+        if (r.useStaticSchedule)
+        {
+            // Set the threads first so the schedule is only compiled once
+            auto staticScheduleNodePlayer = std::make_unique<tracktion::graph::StaticScheduleNodePlayer>();
+            staticScheduleNodePlayer->setNumThreads (numThreads);
+            staticScheduleNodePlayer->setNode (std::move (node), r.sampleRateForAudio, r.blockSizeForAudio);
+
+            return std::make_unique<TracktionNodePlayer> (processState, std::move (staticScheduleNodePlayer));
+        }
+
+        auto nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (node), processState, r.sampleRateForAudio, r.blockSizeForAudio,
+                                                                 getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
+        nodePlayer->setNumThreads (numThreads);
+
+        return nodePlayer;
+    }
 }
 
 
@@ -57,9 +79,7 @@ NodeRenderContext::NodeRenderContext (Renderer::RenderTask& owner_, Renderer::Pa
     jassert (r.edit != nullptr);
     jassert (r.time.getLength() > 0.0s);
 
-    nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState, r.sampleRateForAudio, r.blockSizeForAudio,
-                                                        getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
-    nodePlayer->setNumThreads ((size_t) p.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+    nodePlayer = createNodePlayer (std::move (n), *processState, r);
 
     numLatencySamplesToDrop = nodePlayer->getNode()->getNodeProperties().latencyNumSamples;
     r.time = r.time.withEnd (r.time.getEnd() + TimeDuration::fromSamples (numLatencySamplesToDrop, r.sampleRateForAudio));
@@ -378,15 +398,11 @@ juce::String NodeRenderContext::renderMidi (Renderer::RenderTask& owner,
     std::unique_ptr<TracktionNodePlayer> nodePlayer;
     callBlocking ([&]
                   {
-                      nodePlayer = std::make_unique<TracktionNodePlayer> (std::move (n), *processState,
-                                                                          sampleRate, samplesPerBlock,
-                                                                          getPoolCreatorFunction (static_cast<tracktion::graph::ThreadPoolStrategy> (EditPlaybackContext::getThreadPoolStrategy())));
+                      nodePlayer = createNodePlayer (std::move (n), *processState, r);
                   });
     // Ensure the node player gets deleted on the message thread
     const juce::ErasedScopeGuard scope ([&nodePlayer] { callBlocking ([&] { nodePlayer.reset(); }); });
 
-    nodePlayer->setNumThreads ((size_t) r.engine->getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
-
     //TODO: Should really purge any non-MIDI nodes here then return if no MIDI has been found
 
     playHead->stop();
@@ -81,6 +81,20 @@ tracktion::graph::NodeProperties PluginNode::getNodeProperties()
     return props;
 }
 
+size_t PluginNode::getStateHash()
+{
+    size_t stateHash = 0;
+    hash_combine (stateHash, plugin->itemID.getRawID());
+    hash_combine (stateHash, sampleRate);
+    hash_combine (stateHash, latencyNumSamples);
+    hash_combine (stateHash, maxNumChannels);
+    hash_combine (stateHash, balanceLatency);
+    hash_combine (stateHash, isRendering);
+    hash_combine (stateHash, shouldUseFineGrainAutomation (*plugin));
+
+    return stateHash;
+}
+
 void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo& info)
 {
     juce::ignoreUnused (info);
@@ -111,6 +125,7 @@ void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationIn
         }
     }
 
+    updateSilentInputSkipping();
     isPrepared = true;
 
     if (info.enableNodeMemorySharing && input->numOutputNodes == 1)
@@ -127,6 +142,29 @@ void PluginNode::prepareToPlay (const tracktion::graph::PlaybackInitialisationIn
     }
 }
 
+bool PluginNode::transferPreparedState (Node& oldNode, const tracktion::graph::PlaybackInitialisationInfo&)
+{
+    auto& oldPluginNode = static_cast<PluginNode&> (oldNode);
+
+    if (oldPluginNode.plugin != plugin || ! oldPluginNode.isPrepared)
+        return false;
+
+    jassert (! isPrepared);
+    automationAdjustmentTime = oldPluginNode.automationAdjustmentTime;
+    subBlockSizeToUse = oldPluginNode.subBlockSizeToUse;
+    canProcessBypassed = oldPluginNode.canProcessBypassed;
+    latencyProcessor = oldPluginNode.latencyProcessor;
+    canUseSourceBuffers = oldPluginNode.canUseSourceBuffers;
+    updateSilentInputSkipping();
+
+    // The state hash includes these properties so the old Node's are still valid and the
+    // plugin doesn't need to be queried for them again
+    cachedNodeProperties = oldPluginNode.cachedNodeProperties;
+    isPrepared = true;
+
+    return true;
+}
+
 void PluginNode::prefetchBlock (juce::Range<int64_t>)
 {
     plugin->prepareForNextBlock (getEditTimeRange().getStart());
@@ -151,6 +189,9 @@ void PluginNode::process (ProcessContext& pc)
     const auto numInputChannelsToCopy = std::min (inputAudioBlock.getNumChannels(),
                                                   outputAudioView.getNumChannels());
 
+    if (processSilentInput (inputBuffers, pc))
+        return;
+
     if (latencyProcessor)
     {
         if (numInputChannelsToCopy > 0)
@@ -289,6 +330,49 @@ PluginRenderContext PluginNode::getPluginRenderContext (TimeRange editTime, juce
              isRendering, canProcessBypassed };
 }
 
+void PluginNode::updateSilentInputSkipping()
+{
+    // Plugins that produce audio on their own or balance latency when bypassed always need processing
+    canSkipSilentInput = plugin->hasKnownTailLength()
+                          && ! plugin->producesAudioWhenNoAudioInput()
+                          && latencyProcessor == nullptr;
+
+    numTailSamples = (choc::buffer::FrameCount) (latencyNumSamples + juce::roundToInt (plugin->getTailLength() * sampleRate));
+    numSilentInputSamples = 0;
+}
+
+bool PluginNode::processSilentInput (const Node::AudioAndMidiBuffer& inputBuffers, ProcessContext& pc)
+{
+    if (! canSkipSilentInput)
+        return false;
+
+    if (inputBuffers.audioContent != tracktion::graph::AudioContent::silent
+        || ! inputBuffers.midi.isEmpty() || inputBuffers.midi.isAllNotesOff
+        || playHeadState.didPlayheadJump())
+    {
+        numSilentInputSamples = 0;
+        return false;
+    }
+
+    // Keep processing until the plugin's tail has been output
+    const bool hasTailEnded = numSilentInputSamples >= numTailSamples;
+    numSilentInputSamples = std::min (numTailSamples, numSilentInputSamples + pc.numSamples);
+
+    if (! hasTailEnded)
+        return false;
+
+    pc.buffers.audio.clear();
+    pc.buffers.midi.clear();
+    pc.buffers.audioContent = tracktion::graph::AudioContent::silent;
+
+    // The plugin isn't processed but its parameters should still follow their automation
+    auto outputAudioBuffer = toAudioBuffer (pc.buffers.audio);
+    midiMessageArray.clear();
+    plugin->updateAutomationWithoutProcessing (getPluginRenderContext (getEditTimeRange(), outputAudioBuffer));
+
+    return true;
+}
+
 void PluginNode::replaceLatencyProcessorIfPossible (NodeGraph* nodeGraphToReplace)
 {
     if (nodeGraphToReplace == nullptr)
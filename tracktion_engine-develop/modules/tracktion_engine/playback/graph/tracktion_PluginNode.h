@@ -52,7 +52,9 @@ public:
     tracktion::graph::NodeProperties getNodeProperties() override;
     std::vector<Node*> getDirectInputNodes() override   { return { input.get() }; }
     bool isReadyToProcess() override                    { return input->hasProcessed(); }
+    size_t getStateHash() override;
     void prepareToPlay (const tracktion::graph::PlaybackInitialisationInfo&) override;
+    bool transferPreparedState (Node&, const tracktion::graph::PlaybackInitialisationInfo&) override;
     void prefetchBlock (juce::Range<int64_t>) override;
     void preProcess (choc::buffer::FrameCount, juce::Range<int64_t>) override;
     void process (ProcessContext&) override;
@@ -78,10 +80,15 @@ private:
     std::optional<NodeProperties> cachedNodeProperties;
     bool isPrepared = false, canUseSourceBuffers = false;
 
+    bool canSkipSilentInput = false;
+    choc::buffer::FrameCount numTailSamples = 0, numSilentInputSamples = 0;
+
     //==============================================================================
     void initialisePlugin (double sampleRateToUse, int blockSizeToUse);
     PluginRenderContext getPluginRenderContext (TimeRange, juce::AudioBuffer<float>&);
     void replaceLatencyProcessorIfPossible (NodeGraph*);
+    void updateSilentInputSkipping();
+    bool processSilentInput (const Node::AudioAndMidiBuffer& input, ProcessContext&);
 };
 
 }} // namespace tracktion { inline namespace engine
@@ -0,0 +1,103 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+#include <tracktion_engine/../tracktion_graph/tracktion_graph/tracktion_TestUtilities.h>
+#include <tracktion_engine/testing/tracktion_EnginePlayer.h>
+
+namespace tracktion::inline engine
+{
+
+#if GRAPH_UNIT_TESTS_PLUGINNODE
+    //==============================================================================
+    /** Counts the blocks it's asked to process and opts in to being skipped for silent input. */
+    class BlockCountingTestPlugin  : public Plugin
+    {
+    public:
+        BlockCountingTestPlugin (PluginCreationInfo info)
+            : Plugin (info)
+        {
+            gain = addParam ("gain", TRANS("Gain"), { 0.0f, 1.0f });
+        }
+
+        ~BlockCountingTestPlugin() override
+        {
+            notifyListenersOfDeletion();
+        }
+
+        static const char* getPluginName()                      { return NEEDS_TRANS("Block Counter"); }
+        static inline const char* xmlTypeName = "blockCountingTest";
+        static juce::ValueTree create()                         { return createValueTree (IDs::PLUGIN, IDs::type, xmlTypeName); }
+
+        juce::String getName() const override                   { return getPluginName(); }
+        juce::String getPluginType() override                   { return xmlTypeName; }
+        juce::String getSelectableDescription() override        { return getName(); }
+        bool needsConstantBufferSize() override                 { return false; }
+
+        void initialise (const PluginInitialisationInfo&) override {}
+        void deinitialise() override {}
+        void applyToBuffer (const PluginRenderContext&) override    { ++numBlocksProcessed; }
+
+        bool producesAudioWhenNoAudioInput() override           { return false; }
+        bool hasKnownTailLength() const override                { return true; }
+
+        AutomatableParameter::Ptr gain;
+        std::atomic<int> numBlocksProcessed { 0 };
+    };
+
+    TEST_SUITE ("tracktion_engine")
+    {
+        TEST_CASE ("PluginNode: Silent input skipping")
+        {
+            HostedAudioDeviceInterface::Parameters p;
+            auto& engine = *Engine::getEngines()[0];
+            engine.getPluginManager().createBuiltInType<BlockCountingTestPlugin>();
+
+            auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+            auto track = getAudioTracks (*edit)[0];
+
+            // Half a second of audio followed by silence
+            auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (p.sampleRate, 0.5);
+            const AudioFile af (engine, sinFile->getFile());
+            insertWaveClip (*track, {}, sinFile->getFile(), { { 0_tp, 0.5_tp } }, DeleteExistingClips::no);
+
+            auto plugin = insertNewPlugin<BlockCountingTestPlugin> (*track);
+            REQUIRE (plugin);
+
+            // A ramp that keeps changing whilst the input is silent
+            auto& curve = plugin->gain->getCurve();
+            curve.addPoint (0_tp, 0.0f, 0.0f);
+            curve.addPoint (16_tp, 1.0f, 0.0f);
+            plugin->gain->updateStream();
+
+            // Clips carry on being processed for 8 beats after they end to let their tails decay,
+            // so this is long enough for the track's output to have become silent
+            auto player = test_utilities::createEnginePlayer (*edit, p, { af });
+            player->process (toSamples (10_td, p.sampleRate));
+
+            CHECK (plugin->numBlocksProcessed > 0);
+
+            // The automation should have been applied throughout
+            CHECK_EQ (plugin->gain->getCurrentValue(), doctest::Approx (0.625f).epsilon (0.02));
+
+            // Once the input is silent the plugin shouldn't be processed, but its automation should continue
+            const auto numBlocksBefore = plugin->numBlocksProcessed.load();
+            player->process (toSamples (4_td, p.sampleRate));
+
+            CHECK_EQ (plugin->numBlocksProcessed.load(), numBlocksBefore);
+            CHECK_EQ (plugin->gain->getCurrentValue(), doctest::Approx (0.875f).epsilon (0.02));
+        }
+    }
+#endif
+
+} // namespace tracktion::inline engine
+
+#endif //TRACKTION_UNIT_TESTS
@@ -35,6 +35,8 @@ public:
         auto& engine = *tracktion::engine::Engine::getEngines()[0];
         runNodePreparationBenchmarks (engine);
         runLargeGraphUpdateBenchmark (engine);
+        runGraphHotSwapBenchmark (engine);
+        runFourOscVoiceBenchmark (engine);
     }
 
 private:
@@ -149,6 +151,149 @@ private:
             }
         }
     }
+
+    void runGraphHotSwapBenchmark (Engine& engine)
+    {
+        constexpr int trackCount = 200;
+        auto edit = Edit::createSingleTrackEdit (engine);
+
+        for (int trackIndex = 0; trackIndex < trackCount; ++trackIndex)
+        {
+            auto audioTrack = edit->insertNewAudioTrack (TrackInsertPoint { nullptr, nullptr }, nullptr);
+
+            for (auto pluginType : { VolumeAndPanPlugin::xmlTypeName, VolumeAndPanPlugin::xmlTypeName })
+            {
+                auto plugin = edit->getPluginCache().createNewPlugin (pluginType, {});
+                jassert (plugin.get() != nullptr);
+                audioTrack->pluginList.insertPlugin (plugin, -1, nullptr);
+            }
+        }
+
+        tracktion::graph::PlayHead playHead;
+        tracktion::graph::PlayHeadState playHeadState { playHead };
+        ProcessState processState { playHeadState, edit->tempoSequence };
+        CreateNodeParams cnp { processState, 44100.0, 256 };
+
+        auto oldGraph = node_player_utils::prepareToPlay (createNodeForEdit (*edit, cnp), nullptr,
+                                                          cnp.sampleRate, cnp.blockSize);
+
+        // Swaps in a rebuilt graph for the same Edit, both from scratch and replacing the
+        // previous graph so unchanged Nodes can take over its prepared state
+        for (bool replacing : { false, true })
+        {
+            const auto description = juce::String ("Swapping 123 tracks, XXYY")
+                                        .replace ("123", juce::String (trackCount))
+                                        .replace ("XXYY", replacing ? "replacing" : "non-replacing");
+            beginTest (description);
+
+            auto editNode = createNodeForEdit (*edit, cnp);
+            std::unique_ptr<NodeGraph> newGraph;
+            Benchmark benchmark (createBenchmarkDescription ("Node Preparation",
+                                                             "Graph hot-swap: latency",
+                                                             description.toStdString()));
+
+            {
+                const ScopedMeasurement sm (benchmark);
+                newGraph = node_player_utils::prepareToPlay (std::move (editNode), replacing ? oldGraph.get() : nullptr,
+                                                             cnp.sampleRate, cnp.blockSize);
+            }
+
+            size_t numReusedNodes = 0, numBytesAllocated = 0;
+
+            for (auto node : newGraph->orderedNodes)
+            {
+                numBytesAllocated += node->getAllocatedBytes();
+
+                if (node->hasReusedPreparedState())
+                    ++numReusedNodes;
+            }
+
+            // The allocated size isn't a time so it goes in the description, after the
+            // hash has been created so results can still be compared over time
+            auto result = benchmark.getResult();
+            result.description.description += ", " + std::to_string (numBytesAllocated) + " bytes allocated, "
+                                                + std::to_string (numReusedNodes) + " nodes reused";
+            BenchmarkList::getInstance().addResult (result);
+
+            logMessage ("Reused " + juce::String (numReusedNodes) + " of " + juce::String (newGraph->orderedNodes.size()) + " nodes, "
+                        + juce::File::descriptionOfSizeInBytes ((int64_t) numBytesAllocated) + " allocated by all nodes");
+
+            if (replacing)
+                expect (numReusedNodes > 0, "No nodes were reused when replacing the graph");
+            else
+                expectEquals ((int) numReusedNodes, 0);
+
+            if (replacing)
+                oldGraph = std::move (newGraph);
+        }
+    }
+
+    void runFourOscVoiceBenchmark (Engine& engine)
+    {
+        constexpr int numNotes = 32, blockSize = 512, numBlocks = 200;
+        constexpr double sampleRate = 44100.0;
+        auto edit = Edit::createSingleTrackEdit (engine);
+
+        // Renders 32 notes with 4 unison voices on each oscillator and a 24dB filter
+        auto render = [&] (bool batched)
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (FourOscPlugin::xmlTypeName, {});
+            auto synth = dynamic_cast<FourOscPlugin*> (plugin.get());
+            jassert (synth != nullptr);
+
+            synth->voiceModeValue = 2;
+            synth->voicesValue = numNotes;
+            synth->filterTypeValue = 1;
+            synth->filterSlopeValue = 24;
+
+            for (int i = 0; i < synth->oscParams.size(); ++i)
+            {
+                synth->oscParams[i]->waveShapeValue = i + 1;
+                synth->oscParams[i]->voicesValue = 4;
+                synth->oscParams[i]->detuneValue = 0.2f;
+                synth->oscParams[i]->spreadValue = 50.0f;
+            }
+
+            synth->setVoiceBatchingEnabled (batched);
+            synth->setRandomSeed (1);
+            synth->baseClassInitialise ({ 0s, sampleRate, blockSize });
+
+            MidiMessageArray midi;
+
+            for (int i = 0; i < numNotes; ++i)
+                midi.addMidiMessage (juce::MidiMessage::noteOn (1, 36 + i, (juce::uint8) (64 + i)), 0.0,
+                                     MidiMessageArray::createUniqueMPESourceID());
+
+            juce::AudioBuffer<float> output (2, blockSize * numBlocks);
+            output.clear();
+
+            {
+                const ScopedBenchmark sb (createBenchmarkDescription ("Plugins",
+                                                                      "4OSC voice rendering",
+                                                                      juce::String ("Rendering 123 notes, XXYY")
+                                                                        .replace ("123", juce::String (numNotes))
+                                                                        .replace ("XXYY", batched ? "batched" : "one voice at a time").toStdString()));
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    const auto start = TimePosition::fromSamples (block * blockSize, sampleRate);
+                    const auto end = TimePosition::fromSamples ((block + 1) * blockSize, sampleRate);
+                    PluginRenderContext rc (&output, juce::AudioChannelSet::stereo(), block * blockSize, blockSize,
+                                            &midi, 0.0, { start, end }, true, false, false, false);
+                    synth->applyToBuffer (rc);
+                    midi.clear();
+                }
+            }
+
+            synth->baseClassDeinitialise();
+            return output;
+        };
+
+        // The outputs are compared in the FourOscPlugin unit tests
+        beginTest ("4OSC voice batching");
+        render (false);
+        render (true);
+    }
 };
 
 static PluginNodeBenchmarks pluginNodeBenchmarks;
@@ -56,8 +56,12 @@ void SharedLevelMeasuringNode::process (ProcessContext& pc)
 
     setAudioOutput (input.get(), sourceBuffers.audio);
     pc.buffers.midi.copyFrom (sourceBuffers.midi);
+    pc.buffers.audioContent = sourceBuffers.audioContent;
+
+    // And pass audio to level measurer, silence won't change the sum so can be skipped
+    if (sourceBuffers.audioContent == tracktion::graph::AudioContent::silent)
+        return;
 
-    // And pass audio to level measurer
     auto buffer = tracktion::graph::toAudioBuffer (sourceBuffers.audio);
     levelMeasurer->addBuffer (buffer, 0, buffer.getNumSamples());
 }
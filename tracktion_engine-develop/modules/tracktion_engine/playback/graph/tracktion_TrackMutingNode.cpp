@@ -157,14 +157,20 @@ void TrackMutingNode::process (ProcessContext& pc)
         // If we've just been muted/unmuted we need to copy the data to
         // apply a fade to, otherwise we can just pass on the view
         if (wasJustMuted || wasJustUnMuted)
+        {
             copyIfNotAliased (destAudioView, sourceBuffers.audio);
+        }
         else
+        {
             setAudioOutput (input.get(), sourceBuffers.audio);
+            pc.buffers.audioContent = sourceBuffers.audioContent;
+        }
     }
     else
     {
         destAudioView.clear();
         pc.buffers.midi.clear();
+        pc.buffers.audioContent = tracktion::graph::AudioContent::silent;
     }
 
     if (wasJustMuted)
@@ -49,33 +49,47 @@ public:
         nodePlayer.setNode (std::move (node), sampleRate, blockSize);
     }
 
+    /** Creates an NodePlayer that processes its Node using a compiled, static schedule.
+        This avoids most of the per-block scheduling overhead so is better suited to offline
+        renders where the graph doesn't change.
+        @see tracktion::graph::StaticScheduleNodePlayer
+    */
+    TracktionNodePlayer (ProcessState& processStateToUse,
+                         std::unique_ptr<tracktion::graph::StaticScheduleNodePlayer> staticScheduleNodePlayerToUse)
+        : playHeadState (processStateToUse.playHeadState),
+          processState (processStateToUse),
+          staticScheduleNodePlayer (std::move (staticScheduleNodePlayerToUse))
+    {
+        jassert (staticScheduleNodePlayer != nullptr);
+    }
+
     /** Sets the number of threads to use for rendering.
         This can be 0 in which case only the process calling thread will be used for processing.
         N.B. this will pause processing whilst updating the threads so there will be a gap in the audio.
     */
     void setNumThreads (size_t numThreads)
     {
-        nodePlayer.setNumThreads (numThreads);
+        withNodePlayer ([&] (auto& player) { player.setNumThreads (numThreads); });
     }
 
     tracktion::graph::Node* getNode()
     {
-        return nodePlayer.getNode();
+        return withNodePlayer ([] (auto& player) { return player.getNode(); });
     }
 
     void setNode (std::unique_ptr<tracktion::graph::Node> newNode)
     {
-        nodePlayer.setNode (std::move (newNode));
+        withNodePlayer ([&] (auto& player) { player.setNode (std::move (newNode)); });
     }
 
     void setNode (std::unique_ptr<tracktion::graph::Node> newNode, double sampleRateToUse, int blockSizeToUse)
     {
-        nodePlayer.setNode (std::move (newNode), sampleRateToUse, blockSizeToUse);
+        withNodePlayer ([&] (auto& player) { player.setNode (std::move (newNode), sampleRateToUse, blockSizeToUse); });
     }
 
     void prepareToPlay (double sampleRateToUse, int blockSizeToUse)
     {
-        nodePlayer.prepareToPlay (sampleRateToUse, blockSizeToUse);
+        withNodePlayer ([&] (auto& player) { player.prepareToPlay (sampleRateToUse, blockSizeToUse); });
     }
 
     /** Processes a block of audio and MIDI data.
@@ -107,13 +121,14 @@ public:
     /** Clears the Node currently playing. */
     void clearNode()
     {
-        nodePlayer.clearNode();
+        withNodePlayer ([] (auto& player) { player.clearNode(); });
     }
 
     /** Returns the current sample rate. */
     double getSampleRate() const
     {
-        return nodePlayer.getSampleRate();
+        return staticScheduleNodePlayer != nullptr ? staticScheduleNodePlayer->getSampleRate()
+                                                   : nodePlayer.getSampleRate();
     }
 
     /** @internal */
@@ -128,11 +143,45 @@ public:
         nodePlayer.enableNodeMemorySharing (enableNodeMemorySharing);
     }
 
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableNodePrioritisation */
+    void enableNodePrioritisation (bool enableNodePrioritisation)
+    {
+        nodePlayer.enableNodePrioritisation (enableNodePrioritisation);
+    }
+
+    /** @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableAdaptiveThreading */
+    void enableAdaptiveThreading (bool enableAdaptiveThreading)
+    {
+        nodePlayer.enableAdaptiveThreading (enableAdaptiveThreading);
+    }
+
+    /** @see tracktion::graph::NodeProcessTracer */
+    void setNodeProcessTracer (tracktion::graph::NodeProcessTracer* tracer)
+    {
+        withNodePlayer ([&] (auto& player) { player.setNodeProcessTracer (tracer); });
+    }
+
+    /** @see tracktion::graph::ThreadAffinity */
+    void setThreadAffinity (tracktion::graph::ThreadAffinity affinity)
+    {
+        withNodePlayer ([&] (auto& player) { player.setThreadAffinity (std::move (affinity)); });
+    }
+
 private:
     tracktion::graph::PlayHeadState& playHeadState;
     ProcessState& processState;
     MidiMessageArray scratchMidi;
     tracktion::graph::LockFreeMultiThreadedNodePlayer nodePlayer;
+    std::unique_ptr<tracktion::graph::StaticScheduleNodePlayer> staticScheduleNodePlayer;
+
+    template<typename Function>
+    auto withNodePlayer (Function&& f) -> decltype (f (nodePlayer))
+    {
+        if (staticScheduleNodePlayer != nullptr)
+            return f (*staticScheduleNodePlayer);
+
+        return f (nodePlayer);
+    }
 
     tracktion::graph::Node::ProcessContext getSubProcessContext (const tracktion::graph::Node::ProcessContext& pc, juce::Range<int64_t> subReferenceSampleRange)
     {
@@ -162,7 +211,7 @@ private:
         int numMisses = 0;
         playHeadState.playHead.setReferenceSampleRange (pc.referenceSampleRange);
 
-        const auto sampleRate = nodePlayer.getSampleRate();
+        const auto sampleRate = getSampleRate();
         processState.update (sampleRate, pc.referenceSampleRange, ProcessState::UpdateContinuityFlags::no);
         const auto timeRange = processState.editTimeRange;
 
@@ -210,7 +259,7 @@ private:
         assert (pc.numSamples > 0);
         assert (proportion.getStart() >= 0.0);
         assert (proportion.getEnd() <= 1.0);
-        const auto sampleRate = nodePlayer.getSampleRate();
+        const auto sampleRate = getSampleRate();
 
         const auto startReferenceSample = pc.referenceSampleRange.getStart() + (int64_t) std::llround (proportion.getStart() * pc.referenceSampleRange.getLength());
         const auto endReferenceSample   = pc.referenceSampleRange.getStart() + (int64_t) std::llround (proportion.getEnd() * pc.referenceSampleRange.getLength());
@@ -228,7 +277,7 @@ private:
 
         tracktion::graph::Node::ProcessContext pc2 { sampleRange.size(), referenceRange, { destAudio, scratchMidi } };
         processState.update (sampleRate, referenceRange, ProcessState::UpdateContinuityFlags::yes);
-        const auto numMisses = nodePlayer.process (pc2);
+        const auto numMisses = withNodePlayer ([&] (auto& player) { return player.process (pc2); });
 
         // Merge back MIDI from end of block
         const auto offset = TimeDuration::fromSamples (startReferenceSample - pc.referenceSampleRange.getStart(), sampleRate);
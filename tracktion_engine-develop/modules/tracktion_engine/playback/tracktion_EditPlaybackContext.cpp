@@ -33,6 +33,18 @@ namespace EditPlaybackContextInternal
         return useSharing;
     }
 
+    inline bool& getNodePrioritisationFlag()
+    {
+        static bool usePrioritisation = false;
+        return usePrioritisation;
+    }
+
+    inline bool& getAdaptiveThreadingFlag()
+    {
+        static bool useAdaptiveThreading = false;
+        return useAdaptiveThreading;
+    }
+
     inline bool& getAudioWorkgroupFlag()
     {
         static bool useAudioWorkgroup = false;
@@ -187,9 +199,12 @@ private:
                 #endif
              };
 
+         updateThreadAffinity();
          setNumThreads (numThreads);
          player.enablePooledMemoryAllocations (EditPlaybackContextInternal::getPooledMemoryFlag());
          player.enableNodeMemorySharing (EditPlaybackContextInternal::getNodeMemorySharingFlag());
+         player.enableNodePrioritisation (EditPlaybackContextInternal::getNodePrioritisationFlag());
+         player.enableAdaptiveThreading (EditPlaybackContextInternal::getAdaptiveThreadingFlag());
      }
 
      void setNumThreads (size_t numThreads)
@@ -198,6 +213,15 @@ private:
          player.setNumThreads (std::min (numThreads, maxNumThreads));
      }
 
+     void updateThreadAffinity()
+     {
+         auto& behaviour = editPlaybackContext.edit.engine.getEngineBehaviour();
+         tracktion::graph::ThreadAffinity affinity;
+         affinity.processThreadCPUs = behaviour.getCPUsForAudioCallbackThread();
+         affinity.workerCPUs = behaviour.getCPUsForAudioWorkerThreads();
+         player.setThreadAffinity (std::move (affinity));
+     }
+
      void setNode (std::unique_ptr<Node> node, double sampleRate, int blockSize)
      {
          jassert (sampleRate > 0.0);
@@ -214,6 +238,11 @@ private:
          player.clearNode();
      }
 
+     void setNodeProcessTracer (tracktion::graph::NodeProcessTracer* tracer)
+     {
+         player.setNodeProcessTracer (tracer);
+     }
+
      int getLatencySamples() const
      {
          return latencySamples;
@@ -667,6 +696,10 @@ void EditPlaybackContext::createNode()
     cnp.includeBypassedPlugins = ! engineBehaviour.shouldBypassedPluginsBeRemovedFromPlaybackGraph();
     cnp.allowClipSlots = engineBehaviour.areClipSlotsEnabled();
     cnp.readAheadTimeStretchNodes = engineBehaviour.enableReadAheadForTimeStretchNodes();
+
+    if (engineBehaviour.buildPlaybackGraphInParallel())
+        cnp.threadPool = &edit.engine.getNodeBuilderThreadPool();
+
     auto editNode = createNodeForEdit (*this, audiblePlaybackTime, cnp);
 
     nodePlaybackContext->setNode (std::move (editNode), cnp.sampleRate, cnp.blockSize);
@@ -933,6 +966,8 @@ void EditPlaybackContext::nextBlockStarted()
 
 void EditPlaybackContext::fillNextNodeBlock (float* const* allChannels, int numChannels, int numSamples)
 {
+    const PlaybackTelemetry::ScopedBlock telemetryBlock (telemetry, numSamples, nodePlaybackContext->getSampleRate(),
+                                                         edit.engine.getAudioFileManager().cache);
     nodePlaybackContext->updateReferenceSampleRange (numSamples);
 
     // Sync this playback context with a master context
@@ -1044,6 +1079,18 @@ tracktion::graph::PlayHead* EditPlaybackContext::getNodePlayHead() const
                                : nullptr;
 }
 
+void EditPlaybackContext::setNodeProcessTracer (tracktion::graph::NodeProcessTracer* tracer)
+{
+    if (nodePlaybackContext)
+        nodePlaybackContext->setNodeProcessTracer (tracer);
+}
+
+void EditPlaybackContext::enableTelemetryNodeBreakdown (bool shouldBeEnabled)
+{
+    telemetry.enableNodeBreakdown (shouldBeEnabled);
+    setNodeProcessTracer (telemetry.getNodeProcessTracer());
+}
+
 void EditPlaybackContext::blockUntilSyncPointChange()
 {
     if (const auto startSyncPoint = getSyncPoint())
@@ -1123,7 +1170,10 @@ double EditPlaybackContext::getSampleRate() const
 void EditPlaybackContext::updateNumCPUs()
 {
     if (nodePlaybackContext)
+    {
+        nodePlaybackContext->updateThreadAffinity();
         nodePlaybackContext->setNumThreads ((size_t) edit.engine.getEngineBehaviour().getNumberOfCPUsToUseForAudio() - 1);
+    }
 }
 
 void EditPlaybackContext::setSpeedCompensation (double plusOrMinus)
@@ -1227,7 +1277,7 @@ void EditPlaybackContext::resyncToGlobalStreamTime (juce::Range<double> globalSt
 void EditPlaybackContext::setThreadPoolStrategy (int type)
 {
     type = juce::jlimit (static_cast<int> (tracktion::graph::ThreadPoolStrategy::conditionVariable),
-                         static_cast<int> (tracktion::graph::ThreadPoolStrategy::lightweightSemHybrid),
+                         static_cast<int> (tracktion::graph::ThreadPoolStrategy::workStealing),
                          type);
 
     EditPlaybackContextInternal::getThreadPoolStrategyType() = type;
@@ -1236,7 +1286,7 @@ void EditPlaybackContext::setThreadPoolStrategy (int type)
 int EditPlaybackContext::getThreadPoolStrategy()
 {
     const int type = juce::jlimit (static_cast<int> (tracktion::graph::ThreadPoolStrategy::conditionVariable),
-                                   static_cast<int> (tracktion::graph::ThreadPoolStrategy::lightweightSemHybrid),
+                                   static_cast<int> (tracktion::graph::ThreadPoolStrategy::workStealing),
                                    EditPlaybackContextInternal::getThreadPoolStrategyType());
 
     return type;
@@ -1252,6 +1302,16 @@ void EditPlaybackContext::enableNodeMemorySharing (bool enable)
     EditPlaybackContextInternal::getNodeMemorySharingFlag() = enable;
 }
 
+void EditPlaybackContext::enableNodePrioritisation (bool enable)
+{
+    EditPlaybackContextInternal::getNodePrioritisationFlag() = enable;
+}
+
+void EditPlaybackContext::enableAdaptiveThreading (bool enable)
+{
+    EditPlaybackContextInternal::getAdaptiveThreadingFlag() = enable;
+}
+
 void EditPlaybackContext::enableAudioWorkgroup (bool enable)
 {
     EditPlaybackContextInternal::getAudioWorkgroupFlag() = enable;
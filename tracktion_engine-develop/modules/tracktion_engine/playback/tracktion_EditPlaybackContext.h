@@ -137,6 +137,21 @@ public:
     /** @internal. Will be removed in a future release. */
     tracktion::graph::PlayHead* getNodePlayHead() const;
 
+    /** Sets a NodeProcessTracer to record how long each Node in the playback graph takes to process.
+        Pass nullptr to stop recording. The tracer must outlive its use by this context.
+        @see tracktion::graph::NodeProcessTracer
+    */
+    void setNodeProcessTracer (tracktion::graph::NodeProcessTracer*);
+
+    /** Returns the block timing statistics for this context which can be polled from the message thread. */
+    PlaybackTelemetry& getTelemetry()                           { return telemetry; }
+
+    /** Enables recording the slowest Nodes in the worst block of the telemetry.
+        N.B. This replaces any tracer set with setNodeProcessTracer.
+        @see PlaybackTelemetry::enableNodeBreakdown
+    */
+    void enableTelemetryNodeBreakdown (bool);
+
     /** @internal */
     void blockUntilSyncPointChange();
 
@@ -156,6 +171,19 @@ public:
     */
     static void enableNodeMemorySharing (bool);
 
+    /** Enables processing Nodes on the longest chains to the output first, based on
+        how long each Node took to process in previous blocks.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableNodePrioritisation
+    */
+    static void enableNodePrioritisation (bool);
+
+    /** Enables scaling the number of active worker threads to the parallelism of the Edit
+        whilst playing. This avoids the sync overhead and power use of idle threads for
+        small Edits without the gap in the audio changing the number of threads causes.
+        @see tracktion::graph::LockFreeMultiThreadedNodePlayer::enableAdaptiveThreading
+    */
+    static void enableAdaptiveThreading (bool);
+
     /** Enables using AudioWorkgroups.
         Currently experimental and only on macOS.
     */
@@ -203,6 +231,9 @@ private:
     struct ContextSyncroniser;
     std::unique_ptr<ContextSyncroniser> contextSyncroniser;
 
+    // N.B. This needs to outlive the nodePlaybackContext as the player may be using its tracer
+    PlaybackTelemetry telemetry;
+
     struct NodePlaybackContext;
     std::unique_ptr<NodePlaybackContext> nodePlaybackContext;
 
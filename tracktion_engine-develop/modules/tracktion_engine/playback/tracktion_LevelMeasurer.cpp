@@ -221,6 +221,28 @@ void LevelMeasurer::processBuffer (juce::AudioBuffer<float>& buffer, int start,
     }
 }
 
+void LevelMeasurer::processSilentBuffer (int numChannels)
+{
+    const std::scoped_lock sl (clientsMutex);
+
+    if (clients.isEmpty())
+        return;
+
+    // This gives the same levels as processBuffer would for a block of zeros
+    auto numChans = mode == LevelMeasurer::sumDiffMode ? 2 : std::min ((int) Client::maxNumChannels, numChannels);
+    numActiveChannels = numChans;
+    auto now = juce::Time::getApproximateMillisecondCounter();
+    auto silentDB = gainToDb (0.0f);
+
+    for (auto c : clients)
+    {
+        for (int i = 0; i < numChans; ++i)
+            c->updateAudioLevel (i, { now, silentDB });
+
+        c->setNumChannelsUsed (numChans);
+    }
+}
+
 void LevelMeasurer::processMidi (MidiMessageArray& midiBuffer, const float*)
 {
     const std::scoped_lock sl (clientsMutex);
@@ -314,8 +336,16 @@ void SharedLevelMeasurer::startNextBlock (double streamTime)
     {
         lastStreamTime = streamTime;
 
-        processBuffer (sumBuffer, 0, sumBuffer.getNumSamples());
-        sumBuffer.clear();
+        if (sumBufferHasAudio)
+        {
+            processBuffer (sumBuffer, 0, sumBuffer.getNumSamples());
+            sumBuffer.clear();
+            sumBufferHasAudio = false;
+        }
+        else
+        {
+            processSilentBuffer (sumBuffer.getNumChannels());
+        }
     }
 }
 
@@ -335,6 +365,8 @@ void SharedLevelMeasurer::addBuffer (const juce::AudioBuffer<float>& inBuffer, i
 
     for (int i = 0; i < juce::jmin (sumBuffer.getNumChannels(), inBuffer.getNumChannels()); ++i)
         sumBuffer.addFrom (i, 0, inBuffer, i, startSample, numSamples);
+
+    sumBufferHasAudio = true;
 }
 
 }} // namespace tracktion { inline namespace engine
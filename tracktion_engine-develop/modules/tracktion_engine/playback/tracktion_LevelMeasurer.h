@@ -31,6 +31,9 @@ public:
 
     //==============================================================================
     void processBuffer (juce::AudioBuffer<float>& buffer, int start, int numSamples);
+
+    /** Updates the levels for a block that is known to be silent without having to scan it. */
+    void processSilentBuffer (int numChannels);
     void processMidi (MidiMessageArray& midiBuffer, const float* gains);
     void processMidiLevel (float level);
 
@@ -125,6 +128,7 @@ public:
     juce::SpinLock spinLock;
     double lastStreamTime = 0;
     juce::AudioBuffer<float> sumBuffer;
+    bool sumBufferHasAudio = false;
 };
 
 }} // namespace tracktion { inline namespace engine
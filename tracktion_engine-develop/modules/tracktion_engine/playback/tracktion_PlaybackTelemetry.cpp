@@ -0,0 +1,203 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+PlaybackTelemetry::PlaybackTelemetry()
+{
+    for (auto& bin : histogram)
+        bin.store (0, std::memory_order_relaxed);
+
+    worstBlockFifo.reset (8);
+}
+
+PlaybackTelemetry::~PlaybackTelemetry()
+{
+}
+
+//==============================================================================
+PlaybackTelemetry::Snapshot PlaybackTelemetry::getSnapshot()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    // Only the most recent worst block is needed as each one pushed is slower than the last
+    std::optional<RawWorstBlock> latestWorstBlock;
+
+    for (RawWorstBlock rawBlock; worstBlockFifo.pop (rawBlock);)
+        latestWorstBlock = rawBlock;
+
+    if (latestWorstBlock)
+    {
+        const double cyclesPerMicrosecond = nodeProcessTracer != nullptr ? nodeProcessTracer->getCyclesPerMicrosecond() : 1.0;
+        WorstBlock newWorstBlock;
+        newWorstBlock.durationMicroseconds = latestWorstBlock->durationSeconds * 1.0e6;
+        newWorstBlock.deadlineMicroseconds = latestWorstBlock->deadlineSeconds * 1.0e6;
+        newWorstBlock.numSamples = latestWorstBlock->numSamples;
+
+        for (size_t i = 0; i < latestWorstBlock->numNodes; ++i)
+        {
+            auto& rawNode = latestWorstBlock->nodes[i];
+            newWorstBlock.nodes.push_back ({ tracktion::graph::NodeProcessTracer::getNodeTypeName (*rawNode.nodeType),
+                                             rawNode.node,
+                                             (double) rawNode.durationCycles / cyclesPerMicrosecond,
+                                             rawNode.threadIndex });
+        }
+
+        std::sort (newWorstBlock.nodes.begin(), newWorstBlock.nodes.end(),
+                   [] (auto& n1, auto& n2) { return n1.durationMicroseconds > n2.durationMicroseconds; });
+
+        worstBlock = std::move (newWorstBlock);
+    }
+
+    Snapshot snapshot;
+    snapshot.numBlocks = numBlocks.load (std::memory_order_relaxed);
+    snapshot.numDeadlineMisses = numDeadlineMisses.load (std::memory_order_relaxed);
+    snapshot.numCacheMisses = numCacheMisses.load (std::memory_order_relaxed);
+
+    for (size_t i = 0; i < numHistogramBins; ++i)
+        snapshot.histogram[i] = histogram[i].load (std::memory_order_relaxed);
+
+    snapshot.worstBlock = worstBlock;
+
+    return snapshot;
+}
+
+void PlaybackTelemetry::reset()
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    numBlocks.store (0, std::memory_order_relaxed);
+    numDeadlineMisses.store (0, std::memory_order_relaxed);
+    numCacheMisses.store (0, std::memory_order_relaxed);
+
+    for (auto& bin : histogram)
+        bin.store (0, std::memory_order_relaxed);
+
+    // The audio thread owns the worst duration so signal it to reset it
+    worstBlockResetPending.store (true, std::memory_order_release);
+
+    for (RawWorstBlock rawBlock; worstBlockFifo.pop (rawBlock);)
+    {}
+
+    worstBlock.reset();
+}
+
+void PlaybackTelemetry::enableNodeBreakdown (bool shouldBeEnabled)
+{
+    TRACKTION_ASSERT_MESSAGE_THREAD
+
+    // The tracer is never deleted whilst this object exists as the audio thread may still be using it
+    if (shouldBeEnabled && nodeProcessTracer == nullptr)
+        nodeProcessTracer = std::make_unique<tracktion::graph::NodeProcessTracer> (16384);
+
+    activeNodeProcessTracer.store (shouldBeEnabled ? nodeProcessTracer.get() : nullptr, std::memory_order_release);
+}
+
+tracktion::graph::NodeProcessTracer* PlaybackTelemetry::getNodeProcessTracer() const
+{
+    return activeNodeProcessTracer.load (std::memory_order_acquire);
+}
+
+//==============================================================================
+void PlaybackTelemetry::addBlock (std::chrono::duration<double> duration, int numSamples, double sampleRate, bool hadCacheMiss)
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    if (worstBlockResetPending.exchange (false, std::memory_order_acq_rel))
+    {
+        worstDurationSeconds = 0.0;
+        hasPendingWorstBlock = false;
+    }
+
+    const double deadlineSeconds = numSamples / sampleRate;
+    const double proportionOfDeadline = duration.count() / deadlineSeconds;
+    const auto bin = std::min ((size_t) std::max (0.0, proportionOfDeadline * 10.0), numHistogramBins - 1);
+
+    histogram[bin].fetch_add (1, std::memory_order_relaxed);
+    numBlocks.fetch_add (1, std::memory_order_relaxed);
+
+    if (proportionOfDeadline > 1.0)
+        numDeadlineMisses.fetch_add (1, std::memory_order_relaxed);
+
+    if (hadCacheMiss)
+        numCacheMisses.fetch_add (1, std::memory_order_relaxed);
+
+    // The tracer's queue needs to be drained every block, even if this isn't the worst
+    currentBlock.numNodes = 0;
+
+    if (auto tracer = activeNodeProcessTracer.load (std::memory_order_acquire))
+        updateCurrentBlockNodes (*tracer);
+
+    if (duration.count() > worstDurationSeconds)
+    {
+        worstDurationSeconds = duration.count();
+        currentBlock.durationSeconds = duration.count();
+        currentBlock.deadlineSeconds = deadlineSeconds;
+        currentBlock.numSamples = numSamples;
+        pendingWorstBlock = currentBlock;
+        hasPendingWorstBlock = true;
+    }
+
+    // If the FIFO is full, keep trying on subsequent blocks so the latest worst block isn't lost
+    if (hasPendingWorstBlock && worstBlockFifo.push (pendingWorstBlock))
+        hasPendingWorstBlock = false;
+}
+
+void PlaybackTelemetry::updateCurrentBlockNodes (tracktion::graph::NodeProcessTracer& tracer)
+{
+    // Keep the slowest Nodes, replacing the fastest one kept when full
+    size_t fastestIndex = 0;
+
+    for (tracktion::graph::NodeProcessTracer::Event event; tracer.popEvent (event);)
+    {
+        // Skip the whole-block events
+        if (event.node == nullptr)
+            continue;
+
+        const RawNodeTiming timing { event.nodeType, event.node, event.endCycles - event.startCycles, event.threadIndex };
+
+        if (currentBlock.numNodes < maxNumNodesInBreakdown)
+        {
+            currentBlock.nodes[currentBlock.numNodes++] = timing;
+        }
+        else if (timing.durationCycles > currentBlock.nodes[fastestIndex].durationCycles)
+        {
+            currentBlock.nodes[fastestIndex] = timing;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (currentBlock.numNodes == maxNumNodesInBreakdown)
+        {
+            const auto nodesEnd = currentBlock.nodes.begin() + (std::ptrdiff_t) currentBlock.numNodes;
+            fastestIndex = (size_t) std::distance (currentBlock.nodes.begin(),
+                                                   std::min_element (currentBlock.nodes.begin(), nodesEnd,
+                                                                     [] (auto& n1, auto& n2) { return n1.durationCycles < n2.durationCycles; }));
+        }
+    }
+}
+
+//==============================================================================
+PlaybackTelemetry::ScopedBlock::ScopedBlock (PlaybackTelemetry& t, int numSamplesToProcess, double sampleRateToUse, AudioFileCache& c)
+    : telemetry (t), numSamples (numSamplesToProcess), sampleRate (sampleRateToUse), cache (c)
+{
+}
+
+PlaybackTelemetry::ScopedBlock::~ScopedBlock()
+{
+    telemetry.addBlock (std::chrono::steady_clock::now() - startTime, numSamples, sampleRate,
+                        cache.getNumCacheMisses() != numCacheMissesAtStart);
+}
+
+}} // namespace tracktion { inline namespace engine
@@ -0,0 +1,161 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Collects timing statistics about the blocks processed by an EditPlaybackContext.
+
+    Each block's processing time is compared to its deadline (the duration of the
+    samples it processed) and added to a histogram. Blocks that take longer than
+    their deadline are counted as deadline misses, as these are likely to cause
+    xruns. The slowest block is also kept along with, if enabled, a breakdown of
+    the slowest Nodes processed in it.
+
+    All the audio thread functions are lock-free and non-allocating and the
+    statistics can be polled from the message thread with getSnapshot.
+
+    N.B. This only measures the time taken by a single EditPlaybackContext so if
+    several are playing at once, each will only see its share of the deadline.
+
+    @see EditPlaybackContext::getTelemetry
+*/
+class PlaybackTelemetry
+{
+public:
+    //==============================================================================
+    /** The number of bins in the histogram.
+        Each bin covers 10% of the block deadline with the last bin holding
+        all the blocks that took longer than 110% of the deadline.
+    */
+    static constexpr size_t numHistogramBins = 12;
+
+    /** The maximum number of Nodes kept in the worst block breakdown. */
+    static constexpr size_t maxNumNodesInBreakdown = 32;
+
+    /** The time a single Node took to process. */
+    struct NodeTiming
+    {
+        std::string nodeType;               /**< The demangled name of the Node's type. */
+        const void* node = nullptr;         /**< The address of the Node. Only use this to tell Nodes apart. */
+        double durationMicroseconds = 0.0;  /**< How long the Node took to process. */
+        std::uint32_t threadIndex = 0;      /**< The thread the Node was processed on. */
+    };
+
+    /** The slowest block processed. */
+    struct WorstBlock
+    {
+        double durationMicroseconds = 0.0;  /**< How long the block took to process. */
+        double deadlineMicroseconds = 0.0;  /**< How long the block had to process. */
+        int numSamples = 0;                 /**< The number of samples in the block. */
+        std::vector<NodeTiming> nodes;      /**< The slowest Nodes, slowest first, if the breakdown is enabled. */
+    };
+
+    /** The statistics collected since the last reset. */
+    struct Snapshot
+    {
+        std::uint64_t numBlocks = 0;                                /**< The total number of blocks processed. */
+        std::uint64_t numDeadlineMisses = 0;                        /**< The number of blocks that took longer than their deadline. */
+        std::uint64_t numCacheMisses = 0;                           /**< The number of blocks where the AudioFileCache missed. */
+        std::array<std::uint64_t, numHistogramBins> histogram {};   /**< The number of blocks in each proportion of the deadline. */
+        std::optional<WorstBlock> worstBlock;                       /**< The slowest block, if any have been processed. */
+    };
+
+    //==============================================================================
+    /** Creates an empty PlaybackTelemetry. */
+    PlaybackTelemetry();
+
+    /** Destructor. */
+    ~PlaybackTelemetry();
+
+    //==============================================================================
+    /** Returns the statistics collected since the last reset.
+        [[ message_thread ]]
+    */
+    Snapshot getSnapshot();
+
+    /** Clears all the statistics.
+        [[ message_thread ]]
+    */
+    void reset();
+
+    /** Enables recording the slowest Nodes in the worst block.
+        This has a small overhead for every Node processed so is disabled by default.
+        [[ message_thread ]]
+    */
+    void enableNodeBreakdown (bool);
+
+    /** Returns the tracer to set on the player if the Node breakdown is enabled. */
+    tracktion::graph::NodeProcessTracer* getNodeProcessTracer() const;
+
+    //==============================================================================
+    /** Adds a processed block to the statistics.
+        [[ audio_thread ]]
+    */
+    void addBlock (std::chrono::duration<double> duration, int numSamples, double sampleRate, bool hadCacheMiss);
+
+    /** Times a block and adds it to the statistics when it goes out of scope.
+        [[ audio_thread ]]
+    */
+    struct ScopedBlock
+    {
+        ScopedBlock (PlaybackTelemetry&, int numSamples, double sampleRate, AudioFileCache&);
+        ~ScopedBlock();
+
+        PlaybackTelemetry& telemetry;
+        const int numSamples;
+        const double sampleRate;
+        AudioFileCache& cache;
+        const uint64_t numCacheMissesAtStart { cache.getNumCacheMisses() };
+        const std::chrono::steady_clock::time_point startTime { std::chrono::steady_clock::now() };
+    };
+
+private:
+    //==============================================================================
+    struct RawNodeTiming
+    {
+        const std::type_info* nodeType = nullptr;
+        const void* node = nullptr;
+        std::uint64_t durationCycles = 0;
+        std::uint32_t threadIndex = 0;
+    };
+
+    struct RawWorstBlock
+    {
+        double durationSeconds = 0.0, deadlineSeconds = 0.0;
+        int numSamples = 0;
+        size_t numNodes = 0;
+        std::array<RawNodeTiming, maxNumNodesInBreakdown> nodes;
+    };
+
+    std::atomic<std::uint64_t> numBlocks { 0 }, numDeadlineMisses { 0 }, numCacheMisses { 0 };
+    std::array<std::atomic<std::uint64_t>, numHistogramBins> histogram;
+
+    // Audio thread
+    double worstDurationSeconds = 0.0;
+    std::atomic<bool> worstBlockResetPending { false };
+    RawWorstBlock currentBlock, pendingWorstBlock;
+    bool hasPendingWorstBlock = false;
+    choc::fifo::SingleReaderSingleWriterFIFO<RawWorstBlock> worstBlockFifo;
+
+    // Message thread
+    std::unique_ptr<tracktion::graph::NodeProcessTracer> nodeProcessTracer;
+    std::atomic<tracktion::graph::NodeProcessTracer*> activeNodeProcessTracer { nullptr };
+    std::optional<WorstBlock> worstBlock;
+
+    void updateCurrentBlockNodes (tracktion::graph::NodeProcessTracer&);
+
+    JUCE_DECLARE_NON_COPYABLE (PlaybackTelemetry)
+};
+
+}} // namespace tracktion { inline namespace engine
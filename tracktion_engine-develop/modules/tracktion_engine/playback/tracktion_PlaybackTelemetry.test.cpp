@@ -0,0 +1,129 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS
+#include <tracktion_engine/../3rd_party/doctest/tracktion_doctest.hpp>
+#include <tracktion_engine/testing/tracktion_EnginePlayer.h>
+
+namespace tracktion::inline engine
+{
+
+#if ENGINE_UNIT_TESTS_PLAYBACK_TELEMETRY
+    TEST_SUITE ("tracktion_engine")
+    {
+        TEST_CASE ("PlaybackTelemetry: Histogram and deadline misses")
+        {
+            using namespace std::chrono_literals;
+            PlaybackTelemetry telemetry;
+
+            // 512 samples at 51200Hz gives a 10ms deadline
+            telemetry.addBlock (0.5ms, 512, 51200.0, false);
+            telemetry.addBlock (5.5ms, 512, 51200.0, false);
+            telemetry.addBlock (10.5ms, 512, 51200.0, true);
+            telemetry.addBlock (50ms, 512, 51200.0, true);
+            telemetry.addBlock (2.5ms, 512, 51200.0, false);
+
+            auto snapshot = telemetry.getSnapshot();
+            CHECK_EQ (snapshot.numBlocks, 5u);
+            CHECK_EQ (snapshot.numDeadlineMisses, 2u);
+            CHECK_EQ (snapshot.numCacheMisses, 2u);
+            CHECK_EQ (snapshot.histogram[0], 1u);
+            CHECK_EQ (snapshot.histogram[2], 1u);
+            CHECK_EQ (snapshot.histogram[5], 1u);
+            CHECK_EQ (snapshot.histogram[10], 1u);
+            CHECK_EQ (snapshot.histogram[PlaybackTelemetry::numHistogramBins - 1], 1u);
+
+            REQUIRE (snapshot.worstBlock);
+            CHECK_EQ (snapshot.worstBlock->durationMicroseconds, doctest::Approx (50000.0));
+            CHECK_EQ (snapshot.worstBlock->deadlineMicroseconds, doctest::Approx (10000.0));
+            CHECK_EQ (snapshot.worstBlock->numSamples, 512);
+            CHECK (snapshot.worstBlock->nodes.empty());
+
+            telemetry.reset();
+            snapshot = telemetry.getSnapshot();
+            CHECK_EQ (snapshot.numBlocks, 0u);
+            CHECK_EQ (snapshot.numDeadlineMisses, 0u);
+            CHECK (! snapshot.worstBlock);
+
+            // After a reset, a faster block becomes the worst
+            telemetry.addBlock (1ms, 512, 51200.0, false);
+            snapshot = telemetry.getSnapshot();
+            REQUIRE (snapshot.worstBlock);
+            CHECK_EQ (snapshot.worstBlock->durationMicroseconds, doctest::Approx (1000.0));
+        }
+
+        TEST_CASE ("PlaybackTelemetry: Node breakdown")
+        {
+            struct TestNode : public tracktion::graph::Node
+            {
+                tracktion::graph::NodeProperties getNodeProperties() override   { return {}; }
+                bool isReadyToProcess() override                                { return true; }
+                void process (ProcessContext&) override                         {}
+            };
+
+            using namespace std::chrono_literals;
+            PlaybackTelemetry telemetry;
+            telemetry.enableNodeBreakdown (true);
+            auto tracer = telemetry.getNodeProcessTracer();
+            REQUIRE (tracer != nullptr);
+
+            std::vector<std::unique_ptr<TestNode>> nodes;
+
+            for (size_t i = 0; i < PlaybackTelemetry::maxNumNodesInBreakdown * 2; ++i)
+            {
+                nodes.push_back (std::make_unique<TestNode>());
+                const tracktion::graph::NodeProcessTracer::ScopedEvent event (tracer, nodes.back().get());
+            }
+
+            telemetry.addBlock (1ms, 512, 44100.0, false);
+
+            auto snapshot = telemetry.getSnapshot();
+            REQUIRE (snapshot.worstBlock);
+            CHECK_EQ (snapshot.worstBlock->nodes.size(), PlaybackTelemetry::maxNumNodesInBreakdown);
+            CHECK (snapshot.worstBlock->nodes.front().nodeType.find ("TestNode") != std::string::npos);
+            CHECK (std::is_sorted (snapshot.worstBlock->nodes.begin(), snapshot.worstBlock->nodes.end(),
+                                   [] (auto& n1, auto& n2) { return n1.durationMicroseconds > n2.durationMicroseconds; }));
+
+            telemetry.enableNodeBreakdown (false);
+            CHECK (telemetry.getNodeProcessTracer() == nullptr);
+        }
+
+        TEST_CASE ("PlaybackTelemetry: EditPlaybackContext")
+        {
+            auto& engine = *Engine::getEngines()[0];
+            test_utilities::EnginePlayer player (engine, { .sampleRate = 44100.0, .blockSize = 512, .inputChannels = 0, .outputChannels = 1,
+                                                           .inputNames = {}, .outputNames = {} });
+
+            auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+            auto& tc = edit->getTransport();
+            tc.ensureContextAllocated();
+
+            auto context = edit->getCurrentPlaybackContext();
+            REQUIRE (context != nullptr);
+            context->enableTelemetryNodeBreakdown (true);
+            context->getTelemetry().reset();
+
+            tc.play (false);
+            player.process (512 * 10);
+            tc.stop (false, true);
+
+            const auto snapshot = context->getTelemetry().getSnapshot();
+            CHECK (snapshot.numBlocks > 0);
+            REQUIRE (snapshot.worstBlock);
+            CHECK (! snapshot.worstBlock->nodes.empty());
+
+            context->enableTelemetryNodeBreakdown (false);
+        }
+    }
+#endif
+
+} // namespace tracktion::inline engine
+
+#endif // TRACKTION_UNIT_TESTS
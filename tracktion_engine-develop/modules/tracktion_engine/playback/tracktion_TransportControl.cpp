@@ -387,6 +387,120 @@ struct TransportControl::SectionPlayer  : private Timer
     }
 };
 
+//==============================================================================
+/** Periodically asks the AudioFileCache to prefetch the sections of audio clips'
+    files that are about to be played.
+*/
+struct TransportControl::ClipPrefetcher  : private Timer
+{
+    ClipPrefetcher (TransportControl& tc)
+        : owner (tc)
+    {
+        startTimerHz (10);
+    }
+
+    void timerCallback() override
+    {
+        if (lookAhead <= TimeDuration() || owner.edit.isLoading())
+            return;
+
+        TimeRange window (owner.getPosition(), lookAhead);
+
+        // Playback won't go past the end of the loop, so once that's within the window
+        // prefetch the start of the loop instead, once for each time round
+        if (const auto loopRange = owner.getLoopRange();
+            owner.looping && owner.isPlaying() && loopRange.contains (window.getStart())
+             && window.getEnd() > loopRange.getEnd())
+        {
+            window = window.withEnd (loopRange.getEnd());
+
+            if (! loopStartPrefetched)
+                prefetch (TimeRange (loopRange.getStart(), std::min (lookAhead, loopRange.getLength())));
+
+            loopStartPrefetched = true;
+        }
+        else
+        {
+            loopStartPrefetched = false;
+        }
+
+        // Only the part of the window that hasn't already been prefetched is needed as the
+        // playhead moves forwards, so wait until enough of it is new to be worth doing or
+        // it's reached the end of the loop
+        if (window.getStart() >= lastWindow.getStart() && window.getStart() <= lastWindow.getEnd())
+        {
+            const auto newLength = window.getEnd() - lastWindow.getEnd();
+
+            if (newLength <= TimeDuration() || (newLength < lookAhead * 0.25 && ! loopStartPrefetched))
+                return;
+
+            prefetch ({ lastWindow.getEnd(), window.getEnd() });
+        }
+        else
+        {
+            prefetch (window);
+        }
+
+        lastWindow = window;
+    }
+
+    void prefetch (TimeRange editRange)
+    {
+        CRASH_TRACER
+        auto& cache = owner.engine.getAudioFileManager().cache;
+
+        for (auto track : getAudioTracks (owner.edit))
+        {
+            for (auto clip : track->getClips())
+            {
+                auto audioClip = dynamic_cast<AudioClipBase*> (clip);
+
+                if (audioClip == nullptr)
+                    continue;
+
+                const auto pos = audioClip->getPosition();
+                const auto clipRange = pos.time.getIntersectionWith (editRange);
+
+                if (clipRange.isEmpty())
+                    continue;
+
+                const auto playbackFile = audioClip->getPlaybackFile();
+
+                if (playbackFile.isNull())
+                    continue;
+
+                const auto startInClip = clipRange.getStart() - pos.getStart();
+
+                // Proxies are rendered with the offset, speed and looping already applied
+                if (audioClip->usesTimeStretchedProxy())
+                {
+                    cache.prefetch (playbackFile, { toPosition (startInClip), clipRange.getLength() });
+                    continue;
+                }
+
+                const auto speed = audioClip->getSpeedRatio();
+                const auto fileLength = clipRange.getLength() * speed;
+
+                if (audioClip->isLooping())
+                {
+                    // Rather than working out where in the loop playback will be, just prefetch the whole loop
+                    const auto loopRange = audioClip->getLoopRange();
+                    cache.prefetch (playbackFile, { loopRange.getStart(), std::min (loopRange.getLength(), fileLength) });
+                }
+                else
+                {
+                    cache.prefetch (playbackFile, { toPosition ((pos.getOffset() + startInClip) * speed), fileLength });
+                }
+            }
+        }
+    }
+
+    TransportControl& owner;
+    TimeDuration lookAhead = TimeDuration::fromSeconds (5.0);
+    TimeRange lastWindow;
+    bool loopStartPrefetched = false;
+};
+
 //==============================================================================
 struct TransportControl::FileFlushTimer  : private Timer
 {
@@ -695,6 +809,7 @@ TransportControl::TransportControl (Edit& ed, const juce::ValueTree& v)
     ffRepeater = std::make_unique<ButtonRepeater> (*this, false);
 
     fileFlushTimer = std::make_unique<FileFlushTimer> (*this);
+    clipPrefetcher = std::make_unique<ClipPrefetcher> (*this);
 
     activeTransportControls.add (this);
     startTimerHz (50);
@@ -704,6 +819,7 @@ TransportControl::~TransportControl()
 {
     activeTransportControls.removeAllInstancesOf (this);
     fileFlushTimer = nullptr;
+    clipPrefetcher = nullptr;
 
     CRASH_TRACER
     stop (false, true);
@@ -865,6 +981,18 @@ void TransportControl::forceOrphanFreezeAndProxyFilesPurge()
     fileFlushTimer->forcePurge = true;
 }
 
+void TransportControl::setClipPrefetchLookAhead (TimeDuration lookAhead)
+{
+    clipPrefetcher->lookAhead = lookAhead;
+    clipPrefetcher->lastWindow = {};
+    clipPrefetcher->loopStartPrefetched = false;
+}
+
+TimeDuration TransportControl::getClipPrefetchLookAhead() const
+{
+    return clipPrefetcher->lookAhead;
+}
+
 //==============================================================================
 static int numScreenSaverDefeaters = 0;
 
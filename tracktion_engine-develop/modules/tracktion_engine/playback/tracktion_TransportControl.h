@@ -226,6 +226,16 @@ public:
     /** Triggers a cleanup of any unused freeze and proxy files. */
     void forceOrphanFreezeAndProxyFilesPurge();
 
+    /** Sets how far ahead of the playhead audio clips' files are prefetched.
+        Sections of files that are about to be played are loaded in the background
+        so they're already in memory when they're read. A duration of zero disables this.
+        @see AudioFileCache::prefetch
+    */
+    void setClipPrefetchLookAhead (TimeDuration);
+
+    /** Returns how far ahead of the playhead audio clips' files are prefetched. */
+    TimeDuration getClipPrefetchLookAhead() const;
+
     //==============================================================================
     /** Starts/stops a rewind operation. */
     void setRewindButtonDown (bool isDown);
@@ -452,6 +462,9 @@ private:
     struct FileFlushTimer;
     std::unique_ptr<FileFlushTimer> fileFlushTimer;
 
+    struct ClipPrefetcher;
+    std::unique_ptr<ClipPrefetcher> clipPrefetcher;
+
     struct ButtonRepeater;
     std::unique_ptr<ButtonRepeater> rwRepeater, ffRepeater;
 
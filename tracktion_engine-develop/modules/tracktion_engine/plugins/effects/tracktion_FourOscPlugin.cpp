@@ -278,6 +278,15 @@ private:
     float phase = 0, speedHz = 1.0f, depthMs = 3.0f, width = 0.5f, mix = 0;
 };
 
+//==============================================================================
+// An IIRFilter that gives access to its state so FourOscVoiceBatch can run it in a SIMD lane
+class FourOscFilter : public juce::IIRFilter
+{
+public:
+    bool isActive() const noexcept                  { return active; }
+    float& getState (int index) noexcept            { return index == 0 ? v1 : v2; }
+};
+
 //==============================================================================
 class FourOscVoice : public juce::MPESynthesiserVoice
 {
@@ -339,7 +348,7 @@ public:
             filterR2.reset();
 
             for (auto& o : oscillators)
-                o.start();
+                o.start (synth.random);
 
             filterFrequencySmoother.snapToValue();
 
@@ -402,19 +411,7 @@ public:
     using MPESynthesiserVoice::renderNextBlock;
     void renderNextBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples) override
     {
-        juce::ScopedValueSetter<bool> svs (snapAllValues, firstBlock || snapAllValues);
-
-        updateParams (numSamples);
-
-        if (firstBlock)
-        {
-            filterFrequencySmoother.snapToValue();
-            firstBlock = false;
-        }
-
-        if (numSamples > renderBuffer.getNumSamples())
-            renderBuffer.setSize (2, numSamples, false, false, true);
-
+        startBlock (numSamples);
         renderBuffer.clear();
 
         // Run oscillators
@@ -422,8 +419,6 @@ public:
             o.process (renderBuffer, 0, numSamples);
 
         // Apply velocity
-        float velocityGain = velocityToGain (currentlyPlayingNote.noteOnVelocity.asUnsignedFloat(), paramValue (synth.ampVelocity) / 100.0f);
-        velocityGain = juce::jlimit (0.0f, 1.0f, velocityGain);
         renderBuffer.applyGain (velocityGain);
 
         // Apply filter
@@ -442,6 +437,32 @@ public:
             }
         }
 
+        endBlock (outputBuffer, startSample, numSamples);
+    }
+
+    // Updates the parameters for a block, before the oscillators and filters are run
+    void startBlock (int numSamples)
+    {
+        juce::ScopedValueSetter<bool> svs (snapAllValues, firstBlock || snapAllValues);
+
+        updateParams (numSamples);
+
+        if (firstBlock)
+        {
+            filterFrequencySmoother.snapToValue();
+            firstBlock = false;
+        }
+
+        velocityGain = velocityToGain (currentlyPlayingNote.noteOnVelocity.asUnsignedFloat(), paramValue (synth.ampVelocity) / 100.0f);
+        velocityGain = juce::jlimit (0.0f, 1.0f, velocityGain);
+
+        if (numSamples > renderBuffer.getNumSamples())
+            renderBuffer.setSize (2, numSamples, false, false, true);
+    }
+
+    // Applies the amp envelope to the filtered renderBuffer and adds it to the output
+    void endBlock (juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
         // Apply ADSR
         ampAdsr.applyEnvelopeToBuffer (renderBuffer, 0, numSamples);
 
@@ -691,6 +712,8 @@ public:
     void noteKeyStateChanged() override     {}
 
 private:
+    friend class FourOscVoiceBatch;
+
     float paramValue (AutomatableParameter::Ptr param)
     {
         jassert (param != nullptr);
@@ -743,19 +766,280 @@ private:
     ExpEnvelope ampAdsr;
     LinEnvelope filterAdsr, modAdsr1, modAdsr2;
     SimpleLFO lfo1, lfo2;
-    juce::IIRFilter filterL1, filterR1, filterL2, filterR2;
+    FourOscFilter filterL1, filterR1, filterL2, filterR2;
 
     ValueSmoother<float> filterFrequencySmoother;
 
     bool retrigger = false, isPlaying = false, isQuickStop = false, snapAllValues = false, firstBlock = false;
     juce::LinearSmoothedValue<float> activeNote;
-    float lastLegato = -1.0f, lastFilterFreq = 0;
+    float lastLegato = -1.0f, lastFilterFreq = 0, velocityGain = 0;
 
     float currentModValue[FourOscPlugin::numModSources] = {0};
 
     std::map<AutomatableParameter*, ValueSmoother<float>> smoothers;
 };
 
+//==============================================================================
+/*  Renders a group of FourOscVoices at once with each voice in a SIMD lane.
+
+    The voices still update their own parameters and envelopes but their oscillators
+    and filters are run together, with the phases and filter states read from the
+    voices and written back afterwards. Everything is calculated in the same order as
+    FourOscVoice::renderNextBlock so the output is the same as rendering them one by one.
+*/
+class FourOscVoiceBatch
+{
+public:
+   #if JUCE_USE_SIMD
+    using Lanes = juce::dsp::SIMDRegister<float>;
+    static constexpr int numLanes = int (Lanes::SIMDNumElements);
+
+    void render (FourOscVoice* const* voices, int numVoices, juce::AudioBuffer<float>& outputBuffer, int startSample, int numSamples)
+    {
+        jassert (numVoices > 0 && numVoices <= numLanes);
+
+        if (int (left.size()) < numSamples)
+        {
+            left.resize ((size_t) numSamples);
+            right.resize ((size_t) numSamples);
+            scratch.resize ((size_t) numSamples);
+        }
+
+        for (int i = 0; i < numVoices; ++i)
+            voices[i]->startBlock (numSamples);
+
+        std::fill_n (left.begin(), numSamples, Lanes::expand (0.0f));
+        std::fill_n (right.begin(), numSamples, Lanes::expand (0.0f));
+
+        // Run oscillators
+        for (int osc = 0; osc < juce::numElementsInArray (voices[0]->oscillators); ++osc)
+            renderOscillators (voices, numVoices, osc, numSamples);
+
+        // Apply velocity
+        auto velocityGains = Lanes::expand (0.0f);
+
+        for (int i = 0; i < numVoices; ++i)
+            velocityGains.set ((size_t) i, voices[i]->velocityGain);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            left[(size_t) i] *= velocityGains;
+            right[(size_t) i] *= velocityGains;
+        }
+
+        // Apply filter
+        auto& synth = voices[0]->synth;
+
+        if (synth.filterTypeValue != 0)
+        {
+            processFilters (voices, numVoices, &FourOscVoice::filterL1, left.data(), numSamples);
+            processFilters (voices, numVoices, &FourOscVoice::filterR1, right.data(), numSamples);
+
+            if (synth.filterSlopeValue == 24)
+            {
+                clip (left.data(), numSamples);
+                clip (right.data(), numSamples);
+
+                processFilters (voices, numVoices, &FourOscVoice::filterL2, left.data(), numSamples);
+                processFilters (voices, numVoices, &FourOscVoice::filterR2, right.data(), numSamples);
+            }
+        }
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& voice = *voices[v];
+            auto l = voice.renderBuffer.getWritePointer (0);
+            auto r = voice.renderBuffer.getWritePointer (1);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                l[i] = left[(size_t) i].get ((size_t) v);
+                r[i] = right[(size_t) i].get ((size_t) v);
+            }
+
+            voice.endBlock (outputBuffer, startSample, numSamples);
+        }
+    }
+
+private:
+    std::vector<Lanes> left, right;
+    std::vector<float> scratch;
+    std::vector<float> silence;
+
+    void renderOscillators (FourOscVoice* const* voices, int numVoices, int osc, int numSamples)
+    {
+        int numOscillators = 0;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& o = voices[v]->oscillators[osc];
+            o.updateOscillators();
+            numOscillators = std::max (numOscillators, o.getNumActiveOscillators());
+        }
+
+        for (int index = 0; index < numOscillators; ++index)
+        {
+            auto dest = (index % 2) == 0 ? left.data() : right.data();
+
+            Oscillator* lanes[numLanes] = {};
+            const float* tables[2][numLanes] = {};
+            auto phase = Lanes::expand (0.0f), delta = phase, gain = phase, offset0 = phase, offset1 = phase;
+            float pointsScaler = 0.0f;
+            bool anyLanes = false, anySecondTables = false;
+
+            for (int v = 0; v < numVoices; ++v)
+            {
+                auto& mvo = voices[v]->oscillators[osc];
+
+                if (index >= mvo.getNumActiveOscillators())
+                    continue;
+
+                auto& o = mvo.getOscillator (index);
+
+                if (auto state = o.getWavetableState())
+                {
+                    lanes[v] = &o;
+                    tables[0][v] = state->tables[0];
+                    tables[1][v] = state->tables[1];
+                    phase.set ((size_t) v, o.getPhase());
+                    delta.set ((size_t) v, state->delta);
+                    gain.set ((size_t) v, state->gain);
+                    offset0.set ((size_t) v, state->phaseOffsets[0]);
+                    offset1.set ((size_t) v, state->phaseOffsets[1]);
+                    pointsScaler = state->pointsScaler;
+                    anyLanes = true;
+                    anySecondTables = anySecondTables || state->tables[1] != nullptr;
+                }
+                else if (o.getWave() != Oscillator::none)
+                {
+                    // Noise isn't from a table so is rendered on its own and added to the lane
+                    std::fill_n (scratch.begin(), numSamples, 0.0f);
+                    float* dataPointers[] = { scratch.data() };
+                    juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
+                    o.process (channelBuffer, 0, numSamples);
+
+                    for (int i = 0; i < numSamples; ++i)
+                        dest[i].set ((size_t) v, dest[i].get ((size_t) v) + scratch[(size_t) i]);
+                }
+            }
+
+            if (! anyLanes)
+                continue;
+
+            // Unused lanes read from a table of silence
+            if (silence.size() < size_t (pointsScaler) + 2)
+                silence.resize (size_t (pointsScaler) + 2, 0.0f);
+
+            for (auto& laneTables : tables)
+                for (auto& t : laneTables)
+                    if (t == nullptr)
+                        t = silence.data();
+
+            const auto zero = Lanes::expand (0.0f), one = Lanes::expand (1.0f), scaler = Lanes::expand (pointsScaler);
+
+            auto wrap = [&] (Lanes p)
+            {
+                p -= one & Lanes::greaterThan (p, one);
+                p += one & Lanes::lessThan (p, zero);
+                return p;
+            };
+
+            alignas (Lanes) float positions[numLanes], points0[numLanes], points1[numLanes];
+
+            // This matches juce::dsp::LookupTable::getUnchecked
+            auto lookup = [&] (Lanes p, const float* const* laneTables)
+            {
+                auto position = p * scaler;
+                auto whole = Lanes::truncate (position);
+                whole.copyToRawArray (positions);
+
+                for (int v = 0; v < numLanes; ++v)
+                {
+                    auto point = (size_t) positions[v];
+                    points0[v] = laneTables[v][point];
+                    points1[v] = laneTables[v][point + 1];
+                }
+
+                auto x0 = Lanes::fromRawArray (points0);
+                auto x1 = Lanes::fromRawArray (points1);
+                return x0 + (position - whole) * (x1 - x0);
+            };
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                if (anySecondTables)
+                    dest[i] += (lookup (wrap (phase + offset0), tables[0]) + lookup (wrap (phase + offset1), tables[1])) * gain;
+                else
+                    dest[i] += lookup (phase, tables[0]) * gain;
+
+                phase += delta;
+                phase -= one & Lanes::greaterThanOrEqual (phase, one);
+            }
+
+            for (int v = 0; v < numVoices; ++v)
+                if (lanes[v] != nullptr)
+                    lanes[v]->setPhase (phase.get ((size_t) v));
+        }
+    }
+
+    static void processFilters (FourOscVoice* const* voices, int numVoices, FourOscFilter FourOscVoice::* filter,
+                                Lanes* data, int numSamples)
+    {
+        // Lanes without an active filter pass their input straight through
+        auto c0 = Lanes::expand (1.0f), c1 = Lanes::expand (0.0f), c2 = c1, c3 = c1, c4 = c1;
+        auto lv1 = Lanes::expand (0.0f), lv2 = lv1;
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& f = voices[v]->*filter;
+
+            if (f.isActive())
+            {
+                auto coefs = f.getCoefficients();
+                c0.set ((size_t) v, coefs.coefficients[0]);
+                c1.set ((size_t) v, coefs.coefficients[1]);
+                c2.set ((size_t) v, coefs.coefficients[2]);
+                c3.set ((size_t) v, coefs.coefficients[3]);
+                c4.set ((size_t) v, coefs.coefficients[4]);
+                lv1.set ((size_t) v, f.getState (0));
+                lv2.set ((size_t) v, f.getState (1));
+            }
+        }
+
+        // This matches juce::IIRFilter::processSamples
+        for (int i = 0; i < numSamples; ++i)
+        {
+            auto in = data[i];
+            auto out = c0 * in + lv1;
+            data[i] = out;
+
+            lv1 = c1 * in - c3 * out + lv2;
+            lv2 = c2 * in - c4 * out;
+        }
+
+        for (int v = 0; v < numVoices; ++v)
+        {
+            auto& f = voices[v]->*filter;
+
+            if (f.isActive())
+            {
+                auto s1 = lv1.get ((size_t) v), s2 = lv2.get ((size_t) v);
+                JUCE_SNAP_TO_ZERO (s1);  f.getState (0) = s1;
+                JUCE_SNAP_TO_ZERO (s2);  f.getState (1) = s2;
+            }
+        }
+    }
+
+    static void clip (Lanes* data, int numSamples)
+    {
+        const auto lower = Lanes::expand (-1.0f), upper = Lanes::expand (1.0f);
+
+        for (int i = 0; i < numSamples; ++i)
+            data[i] = Lanes::min (upper, Lanes::max (lower, data[i]));
+    }
+   #endif
+};
+
 //==============================================================================
 FourOscPlugin::OscParams::OscParams (FourOscPlugin& plugin, int oscNum)
 {
@@ -905,6 +1189,7 @@ FourOscPlugin::FourOscPlugin (PluginCreationInfo info)  : Plugin (info)
 
     delay  = std::make_unique<FODelay>();
     chorus = std::make_unique<FOChorus>();
+    voiceBatch = std::make_unique<FourOscVoiceBatch>();
 
     for (int i = 0; i < 4; i++) oscParams.add (new OscParams (*this, i + 1));
     for (int i = 0; i < 2; i++) lfoParams.add (new LFOParams (*this, i + 1));
@@ -1521,6 +1806,46 @@ void FourOscPlugin::applyToBuffer (juce::AudioBuffer<float>& buffer, juce::MidiB
         itr.second.process (buffer.getNumSamples());
 }
 
+void FourOscPlugin::renderNextSubBlock (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+   #if JUCE_USE_SIMD
+    if (voiceBatchingEnabled)
+    {
+        const juce::ScopedLock sl (voicesLock);
+
+        FourOscVoice* group[FourOscVoiceBatch::numLanes];
+        int numInGroup = 0;
+
+        // A voice on its own doesn't gain anything from the SIMD lanes
+        auto renderGroup = [&]
+        {
+            if (numInGroup > 1)
+                voiceBatch->render (group, numInGroup, buffer, startSample, numSamples);
+            else if (numInGroup == 1)
+                group[0]->renderNextBlock (buffer, startSample, numSamples);
+
+            numInGroup = 0;
+        };
+
+        for (auto voice : voices)
+        {
+            if (! voice->isActive())
+                continue;
+
+            group[numInGroup++] = static_cast<FourOscVoice*> (voice);
+
+            if (numInGroup == FourOscVoiceBatch::numLanes)
+                renderGroup();
+        }
+
+        renderGroup();
+        return;
+    }
+   #endif
+
+    MPESynthesiser::renderNextSubBlock (buffer, startSample, numSamples);
+}
+
 void FourOscPlugin::applyEffects (juce::AudioBuffer<float>& buffer)
 {
     int numSamples = buffer.getNumSamples();
@@ -12,6 +12,8 @@ namespace tracktion { inline namespace engine
 
 class FODelay;
 class FOChorus;
+class FourOscVoice;
+class FourOscVoiceBatch;
 
 //==============================================================================
 /** Smooths a value between 0 and 1 at a constant rate */
@@ -200,6 +202,15 @@ public:
 
     float getCurrentTempo()                             { return currentTempo; }
 
+    /** Renders the active voices in groups, running their oscillators and filters
+        together in SIMD lanes. This is on by default and gives the same output as
+        rendering the voices one at a time.
+    */
+    void setVoiceBatchingEnabled (bool shouldBatch)      { voiceBatchingEnabled = shouldBatch; }
+
+    /** Seeds the random start phases of the oscillators so the same notes always give the same output. */
+    void setRandomSeed (juce::int64 seed)                { random.setSeed (seed); }
+
 private:
     std::unordered_map<juce::String, juce::String> labels;
 
@@ -366,6 +377,9 @@ private:
     void handleAsyncUpdate() override;
     void handleController (int midiChannel, int controllerNumber, int controllerValue) override;
 
+    using juce::MPESynthesiser::renderNextSubBlock;
+    void renderNextSubBlock (juce::AudioBuffer<float>&, int startSample, int numSamples) override;
+
     void flushPluginStateToValueTree() override;
 
     void loadModMatrix();
@@ -383,6 +397,11 @@ private:
     std::unique_ptr<FOChorus> chorus;
     std::unordered_map<AutomatableParameter*, ValueSmoother<float>> smoothers;
 
+    friend class FourOscVoice;
+    std::unique_ptr<FourOscVoiceBatch> voiceBatch;
+    std::atomic<bool> voiceBatchingEnabled { true };
+    juce::Random random;
+
     bool flushingState = false;
     float currentTempo = 0.0f;
     LevelMeasurer levelMeasurer;
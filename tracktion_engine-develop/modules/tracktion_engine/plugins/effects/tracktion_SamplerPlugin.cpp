@@ -14,35 +14,51 @@ namespace tracktion { inline namespace engine
 // this must be high enough for low freq sounds not to click
 static constexpr int minimumSamplesToPlayWhenStopping = 8;
 static constexpr int maximumSimultaneousNotes = 32;
+static constexpr int maximumStreamingNotesPerSound = 8;
 
 
 struct SamplerPlugin::SampledNote   : public ReferenceCountedObject
 {
 public:
-    SampledNote (int midiNote, int keyNote,
-                 float velocity,
-                 const AudioFile& file,
+    SampledNote (int midiNote, float velocity,
+                 SamplerSound& soundToPlay,
                  double sampleRate,
                  int sampleDelayFromBufferStart,
-                 const juce::AudioBuffer<float>& data,
-                 int lengthInSamples,
-                 float gainDb,
-                 float pan,
-                 bool openEnded_)
+                 bool isRendering)
        : note (midiNote),
          offset (-sampleDelayFromBufferStart),
-         audioData (data),
-         openEnded (openEnded_)
+         sound (soundToPlay),
+         audioData (sound.audioData),
+         numPreloadedSamples (sound.numPreloadedSamples),
+         fileStartSample (sound.fileStartSample),
+         fileLengthSamples (sound.fileLengthSamples),
+         timeoutMs (isRendering ? 5000 : 0),
+         openEnded (sound.openEnded)
     {
         resampler[0].reset();
         resampler[1].reset();
 
-        const float volumeSliderPos = decibelsToVolumeFaderPosition (gainDb - (20.0f * (1.0f - velocity)));
-        getGainsFromVolumeFaderPositionAndPan (volumeSliderPos, pan, getDefaultPanLaw(), gains[0], gains[1]);
+        const float volumeSliderPos = decibelsToVolumeFaderPosition (sound.gainDb - (20.0f * (1.0f - velocity)));
+        getGainsFromVolumeFaderPositionAndPan (volumeSliderPos, sound.pan, getDefaultPanLaw(), gains[0], gains[1]);
 
         const double hz = juce::MidiMessage::getMidiNoteInHertz (midiNote);
-        playbackRatio = hz / juce::MidiMessage::getMidiNoteInHertz (keyNote);
-        playbackRatio *= file.getSampleRate() / sampleRate;
+        playbackRatio = hz / juce::MidiMessage::getMidiNoteInHertz (sound.keyNote);
+        playbackRatio *= sound.audioFile.getSampleRate() / sampleRate;
+
+        auto lengthInSamples = fileLengthSamples;
+
+        if (sound.isStreaming())
+        {
+            // When rendering, readers can be created straight away. Otherwise, a new one is
+            // created on the message thread whilst the preloaded part is playing
+            if (auto r = sound.getFreeStreamingReader (isRendering))
+                setStreamingReader (r);
+            else if (sound.canAddStreamingReader())
+                isWaitingForStreamingReader = true;
+            else
+                lengthInSamples = numPreloadedSamples; // If there are already too many notes streaming this sound, just play the preloaded part
+        }
+
         samplesLeftToPlay = playbackRatio > 0 ? (1 + (int) (lengthInSamples / playbackRatio)) : 0;
     }
 
@@ -62,22 +78,24 @@ public:
 
         if (numSamps > 0)
         {
+            const int numSampsNeeded = 4 + (int) std::ceil (numSamps * playbackRatio);
             int numUsed = 0;
 
-            for (int i = std::min (2, outBuffer.getNumChannels()); --i >= 0;)
+            if (needsStreamedSamples (numSampsNeeded))
             {
-                numUsed = resampler[i]
-                            .processAdding (playbackRatio,
-                                            audioData.getReadPointer (std::min (i, audioData.getNumChannels() - 1), offset),
-                                            outBuffer.getWritePointer (i, startSamp),
-                                            numSamps,
-                                            gains[i]);
+                AudioScratchBuffer scratch (audioData.getNumChannels(), numSampsNeeded);
+                readSourceSamples (scratch.buffer, numSampsNeeded);
+                numUsed = addResampled (scratch.buffer, 0, outBuffer, startSamp, numSamps);
+            }
+            else
+            {
+                numUsed = addResampled (audioData, offset, outBuffer, startSamp, numSamps);
             }
 
             offset += numUsed;
             samplesLeftToPlay -= numSamps;
 
-            jassert (offset <= audioData.getNumSamples());
+            jassert (isStreaming() || offset <= audioData.getNumSamples());
         }
 
         if (numSamples > numSamps && startFade > 0.0f)
@@ -99,7 +117,16 @@ public:
             const int numSampsNeeded = 2 + juce::roundToInt ((numSamps + 2) * playbackRatio);
             AudioScratchBuffer scratch (audioData.getNumChannels(), numSampsNeeded + 8);
 
-            if (offset + numSampsNeeded < audioData.getNumSamples())
+            // The preloaded data is padded by 32 samples, so streamed notes stop at the same point as preloaded ones
+            if (offset + numSampsNeeded >= fileLengthSamples + 32)
+            {
+                scratch.buffer.clear();
+            }
+            else if (needsStreamedSamples (numSampsNeeded))
+            {
+                readSourceSamples (scratch.buffer, numSampsNeeded);
+            }
+            else if (offset + numSampsNeeded < audioData.getNumSamples())
             {
                 for (int i = scratch.buffer.getNumChannels(); --i >= 0;)
                     scratch.buffer.copyFrom (i, 0, audioData, i, offset, numSampsNeeded);
@@ -115,15 +142,7 @@ public:
 
             startFade = endFade;
 
-            int numUsed = 0;
-
-            for (int i = std::min (2, outBuffer.getNumChannels()); --i >= 0;)
-                numUsed = resampler[i].processAdding (playbackRatio,
-                                                      scratch.buffer.getReadPointer (std::min (i, scratch.buffer.getNumChannels() - 1)),
-                                                      outBuffer.getWritePointer (i, startSamp),
-                                                      numSamps, gains[i]);
-
-            offset += numUsed;
+            offset += addResampled (scratch.buffer, 0, outBuffer, startSamp, numSamps);
 
             if (startFade <= 0.0f)
                 isFinished = true;
@@ -135,18 +154,95 @@ public:
     int offset, samplesLeftToPlay = 0;
     float gains[2];
     double playbackRatio = 1.0;
+    SamplerSound& sound;
     const juce::AudioBuffer<float>& audioData;
+    const int numPreloadedSamples, fileStartSample, fileLengthSamples, timeoutMs;
+    AudioFileCache::Reader::Ptr streamingReader;
+    bool isWaitingForStreamingReader = false;
     float lastVals[4] = { 0, 0, 0, 0 };
     float startFade = 1.0f;
     bool openEnded, isFinished = false;
 
+    void setStreamingReader (AudioFileCache::Reader::Ptr r)
+    {
+        streamingReader = std::move (r);
+        streamingReader->setReadPosition (fileStartSample + std::max (offset, numPreloadedSamples));
+        isWaitingForStreamingReader = false;
+    }
+
 private:
+    bool isStreaming() const noexcept
+    {
+        return streamingReader != nullptr || isWaitingForStreamingReader;
+    }
+
+    int addResampled (const juce::AudioBuffer<float>& source, int sourceOffset,
+                      juce::AudioBuffer<float>& outBuffer, int startSamp, int numSamps)
+    {
+        int numUsed = 0;
+
+        for (int i = std::min (2, outBuffer.getNumChannels()); --i >= 0;)
+            numUsed = resampler[i].processAdding (playbackRatio,
+                                                  source.getReadPointer (std::min (i, source.getNumChannels() - 1), sourceOffset),
+                                                  outBuffer.getWritePointer (i, startSamp),
+                                                  numSamps, gains[i]);
+
+        return numUsed;
+    }
+
+    bool needsStreamedSamples (int numSampsNeeded) const noexcept
+    {
+        return isStreaming() && offset + numSampsNeeded > numPreloadedSamples;
+    }
+
+    /** Fills a buffer with the source samples from the current offset, taking them from the
+        preloaded data where possible and streaming the rest from the file.
+    */
+    void readSourceSamples (juce::AudioBuffer<float>& dest, int numSampsNeeded)
+    {
+        const int numFromPreload = juce::jlimit (0, numSampsNeeded, numPreloadedSamples - offset);
+
+        if (numFromPreload > 0)
+            for (int i = dest.getNumChannels(); --i >= 0;)
+                dest.copyFrom (i, 0, audioData, i, offset, numFromPreload);
+
+        const auto streamStart = offset + numFromPreload;
+        const auto numToStream = juce::jlimit (0, numSampsNeeded - numFromPreload, fileLengthSamples - streamStart);
+        const auto numLeft = numSampsNeeded - numFromPreload - numToStream;
+
+        if (numToStream > 0)
+        {
+            // This will be silent if the reader still hasn't been created by the end of the preload
+            if (streamingReader == nullptr)
+            {
+                dest.clear (numFromPreload, numToStream);
+            }
+            else
+            {
+                streamingReader->setReadPosition (fileStartSample + streamStart);
+
+                if (! streamingReader->readSamples (numToStream, dest,
+                                                    juce::AudioChannelSet::canonicalChannelSet (dest.getNumChannels()),
+                                                    numFromPreload, juce::AudioChannelSet::stereo(), timeoutMs))
+                    dest.clear (numFromPreload, numToStream);
+            }
+        }
+
+        if (numLeft > 0)
+            dest.clear (numSampsNeeded - numLeft, numLeft);
+    }
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SampledNote)
 };
 
 //==============================================================================
 SamplerPlugin::SamplerPlugin (PluginCreationInfo info)  : Plugin (info)
 {
+    auto um = getUndoManager();
+
+    streamFromDisk.referTo (state, IDs::streamFromDisk, um, false);
+    preloadTimeMs.referTo (state, IDs::preloadTimeMs, um, 250);
+
     triggerAsyncUpdate();
 }
 
@@ -198,7 +294,9 @@ void SamplerPlugin::handleAsyncUpdate()
         {
             if (s->source == newSound->source
                 && s->startTime == newSound->startTime
-                && s->length == newSound->length)
+                && s->length == newSound->length
+                && s->numPreloadedSamples == newSound->numPreloadedSamples
+                && s->isStreaming() == newSound->isStreaming())
             {
                 newSound->audioFile = s->audioFile;
                 newSound->fileStartSample = s->fileStartSample;
@@ -220,6 +318,38 @@ void SamplerPlugin::handleAsyncUpdate()
     changed();
 }
 
+void SamplerPlugin::createStreamingReaders()
+{
+    CRASH_TRACER
+    juce::Array<SamplerSound*> soundsToAddReadersTo;
+
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (auto n : playingNotes)
+            if (n->isWaitingForStreamingReader)
+                soundsToAddReadersTo.add (&n->sound);
+    }
+
+    // The readers are created without the lock held as this may need to open the file.
+    // The sounds can only be replaced on this thread so will still be valid
+    juce::ReferenceCountedArray<AudioFileCache::Reader> newReaders;
+
+    for (auto sound : soundsToAddReadersTo)
+        newReaders.add (engine.getAudioFileManager().cache.createReader (sound->audioFile));
+
+    const juce::ScopedLock sl (lock);
+
+    for (int i = 0; i < soundsToAddReadersTo.size(); ++i)
+        if (auto r = newReaders[i]; r != nullptr && soundsToAddReadersTo[i]->canAddStreamingReader())
+            soundsToAddReadersTo[i]->streamingReaders.add (r);
+
+    for (auto n : playingNotes)
+        if (n->isWaitingForStreamingReader)
+            if (auto r = n->sound.getFreeStreamingReader (false))
+                n->setStreamingReader (r);
+}
+
 void SamplerPlugin::initialise (const PluginInitialisationInfo&)
 {
     const juce::ScopedLock sl (lock);
@@ -256,17 +386,10 @@ void SamplerPlugin::playNotes (const juce::BigInteger& keysDown)
                          && (! ss->audioFile.isNull())
                          && playingNotes.size() < maximumSimultaneousNotes)
                     {
-                        playingNotes.add (new SampledNote (note,
-                                                           ss->keyNote,
-                                                           0.75f,
-                                                           ss->audioFile,
-                                                           sampleRate,
-                                                           0,
-                                                           ss->audioData,
-                                                           ss->fileLengthSamples,
-                                                           ss->gainDb,
-                                                           ss->pan,
-                                                           ss->openEnded));
+                        playingNotes.add (new SampledNote (note, 0.75f, *ss, sampleRate, 0, false));
+
+                        if (playingNotes.getLast()->isWaitingForStreamingReader)
+                            streamingReaderCreator.triggerAsyncUpdate();
                     }
                 }
             }
@@ -328,17 +451,12 @@ void SamplerPlugin::applyToBuffer (const PluginRenderContext& fc)
                         {
                             highlightedNotes.setBit (note);
 
-                            playingNotes.add (new SampledNote (note,
-                                                               ss->keyNote,
-                                                               m.getVelocity() / 127.0f,
-                                                               ss->audioFile,
-                                                               sampleRate,
-                                                               noteTimeSample,
-                                                               ss->audioData,
-                                                               ss->fileLengthSamples,
-                                                               ss->gainDb,
-                                                               ss->pan,
-                                                               ss->openEnded));
+                            playingNotes.add (new SampledNote (note, m.getVelocity() / 127.0f, *ss,
+                                                               sampleRate, noteTimeSample,
+                                                               fc.isRendering));
+
+                            if (playingNotes.getLast()->isWaitingForStreamingReader)
+                                streamingReaderCreator.triggerAsyncUpdate();
                         }
                     }
                 }
@@ -653,16 +771,27 @@ void SamplerPlugin::SamplerSound::setExcerpt (double startTime_, double length_)
 
         fileStartSample   = juce::roundToInt (startTime * audioFile.getSampleRate());
         fileLengthSamples = juce::roundToInt (length * audioFile.getSampleRate());
+        numPreloadedSamples = fileLengthSamples;
+        streamingReaders.clear();
+
+        if (owner.streamFromDisk.get())
+            numPreloadedSamples = std::min (fileLengthSamples,
+                                            juce::roundToInt (owner.preloadTimeMs.get() * audioFile.getSampleRate() / 1000.0));
 
         if (auto reader = owner.engine.getAudioFileManager().cache.createReader (audioFile))
         {
-            audioData.setSize (audioFile.getNumChannels(), fileLengthSamples + 32);
+            // The reader used to preload the sound is kept for the first note to stream the rest.
+            // Any others are only created when more notes play it at once
+            if (numPreloadedSamples < fileLengthSamples)
+                streamingReaders.add (reader);
+
+            audioData.setSize (audioFile.getNumChannels(), numPreloadedSamples + 32);
             audioData.clear();
 
             auto audioDataChannelSet = juce::AudioChannelSet::canonicalChannelSet (audioFile.getNumChannels());
             auto channelsToUse = juce::AudioChannelSet::stereo();
 
-            int total = fileLengthSamples;
+            int total = numPreloadedSamples;
             int offset = 0;
 
             while (total > 0)
@@ -682,6 +811,7 @@ void SamplerPlugin::SamplerSound::setExcerpt (double startTime_, double length_)
         }
         else
         {
+            numPreloadedSamples = fileLengthSamples;
             audioData.clear();
         }
 
@@ -704,6 +834,30 @@ void SamplerPlugin::SamplerSound::setExcerpt (double startTime_, double length_)
     }
 }
 
+AudioFileCache::Reader::Ptr SamplerPlugin::SamplerSound::getFreeStreamingReader (bool createIfNeeded)
+{
+    // Playing notes hold a reference to the reader they're using
+    for (auto r : streamingReaders)
+        if (r->getReferenceCount() == 1)
+            return r;
+
+    if (createIfNeeded && canAddStreamingReader())
+    {
+        if (auto r = owner.engine.getAudioFileManager().cache.createReader (audioFile))
+        {
+            streamingReaders.add (r);
+            return r;
+        }
+    }
+
+    return {};
+}
+
+bool SamplerPlugin::SamplerSound::canAddStreamingReader() const
+{
+    return isStreaming() && streamingReaders.size() < maximumStreamingNotesPerSound;
+}
+
 void SamplerPlugin::SamplerSound::refreshFile()
 {
     audioFile = AudioFile (owner.edit.engine);
@@ -46,6 +46,18 @@ public:
     void playNotes (const juce::BigInteger& keysDown);
     void allNotesOff();
 
+    //==============================================================================
+    /** When enabled, only the start of each sound is loaded in to memory and the rest is
+        streamed from the AudioFileCache as notes play. This keeps the load time and memory
+        use of large multi-sample kits proportional to the number of sounds, not their length.
+    */
+    juce::CachedValue<bool> streamFromDisk;
+
+    /** The length of the start of each sound to load when streaming, in milliseconds.
+        This needs to be long enough for the cache to have read the rest by the time it's needed.
+    */
+    juce::CachedValue<int> preloadTimeMs;
+
     //==============================================================================
     static const char* getPluginName()                  { return NEEDS_TRANS("Sampler"); }
     static const char* xmlTypeName;
@@ -94,6 +106,27 @@ public:
         AudioFile audioFile;
         juce::AudioBuffer<float> audioData { 2, 64 };
 
+        /** The number of samples from fileStartSample in audioData.
+            When streaming, this is only the preloaded start of the sound.
+        */
+        int numPreloadedSamples = 0;
+
+        /** Readers used to stream the rest of the sound, one for each note playing it at once.
+            This starts with the reader used to preload the sound and more are added as needed.
+        */
+        juce::ReferenceCountedArray<AudioFileCache::Reader> streamingReaders;
+
+        bool isStreaming() const noexcept               { return numPreloadedSamples < fileLengthSamples; }
+
+        /** Returns a reader that isn't being used by a playing note.
+            If they're all in use and createIfNeeded is true, this adds a new one if there's room.
+            Otherwise it returns nullptr.
+        */
+        AudioFileCache::Reader::Ptr getFreeStreamingReader (bool createIfNeeded);
+
+        /** Returns true if there's room for another streaming reader. */
+        bool canAddStreamingReader() const;
+
     private:
         JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SamplerSound)
     };
@@ -107,8 +140,10 @@ private:
     juce::ReferenceCountedArray<SampledNote> playingNotes;
     juce::OwnedArray<SamplerSound> soundList;
     juce::BigInteger highlightedNotes;
+    AsyncCaller streamingReaderCreator { [this] { createStreamingReaders(); } };
 
     juce::ValueTree getSound (int index) const;
+    void createStreamingReaders();
 
     void valueTreeChanged() override;
     void handleAsyncUpdate() override;
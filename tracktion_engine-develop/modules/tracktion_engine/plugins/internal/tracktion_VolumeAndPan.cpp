@@ -149,9 +149,10 @@ juce::ValueTree VolumeAndPanPlugin::create()
 const char* VolumeAndPanPlugin::xmlTypeName = "volume";
 
 //==============================================================================
-void VolumeAndPanPlugin::initialise (const PluginInitialisationInfo&)
+void VolumeAndPanPlugin::initialise (const PluginInitialisationInfo& info)
 {
     refreshVCATrack();
+    volumeAutomationBuffer.resize ((size_t) info.blockSizeSamples);
 
     auto sliderPos = getSliderPos();
     getGainsFromVolumeFaderPositionAndPan (sliderPos, getPan(), getPanLaw(), lastGainL, lastGainR);
@@ -212,6 +213,14 @@ void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
                                 : 0.0f;
             }
 
+            if (applySampleAccurateVolume (fc, vcaPosDelta))
+            {
+                if (applyToMidi && fc.bufferForMidiMessages != nullptr)
+                    fc.bufferForMidiMessages->multiplyVelocities (volumeFaderPositionToGain (getSliderPos()));
+
+                return;
+            }
+
             float lgain, rgain;
             getGainsFromVolumeFaderPositionAndPan (getSliderPos() + vcaPosDelta, getPan(), getPanLaw(), lgain, rgain);
             lgain *= (polarity ? -1 : 1);
@@ -242,6 +251,59 @@ void VolumeAndPanPlugin::applyToBuffer (const PluginRenderContext& fc)
     }
 }
 
+bool VolumeAndPanPlugin::applySampleAccurateVolume (const PluginRenderContext& fc, float vcaPosDelta)
+{
+    const int numSamples = fc.bufferNumSamples;
+
+    if (! fc.isPlaying || fc.isScrubbing
+        || numSamples > (int) volumeAutomationBuffer.size()
+        || ! volParam->getValuesForBlock (fc.editTime, volumeAutomationBuffer.data(), numSamples))
+        return false;
+
+    // Pan is still applied per block so find its gains at unity
+    float panGainL, panGainR;
+    getGainsFromVolumeFaderPositionAndPan (decibelsToVolumeFaderPosition (0.0f), getPan(), getPanLaw(), panGainL, panGainR);
+
+    auto gains = volumeAutomationBuffer.data();
+    const float polarityGain = polarity ? -1.0f : 1.0f;
+
+    for (int i = 0; i < numSamples; ++i)
+        gains[i] = volumeFaderPositionToGain (gains[i] + vcaPosDelta) * polarityGain;
+
+    // Like the block based gain ramps, any jump from the last block's gain, e.g. from a pan
+    // or VCA change, is smoothed out over the block
+    auto applyGains = [&] (float* dest, float panGain, float lastChannelGain)
+    {
+        const auto startError = lastChannelGain - gains[0] * panGain;
+        const auto errorDelta = startError / (float) numSamples;
+
+        for (int i = 0; i < numSamples; ++i)
+            dest[i] *= gains[i] * panGain + (startError - errorDelta * (float) i);
+    };
+
+    auto& buffer = *fc.destBuffer;
+    const int numChans = buffer.getNumChannels();
+
+    for (int chan = 0; chan < numChans; ++chan)
+    {
+        auto dest = buffer.getWritePointer (chan, fc.bufferStartSample);
+
+        // If the number of channels is greater than two, just apply volume
+        if (chan < 2)
+            applyGains (dest, chan == 0 ? panGainL : panGainR, chan == 0 ? lastGainL : lastGainR);
+        else
+            applyGains (dest, 1.0f, lastGainS);
+    }
+
+    // Keep the last gains so there's no jump if the next block isn't sample-accurate
+    const auto lastGain = gains[numSamples - 1];
+    lastGainL = lastGain * panGainL;
+    lastGainR = lastGain * panGainR;
+    lastGainS = lastGain;
+
+    return true;
+}
+
 void VolumeAndPanPlugin::refreshVCATrack()
 {
     juce::ReferenceCountedObjectPtr<AudioTrack> newVcaTrack (ignoreVca ? nullptr : dynamic_cast<AudioTrack*> (getOwnerTrack()));
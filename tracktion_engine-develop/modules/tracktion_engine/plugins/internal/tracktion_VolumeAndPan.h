@@ -56,6 +56,7 @@ public:
     juce::String getShortName (int) override                { return "VolPan"; }
     juce::String getSelectableDescription() override        { return getName(); }
     bool needsConstantBufferSize() override                 { return false; }
+    bool hasKnownTailLength() const override                { return true; }
 
     void initialise (const PluginInitialisationInfo&) override;
     void initialiseWithoutStopping (const PluginInitialisationInfo&) override;
@@ -76,12 +77,14 @@ public:
 
 private:
     float lastGainL = 0.0f, lastGainR = 0.0f, lastGainS = 0.0f, lastVolumeBeforeMute = 0.0f;
+    std::vector<float> volumeAutomationBuffer;
 
     RealTimeSpinLock vcaTrackLock;
     juce::ReferenceCountedObjectPtr<AudioTrack> vcaTrack;
     const bool isMasterVolume = false;
 
     void refreshVCATrack();
+    bool applySampleAccurateVolume (const PluginRenderContext&, float vcaPosDelta);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VolumeAndPanPlugin)
 };
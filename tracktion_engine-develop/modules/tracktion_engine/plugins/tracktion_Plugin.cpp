@@ -660,37 +660,31 @@ void Plugin::applyToBufferWithAutomation (const PluginRenderContext& pc)
     if (shoulMeasureCpuUsage())
         cpuMeter.emplace (cpuUsageMs, 0.2);
 
-    auto& arm = edit.getAutomationRecordManager();
     jassert (initialiseCount > 0);
    #if JUCE_DEBUG
     jassert (! isInitialisingFlag);
    #endif
 
+    updateAutomationWithoutProcessing (pc);
+    applyToBuffer (pc);
+}
+
+void Plugin::updateAutomationWithoutProcessing (const PluginRenderContext& pc)
+{
+    SCOPED_REALTIME_CHECK
+    auto& arm = edit.getAutomationRecordManager();
+
     updateLastPlaybackTime();
 
     if (isAutomationNeeded()
         && (arm.isReadingAutomation() || isClipEffect.load()))
     {
-        if (pc.isScrubbing || ! pc.isPlaying)
-        {
-            SCOPED_REALTIME_CHECK
-            auto& tc = edit.getTransport();
-            updateParameterStreams (tc.isPlayContextActive() && ! pc.isRendering
-                                        ? tc.getPosition()
-                                        : pc.editTime.getStart());
-            applyToBuffer (pc);
-        }
+        auto& tc = edit.getTransport();
+
+        if ((pc.isScrubbing || ! pc.isPlaying) && tc.isPlayContextActive() && ! pc.isRendering)
+            updateParameterStreams (tc.getPosition());
         else
-        {
-            SCOPED_REALTIME_CHECK
             updateParameterStreams (pc.editTime.getStart());
-            applyToBuffer (pc);
-        }
-    }
-    else
-    {
-        SCOPED_REALTIME_CHECK
-        applyToBuffer (pc);
     }
 }
 
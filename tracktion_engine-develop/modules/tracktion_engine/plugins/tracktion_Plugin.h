@@ -214,6 +214,13 @@ public:
     // wrapper on applyTobuffer, called by the node
     void applyToBufferWithAutomation (const PluginRenderContext&);
 
+    /** Updates the automated parameters for a block without processing it.
+        Called by the node instead of applyToBufferWithAutomation when it skips the
+        plugin, e.g. because its input is silent, so the parameters keep following
+        their automation.
+    */
+    void updateAutomationWithoutProcessing (const PluginRenderContext&);
+
     /** Plugins can return false if they want to avoid the overhead of measuring the CPU usage.
         It's a small overhead but with many tracks, the level meters and vol/pan plugins can make a difference.
     */
@@ -241,6 +248,12 @@ public:
     virtual bool isSynth()                              { return false; }
     virtual double getLatencySeconds()                  { return 0.0; }
     virtual double getTailLength() const                { return 0.0; }
+
+    /** Should return true if the plugin's output is guaranteed to be silent once its input has
+        been silent for getTailLength() seconds (plus any latency), in which case processing can
+        be skipped until the input becomes non-silent again.
+    */
+    virtual bool hasKnownTailLength() const             { return false; }
     virtual bool canSidechain();
 
     juce::StringArray getInputChannelNames();
@@ -391,6 +391,203 @@ TEST_SUITE ("tracktion_engine")
             CHECK_EQ (setAndGet (15_tp), 0.0f);
         }
     }
+
+    TEST_CASE ("Sample-accurate automation")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volParam = getAudioTracks(*edit)[0]->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+
+        // A linear ramp from 0s to 1s followed by a flat section
+        volCurve.addPoint (0_tp, 0.0f, 0.0f);
+        volCurve.addPoint (1_tp, 1.0f, 0.0f);
+        volCurve.addPoint (2_tp, 1.0f, 0.0f);
+
+        AutomationIterator iter (*volParam);
+        std::vector<float> values (100);
+
+        // Within the ramp, each sample should follow the curve
+        CHECK (iter.getValues ({ 0.25_tp, 0.5_tp }, values.data(), (int) values.size()));
+
+        for (size_t i = 0; i < values.size(); ++i)
+            CHECK_EQ (values[i], doctest::Approx (0.25 + 0.25 * (double) i / values.size()).epsilon (0.01));
+
+        // Crossing the end of the ramp
+        CHECK (iter.getValues ({ 0.95_tp, 1.05_tp }, values.data(), (int) values.size()));
+        CHECK_EQ (values.front(), doctest::Approx (0.95f).epsilon (0.01));
+        CHECK_EQ (values.back(), doctest::Approx (1.0f).epsilon (0.01));
+        CHECK (std::is_sorted (values.begin(), values.end()));
+
+        // Flat sections and past the end don't need a buffer
+        CHECK (! iter.getValues ({ 1.25_tp, 1.5_tp }, values.data(), (int) values.size()));
+        CHECK (! iter.getValues ({ 5_tp, 6_tp }, values.data(), (int) values.size()));
+
+        // Curves, including steep ones with flat ends, should match the curve at each sample
+        volCurve.setCurveValue (0, 0.3f);
+        volCurve.setCurveValue (1, 0.0f);
+        volCurve.addPoint (3_tp, 0.0f, 0.8f);
+        volCurve.addPoint (4_tp, 0.5f, 0.0f);
+
+        for (auto range : { TimeRange (0_tp, 1_tp), TimeRange (2_tp, 4_tp) })
+        {
+            AutomationIterator curvedIter (*volParam);
+            CHECK (curvedIter.getValues (range, values.data(), (int) values.size()));
+
+            for (size_t i = 0; i < values.size(); ++i)
+            {
+                const auto time = range.getStart() + range.getLength() * ((double) i / (double) values.size());
+                CHECK_EQ (values[i], doctest::Approx (volCurve.getValueAt (time)).epsilon (0.001));
+            }
+        }
+
+        // Getting values shouldn't change the current position
+        iter.setPosition (0.5_tp);
+        const auto currentValue = iter.getCurrentValue();
+        CHECK (iter.getValues ({ 0_tp, 0.1_tp }, values.data(), (int) values.size()));
+        CHECK_EQ (iter.getCurrentValue(), currentValue);
+    }
+
+    TEST_CASE ("Sample-accurate volume automation output")
+    {
+        HostedAudioDeviceInterface::Parameters p;
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+        auto track = getAudioTracks (*edit)[0];
+
+        // A constant signal so the output is just the gain applied
+        const auto duration = 2_td;
+        choc::buffer::ChannelArrayBuffer<float> dc (choc::buffer::Size::create (2, toSamples (duration, p.sampleRate)));
+        choc::buffer::setAllFrames (dc, [] { return 0.5f; });
+        auto dcFile = graph::test_utilities::writeToTemporaryFile<juce::WavAudioFormat> (dc, p.sampleRate);
+        const AudioFile af (engine, dcFile->getFile());
+        insertWaveClip (*track, {}, dcFile->getFile(), { { 0_tp, duration } }, DeleteExistingClips::no);
+
+        // Unity gain, then a steep bezier down which the 10ms interpolation grid wouldn't follow exactly
+        auto volParam = track->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+        const auto unityPos = decibelsToVolumeFaderPosition (0.0f);
+        volCurve.addPoint (0_tp, unityPos, 0.0f);
+        volCurve.addPoint (0.5_tp, unityPos, 0.45f);
+        volCurve.addPoint (1.5_tp, 0.1f, 0.0f);
+
+        // The curve is normally updated asynchronously
+        volParam->updateStream();
+
+        auto player = test_utilities::createEnginePlayer (*edit, p, { af });
+        player->process (toSamples (duration, p.sampleRate));
+        auto output = player->getOutput();
+
+        // The pan gains are constant so find them from the unity section
+        const auto unitySample = (choc::buffer::FrameCount) toSamples (0.25_tp, p.sampleRate);
+        const auto panGain = output.getSample (0, unitySample) / 0.5f;
+        CHECK (panGain > 0.0f);
+
+        float maxError = 0.0f;
+
+        for (auto sample = (choc::buffer::FrameCount) toSamples (0.5_tp, p.sampleRate);
+             sample < (choc::buffer::FrameCount) toSamples (1.5_tp, p.sampleRate); ++sample)
+        {
+            const auto time = TimePosition::fromSamples (sample, p.sampleRate);
+            const auto expected = 0.5f * panGain * volumeFaderPositionToGain (volCurve.getValueAt (time));
+            maxError = std::max (maxError, std::abs (output.getSample (0, sample) - expected));
+        }
+
+        CHECK (maxError < 1.0e-4f);
+    }
+
+    TEST_CASE ("Sample-accurate volume automation smooths pan changes")
+    {
+        HostedAudioDeviceInterface::Parameters p;
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+        auto track = getAudioTracks (*edit)[0];
+
+        const auto duration = 2_td;
+        choc::buffer::ChannelArrayBuffer<float> dc (choc::buffer::Size::create (2, toSamples (duration, p.sampleRate)));
+        choc::buffer::setAllFrames (dc, [] { return 0.5f; });
+        auto dcFile = graph::test_utilities::writeToTemporaryFile<juce::WavAudioFormat> (dc, p.sampleRate);
+        const AudioFile af (engine, dcFile->getFile());
+        insertWaveClip (*track, {}, dcFile->getFile(), { { 0_tp, duration } }, DeleteExistingClips::no);
+
+        // A slow ramp so every block uses the sample-accurate gains
+        auto volumePlugin = track->getVolumePlugin();
+        auto& volCurve = volumePlugin->volParam->getCurve();
+        volCurve.addPoint (0_tp, decibelsToVolumeFaderPosition (0.0f), 0.0f);
+        volCurve.addPoint (2_tp, decibelsToVolumeFaderPosition (-6.0f), 0.0f);
+        volumePlugin->volParam->updateStream();
+
+        auto player = test_utilities::createEnginePlayer (*edit, p, { af });
+        player->process (toSamples (1_td, p.sampleRate));
+        volumePlugin->setPan (-1.0f);
+        player->process (toSamples (1_td, p.sampleRate));
+
+        // Panning hard left should ramp the right channel down rather than stepping
+        auto output = player->getOutput();
+        const auto startSample = (choc::buffer::FrameCount) toSamples (0.25_tp, p.sampleRate);
+        float maxStep = 0.0f;
+
+        for (auto sample = startSample; sample < output.getNumFrames(); ++sample)
+            maxStep = std::max (maxStep, std::abs (output.getSample (1, sample) - output.getSample (1, sample - 1)));
+
+        CHECK (output.getSample (1, startSample) > 0.1f);
+        CHECK (output.getSample (0, startSample * 3) < output.getSample (0, startSample));
+        CHECK (std::abs (output.getSample (1, output.getNumFrames() - 1)) < 1.0e-3f);
+        CHECK (maxStep < 0.01f);
+    }
+
+    TEST_CASE ("Incremental automation iterator")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1);
+        auto volParam = getAudioTracks(*edit)[0]->getVolumePlugin()->volParam;
+        auto& volCurve = volParam->getCurve();
+
+        for (int i = 0; i < 20; ++i)
+            volCurve.addPoint (TimePosition::fromSeconds (i * 0.5), (i % 3) / 3.0f, (i % 4) * 0.25f - 0.5f);
+
+        auto previous = std::make_unique<AutomationIterator> (*volParam);
+
+        // Each edit is applied cumulatively and an incremental rebuild should match a full one
+        auto checkMatchesFullRebuild = [&]
+        {
+            auto incremental = std::make_unique<AutomationIterator> (*volParam, *previous);
+            AutomationIterator full (*volParam);
+
+            for (int i = 0; i < 12000; ++i)
+            {
+                const auto t = TimePosition::fromSeconds (i * 0.001);
+                incremental->setPosition (t);
+                full.setPosition (t);
+                CHECK_EQ (incremental->getCurrentValue(), full.getCurrentValue());
+            }
+
+            previous = std::move (incremental);
+        };
+
+        checkMatchesFullRebuild();
+
+        volCurve.movePoint (8, 4.2_tp, 0.9f, false);
+        checkMatchesFullRebuild();
+
+        volCurve.setCurveValue (12, 0.8f);
+        checkMatchesFullRebuild();
+
+        volCurve.addPoint (7.25_tp, 0.1f, 0.0f);
+        checkMatchesFullRebuild();
+
+        volCurve.removePoint (3);
+        checkMatchesFullRebuild();
+
+        volCurve.setPointValue (0, 0.7f);
+        checkMatchesFullRebuild();
+
+        volCurve.movePoint (volCurve.getNumPoints() - 1, 11_tp, 0.2f, false);
+        checkMatchesFullRebuild();
+
+        volCurve.addPoint (10.7_tp, 0.5f, 0.0f);
+        checkMatchesFullRebuild();
+    }
 }
 #endif
 
@@ -422,6 +619,135 @@ TEST_SUITE ("tracktion_engine")
 }
 #endif
 
+#if ENGINE_UNIT_TESTS_PLUGINS
+TEST_SUITE ("tracktion_engine")
+{
+    TEST_CASE ("SamplerPlugin streaming")
+    {
+        auto& engine = *Engine::getEngines()[0];
+        auto sinFile = graph::test_utilities::getSinFile<juce::WavAudioFormat> (44100.0, 3.0, 2);
+
+        auto render = [&] (bool streamFromDisk)
+        {
+            auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+            auto track = getAudioTracks (*edit)[0];
+
+            auto sampler = dynamic_cast<SamplerPlugin*> (edit->getPluginCache().createNewPlugin (SamplerPlugin::xmlTypeName, {}).get());
+            track->pluginList.insertPlugin (*sampler, 0, nullptr);
+
+            sampler->streamFromDisk = streamFromDisk;
+            sampler->preloadTimeMs = 50;
+            CHECK (sampler->addSound (sinFile->getFile().getFullPathName(), "sine", 0.0, 0.0, 0.0f).isEmpty());
+            sampler->setSoundParams (0, 60, 0, 127);
+
+            // The sounds are loaded asynchronously
+            for (int i = 0; i < 100 && ! sampler->getSoundFile (0).isValid(); ++i)
+                juce::MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            REQUIRE (sampler->getSoundFile (0).isValid());
+
+            // Overlapping notes so more than one has to stream the sound at once
+            auto midiClip = track->insertMIDIClip ({ 0.0s, TimePosition (3.0s) }, nullptr);
+
+            for (int i = 0; i < 3; ++i)
+                midiClip->getSequence().addNote (60 + i * 4, BeatPosition::fromBeats (i * 0.5), BeatDuration::fromBeats (4.0), 127, 0, nullptr);
+
+            return engine::test_utilities::renderToAudioBuffer (*edit);
+        };
+
+        // Rendering waits for the streamed samples so should match the fully loaded sound
+        const auto preloaded = render (false);
+        const auto streamed = render (true);
+
+        REQUIRE (preloaded.buffer.getNumSamples() > 0);
+        REQUIRE (streamed.buffer.getNumSamples() == preloaded.buffer.getNumSamples());
+        REQUIRE (streamed.buffer.getNumChannels() == preloaded.buffer.getNumChannels());
+        CHECK (streamed.buffer.getRMSLevel (0, 44100, 44100) > 0.1f);
+
+        float maxError = 0.0f;
+
+        for (int c = 0; c < preloaded.buffer.getNumChannels(); ++c)
+            for (int i = 0; i < preloaded.buffer.getNumSamples(); ++i)
+                maxError = std::max (maxError, std::abs (streamed.buffer.getSample (c, i) - preloaded.buffer.getSample (c, i)));
+
+        CHECK (maxError < 1.0e-6f);
+    }
+
+    TEST_CASE ("FourOscPlugin voice batching")
+    {
+        constexpr int numNotes = 32, blockSize = 512, numBlocks = 50;
+        constexpr double sampleRate = 44100.0;
+        auto& engine = *Engine::getEngines()[0];
+        auto edit = engine::test_utilities::createTestEdit (engine, 1, Edit::EditRole::forEditing);
+
+        // Renders 32 notes with 4 unison voices on each oscillator and a 24dB filter
+        auto render = [&] (bool batched, std::array<Oscillator::Waves, 4> waveShapes)
+        {
+            auto plugin = edit->getPluginCache().createNewPlugin (FourOscPlugin::xmlTypeName, {});
+            auto synth = dynamic_cast<FourOscPlugin*> (plugin.get());
+            REQUIRE (synth != nullptr);
+
+            synth->voiceModeValue = 2;
+            synth->voicesValue = numNotes;
+            synth->filterTypeValue = 1;
+            synth->filterSlopeValue = 24;
+
+            for (int i = 0; i < synth->oscParams.size(); ++i)
+            {
+                synth->oscParams[i]->waveShapeValue = (int) waveShapes[(size_t) i];
+                synth->oscParams[i]->voicesValue = 4;
+                synth->oscParams[i]->detuneValue = 0.2f;
+                synth->oscParams[i]->spreadValue = 50.0f;
+            }
+
+            synth->setVoiceBatchingEnabled (batched);
+            synth->setRandomSeed (1);
+            synth->baseClassInitialise ({ 0s, sampleRate, blockSize });
+
+            MidiMessageArray midi;
+
+            for (int i = 0; i < numNotes; ++i)
+                midi.addMidiMessage (juce::MidiMessage::noteOn (1, 36 + i, (juce::uint8) (64 + i)), 0.0,
+                                     MidiMessageArray::createUniqueMPESourceID());
+
+            juce::AudioBuffer<float> output (2, blockSize * numBlocks);
+            output.clear();
+
+            for (int block = 0; block < numBlocks; ++block)
+            {
+                const auto start = TimePosition::fromSamples (block * blockSize, sampleRate);
+                const auto end = TimePosition::fromSamples ((block + 1) * blockSize, sampleRate);
+                PluginRenderContext rc (&output, juce::AudioChannelSet::stereo(), block * blockSize, blockSize,
+                                        &midi, 0.0, { start, end }, true, false, false, false);
+                synth->applyToBuffer (rc);
+                midi.clear();
+            }
+
+            synth->baseClassDeinitialise();
+            return output;
+        };
+
+        // Batched voices should sound the same as ones rendered one at a time.
+        // Noise oscillators aren't batched but still have to be mixed in with the others
+        for (auto waveShapes : { std::array { Oscillator::sine, Oscillator::square, Oscillator::saw, Oscillator::triangle },
+                                 std::array { Oscillator::saw, Oscillator::triangle, Oscillator::square, Oscillator::noise } })
+        {
+            const auto unbatched = render (false, waveShapes);
+            const auto batched = render (true, waveShapes);
+
+            float maxDifference = 0.0f;
+
+            for (int ch = 0; ch < unbatched.getNumChannels(); ++ch)
+                for (int i = 0; i < unbatched.getNumSamples(); ++i)
+                    maxDifference = std::max (maxDifference, std::abs (unbatched.getSample (ch, i) - batched.getSample (ch, i)));
+
+            CHECK (unbatched.getMagnitude (0, unbatched.getNumSamples()) > 0.0f);
+            CHECK (maxDifference < 1.0e-4f);
+        }
+    }
+}
+#endif
+
 } // namespace tracktion::inline engine
 
 #endif //TRACKTION_UNIT_TESTS
\ No newline at end of file
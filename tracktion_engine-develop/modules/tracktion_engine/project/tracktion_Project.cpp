@@ -63,10 +63,14 @@ void Project::load()
         in->setPosition (objectOffset);
         int num = in->readInt();
 
-        jassert (num >= 0 && num < 20000); // vague sanity check
+        // Each entry in the table is an ID and an offset
+        const auto maxNum = (in->getTotalLength() - in->getPosition()) / (juce::int64) (2 * sizeof (int));
+        jassert (num >= 0 && num <= maxNum); // vague sanity check
 
-        if (num < 20000)
+        if (num <= maxNum)
         {
+            objects.ensureStorageAllocated (num);
+
             while (--num >= 0)
             {
                 ObjectInfo o;
@@ -77,13 +81,13 @@ void Project::load()
                 jassert (o.fileOffset > 0);
 
                 if (o.fileOffset > 0 && o.itemID != 0)
-                    objects.add (o);
+                    addObject (o, false);
             }
         }
     }
     else
     {
-        stream = nullptr;
+        closeInputStream();
         projectId = 0;
     }
 
@@ -92,7 +96,7 @@ void Project::load()
 
 void Project::refreshProjectPropertiesFromFile()
 {
-    stream = nullptr;
+    closeInputStream();
 
     if (auto in = getInputStream())
         readProjectHeader (*in, false);
@@ -103,7 +107,10 @@ bool Project::readProjectHeader (juce::InputStream& in, bool clearObjectInfo)
     CRASH_TRACER
 
     if (clearObjectInfo)
+    {
         objects.clear();
+        objectIndexesNeedRebuilding = true;
+    }
 
     char n[4] = { 0 };
     in.read (n, 4);
@@ -141,7 +148,7 @@ bool Project::loadProjectItem (ObjectInfo& o)
         if (auto in = getInputStream())
         {
             in->setPosition (o.fileOffset);
-            o.item = new ProjectItem (engine, ProjectItemID (o.itemID, projectId), in);
+            o.item = new ProjectItem (engine, ProjectItemID (o.itemID, projectId), in.get());
             return true;
         }
     }
@@ -161,13 +168,25 @@ void Project::loadAllProjectItems()
                 break;
 }
 
-juce::BufferedInputStream* Project::getInputStream()
+std::unique_ptr<juce::InputStream> Project::getInputStream()
 {
-    if (stream == nullptr && file.getSize() > 0)
-        if (auto in = file.createInputStream())
-            stream = std::make_unique<juce::BufferedInputStream> (in.release(), 16384, true);
+    if (mappedFile == nullptr && file.getSize() > 0)
+    {
+        mappedFile = std::make_unique<juce::MemoryMappedFile> (file, juce::MemoryMappedFile::readOnly);
+
+        if (mappedFile->getData() == nullptr)
+            mappedFile.reset();
+    }
 
-    return stream.get();
+    if (mappedFile != nullptr)
+        return std::make_unique<juce::MemoryInputStream> (mappedFile->getData(), mappedFile->getSize(), false);
+
+    return {};
+}
+
+void Project::closeInputStream()
+{
+    mappedFile.reset();
 }
 
 void Project::handleAsyncUpdate()
@@ -195,7 +214,7 @@ bool Project::save()
             saveTo (*out);
             out.reset();
 
-            stream = nullptr;
+            closeInputStream();
             unlockFile();
 
             // try this twice
@@ -332,7 +351,7 @@ void Project::setName (const juce::String& newName)
 
         auto dst = file.getParentDirectory().getChildFile (juce::File::createLegalFileName (newName)
                                                              + file.getFileExtension());
-        stream = nullptr;
+        closeInputStream();
 
         unlockFile();
 
@@ -504,16 +523,51 @@ int Project::getIndexOf (ProjectItemID mo) const
 
     if (mo.getProjectID() == getProjectID())
     {
-        auto itemID = mo.getItemID();
+        rebuildObjectIndexesIfNeeded();
 
-        for (int i = objects.size(); --i >= 0;)
-            if (objects.getReference(i).itemID == itemID)
-                return i;
+        if (auto found = objectIndexes.find (mo.getItemID()); found != objectIndexes.end())
+            return found->second;
     }
 
     return -1;
 }
 
+void Project::addObject (const ObjectInfo& o, bool atStart)
+{
+    const juce::ScopedLock sl (objectLock);
+
+    if (atStart)
+    {
+        objects.insert (0, o);
+        objectIndexesNeedRebuilding = true;
+    }
+    else
+    {
+        objects.add (o);
+
+        // Appending doesn't move any other objects so the index can be updated in place
+        if (! objectIndexesNeedRebuilding)
+            objectIndexes[o.itemID] = objects.size() - 1;
+    }
+}
+
+void Project::rebuildObjectIndexesIfNeeded() const
+{
+    const juce::ScopedLock sl (objectLock);
+
+    if (! objectIndexesNeedRebuilding)
+        return;
+
+    objectIndexes.clear();
+    objectIndexes.reserve ((size_t) objects.size());
+
+    // If there are any duplicate IDs, the last one is used
+    for (int i = 0; i < objects.size(); ++i)
+        objectIndexes[objects.getReference (i).itemID] = i;
+
+    objectIndexesNeedRebuilding = false;
+}
+
 void Project::moveProjectItem (int indexToMoveFrom, int indexToMoveTo)
 {
     if (indexToMoveTo != indexToMoveFrom)
@@ -523,6 +577,7 @@ void Project::moveProjectItem (int indexToMoveFrom, int indexToMoveTo)
         if (indexToMoveFrom >= 0 && indexToMoveFrom < objects.size())
         {
             objects.move (indexToMoveFrom, juce::jlimit (0, objects.size(), indexToMoveTo));
+            objectIndexesNeedRebuilding = true;
             changed();
         }
     }
@@ -548,15 +603,7 @@ ProjectItem::Ptr Project::createNewItem (const juce::File& fileToReference,
                                   ProjectItemID::createNewID (getProjectID()));
         o.itemID = o.item->getID().getItemID();
         o.fileOffset = 0;
-
-        {
-            const juce::ScopedLock sl (objectLock);
-
-            if (atTopOfList)
-                objects.insert (0, o);
-            else
-                objects.add (o);
-        }
+        addObject (o, atTopOfList);
 
         o.item->setSourceFile (fileToReference);
         o.item->verifyLength();
@@ -580,11 +627,7 @@ ProjectItem::Ptr Project::quickAddProjectItem (const juce::String& relPathName,
     o.itemID = o.item->getID().getItemID();
     o.fileOffset = 0;
     o.item->file = relPathName;
-
-    {
-        const juce::ScopedLock sl (objectLock);
-        objects.add (o);
-    }
+    addObject (o, false);
 
     changed();
     return o.item;
@@ -614,6 +657,7 @@ bool Project::removeProjectItem (ProjectItemID item, bool deleteSourceMaterial)
                 }
 
                 objects.remove (index);
+                objectIndexesNeedRebuilding = true;
             }
         }
 
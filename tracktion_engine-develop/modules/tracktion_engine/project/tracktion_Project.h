@@ -153,7 +153,7 @@ private:
     juce::NamedValueSet properties;
     juce::CriticalSection objectLock, propertyLock;
 
-    std::unique_ptr<juce::BufferedInputStream> stream;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
     std::unique_ptr<juce::FileInputStream> fileLockingStream;
 
     struct ObjectInfo
@@ -163,12 +163,21 @@ private:
     };
 
     juce::Array<ObjectInfo> objects;
+    mutable std::unordered_map<int, int> objectIndexes;
+    mutable bool objectIndexesNeedRebuilding = true;
     int objectOffset = 0, indexOffset = 0;
     bool readOnly = false, hasChanged = false, temporary = false;
 
     Project (Engine&, ProjectManager&, const juce::File&);
 
-    juce::BufferedInputStream* getInputStream();
+    /** Returns a stream reading from a memory-mapped view of the project file.
+        The view is shared by all the streams and kept until the file is next changed.
+    */
+    std::unique_ptr<juce::InputStream> getInputStream();
+    void closeInputStream();
+
+    void addObject (const ObjectInfo&, bool atStart);
+    void rebuildObjectIndexesIfNeeded() const;
 
     void load();
     void saveTo (juce::FileOutputStream&);
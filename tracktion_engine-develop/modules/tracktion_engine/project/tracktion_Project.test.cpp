@@ -0,0 +1,224 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_UNIT_TESTS && ENGINE_UNIT_TESTS_PROJECT
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ProjectTests  : public juce::UnitTest
+{
+public:
+    ProjectTests()
+        : juce::UnitTest ("Project", "tracktion_engine")
+    {}
+
+    void runTest() override
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        juce::TemporaryFile tempFile (projectFileSuffix);
+        auto project = ProjectManager::TempProject (engine.getProjectManager(), tempFile.getFile(), true).project;
+
+        beginTest ("Project item indexes");
+        {
+            expect (project != nullptr && project->isValid() && ! project->isReadOnly());
+
+            auto addItem = [&] (const juce::String& name, bool atTopOfList)
+            {
+                auto item = project->createNewItem (tempFile.getFile().getSiblingFile (name + ".wav"),
+                                                    ProjectItem::waveItemType(), name, {},
+                                                    ProjectItem::Category::imported, atTopOfList);
+                expect (item != nullptr);
+                return item->getID();
+            };
+
+            auto a = addItem ("a", false);
+            auto b = addItem ("b", false);
+            auto c = addItem ("c", false);
+            auto d = addItem ("d", true);
+            expectOrder ({ d, a, b, c }, *project);
+
+            project->moveProjectItem (0, 3);
+            expectOrder ({ a, b, c, d }, *project);
+
+            project->moveProjectItem (3, 1);
+            expectOrder ({ a, d, b, c }, *project);
+
+            expect (project->removeProjectItem (b, false));
+            expectOrder ({ a, d, c }, *project);
+            expectEquals (project->getIndexOf (b), -1);
+            expect (project->getProjectItemForID (b) == nullptr);
+
+            auto e = addItem ("e", false);
+            expectOrder ({ a, d, c, e }, *project);
+
+            auto f = addItem ("f", true);
+            expectOrder ({ f, a, d, c, e }, *project);
+        }
+    }
+
+private:
+    void expectOrder (const juce::Array<ProjectItemID>& expectedIDs, Project& project)
+    {
+        expectEquals (project.getNumProjectItems(), expectedIDs.size());
+
+        for (int i = 0; i < expectedIDs.size(); ++i)
+        {
+            const auto itemID = expectedIDs.getReference (i);
+            expect (project.getProjectItemID (i) == itemID);
+            expectEquals (project.getIndexOf (itemID), i);
+
+            auto item = project.getProjectItemForID (itemID);
+            expect (item != nullptr && item->getID() == itemID);
+        }
+    }
+};
+
+static ProjectTests projectTests;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif //TRACKTION_UNIT_TESTS
+
+#if TRACKTION_BENCHMARKS && ENGINE_BENCHMARKS_PROJECT
+
+#include "../playback/graph/tracktion_BenchmarkUtilities.h"
+
+namespace tracktion { inline namespace engine
+{
+
+//==============================================================================
+//==============================================================================
+class ProjectBenchmarks  : public juce::UnitTest
+{
+public:
+    ProjectBenchmarks()
+        : juce::UnitTest ("Project", "tracktion_benchmarks")
+    {}
+
+    void runTest() override
+    {
+        auto& engine = *tracktion::engine::Engine::getEngines()[0];
+        auto& pm = engine.getProjectManager();
+
+        constexpr int numItems = 50'000;
+        constexpr int projectID = 12345;
+        juce::TemporaryFile tempFile (projectFileSuffix);
+
+        beginTest ("Benchmark: Project items");
+
+        writeProjectFile (tempFile.getFile(), projectID, numItems);
+
+        std::vector<int> itemIDs ((size_t) numItems);
+        std::iota (itemIDs.begin(), itemIDs.end(), 1);
+        std::shuffle (itemIDs.begin(), itemIDs.end(), std::mt19937 (42));
+
+        Project::Ptr project;
+
+        {
+            ScopedBenchmark sb (getDescription ("Open project with 50,000 items"));
+            project = ProjectManager::TempProject (pm, tempFile.getFile(), false).project;
+        }
+
+        expect (project != nullptr && project->isValid());
+        expectEquals (project->getNumProjectItems(), numItems);
+        int numFound = 0;
+
+        {
+            ScopedBenchmark sb (getDescription ("Load 50,000 items by ID"));
+
+            for (auto itemID : itemIDs)
+                if (auto item = project->getProjectItemForID (ProjectItemID (itemID, projectID)))
+                    if (item->getName() == getItemName (itemID))
+                        ++numFound;
+        }
+
+        expectEquals (numFound, numItems);
+
+        {
+            ScopedBenchmark sb (getDescription ("Find 50,000 loaded items by ID"));
+
+            for (auto itemID : itemIDs)
+                if (project->getProjectItemForID (ProjectItemID (itemID, projectID)) == nullptr)
+                    --numFound;
+        }
+
+        expectEquals (numFound, numItems);
+    }
+
+private:
+    static juce::String getItemName (int itemID)
+    {
+        return "Item " + juce::String (itemID);
+    }
+
+    /** Writes a project file in the same format as Project::saveTo. */
+    static void writeProjectFile (const juce::File& file, int projectID, int numItems)
+    {
+        juce::FileOutputStream out (file);
+        out.setPosition (0);
+        out.truncate();
+
+        out.write ("TP01", 4);
+        out.writeInt (projectID);
+        out.writeInt (0);
+        out.writeInt (0);
+
+        out.writeInt (1);
+        out.writeString ("name");
+        out.writeInt (8);
+        out.write ("Project", 8);
+
+        std::vector<int> offsets;
+
+        for (int i = 1; i <= numItems; ++i)
+        {
+            offsets.push_back ((int) out.getPosition());
+            out.writeString (getItemName (i));
+            out.writeString (ProjectItem::waveItemType());
+            out.writeString ({});
+            out.writeString ("item" + juce::String (i) + ".wav");
+            out.writeDouble (1.0);
+        }
+
+        const auto objectOffset = (int) out.getPosition();
+        out.writeInt (numItems);
+
+        for (int i = 1; i <= numItems; ++i)
+        {
+            out.writeInt (i);
+            out.writeInt (offsets[(size_t) i - 1]);
+        }
+
+        const auto indexOffset = (int) out.getPosition();
+        out.writeInt (0);
+
+        out.setPosition (8);
+        out.writeInt (objectOffset);
+        out.writeInt (indexOffset);
+    }
+
+    BenchmarkDescription getDescription (std::string bmName)
+    {
+        const auto bmCategory = (getName() + "/" + getCategory()).toStdString();
+        const auto bmDescription = bmName;
+
+        return { std::hash<std::string>{} (bmName + bmCategory + bmDescription),
+                 bmCategory, bmName, bmDescription };
+    }
+};
+
+static ProjectBenchmarks projectBenchmarks;
+
+}} // namespace tracktion { inline namespace engine
+
+#endif //TRACKTION_BENCHMARKS
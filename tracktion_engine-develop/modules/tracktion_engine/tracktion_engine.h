@@ -267,6 +267,7 @@ namespace tracktion::inline graph
 {
     class PlayHead;
     struct LatencyProcessor;
+    class NodeProcessTracer;
 }
 
 //==============================================================================
@@ -499,6 +500,8 @@ namespace tracktion { inline namespace engine
 #include "model/edit/tracktion_PitchSequence.h"
 #include "model/edit/tracktion_Edit.h"
 #include "model/edit/tracktion_EditFileOperations.h"
+#include "model/edit/tracktion_ChunkedEditFile.h"
+#include "model/edit/tracktion_EditJournal.h"
 
 #include "playback/tracktion_TransportControl.h"
 #include "playback/tracktion_AbletonLink.h"
@@ -516,9 +519,13 @@ namespace tracktion { inline namespace engine
 #include "utilities/tracktion_EngineBehaviour.h"
 #include "utilities/tracktion_Pitch.h"
 
+#include "audio_files/tracktion_BufferedFileReader.h"
 #include "audio_files/tracktion_AudioFileCache.h"
+#include "audio_files/tracktion_ThumbnailPyramid.h"
+#include "audio_files/tracktion_ThumbnailService.h"
 #include "audio_files/tracktion_SmartThumbnail.h"
 #include "audio_files/tracktion_AudioProxyGenerator.h"
+#include "audio_files/tracktion_DecodedAudioFileCache.h"
 #include "audio_files/tracktion_AudioFileManager.h"
 #include "audio_files/tracktion_AudioFileWriter.h"
 #include "audio_files/tracktion_BufferedAudioReader.h"
@@ -614,6 +621,7 @@ namespace tracktion { inline namespace engine
 #include "playback/tracktion_DeviceManager.h"
 #include "playback/tracktion_HostedAudioDevice.h"
 #include "playback/tracktion_MidiNoteDispatcher.h"
+#include "playback/tracktion_PlaybackTelemetry.h"
 #include "playback/tracktion_EditPlaybackContext.h"
 #include "playback/tracktion_EditInputDevices.h"
 
@@ -32,6 +32,11 @@ extern "C"
  #include <Windows.h>
 #endif
 
+#if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID || JUCE_MAC || JUCE_IOS
+ #include <fcntl.h>
+ #include <unistd.h>
+#endif
+
 #include <string>
 #include <bitset>
 
@@ -45,10 +50,13 @@ extern "C"
 #include "audio_files/formats/tracktion_RexFileFormat.cpp"
 #include "audio_files/formats/tracktion_LAMEManager.cpp"
 
-#include "audio_files/tracktion_BufferedFileReader.h"
 #include "audio_files/tracktion_BufferedFileReader.cpp"
 
 #include "audio_files/tracktion_AudioFileCache.cpp"
+#include "audio_files/tracktion_DecodedAudioFileCache.cpp"
+#include "audio_files/tracktion_ThumbnailPyramid.cpp"
+#include "audio_files/tracktion_ThumbnailService.cpp"
+#include "audio_files/tracktion_ThumbnailService.test.cpp"
 #include "audio_files/tracktion_AudioFileCache.test.cpp"
 #include "audio_files/tracktion_AudioFile.cpp"
 #include "audio_files/tracktion_AudioFile.test.cpp"
@@ -64,6 +64,10 @@ using namespace std::literals;
 #include "model/edit/tracktion_TimeSigSetting.cpp"
 #include "model/edit/tracktion_EditSnapshot.cpp"
 #include "model/edit/tracktion_EditFileOperations.cpp"
+#include "model/edit/tracktion_ChunkedEditFile.cpp"
+#include "model/edit/tracktion_ChunkedEditFile.test.cpp"
+#include "model/edit/tracktion_EditJournal.cpp"
+#include "model/edit/tracktion_EditJournal.test.cpp"
 #include "model/edit/tracktion_EditInsertPoint.cpp"
 
 #include "model/export/tracktion_Exportable.cpp"
@@ -75,12 +79,14 @@ using namespace std::literals;
 #include "model/export/tracktion_RenderOptions.cpp"
 #include "model/clips/tracktion_EditClipRenderJob.cpp"
 #include "model/clips/tracktion_AudioSegmentList.cpp"
+#include "model/clips/tracktion_AudioSegmentList.test.cpp"
 #include "audio_files/tracktion_LoopInfo.cpp"
 #include "audio_files/tracktion_LoopInfo.test.cpp"
 
 #include "project/tracktion_ProjectItemID.cpp"
 #include "project/tracktion_ProjectItem.cpp"
 #include "project/tracktion_Project.cpp"
+#include "project/tracktion_Project.test.cpp"
 #include "project/tracktion_ProjectManager.cpp"
 #include "project/tracktion_ProjectSearchIndex.cpp"
 
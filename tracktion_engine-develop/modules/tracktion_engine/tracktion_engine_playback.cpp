@@ -264,10 +264,13 @@ using namespace std::literals;
 
 #include "playback/graph/tracktion_WaveNode.test.cpp"
 #include "playback/graph/tracktion_MidiNode.test.cpp"
+#include "playback/graph/tracktion_PluginNode.test.cpp"
 #include "playback/graph/tracktion_RackBenchmarks.test.cpp"
 
 #include "playback/tracktion_DeviceManager.cpp"
 #include "playback/tracktion_EditPlaybackContext.cpp"
+#include "playback/tracktion_PlaybackTelemetry.cpp"
+#include "playback/tracktion_PlaybackTelemetry.test.cpp"
 #include "playback/tracktion_EditInputDevices.cpp"
 #include "playback/tracktion_LevelMeasurer.cpp"
 #include "playback/tracktion_MidiNoteDispatcher.cpp"
@@ -81,6 +81,7 @@ Engine::~Engine()
     getExternalControllerManager().shutdown();
     getDeviceManager().closeDevices();
     getBackgroundJobs().stopAndDeleteAllRunningJobs();
+    nodeBuilderThreadPool.reset();
 
     temporaryFileManager->cleanUp();
 
@@ -270,6 +271,16 @@ SharedTimer& Engine::getBackToArrangerUpdateTimer() const
     return *backToArrangerUpdateTimer;
 }
 
+juce::ThreadPool& Engine::getNodeBuilderThreadPool() const
+{
+    if (! nodeBuilderThreadPool)
+        nodeBuilderThreadPool = std::make_unique<juce::ThreadPool> (juce::ThreadPoolOptions()
+                                                                       .withThreadName ("Node builder")
+                                                                       .withNumberOfThreads (std::max (1, juce::SystemStats::getNumCpus() - 1)));
+
+    return *nodeBuilderThreadPool;
+}
+
 BufferedAudioFileManager& Engine::getBufferedAudioFileManager()
 {
     if (! bufferedAudioFileManager)
@@ -79,6 +79,7 @@ public:
     ProjectManager& getProjectManager() const;                          ///< Returns the ProjectManager instance.
     SharedTimer& getBackToArrangerUpdateTimer() const;                  ///< Returns the SharedTimer instance.
     BufferedAudioFileManager& getBufferedAudioFileManager();            ///< Returns the BufferedAudioFileManager instance
+    juce::ThreadPool& getNodeBuilderThreadPool() const;                 ///< Returns the ThreadPool used to build playback graphs in parallel.
 
     using WeakRef = juce::WeakReference<Engine>;
 
@@ -107,6 +108,7 @@ private:
     mutable std::unique_ptr<CompFactory> compFactory;
     mutable std::unique_ptr<WarpTimeFactory> warpTimeFactory;
     mutable std::unique_ptr<SharedTimer> backToArrangerUpdateTimer;
+    mutable std::unique_ptr<juce::ThreadPool> nodeBuilderThreadPool;
     std::unique_ptr<BufferedAudioFileManager> bufferedAudioFileManager;
 
     JUCE_DECLARE_WEAK_REFERENCEABLE (Engine)
@@ -98,6 +98,13 @@ public:
     */
     virtual bool enableReadAheadForTimeStretchNodes()                             { return false; }
 
+    /** If enabled, the MIDI sequences for each top-level track will be generated in parallel
+        when the playback graph is built. N.B. this means createPlaybackMidiSequence will be
+        called on background threads whilst the message thread waits for it so only enable
+        this if your override of it is thread safe.
+    */
+    virtual bool buildPlaybackGraphInParallel()                                   { return false; }
+
     /** Gives plugins an opportunity to save custom data when the plugin state gets flushed. */
     virtual void saveCustomPluginProperties (juce::ValueTree&, juce::AudioPluginInstance&, juce::UndoManager*) {}
 
@@ -153,6 +160,20 @@ public:
 
     virtual int getNumberOfCPUsToUseForAudio()                                      { return juce::jmax (1, juce::SystemStats::getNumCpus()); }
 
+    /** Should return the CPU cores to pin the playback worker threads to.
+        Each thread is pinned to the next core in turn. If this is empty, the threads
+        can run on any core. Keeping these on one NUMA node avoids buffers moving between sockets.
+        @see tracktion::graph::ThreadAffinity, getCPUsForAudioCallbackThread
+    */
+    virtual std::vector<size_t> getCPUsForAudioWorkerThreads()                      { return {}; }
+
+    /** Should return the CPU cores to pin the audio device callback thread to.
+        These shouldn't be any of the worker thread cores so the callback isn't held
+        up by the workers. If this is empty, the thread's affinity isn't changed.
+        @see getCPUsForAudioWorkerThreads
+    */
+    virtual std::vector<size_t> getCPUsForAudioCallbackThread()                     { return {}; }
+
     /** Should muted tracks processing be disabled to save CPU */
     virtual bool shouldProcessMutedTracks()                                         { return false; }
 
@@ -213,6 +234,10 @@ public:
     /** Called by the MidiList to create a MidiMessageSequence for playback.
         You can override this to add your own messages but should generally follow the
         procedure in MidiList::createDefaultPlaybackMidiSequence.
+        This may be called on a background thread, see buildPlaybackGraphInParallel.
+        N.B. the results are cached by each clip and only created again when the clip's state,
+        the tempo sequence or its groove template change, so your override shouldn't depend
+        on anything else.
     */
     virtual juce::MidiMessageSequence createPlaybackMidiSequence (const MidiList& list, MidiClip& clip, MidiList::TimeBase tb, bool generateMPE)
     {
@@ -233,6 +258,32 @@ public:
     /** Interpolate automation at 10ms intervals (faster) or calculate actual value (slower) */
     virtual bool interpolateAutomation()                                            { return true; }
 
+    /** If this returns true, Edits will be saved as a ChunkedEditFile rather than as XML.
+        Edits in either format can always be loaded.
+    */
+    virtual bool saveEditsAsChunkedBinary()                                         { return false; }
+
+    /** If this returns true, autosaving an Edit appends the changes made since the last
+        autosave to a journal next to its temp file rather than rewriting the whole file.
+        loadEditFromFile applies the journal when the temp file is loaded.
+        @see EditJournal
+    */
+    virtual bool useJournalForEditAutosaves()                                       { return false; }
+
+    /** Determines how files that can't be memory-mapped are streamed from disk.
+        @see BufferedFileReader::Pool
+    */
+    struct StreamingReaderSettings
+    {
+        size_t maxNumBytes = 256 * 1024 * 1024;     ///< The memory shared by all the streamed files
+        int numThreads = 2;                         ///< The number of threads reading from them
+    };
+
+    /** Returns the settings used for streaming files that can't be memory-mapped.
+        This is called the first time one of these files is read.
+    */
+    virtual StreamingReaderSettings getStreamingReaderSettings()                    { return {}; }
+
     /** Determines the default properties of clips. */
     struct ClipDefaults
     {
@@ -214,6 +214,8 @@ namespace IDs
     DECLARE_ID (minNote)
     DECLARE_ID (maxNote)
     DECLARE_ID (openEnded)
+    DECLARE_ID (streamFromDisk)
+    DECLARE_ID (preloadTimeMs)
     DECLARE_ID (SOUND)
     DECLARE_ID (threshold)
     DECLARE_ID (inputDb)
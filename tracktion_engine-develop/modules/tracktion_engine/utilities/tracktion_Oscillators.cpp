@@ -89,12 +89,65 @@ void Oscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int
     }
 }
 
-void Oscillator::processSine (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+float Oscillator::getPhaseDelta() const
 {
     const float frequency = std::min (float (sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (note - 69.0f) / 12.0f));
     const float period = 1.0f / float (frequency);
     const float periodInSamples = float (period * sampleRate);
-    const float delta = 1.0f / periodInSamples;
+    return 1.0f / periodInSamples;
+}
+
+int Oscillator::getTableIndex (int numTables) const
+{
+    return juce::jlimit (0, numTables - 1, int ((note - 0.5) / lookupTables->tablePerNumNotes));
+}
+
+std::optional<Oscillator::WavetableState> Oscillator::getWavetableState() const
+{
+    if (lookupTables == nullptr)
+        return {};
+
+    WavetableState state;
+    state.delta = getPhaseDelta();
+    state.gain = gain;
+    state.pointsScaler = lookupTables->pointsScaler;
+
+    switch (wave)
+    {
+        case sine:
+            state.tables[0] = lookupTables->sinePoints.data();
+            break;
+
+        case saw:
+            state.tables[0] = lookupTables->sawUpPoints[(size_t) getTableIndex ((int) lookupTables->sawUpPoints.size())].data();
+            break;
+
+        case triangle:
+            state.tables[0] = lookupTables->trianglePoints[(size_t) getTableIndex ((int) lookupTables->trianglePoints.size())].data();
+            break;
+
+        case square:
+        {
+            auto tableIndex = (size_t) getTableIndex ((int) lookupTables->sawUpPoints.size());
+            state.tables[0] = lookupTables->sawUpPoints[tableIndex].data();
+            state.tables[1] = lookupTables->sawDownPoints[tableIndex].data();
+            state.phaseOffsets[0] = 0.5f * pulseWidth;
+            state.phaseOffsets[1] = -(0.5f * pulseWidth);
+            break;
+        }
+
+        case none:
+        case noise:
+        default:
+            return {};
+    }
+
+    return state;
+}
+
+void Oscillator::processSine (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    const float delta = getPhaseDelta();
 
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
@@ -127,17 +180,12 @@ void Oscillator::processNoise (juce::AudioBuffer<float>& buffer, int startSample
 void Oscillator::processLookup (juce::AudioBuffer<float>& buffer, int startSample, int numSamples,
                                 const juce::OwnedArray<juce::dsp::LookupTableTransform<float>>& tableSet)
 {
-    const float frequency = std::min (float (sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (note - 69.0f) / 12.0f));
-    const float period = 1.0f / float (frequency);
-    const float periodInSamples = float (period * sampleRate);
-    const float delta = 1.0f / periodInSamples;
+    const float delta = getPhaseDelta();
 
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
 
-    int tableIndex = juce::jlimit (0, tableSet.size() - 1, int ((note - 0.5) / lookupTables->tablePerNumNotes));
-
-    auto table = tableSet[tableIndex];
+    auto table = tableSet[getTableIndex (tableSet.size())];
     jassert (table != nullptr);
 
     if (table != nullptr)
@@ -157,15 +205,12 @@ void Oscillator::processLookup (juce::AudioBuffer<float>& buffer, int startSampl
 
 void Oscillator::processSquare (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
 {
-    const float frequency = std::min (float (sampleRate) / 2.0f, 440.0f * std::pow (2.0f, (note - 69.0f) / 12.0f));
-    const float period = 1.0f / float (frequency);
-    const float periodInSamples = float (period * sampleRate);
-    const float delta = 1.0f / periodInSamples;
+    const float delta = getPhaseDelta();
 
     auto* channels = buffer.getArrayOfWritePointers();
     const int numChannels = buffer.getNumChannels();
 
-    int tableIndex = juce::jlimit (0, lookupTables->sawUpFunctions.size() - 1, int ((note - 0.5) / lookupTables->tablePerNumNotes));
+    int tableIndex = getTableIndex (lookupTables->sawUpFunctions.size());
 
     auto saw1 = lookupTables->sawUpFunctions[tableIndex];
     auto saw2 = lookupTables->sawDownFunctions[tableIndex];
@@ -205,7 +250,11 @@ MultiVoiceOscillator::MultiVoiceOscillator (int maxVoices)
 void MultiVoiceOscillator::start()
 {
     static juce::Random r;
+    start (r);
+}
 
+void MultiVoiceOscillator::start (juce::Random& r)
+{
     for (int i = 0; i < oscillators.size(); i += 2)
     {
         float phase = r.nextFloat();
@@ -262,7 +311,12 @@ void MultiVoiceOscillator::setSpread (float s)
     spread = s;
 }
 
-void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+int MultiVoiceOscillator::getNumActiveOscillators() const
+{
+    return voices == 1 ? 2 : std::min (voices * 2, oscillators.size());
+}
+
+void MultiVoiceOscillator::updateOscillators()
 {
     if (voices == 1)
     {
@@ -274,21 +328,15 @@ void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startS
             bool left = (i % 2) == 0;
             float panGain = left ? leftGain : rightGain;
 
-            float* data = buffer.getWritePointer (left ? 0 : 1, startSample);
-            float* dataPointers[] = {data};
-
-            juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
-
             auto& o = *oscillators[i];
 
             o.setGain (gain * panGain / voices);
             o.setNote (note);
-            o.process (channelBuffer, 0, numSamples);
         }
     }
     else
     {
-        for (int i = 0; i < std::min (voices * 2, oscillators.size()); i++)
+        for (int i = 0; i < getNumActiveOscillators(); i++)
         {
             int voiceIndex = (i / 2);
             float localPan = juce::jlimit (-1.0f, 1.0f, ((voiceIndex % 2 == 0) ? 1 : -1) * spread);
@@ -301,20 +349,31 @@ void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startS
             bool left = (i % 2) == 0;
             float panGain = left ? leftGain : rightGain;
 
-            float* data = buffer.getWritePointer (left ? 0 : 1, startSample);
-            float* dataPointers[] = {data};
-
-            juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
-
             auto& o = *oscillators[i];
 
             o.setGain (gain * panGain / voices);
             o.setNote (base + delta * (i / 2));
-            o.process (channelBuffer, 0, numSamples);
         }
     }
 }
 
+void MultiVoiceOscillator::process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    updateOscillators();
+
+    for (int i = 0; i < getNumActiveOscillators(); i++)
+    {
+        bool left = (i % 2) == 0;
+
+        float* data = buffer.getWritePointer (left ? 0 : 1, startSample);
+        float* dataPointers[] = {data};
+
+        juce::AudioBuffer<float> channelBuffer (dataPointers, 1, numSamples);
+
+        oscillators[i]->process (channelBuffer, 0, numSamples);
+    }
+}
+
 //==============================================================================
 static juce::Array<BandlimitedWaveLookupTables*> tableCache;
 
@@ -328,10 +387,28 @@ BandlimitedWaveLookupTables::Ptr BandlimitedWaveLookupTables::getLookupTables (d
     return table;
 }
 
+static void initialiseTable (juce::dsp::LookupTableTransform<float>& table, std::vector<float>& points,
+                             std::function<float (float)> function, int tableSize)
+{
+    // LookupTableTransform doesn't give access to its points so they're kept as they're generated
+    points.reserve (size_t (tableSize + 1));
+
+    table.initialise ([&points, function] (float in)
+                      {
+                          auto value = function (in);
+                          points.push_back (value);
+                          return value;
+                      }, 0.0f, 1.0f, (size_t) tableSize);
+
+    jassert (points.size() == size_t (tableSize));
+    points.push_back (points.back());
+}
+
 BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int tableSize)
-    : sampleRate (sr),
-      sineFunction ([] (float in) { return sine (in); }, 0.0f, 1.0f, (size_t) tableSize)
+    : sampleRate (sr), pointsScaler (float (tableSize - 1))
 {
+    initialiseTable (sineFunction, sinePoints, [] (float in) { return sine (in); }, tableSize);
+
     auto getMidiNoteInHertz = [](float noteNumber)
     {
         return 440.0f * std::pow (2.0f, (noteNumber - 69) / 12.0f);
@@ -343,14 +420,14 @@ BandlimitedWaveLookupTables::BandlimitedWaveLookupTables (double sr, int tableSi
     {
         const float freq = getMidiNoteInHertz (note);
 
-        triangleFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                               { return triangle (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        initialiseTable (*triangleFunctions.add (new juce::dsp::LookupTableTransform<float>()), trianglePoints.emplace_back(),
+                         [freq, sr] (float value) { return triangle (value, freq, sr); }, tableSize);
 
-        sawUpFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                            { return sawUp (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        initialiseTable (*sawUpFunctions.add (new juce::dsp::LookupTableTransform<float>()), sawUpPoints.emplace_back(),
+                         [freq, sr] (float value) { return sawUp (value, freq, sr); }, tableSize);
 
-        sawDownFunctions.add (new juce::dsp::LookupTableTransform<float> ([freq, sr] (float value)
-                              { return sawDown (value, freq, sr); }, 0.0f, 1.0f, (size_t) tableSize));
+        initialiseTable (*sawDownFunctions.add (new juce::dsp::LookupTableTransform<float>()), sawDownPoints.emplace_back(),
+                         [freq, sr] (float value) { return sawDown (value, freq, sr); }, tableSize);
     }
 
     auto elapsed = (juce::Time::getCurrentTime() - start);
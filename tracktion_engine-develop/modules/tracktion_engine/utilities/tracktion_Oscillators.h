@@ -27,6 +27,12 @@ public:
 
     juce::OwnedArray<juce::dsp::LookupTableTransform<float>> triangleFunctions, sawUpFunctions, sawDownFunctions;
 
+    // The points each of the tables above interpolates between, including the guard point
+    // at the end. A phase is scaled by pointsScaler to give the position in these.
+    std::vector<float> sinePoints;
+    std::vector<std::vector<float>> trianglePoints, sawUpPoints, sawDownPoints;
+    float pointsScaler = 0.0f;
+
     const int tablePerNumNotes = 3;
 
 private:
@@ -60,10 +66,33 @@ public:
     void setGain (float g)          { gain = g;         }
     void setPulseWidth (float p)    { pulseWidth = p;   }
 
+    Waves getWave() const           { return wave;      }
+    float getPhase() const          { return phase;     }
+    void setPhase (float p)         { phase = p;        }
+
     void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
+    //==============================================================================
+    /** What's needed to render the current wave from the BandlimitedWaveLookupTables points.
+        Each sample is the sum of the two tables read at the phase plus their offsets, wrapped
+        to 0-1, multiplied by the gain. The second table is nullptr if it isn't used.
+        This lets several Oscillators be rendered together and give the same output as process().
+    */
+    struct WavetableState
+    {
+        const float* tables[2] = {};
+        float phaseOffsets[2] = {};
+        float delta = 0, gain = 0, pointsScaler = 0;
+    };
+
+    /** Returns the WavetableState for the current settings, or nothing for noise and none. */
+    std::optional<WavetableState> getWavetableState() const;
+
 private:
     //==============================================================================
+    float getPhaseDelta() const;
+    int getTableIndex (int numTables) const;
+
     void processSine (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
     void processSquare (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
     void processNoise (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
@@ -89,6 +118,7 @@ public:
     MultiVoiceOscillator (int maxVoices = 8);
 
     void start();
+    void start (juce::Random&);
     void setSampleRate (double sr);
     void setWave (Oscillator::Waves w);
     void setNote (float n);
@@ -102,6 +132,18 @@ public:
 
     void process (juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
 
+    //==============================================================================
+    /** Returns the number of Oscillators process() uses, two per voice for the left and right channels. */
+    int getNumActiveOscillators() const;
+
+    /** Returns one of the Oscillators, the even ones are for the left channel and the odd ones the right. */
+    Oscillator& getOscillator (int index)               { return *oscillators.getUnchecked (index); }
+
+    /** Sets the note and gain of each active Oscillator from the voice settings.
+        This is called by process() so only needs calling when rendering the Oscillators directly.
+    */
+    void updateOscillators();
+
 private:
     juce::OwnedArray<Oscillator> oscillators;
 
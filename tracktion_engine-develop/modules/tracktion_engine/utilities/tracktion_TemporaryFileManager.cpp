@@ -204,6 +204,7 @@ static juce::String getFileProxyPrefix()                { return "proxy_"; }
 static juce::String getDeviceFreezePrefix (Edit& edit)  { return "freeze_" + edit.getProjectItemID().toStringSuitableForFilename() + "_"; }
 static juce::String getTrackFreezePrefix()              { return "trackFreeze_"; }
 static juce::String getCompPrefix()                     { return "comp_"; }
+static juce::String getSegmentPrefix()                  { return "segment_"; }
 
 static AudioFile getCachedEditFile (Edit& edit, const juce::String& prefix, HashCode hash)
 {
@@ -230,6 +231,11 @@ AudioFile TemporaryFileManager::getFileForCachedFileRender (Edit& edit, HashCode
     return getCachedEditFile (edit, getFileProxyPrefix(), hash);
 }
 
+AudioFile TemporaryFileManager::getFileForCachedSegmentRender (Edit& edit, HashCode hash)
+{
+    return getCachedEditFile (edit, getSegmentPrefix(), hash);
+}
+
 juce::File TemporaryFileManager::getFreezeFileForDevice (Edit& edit, OutputDevice& device)
 {
     return edit.getTempDirectory (true)
@@ -321,13 +327,35 @@ void TemporaryFileManager::purgeOrphanFreezeAndProxyFiles (Edit& edit)
 {
     CRASH_TRACER
     juce::Array<juce::File> filesToDelete;
+    std::optional<juce::Array<juce::File>> segmentFilesInUse;
+
+    auto isSegmentFileInUse = [&] (const juce::File& f)
+    {
+        if (! segmentFilesInUse)
+        {
+            segmentFilesInUse.emplace();
+
+            for (auto t : getClipTracks (edit))
+                for (auto acb : getClipsOfTypeRecursive<AudioClipBase> (*t))
+                    if (acb->canUseProxy() && acb->usesTimeStretchedProxy())
+                        for (auto& segmentFile : acb->createProxyRenderingInfo()->segmentFiles)
+                            segmentFilesInUse->add (segmentFile.getFile());
+        }
+
+        return segmentFilesInUse->contains (f);
+    };
 
     for (auto entry : juce::RangedDirectoryIterator (edit.getTempDirectory (false), false, "*"))
     {
         auto name = entry.getFile().getFileName();
         auto itemID = getEditItemIDFromFilename (name);
 
-        if (itemID.isValid())
+        if (name.startsWith (getSegmentPrefix()))
+        {
+            if (! isSegmentFileInUse (entry.getFile()))
+                filesToDelete.add (entry.getFile());
+        }
+        else if (itemID.isValid())
         {
             if (name.startsWith (getClipProxyPrefix())
                  || name.startsWith (getCompPrefix()))
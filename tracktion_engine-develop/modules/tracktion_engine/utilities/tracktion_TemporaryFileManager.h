@@ -74,6 +74,9 @@ public:
     /** */
     static AudioFile getFileForCachedFileRender (Edit&, HashCode hash);
 
+    /** */
+    static AudioFile getFileForCachedSegmentRender (Edit&, HashCode hash);
+
     /** */
     static juce::File getFreezeFileForDevice (Edit&, OutputDevice&);
 
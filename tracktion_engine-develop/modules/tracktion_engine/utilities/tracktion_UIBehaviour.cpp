@@ -228,4 +228,15 @@ void UIBehaviour::recreatePluginWindowContentAsync (Plugin& p)
     p.windowState->recreateWindowIfShowing();
 }
 
+std::unique_ptr<juce::AudioThumbnailBase> UIBehaviour::createAudioThumbnail (int sourceSamplesPerThumbnailSample,
+                                                                             juce::AudioFormatManager& formatManagerToUse,
+                                                                             juce::AudioThumbnailCache& cacheToUse)
+{
+    if (auto service = dynamic_cast<ThumbnailService*> (&cacheToUse))
+        return std::make_unique<TracktionThumbnail> (*service);
+
+    return std::make_unique<juce::AudioThumbnail> (sourceSamplesPerThumbnailSample,
+                                                   formatManagerToUse, cacheToUse);
+}
+
 }} // namespace tracktion { inline namespace engine
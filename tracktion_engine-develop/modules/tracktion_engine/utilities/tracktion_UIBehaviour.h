@@ -59,14 +59,13 @@ public:
     /** Called when a new track is created from some kind of user action i.e. not from an Edit load. */
     virtual void newTrackCreated (Track&) {}
 
-    /** Must create an AudioThumnail for displaying, usually in a SmartThumbnail. */
+    /** Must create an AudioThumnail for displaying, usually in a SmartThumbnail.
+        The default creates a TracktionThumbnail if the cache is the Engine's
+        ThumbnailService, otherwise a juce::AudioThumbnail.
+    */
     virtual std::unique_ptr<juce::AudioThumbnailBase> createAudioThumbnail (int sourceSamplesPerThumbnailSample,
                                                                             juce::AudioFormatManager& formatManagerToUse,
-                                                                            juce::AudioThumbnailCache& cacheToUse)
-    {
-        return std::make_unique<juce::AudioThumbnail> (sourceSamplesPerThumbnailSample,
-                                                       formatManagerToUse, cacheToUse);
-    }
+                                                                            juce::AudioThumbnailCache& cacheToUse);
 
     //==============================================================================
     /** Should display a dismissable alert window. N.B. this should be non-blocking. */
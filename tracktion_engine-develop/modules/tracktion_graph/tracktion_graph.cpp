@@ -43,13 +43,22 @@
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.cpp"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.cpp"
+#include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.test.cpp"
+#include "tracktion_graph/tracktion_StaticScheduleNodePlayer.cpp"
+#include "tracktion_graph/tracktion_StaticScheduleNodePlayer.test.cpp"
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.test.cpp"
 
 #include "utilities/tracktion_AudioBufferPool.tests.cpp"
 #include "utilities/tracktion_Semaphore.cpp"
 #include "utilities/tracktion_Semaphore.tests.cpp"
+#include "utilities/tracktion_WorkStealingQueue.test.cpp"
+#include "utilities/tracktion_PriorityFifo.test.cpp"
+#include "utilities/tracktion_NodeProcessTracer.cpp"
+#include "utilities/tracktion_NodeProcessTracer.test.cpp"
 #include "utilities/tracktion_Threads.cpp"
+#include "utilities/tracktion_SummingKernels.cpp"
+#include "utilities/tracktion_SummingKernels.test.cpp"
 
 // Put this last to avoid macro leakage
 #include "utilities/tracktion_Allocation.test.cpp"
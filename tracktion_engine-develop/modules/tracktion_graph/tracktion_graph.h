@@ -97,16 +97,20 @@ namespace tracktion_engine = tracktion::engine;
 #include "tracktion_graph/tracktion_Node.h"
 #include "tracktion_graph/tracktion_Utility.h"
 
+#include "utilities/tracktion_Threads.h"
+#include "utilities/tracktion_RealTimeSpinLock.h"
 #include "utilities/tracktion_AudioBufferPool.h"
 #include "utilities/tracktion_AudioBufferStack.h"
 #include "utilities/tracktion_GlueCode.h"
+#include "utilities/tracktion_SummingKernels.h"
 #include "utilities/tracktion_AudioFifo.h"
 #include "utilities/tracktion_PerformanceMeasurement.h"
-#include "utilities/tracktion_RealTimeSpinLock.h"
 #include "utilities/tracktion_Semaphore.h"
-#include "utilities/tracktion_Threads.h"
 #include "utilities/tracktion_LatencyProcessor.h"
 #include "utilities/tracktion_LockFreeObject.h"
+#include "utilities/tracktion_WorkStealingQueue.h"
+#include "utilities/tracktion_PriorityFifo.h"
+#include "utilities/tracktion_NodeProcessTracer.h"
 
 #include "tracktion_graph/tracktion_PlayHead.h"
 
@@ -118,6 +122,7 @@ namespace tracktion_engine = tracktion::engine;
 #include "tracktion_graph/tracktion_MultiThreadedNodePlayer.h"
 #include "tracktion_graph/tracktion_LockFreeMultiThreadedNodePlayer.h"
 #include "tracktion_graph/tracktion_NodePlayerThreadPools.h"
+#include "tracktion_graph/tracktion_StaticScheduleNodePlayer.h"
 
 #include "tracktion_graph/nodes/tracktion_ConnectedNode.h"
 #include "tracktion_graph/nodes/tracktion_LatencyNode.h"
@@ -50,8 +50,6 @@ public:
         auto props = input->getNodeProperties();
         props.latencyNumSamples += latencyProcessor->getLatencyNumSamples();
 
-        constexpr size_t latencyNodeMagicHash = size_t (0x95ab5e9dcc);
-
         if (props.nodeID != 0)
             hash_combine (props.nodeID, latencyNodeMagicHash);
 
@@ -68,12 +66,32 @@ public:
         return input->hasProcessed();
     }
 
+    size_t getStateHash() override
+    {
+        auto stateHash = latencyNodeMagicHash;
+        hash_combine (stateHash, latencyProcessor->getLatencyNumSamples());
+
+        return stateHash;
+    }
+
     void prepareToPlay (const PlaybackInitialisationInfo& info) override
     {
         latencyProcessor->prepareToPlay (info.sampleRate, info.blockSize, getNodeProperties().numberOfChannels);
         replaceLatencyProcessorIfPossible (info.nodeGraphToReplace);
     }
 
+    bool transferPreparedState (Node& oldNode, const PlaybackInitialisationInfo& info) override
+    {
+        auto& oldLatencyProcessor = static_cast<LatencyNode&> (oldNode).latencyProcessor;
+
+        if (! oldLatencyProcessor->hasConfiguration (latencyProcessor->getLatencyNumSamples(), info.sampleRate,
+                                                     getNodeProperties().numberOfChannels))
+            return false;
+
+        latencyProcessor = oldLatencyProcessor;
+        return true;
+    }
+
     void process (ProcessContext& pc) override
     {
         auto inputBuffer = input->getProcessedOutput().audio;
@@ -90,6 +108,8 @@ public:
     }
 
 private:
+    static constexpr size_t latencyNodeMagicHash = size_t (0x95ab5e9dcc);
+
     std::unique_ptr<Node> ownedInput;
     std::shared_ptr<Node> sharedInput;
     Node* input = nullptr;
@@ -119,6 +119,8 @@ public:
             tempDoubleBuffer.resize ({ (choc::buffer::ChannelCount) getNodeProperties().numberOfChannels,
                                        (choc::buffer::FrameCount) info.blockSize });
 
+        inputViews.resize (nodes.size());
+        inputChannels.resize (nodes.size());
         isPrepared = true;
     }
 
@@ -150,6 +152,10 @@ private:
     bool useDoublePrecision = false;
     choc::buffer::ChannelArrayBuffer<double> tempDoubleBuffer;
 
+    // Scratch space for the summing kernels so inputs can be added in a single pass
+    std::vector<choc::buffer::ChannelArrayView<float>> inputViews;
+    std::vector<const float*> inputChannels;
+
     static void sortByTimestampUnstable (tracktion_engine::MidiMessageArray& messages) noexcept
     {
         std::sort (messages.begin(), messages.end(), [] (const juce::MidiMessage& a, const juce::MidiMessage& b)
@@ -167,20 +173,27 @@ private:
     }
 
     //==============================================================================
-    void processSinglePrecision (const ProcessContext& pc)
+    void processSinglePrecision (ProcessContext& pc)
     {
         const auto numChannels = pc.buffers.audio.getNumChannels();
 
         int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
+        bool allInputsSilent = true;
+        size_t numInputViews = 0;
 
-        // Get each of the inputs and add them to dest
+        // Get each of the inputs and gather them to add to dest
         for (auto& node : nodes)
         {
             auto inputFromNode = node->getProcessedOutput();
 
             if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (pc.buffers.audio.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            {
+                if (inputFromNode.audioContent != AudioContent::silent)
+                {
+                    inputViews[numInputViews++] = inputFromNode.audio.getFirstChannels (numChannelsToAdd);
+                    allInputsSilent = false;
+                }
+            }
 
             if (inputFromNode.midi.isNotEmpty())
                 nodesWithMidi++;
@@ -188,26 +201,32 @@ private:
             pc.buffers.midi.mergeFrom (inputFromNode.midi);
         }
 
+        summing::addViews (pc.buffers.audio, inputViews.data(), numInputViews, inputChannels.data());
+
+        if (allInputsSilent)
+            pc.buffers.audioContent = AudioContent::silent;
+
         if (nodesWithMidi > 1)
             sortByTimestampUnstable (pc.buffers.midi);
     }
 
-    void processDoublePrecision (const ProcessContext& pc)
+    void processDoublePrecision (ProcessContext& pc)
     {
         const auto numChannels = pc.buffers.audio.getNumChannels();
         auto doubleView = tempDoubleBuffer.getView().getStart (pc.buffers.audio.getNumFrames());
         doubleView.clear();
 
         int nodesWithMidi = pc.buffers.midi.isEmpty() ? 0 : 1;
+        size_t numInputViews = 0;
 
-        // Get each of the inputs and add them to dest
+        // Get each of the inputs and gather them to add to dest
         for (auto& node : nodes)
         {
             auto inputFromNode = node->getProcessedOutput();
 
-            if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
-                add (doubleView.getFirstChannels (numChannelsToAdd),
-                     inputFromNode.audio.getFirstChannels (numChannelsToAdd));
+            if (inputFromNode.audioContent != AudioContent::silent)
+                if (auto numChannelsToAdd = std::min (inputFromNode.audio.getNumChannels(), numChannels))
+                    inputViews[numInputViews++] = inputFromNode.audio.getFirstChannels (numChannelsToAdd);
 
             if (inputFromNode.midi.isNotEmpty())
                 nodesWithMidi++;
@@ -215,9 +234,14 @@ private:
             pc.buffers.midi.mergeFrom (inputFromNode.midi);
         }
 
+        const bool allInputsSilent = numInputViews == 0;
+        summing::addViews (doubleView, inputViews.data(), numInputViews, inputChannels.data());
+
         assert (doubleView.getNumChannels() == (choc::buffer::ChannelCount) numChannels);
 
-        if (numChannels != 0)
+        if (allInputsSilent)
+            pc.buffers.audioContent = AudioContent::silent;
+        else if (numChannels != 0)
             add (pc.buffers.audio.getFirstChannels (numChannels), doubleView);
 
         if (nodesWithMidi > 1)
@@ -95,25 +95,34 @@ namespace node_player_utils
         // - Multiply it by the maximum number of inputs any Node has
         // - Then multiply that by the number of threads that will be used (or the num leaf Nodes if that’s smaller)
         // - Add one for the root node so the ouput can be retained
-        [[ maybe_unused ]] size_t maxNumChannels = 0, maxNumInputs = 0, numLeafNodes = 0;
+        [[ maybe_unused ]] size_t maxNumInputs = 0, numLeafNodes = 0;
 
         // However, this algorithm is too pessimistic as it assumes there can be
         // numThreads * maxNumInputs which is unlikely to be true.
         // It's probably better to stack up numThreads maxNumInputs and use the min of that size and numThreads
 
+        // A size class is reserved for each channel count so Nodes with fewer
+        // channels don't need buffers the size of the widest one
+        std::map<size_t, size_t> numNodesWithNumChannels;
+
         for (auto n : allNodes)
         {
             const auto numInputs = n->getDirectInputNodes().size();
             const auto props = n->getNodeProperties();
             maxNumInputs    = std::max (maxNumInputs, numInputs);
-            maxNumChannels  = std::max (maxNumChannels, (size_t) props.numberOfChannels);
+
+            if (props.numberOfChannels > 0)
+                ++numNodesWithNumChannels[(size_t) props.numberOfChannels];
 
             if (numInputs == 0)
                 ++numLeafNodes;
         }
 
-        const size_t numBuffersRequired = std::max ((size_t) 2, std::min (allNodes.size(), 1 + numThreads));
-        audioBufferPool.reserve (numBuffersRequired, choc::buffer::Size::create (maxNumChannels, blockSize));
+        for (auto [numChannels, numNodes] : numNodesWithNumChannels)
+        {
+            const size_t numBuffersRequired = std::max ((size_t) 2, std::min (numNodes, 1 + numThreads));
+            audioBufferPool.reserve (numBuffersRequired, choc::buffer::Size::create (numChannels, blockSize));
+        }
     }
 }
 
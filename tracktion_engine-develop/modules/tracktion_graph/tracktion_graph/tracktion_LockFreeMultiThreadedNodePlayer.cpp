@@ -101,6 +101,11 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     if (! preparedNode->graph->rootNode)
         return -1;
 
+    const NodeProcessTracer::ScopedEvent blockEvent (nodeProcessTracer.load (std::memory_order_relaxed), nullptr);
+
+    if (processThreadAffinityPending.exchange (false, std::memory_order_acq_rel))
+        setCurrentThreadAffinity (processThreadCPUsToApply);
+
     // Reset the stream range
     numSamplesToProcess = pc.numSamples;
     referenceSampleRange = pc.referenceSampleRange;
@@ -115,7 +120,10 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
     if (numThreadsToUse.load (std::memory_order_acquire) == 0 || preparedNode->graph->orderedNodes.size() == 1)
     {
         for (auto node : preparedNode->graph->orderedNodes)
+        {
+            const NodeProcessTracer::ScopedEvent nodeEvent (blockEvent.tracer, node);
             node->process (numSamplesToProcess, referenceSampleRange);
+        }
     }
     else
     {
@@ -124,14 +132,29 @@ int LockFreeMultiThreadedNodePlayer::process (const Node::ProcessContext& pc)
         resetProcessQueue (*preparedNode);
 
         // Try to process Nodes until the root is ready
+        const bool useWorkQueue = isUsingWorkStealing();
+        const bool adaptive = useAdaptiveThreading.load (std::memory_order_relaxed);
+        const auto blockStartCycles = adaptive ? rdtsc() : 0;
+        std::uint64_t waitCycles = 0;
+
         for (;;)
         {
             if (preparedNode->graph->rootNode->hasProcessed())
                 break;
 
-            if (! processNextFreeNode (*preparedNode))
+            if (! (useWorkQueue ? processNextFreeNode (*preparedNode, 0)
+                                : processNextFreeNode (*preparedNode)))
+            {
+                const auto waitStartCycles = adaptive ? rdtsc() : 0;
                 threadPool->waitForFinalNode();
+
+                if (adaptive)
+                    waitCycles += rdtsc() - waitStartCycles;
+            }
         }
+
+        if (adaptive)
+            updateNumActiveThreads (rdtsc() - blockStartCycles, waitCycles);
     }
 
     // Add output from graph to buffers
@@ -172,12 +195,75 @@ void LockFreeMultiThreadedNodePlayer::enablePooledMemoryAllocations (bool usePoo
         prepareToPlay (sampleRate, blockSize);
 }
 
+AudioBufferPool::Statistics LockFreeMultiThreadedNodePlayer::getAudioBufferPoolStatistics() const
+{
+    if (lastAudioBufferPoolPosted == nullptr)
+        return {};
+
+    return lastAudioBufferPoolPosted->getStatistics();
+}
+
 void LockFreeMultiThreadedNodePlayer::enableNodeMemorySharing (bool shouldBeEnabled)
 {
     if (std::exchange (nodeMemorySharingEnabled, shouldBeEnabled) != shouldBeEnabled)
         prepareToPlay (sampleRate, blockSize);
 }
 
+void LockFreeMultiThreadedNodePlayer::enableNodePrioritisation (bool shouldBeEnabled)
+{
+    useNodePrioritisation.store (shouldBeEnabled, std::memory_order_release);
+}
+
+void LockFreeMultiThreadedNodePlayer::setNodeProcessTracer (NodeProcessTracer* tracer)
+{
+    nodeProcessTracer.store (tracer, std::memory_order_release);
+}
+
+void LockFreeMultiThreadedNodePlayer::enableAdaptiveThreading (bool shouldBeEnabled)
+{
+    if (useAdaptiveThreading.exchange (shouldBeEnabled, std::memory_order_acq_rel) == shouldBeEnabled)
+        return;
+
+    // When disabled, all the threads should process again
+    if (! shouldBeEnabled)
+    {
+        const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
+        numActiveThreads.store (numThreadsToUse.load(), std::memory_order_release);
+        threadPool->signalActivated();
+    }
+}
+
+LockFreeMultiThreadedNodePlayer::AdaptiveThreadingStats LockFreeMultiThreadedNodePlayer::getAdaptiveThreadingStats() const
+{
+    return { numActiveThreads.load (std::memory_order_acquire),
+             smoothedParallelism.load (std::memory_order_relaxed),
+             smoothedWaitProportion.load (std::memory_order_relaxed) };
+}
+
+void LockFreeMultiThreadedNodePlayer::setThreadAffinity (ThreadAffinity newAffinity)
+{
+    if (newAffinity == threadAffinity)
+        return;
+
+    clearThreads();
+
+    {
+        const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
+
+        // If the process thread was pinned before, it needs to be allowed to run on any core again
+        processThreadCPUsToApply = newAffinity.processThreadCPUs;
+
+        if (processThreadCPUsToApply.empty() && ! threadAffinity.processThreadCPUs.empty())
+            for (auto& nodeCPUs : getNUMANodeCPUs())
+                processThreadCPUsToApply.insert (processThreadCPUsToApply.end(), nodeCPUs.begin(), nodeCPUs.end());
+
+        threadAffinity = std::move (newAffinity);
+        processThreadAffinityPending.store (! processThreadCPUsToApply.empty(), std::memory_order_release);
+    }
+
+    createThreads();
+}
+
 
 //==============================================================================
 //==============================================================================
@@ -216,7 +302,76 @@ void LockFreeMultiThreadedNodePlayer::clearThreads()
 void LockFreeMultiThreadedNodePlayer::createThreads()
 {
     const std::scoped_lock<RealTimeSpinLock> sl (processMutex);
-    threadPool->createThreads (numThreadsToUse.load(), audioWorkgroup);
+    const auto numThreads = numThreadsToUse.load();
+
+    // The number of threads can only change after they've been cleared so
+    // it's safe to recreate the queues here
+    if (threadPool->queueType == QueueType::workStealing
+        && workQueues.size() != numThreads + 1)
+    {
+        workQueues.clear();
+
+        for (size_t i = 0; i < numThreads + 1; ++i)
+            workQueues.push_back (std::make_unique<WorkQueue> (workQueueCapacity));
+    }
+
+    // Only start scaling again from all the threads if the number has changed,
+    // otherwise setting a new Node would undo the adaptive scaling
+    if (std::exchange (numThreadsCreated, numThreads) != numThreads)
+    {
+        numActiveThreads.store (numThreads, std::memory_order_release);
+        numUnderusedBlocks = 0;
+    }
+
+    threadPool->createThreads (numThreads, audioWorkgroup);
+}
+
+void LockFreeMultiThreadedNodePlayer::updateNumActiveThreads (std::uint64_t blockCycles, std::uint64_t waitCycles)
+{
+    if (blockCycles == 0)
+        return;
+
+    // The parallelism is the average number of threads, including this one, processing Nodes during the block
+    const auto parallelism = (float) busyCycles.exchange (0, std::memory_order_relaxed) / (float) blockCycles;
+    const auto waitProportion = (float) waitCycles / (float) blockCycles;
+    const bool hadBacklog = hadReadyNodeBacklog.exchange (false, std::memory_order_relaxed);
+
+    const auto lastParallelism = smoothedParallelism.load (std::memory_order_relaxed);
+    const auto lastWaitProportion = smoothedWaitProportion.load (std::memory_order_relaxed);
+    smoothedParallelism.store (lastParallelism + (parallelism - lastParallelism) * 0.1f, std::memory_order_relaxed);
+    smoothedWaitProportion.store (lastWaitProportion + (waitProportion - lastWaitProportion) * 0.1f, std::memory_order_relaxed);
+
+    const auto maxNumThreads = numThreadsToUse.load (std::memory_order_acquire);
+    const auto numActive = std::min (numActiveThreads.load (std::memory_order_relaxed), maxNumThreads);
+
+    // Add a thread as soon as the active ones are saturated and Nodes are queuing up, unless this
+    // thread is mostly waiting on dependencies as more threads won't shorten the critical path
+    if (numActive < maxNumThreads
+        && hadBacklog
+        && parallelism > 0.8f * (float) (numActive + 1)
+        && waitProportion < 0.5f)
+    {
+        numActiveThreads.store (numActive + 1, std::memory_order_release);
+        threadPool->signalActivated();
+        numUnderusedBlocks = 0;
+        return;
+    }
+
+    // Remove threads slowly if the work could have been done by one fewer or there's no parallel work.
+    // Using a lower threshold than when adding threads stops the count oscillating
+    if (numActive > 0
+        && (smoothedParallelism.load (std::memory_order_relaxed) < 0.6f * (float) numActive || ! hadBacklog))
+    {
+        if (++numUnderusedBlocks >= 32)
+        {
+            numActiveThreads.store (numActive - 1, std::memory_order_release);
+            numUnderusedBlocks = 0;
+        }
+
+        return;
+    }
+
+    numUnderusedBlocks = 0;
 }
 
 inline void LockFreeMultiThreadedNodePlayer::pause()
@@ -249,14 +404,19 @@ void LockFreeMultiThreadedNodePlayer::postNewGraph (std::unique_ptr<NodeGraph> n
 
     PreparedNode newPreparedNode;
     newPreparedNode.graph = std::move (newGraph);
-    newPreparedNode.nodesReadyToBeProcessed = std::make_unique<LockFreeFifo<Node*>> ((int) newPreparedNode.graph->orderedNodes.size());
+    newPreparedNode.nodesReadyToBeProcessed = std::make_unique<PriorityFifo<Node*>> (numNodePriorities, newPreparedNode.graph->orderedNodes.size());
     buildNodesOutputLists (newPreparedNode);
+    copyNodeCosts (newPreparedNode, lastGraphPosted);
+    newPreparedNode.readyNodes.reserve (newPreparedNode.playbackNodes.size());
 
     if (useMemoryPool)
     {
         const size_t poolCapacity = newPreparedNode.graph->orderedNodes.size();
         newPreparedNode.audioBufferPool = std::make_unique<AudioBufferPool> (poolCapacity);
 
+        if (! threadAffinity.isEmpty())
+            newPreparedNode.audioBufferPool->setNUMANodesInUse (threadAffinity.getNUMANodes());
+
         node_player_utils::reserveAudioBufferPool (newPreparedNode.graph->rootNode.get(),
                                                    newPreparedNode.graph->orderedNodes,
                                                    *newPreparedNode.audioBufferPool,
@@ -301,6 +461,42 @@ void LockFreeMultiThreadedNodePlayer::buildNodesOutputLists (PreparedNode& prepa
     }
 }
 
+void LockFreeMultiThreadedNodePlayer::copyNodeCosts (PreparedNode& preparedNode, const NodeGraph* oldGraph)
+{
+    // The old graph is still owned by the current or pending PreparedNode so its
+    // Nodes' PlaybackNodes are valid. Carry over the costs measured for Nodes with
+    // the same ID so the priorities don't have to be learnt again after every edit
+    if (oldGraph == nullptr)
+        return;
+
+    std::vector<std::pair<size_t, float>> oldCosts;
+    oldCosts.reserve (oldGraph->orderedNodes.size());
+
+    for (auto n : oldGraph->orderedNodes)
+        if (auto nodeID = n->getNodeProperties().nodeID; nodeID != 0 && n->internal != nullptr)
+            oldCosts.emplace_back (nodeID, static_cast<PlaybackNode*> (n->internal)->cost.load (std::memory_order_relaxed));
+
+    if (oldCosts.empty())
+        return;
+
+    std::sort (oldCosts.begin(), oldCosts.end(),
+               [] (auto& c1, auto& c2) { return c1.first < c2.first; });
+
+    for (auto& playbackNode : preparedNode.playbackNodes)
+    {
+        const auto nodeID = playbackNode->node.getNodeProperties().nodeID;
+
+        if (nodeID == 0)
+            continue;
+
+        auto found = std::lower_bound (oldCosts.begin(), oldCosts.end(), nodeID,
+                                       [] (auto& c, auto id) { return c.first < id; });
+
+        if (found != oldCosts.end() && found->first == nodeID)
+            playbackNode->cost.store (found->second, std::memory_order_relaxed);
+    }
+}
+
 void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedNode)
 {
     // Clear the nodesReadyToBeProcessed list
@@ -308,12 +504,18 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
     {
         Node* temp;
 
-        if (! preparedNode.nodesReadyToBeProcessed->try_dequeue (temp))
+        if (! preparedNode.nodesReadyToBeProcessed->tryPop (temp))
             break;
     }
 
     numNodesQueued.store (0, std::memory_order_release);
 
+   #if JUCE_DEBUG
+    // Every queued Node should have been processed by the end of the last block
+    for (auto& workQueue : workQueues)
+        jassert (workQueue->getNumItems() == 0);
+   #endif
+
     // Reset all the counters
     // And then move any Nodes that are ready to the correct queue
     for (auto& playbackNode : preparedNode.playbackNodes)
@@ -343,18 +545,46 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
    #endif
 
     size_t numNodesJustQueued = 0;
+    const bool prioritiseNodes = useNodePrioritisation.load (std::memory_order_acquire);
+    prioritiseNodesThisBlock.store (prioritiseNodes, std::memory_order_relaxed);
 
-    // Make sure the counters are reset for all nodes before queueing any
-    for (auto& playbackNode : preparedNode.playbackNodes)
+    if (prioritiseNodes)
     {
-        if (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == 0)
+        updateCriticalPathWeights (preparedNode);
+
+        // Queue the ready Nodes with the heaviest chains first so they're also in order within each priority
+        auto& readyNodes = preparedNode.readyNodes;
+        readyNodes.clear();
+
+        for (auto& playbackNode : preparedNode.playbackNodes)
+            if (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == 0)
+                readyNodes.push_back (playbackNode.get());
+
+        std::sort (readyNodes.begin(), readyNodes.end(),
+                   [] (auto pn1, auto pn2) { return pn1->criticalPathWeight > pn2->criticalPathWeight; });
+
+        for (auto playbackNode : readyNodes)
         {
             jassert (! playbackNode->hasBeenQueued);
             playbackNode->hasBeenQueued = true;
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&playbackNode->node);
+            preparedNode.nodesReadyToBeProcessed->tryPush (&playbackNode->node, playbackNode->priority);
             ++numNodesJustQueued;
         }
     }
+    else
+    {
+        // Make sure the counters are reset for all nodes before queueing any
+        for (auto& playbackNode : preparedNode.playbackNodes)
+        {
+            if (playbackNode->numInputsToBeProcessed.load (std::memory_order_acquire) == 0)
+            {
+                jassert (! playbackNode->hasBeenQueued);
+                playbackNode->hasBeenQueued = true;
+                preparedNode.nodesReadyToBeProcessed->tryPush (&playbackNode->node, 0);
+                ++numNodesJustQueued;
+            }
+        }
+    }
 
     // Make sure this is only incremented after all the nodes have been queued
     // or the threads will start queueing Nodes at the same time
@@ -362,16 +592,59 @@ void LockFreeMultiThreadedNodePlayer::resetProcessQueue (PreparedNode& preparedN
 
     threadPool->setCurrentNode (&preparedNode);
 
+    // Parked threads won't take any Nodes so only signal the active ones
     if (int numThreadsToSignal = (int) numNodesQueued.load(); numThreadsToSignal > 1)
-        threadPool->signal (numThreadsToSignal);
+        if (const auto numActive = (int) numActiveThreads.load (std::memory_order_acquire); numActive > 0)
+            threadPool->signal (std::min (numThreadsToSignal, numActive));
 }
 
-Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode& preparedNode, Node& node)
+void LockFreeMultiThreadedNodePlayer::updateCriticalPathWeights (PreparedNode& preparedNode)
+{
+    // The playbackNodes are in the same order as the orderedNodes so all outputs come
+    // after their inputs. Iterating backwards means the output weights are always
+    // calculated before the Nodes that feed them
+    float maxWeight = 0.0f;
+
+    for (auto iter = preparedNode.playbackNodes.rbegin(); iter != preparedNode.playbackNodes.rend(); ++iter)
+    {
+        auto& playbackNode = **iter;
+        float maxOutputWeight = 0.0f;
+
+        for (auto output : playbackNode.outputs)
+            maxOutputWeight = std::max (maxOutputWeight, static_cast<PlaybackNode*> (output->internal)->criticalPathWeight);
+
+        playbackNode.criticalPathWeight = playbackNode.cost.load (std::memory_order_relaxed) + maxOutputWeight;
+        maxWeight = std::max (maxWeight, playbackNode.criticalPathWeight);
+    }
+
+    // Then spread the weights over the priorities so the heaviest chains are taken
+    // first, including the Nodes that become ready during the block
+    const auto weightToPriority = maxWeight > 0.0f ? (float) numNodePriorities / maxWeight : 0.0f;
+
+    for (auto& playbackNode : preparedNode.playbackNodes)
+        playbackNode->priority = std::min (numNodePriorities - 1, (size_t) (playbackNode->criticalPathWeight * weightToPriority));
+}
+
+inline void LockFreeMultiThreadedNodePlayer::queueNode (PreparedNode& preparedNode, Node& node, WorkQueue* localQueue)
+{
+    // When prioritising, Nodes go on the shared queue so the heaviest chains are taken first.
+    // Otherwise keep the Node on this thread's queue if there is one as its inputs are likely
+    // to still be in the cache, falling back to the shared queue
+    if (prioritiseNodesThisBlock.load (std::memory_order_relaxed))
+        preparedNode.nodesReadyToBeProcessed->tryPush (&node, static_cast<PlaybackNode*> (node.internal)->priority);
+    else if (localQueue == nullptr || ! localQueue->tryPush (&node))
+        preparedNode.nodesReadyToBeProcessed->tryPush (&node, 0);
+
+    numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+}
+
+Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode& preparedNode, Node& node, WorkQueue* localQueue)
 {
     auto playbackNode = static_cast<PlaybackNode*> (node.internal);
 
    #if RETURN_MID_NODES_OPTIMISATION
     Node* nodeToReturn = nullptr;
+    const bool prioritiseNodes = prioritiseNodesThisBlock.load (std::memory_order_relaxed);
    #endif
 
     for (auto output : playbackNode->outputs)
@@ -392,10 +665,16 @@ Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode&
             {
                 nodeToReturn = &outputPlaybackNode->node;
             }
+            else if (prioritiseNodes
+                     && outputPlaybackNode->criticalPathWeight > static_cast<PlaybackNode*> (nodeToReturn->internal)->criticalPathWeight)
+            {
+                // Keep the heaviest chain on this thread and hand the lighter one off
+                queueNode (preparedNode, *nodeToReturn, localQueue);
+                nodeToReturn = &outputPlaybackNode->node;
+            }
             else
             {
-                preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-                numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+                queueNode (preparedNode, outputPlaybackNode->node, localQueue);
             }
            #else
             // If there is only one Node or we're at the last Node we can return this to be processed by the same thread
@@ -403,8 +682,7 @@ Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode&
                 || output == playbackNode->outputs.back())
                 return &outputPlaybackNode->node;
 
-            preparedNode.nodesReadyToBeProcessed->try_enqueue (&outputPlaybackNode->node);
-            numNodesQueued.fetch_add (1, std::memory_order_acq_rel);
+            queueNode (preparedNode, outputPlaybackNode->node, localQueue);
            #endif
         }
     }
@@ -417,6 +695,17 @@ Node* LockFreeMultiThreadedNodePlayer::updateProcessQueueForNode (PreparedNode&
 }
 
 //==============================================================================
+bool LockFreeMultiThreadedNodePlayer::isUsingWorkStealing() const
+{
+    return threadPool->queueType == QueueType::workStealing && ! workQueues.empty();
+}
+
+size_t LockFreeMultiThreadedNodePlayer::getMaxQueuedPriority() const
+{
+    // Without prioritisation everything is queued at the lowest level so the others can be skipped
+    return prioritiseNodesThisBlock.load (std::memory_order_relaxed) ? numNodePriorities - 1 : 0;
+}
+
 bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode)
 {
     Node* nodeToProcess = nullptr;
@@ -424,10 +713,10 @@ bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& prepare
     if (numNodesQueued.load (std::memory_order_acquire) == 0)
         return false;
 
-    if (! preparedNode.nodesReadyToBeProcessed->try_dequeue (nodeToProcess))
+    if (! preparedNode.nodesReadyToBeProcessed->tryPop (nodeToProcess, getMaxQueuedPriority()))
         return false;
 
-    numNodesQueued.fetch_sub (1, std::memory_order_acq_rel);
+    updateReadyNodeBacklog (numNodesQueued.fetch_sub (1, std::memory_order_acq_rel));
 
     assert (nodeToProcess != nullptr);
     processNode (preparedNode, *nodeToProcess);
@@ -435,9 +724,48 @@ bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& prepare
     return true;
 }
 
-void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node)
+bool LockFreeMultiThreadedNodePlayer::processNextFreeNode (PreparedNode& preparedNode, size_t workQueueIndex)
+{
+    if (numNodesQueued.load (std::memory_order_acquire) == 0)
+        return false;
+
+    jassert (workQueueIndex < workQueues.size());
+    auto& localQueue = *workQueues[workQueueIndex];
+    Node* nodeToProcess = nullptr;
+
+    // Prefer the most recent Node this thread made ready, then any in the shared queue
+    // (the leaf Nodes) and finally try to take one from another thread
+    if (! localQueue.tryPop (nodeToProcess)
+        && ! preparedNode.nodesReadyToBeProcessed->tryPop (nodeToProcess, getMaxQueuedPriority())
+        && ! stealNode (workQueueIndex, nodeToProcess))
+        return false;
+
+    updateReadyNodeBacklog (numNodesQueued.fetch_sub (1, std::memory_order_acq_rel));
+
+    assert (nodeToProcess != nullptr);
+    processNode (preparedNode, *nodeToProcess, &localQueue);
+
+    return true;
+}
+
+bool LockFreeMultiThreadedNodePlayer::stealNode (size_t thiefIndex, Node*& stolenNode)
+{
+    const auto numQueues = workQueues.size();
+
+    // Start with the next thread along so threads don't all pile on to the same queue
+    for (size_t i = 1; i < numQueues; ++i)
+        if (workQueues[(thiefIndex + i) % numQueues]->trySteal (stolenNode))
+            return true;
+
+    return false;
+}
+
+void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, Node& node, WorkQueue* localQueue)
 {
     auto* nodeToProcess = &node;
+    auto* tracer = nodeProcessTracer.load (std::memory_order_relaxed);
+    const bool adaptive = useAdaptiveThreading.load (std::memory_order_relaxed);
+    const auto startCycles = adaptive ? rdtsc() : 0;
 
     // Attempt to process serial Node chains on this thread
     // to reduce context switches and overhead
@@ -449,12 +777,43 @@ void LockFreeMultiThreadedNodePlayer::processNode (PreparedNode& preparedNode, N
         #endif
 
         // Process Node
-        nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
-        nodeToProcess = updateProcessQueueForNode (preparedNode, *nodeToProcess);
+        const NodeProcessTracer::ScopedEvent nodeEvent (tracer, nodeToProcess);
+
+        if (prioritiseNodesThisBlock.load (std::memory_order_relaxed))
+        {
+            // Use the same clock as the tracer and adaptive threading so their timings can be compared
+            const auto nodeStartCycles = rdtsc();
+            nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
+            const auto numCycles = (float) (rdtsc() - nodeStartCycles);
+
+            // Smooth the cost so a single slow block doesn't reorder everything
+            auto& cost = static_cast<PlaybackNode*> (nodeToProcess->internal)->cost;
+            const auto oldCost = cost.load (std::memory_order_relaxed);
+            cost.store (oldCost + (numCycles - oldCost) * 0.1f, std::memory_order_relaxed);
+        }
+        else
+        {
+            nodeToProcess->process (numSamplesToProcess, referenceSampleRange);
+        }
+
+        nodeToProcess = updateProcessQueueForNode (preparedNode, *nodeToProcess, localQueue);
 
         if (! nodeToProcess)
             break;
     }
+
+    if (adaptive)
+        busyCycles.fetch_add (rdtsc() - startCycles, std::memory_order_relaxed);
+}
+
+inline void LockFreeMultiThreadedNodePlayer::updateReadyNodeBacklog (size_t numNodesQueuedBeforeDequeue)
+{
+    // If another Node was ready when this one was taken, there's work for more threads.
+    // This is checked first to avoid all the threads writing to the flag
+    if (numNodesQueuedBeforeDequeue > 1
+        && useAdaptiveThreading.load (std::memory_order_relaxed)
+        && ! hadReadyNodeBacklog.load (std::memory_order_relaxed))
+        hadReadyNodeBacklog.store (true, std::memory_order_relaxed);
 }
 
 }}
@@ -34,22 +34,6 @@ class LockFreeMultiThreadedNodePlayer
 {
 private:
     //==============================================================================
-    template<typename Type>
-    class LockFreeFifo
-    {
-    public:
-        LockFreeFifo (int capacity)
-            : fifo (std::make_unique<rigtorp::MPMCQueue<Type>> (static_cast<size_t> (capacity)))
-        {
-        }
-
-        bool try_enqueue (Type&& item)      { return fifo->try_push (std::move (item)); }
-        bool try_dequeue (Type& item)       { return fifo->try_pop (item); }
-
-    private:
-        std::unique_ptr<rigtorp::MPMCQueue<Type>> fifo;
-    };
-
     struct PlaybackNode
     {
         PlaybackNode (Node& n)
@@ -61,6 +45,14 @@ private:
         std::vector<Node*> outputs;
         std::atomic<size_t> numInputsToBeProcessed { 0 };
         std::atomic<bool> hasBeenQueued { true };
+
+        // Used for prioritisation. The cost is a moving average of the CPU cycles
+        // spent processing this Node and the weight is the longest total cost from
+        // this Node to the root, which is quantised to the priority it's queued with.
+        // The cost is updated by whichever thread processes the Node so is atomic
+        std::atomic<float> cost { 0.0f };
+        float criticalPathWeight = 0.0f;
+        size_t priority = 0;
        #if JUCE_DEBUG
         std::atomic<bool> hasBeenDequeued { false };
        #endif
@@ -70,11 +62,20 @@ private:
     {
         std::unique_ptr<NodeGraph> graph;
         std::vector<std::unique_ptr<PlaybackNode>> playbackNodes;
-        std::unique_ptr<LockFreeFifo<Node*>> nodesReadyToBeProcessed;
+        std::unique_ptr<PriorityFifo<Node*>> nodesReadyToBeProcessed;
         std::unique_ptr<AudioBufferPool> audioBufferPool;
+        std::vector<PlaybackNode*> readyNodes;
     };
 
 public:
+    //==============================================================================
+    /** Determines how Nodes that are ready to be processed are handed between threads. */
+    enum class QueueType
+    {
+        shared,         /**< All threads push and pop Nodes from a single shared queue. */
+        workStealing    /**< Each thread keeps the Nodes it makes ready on its own queue and steals from the others when that runs out. */
+    };
+
     //==============================================================================
     /**
         Base class for thread pools which can be customised to determine how
@@ -82,9 +83,12 @@ public:
     */
     struct ThreadPool
     {
-        /** Constructs a ThreadPool for a given LockFreeMultiThreadedNodePlayer. */
-        ThreadPool (LockFreeMultiThreadedNodePlayer& p)
-            : player (p)
+        /** Constructs a ThreadPool for a given LockFreeMultiThreadedNodePlayer.
+            If the QueueType is workStealing, the threads should call process (size_t)
+            instead of process().
+        */
+        ThreadPool (LockFreeMultiThreadedNodePlayer& p, QueueType qt = QueueType::shared)
+            : player (p), queueType (qt)
         {
         }
 
@@ -124,6 +128,7 @@ public:
         {
             threadsShouldExit = true;
             signalAll();
+            activationSemaphore.signal ((int) numParkedThreads.load (std::memory_order_acquire));
         }
 
         /** Signals the pool that all the threads should continue to run and not exit. */
@@ -172,6 +177,59 @@ public:
             return false;
         }
 
+        /** Process the next chain of Nodes using a work-stealing queue.
+            Pools using QueueType::workStealing should call this from each of their
+            threads with a unique index in the range [0, numThreads).
+            Returns true if at least one Node was processed, false if no Nodes were processed.
+        */
+        bool process (size_t threadIndex)
+        {
+            if (auto cpn = currentPreparedNode.load())
+                return player.processNextFreeNode (*cpn, threadIndex + 1);
+
+            return false;
+        }
+
+        /** Returns true if the thread with the given index should process Nodes.
+            When adaptive threading is enabled, threads with an index above the number
+            of active threads should call waitUntilActive instead.
+            @see LockFreeMultiThreadedNodePlayer::enableAdaptiveThreading
+        */
+        bool isThreadActive (size_t threadIndex) const
+        {
+            return threadIndex < player.numActiveThreads.load (std::memory_order_acquire);
+        }
+
+        /** Blocks the calling thread until it becomes active again or the threads should exit. */
+        void waitUntilActive (size_t threadIndex)
+        {
+            numParkedThreads.fetch_add (1, std::memory_order_acq_rel);
+
+            // This times out in case the signal is missed whilst parking
+            while (! shouldExit() && ! isThreadActive (threadIndex))
+                activationSemaphore.timed_wait (10'000);
+
+            numParkedThreads.fetch_sub (1, std::memory_order_acq_rel);
+        }
+
+        /** Called by the player when more threads become active to wake up the parked ones. */
+        void signalActivated()
+        {
+            if (const auto numParked = numParkedThreads.load (std::memory_order_acquire); numParked > 0)
+                activationSemaphore.signal ((int) numParked);
+        }
+
+        /** Pins the calling thread to the core the player's ThreadAffinity gives the
+            worker with this index, if it has one.
+            Subclasses should call this at the start of each of their threads.
+            @see LockFreeMultiThreadedNodePlayer::setThreadAffinity
+        */
+        void applyThreadAffinity (size_t threadIndex)
+        {
+            if (auto cpu = player.getThreadAffinity().getWorkerCPU (threadIndex))
+                setCurrentThreadAffinity ({ *cpu });
+        }
+
         /** Sets the current PreparedNode in use. This should live as long as the threads are running once set. */
         void setCurrentNode (LockFreeMultiThreadedNodePlayer::PreparedNode* nodeInUse)
         {
@@ -182,10 +240,13 @@ public:
         }
 
         LockFreeMultiThreadedNodePlayer& player;
+        const QueueType queueType;
 
     private:
         std::atomic<bool> threadsShouldExit { false };
         std::atomic<LockFreeMultiThreadedNodePlayer::PreparedNode*> currentPreparedNode { nullptr };
+        LightweightSemaphore activationSemaphore;
+        std::atomic<size_t> numParkedThreads { 0 };
     };
 
     //==============================================================================
@@ -254,15 +315,82 @@ public:
     */
     void enablePooledMemoryAllocations (bool);
 
+    /** Returns the allocation statistics of the current AudioBufferPool.
+        This will be empty if pooled memory allocations aren't enabled.
+        This should be called from the same thread as setNode.
+        @see enablePooledMemoryAllocations
+    */
+    AudioBufferPool::Statistics getAudioBufferPoolStatistics() const;
+
     /* @internal. */
     void enableNodeMemorySharing (bool shouldBeEnabled);
 
+    /** Enables or disables critical-path prioritisation of Nodes.
+        When enabled, the time taken to process each Node is measured and used to
+        find the longest chains to the root Node. Ready Nodes on the longest chains,
+        including those that become ready during the block, are then processed first
+        so they're less likely to be left until the end of the block.
+        This has a small overhead so is best used with uneven graphs.
+    */
+    void enableNodePrioritisation (bool shouldBeEnabled);
+
+    /** Sets a NodeProcessTracer to record the time each Node takes to process.
+        Pass nullptr to stop recording. The tracer must outlive its use by this player.
+    */
+    void setNodeProcessTracer (NodeProcessTracer*);
+
+    /** Sets the CPU cores the worker threads and the thread calling process should run on.
+        The worker threads are recreated to apply this so there will be a gap in the audio.
+        The thread calling process is pinned the next time it calls process.
+        If the memory pool is enabled, its buffers are allocated on the NUMA nodes of the cores.
+        @see ThreadAffinity, enablePooledMemoryAllocations
+    */
+    void setThreadAffinity (ThreadAffinity);
+
+    /** Returns the ThreadAffinity set with setThreadAffinity. */
+    const ThreadAffinity& getThreadAffinity() const     { return threadAffinity; }
+
+    //==============================================================================
+    /** Enables scaling the number of active worker threads to the parallelism of the graph.
+        When enabled, the time spent processing Nodes and the time the thread calling
+        process spends waiting on Node dependencies are measured each block. Workers are
+        then activated when the active ones are saturated and there are Nodes waiting, and
+        parked when the work could be done by fewer threads, up to the number set with
+        setNumThreads.
+        Unlike setNumThreads, this doesn't recreate the threads so there's no gap in the audio.
+    */
+    void enableAdaptiveThreading (bool shouldBeEnabled);
+
+    /** Measurements used to scale the number of active threads. */
+    struct AdaptiveThreadingStats
+    {
+        size_t numActiveThreads = 0;    /**< The number of worker threads currently processing Nodes. */
+        float parallelism = 0.0f;       /**< The smoothed average number of threads processing Nodes at once. */
+        float waitProportion = 0.0f;    /**< The smoothed proportion of each block spent waiting on dependencies by the thread calling process. */
+    };
+
+    /** Returns the current adaptive threading measurements. */
+    AdaptiveThreadingStats getAdaptiveThreadingStats() const;
+
 private:
     //==============================================================================
     std::atomic<size_t> numThreadsToUse { std::max ((size_t) 0, (size_t) std::thread::hardware_concurrency() - 1) };
     juce::Range<int64_t> referenceSampleRange;
     choc::buffer::FrameCount numSamplesToProcess = 0;
-    std::atomic<bool> threadsShouldExit { false }, useMemoryPool { false };
+    std::atomic<bool> threadsShouldExit { false }, useMemoryPool { false }, useNodePrioritisation { false };
+    std::atomic<NodeProcessTracer*> nodeProcessTracer { nullptr };
+
+    ThreadAffinity threadAffinity;
+    std::vector<size_t> processThreadCPUsToApply;
+    std::atomic<bool> processThreadAffinityPending { false };
+
+    // Adaptive threading
+    std::atomic<bool> useAdaptiveThreading { false }, hadReadyNodeBacklog { false };
+    std::atomic<size_t> numActiveThreads { 0 };
+    std::atomic<std::uint64_t> busyCycles { 0 };
+    std::atomic<float> smoothedParallelism { 0.0f }, smoothedWaitProportion { 0.0f };
+    size_t numThreadsCreated = 0;
+    int numUnderusedBlocks = 0;
 
     RealTimeSpinLock processMutex;
     std::unique_ptr<ThreadPool> threadPool;
@@ -275,6 +403,18 @@ private:
 
     std::atomic<size_t> numNodesQueued { 0 };
 
+    // When prioritising, ready Nodes are queued at one of these levels depending on their
+    // critical path weight. This is latched at the start of each block so toggling it
+    // can't leave Nodes on levels that aren't being checked
+    static constexpr size_t numNodePriorities = 8;
+    std::atomic<bool> prioritiseNodesThisBlock { false };
+
+    // Used when the ThreadPool's QueueType is workStealing.
+    // Index 0 belongs to the thread calling process, the rest to each of the pool's threads
+    using WorkQueue = WorkStealingQueue<Node*>;
+    static constexpr size_t workQueueCapacity = 1024;
+    std::vector<std::unique_ptr<WorkQueue>> workQueues;
+
     //==============================================================================
     std::atomic<double> sampleRate { 44100.0 };
     std::atomic<int> blockSize { 512 };
@@ -290,18 +430,27 @@ private:
     void clearThreads();
     void createThreads();
     void pause();
+    void updateNumActiveThreads (std::uint64_t blockCycles, std::uint64_t waitCycles);
 
     //==============================================================================
     void postNewGraph (std::unique_ptr<NodeGraph>);
 
     //==============================================================================
     static void buildNodesOutputLists (PreparedNode&);
+    static void copyNodeCosts (PreparedNode&, const NodeGraph* oldGraph);
     void resetProcessQueue (PreparedNode&);
-    Node* updateProcessQueueForNode (PreparedNode&, Node&);
-    void processNode (PreparedNode&, Node&);
+    static void updateCriticalPathWeights (PreparedNode&);
+    void queueNode (PreparedNode&, Node&, WorkQueue*);
+    Node* updateProcessQueueForNode (PreparedNode&, Node&, WorkQueue*);
+    void processNode (PreparedNode&, Node&, WorkQueue* localQueue = nullptr);
 
     //==============================================================================
+    bool isUsingWorkStealing() const;
+    size_t getMaxQueuedPriority() const;
     bool processNextFreeNode (PreparedNode&);
+    bool processNextFreeNode (PreparedNode&, size_t workQueueIndex);
+    bool stealNode (size_t thiefIndex, Node*&);
+    void updateReadyNodeBacklog (size_t numNodesQueuedBeforeDequeue);
 };
 
 }}
@@ -0,0 +1,304 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_NODEPLAYER
+ #include "../../tracktion_core/utilities/tracktion_Benchmark.h"
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+namespace test_utilities
+{
+    /** Creates a graph of numTracks sin generators, each followed by a chain of
+        numNodesPerTrack gain Nodes and then summed together.
+        The output will be a full-scale sin wave.
+    */
+    static inline std::unique_ptr<Node> createWideSinGraph (int numTracks, int numNodesPerTrack)
+    {
+        std::vector<std::unique_ptr<Node>> tracks;
+
+        for (int i = 0; i < numTracks; ++i)
+        {
+            std::unique_ptr<Node> node = std::make_unique<SinNode> (220.0f);
+            node = makeGainNode (std::move (node), 1.0f / (float) numTracks);
+
+            for (int j = 1; j < numNodesPerTrack; ++j)
+                node = makeGainNode (std::move (node), 1.0f);
+
+            tracks.push_back (std::move (node));
+        }
+
+        return std::make_unique<BasicSummingNode> (std::move (tracks));
+    }
+
+    /** Creates a graph of numTracks sin generators where each track has one more gain
+        Node than the last, up to maxNumNodesPerTrack. This gives one long critical
+        path alongside many short ones.
+        The output will be a full-scale sin wave.
+    */
+    static inline std::unique_ptr<Node> createUnevenSinGraph (int numTracks, int maxNumNodesPerTrack)
+    {
+        std::vector<std::unique_ptr<Node>> tracks;
+
+        for (int i = 0; i < numTracks; ++i)
+        {
+            std::unique_ptr<Node> node = std::make_unique<SinNode> (220.0f);
+            node = makeGainNode (std::move (node), 1.0f / (float) numTracks);
+
+            const int numNodesForTrack = 1 + (i * maxNumNodesPerTrack) / numTracks;
+
+            for (int j = 1; j < numNodesForTrack; ++j)
+                node = makeGainNode (std::move (node), 1.0f);
+
+            tracks.push_back (std::move (node));
+        }
+
+        return std::make_unique<BasicSummingNode> (std::move (tracks));
+    }
+
+    /** Creates a LockFreeMultiThreadedNodePlayer using the given strategy and number of threads. */
+    static inline std::unique_ptr<LockFreeMultiThreadedNodePlayer> createLockFreePlayer (std::unique_ptr<Node> node, const TestSetup& ts,
+                                                                                          ThreadPoolStrategy strategy, size_t numThreads)
+    {
+        auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (strategy));
+        player->setNumThreads (numThreads);
+        player->setNode (std::move (node), ts.sampleRate, ts.blockSize);
+
+        return player;
+    }
+}
+
+#if GRAPH_UNIT_TESTS_LOCKFREEPLAYER
+
+using namespace test_utilities;
+
+//==============================================================================
+//==============================================================================
+class LockFreeMultiThreadedNodePlayerTests : public juce::UnitTest
+{
+public:
+    LockFreeMultiThreadedNodePlayerTests()
+        : juce::UnitTest ("LockFreeMultiThreadedNodePlayer", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        TestSetup ts;
+        ts.randomiseBlockSizes = true;
+        ts.random = getRandom();
+
+        for (auto strategy : getThreadPoolStrategies())
+        {
+            for (size_t numThreads : { 2u, 8u })
+            {
+                beginTest ("Wide graph: " + test_utilities::getName (strategy) + ", " + juce::String (numThreads) + " threads");
+                {
+                    auto player = createLockFreePlayer (createWideSinGraph (32, 4), ts, strategy, numThreads);
+                    auto testContext = createTestContext (std::move (player), ts, 1, 1.0);
+                    expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+                }
+            }
+        }
+
+        for (auto strategy : { ThreadPoolStrategy::lightweightSemHybrid, ThreadPoolStrategy::workStealing })
+        {
+            beginTest ("Prioritised uneven graph: " + test_utilities::getName (strategy));
+            {
+                auto player = createLockFreePlayer (createUnevenSinGraph (32, 64), ts, strategy, 4);
+                player->enableNodePrioritisation (true);
+                TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 1.0, true);
+
+                // Toggling should be safe whilst processing
+                testProcess.process (juce::roundToInt (ts.sampleRate * 0.25));
+                testProcess.getNodePlayer().enableNodePrioritisation (false);
+                testProcess.process (juce::roundToInt (ts.sampleRate * 0.25));
+                testProcess.getNodePlayer().enableNodePrioritisation (true);
+
+                auto testContext = testProcess.processAll();
+                expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+            }
+        }
+
+        beginTest ("Work stealing graph rebuild");
+        {
+            auto player = createLockFreePlayer (createWideSinGraph (8, 2), ts, ThreadPoolStrategy::workStealing, 4);
+            TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 2.0, true);
+
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setNumThreads (2);
+            testProcess.setNode (createWideSinGraph (64, 8));
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setNumThreads (6);
+            testProcess.setNode (createWideSinGraph (16, 3));
+
+            auto testContext = testProcess.processAll();
+            expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+
+        for (auto strategy : getThreadPoolStrategies())
+        {
+            beginTest ("Adaptive threading: " + test_utilities::getName (strategy));
+            {
+                // A single chain has no parallelism so the workers should be parked
+                {
+                    auto player = createLockFreePlayer (createWideSinGraph (1, 32), ts, strategy, 4);
+                    player->enableAdaptiveThreading (true);
+                    expectEquals (player->getAdaptiveThreadingStats().numActiveThreads, (size_t) 4);
+
+                    TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 5.0, true);
+                    auto testContext = testProcess.processAll();
+                    expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+
+                    auto& nodePlayer = testProcess.getNodePlayer();
+                    const auto numActiveThreads = nodePlayer.getAdaptiveThreadingStats().numActiveThreads;
+                    expectLessThan (numActiveThreads, (size_t) 4);
+
+                    // Setting a new Node shouldn't reactivate the parked threads
+                    testProcess.setNode (createWideSinGraph (1, 32));
+                    expectEquals (nodePlayer.getAdaptiveThreadingStats().numActiveThreads, numActiveThreads);
+
+                    // Disabling should reactivate all the threads without recreating them
+                    nodePlayer.enableAdaptiveThreading (false);
+                    expectEquals (nodePlayer.getAdaptiveThreadingStats().numActiveThreads, (size_t) 4);
+                }
+
+                // A wide graph should still render correctly whilst threads are being scaled
+                {
+                    auto player = createLockFreePlayer (createWideSinGraph (64, 4), ts, strategy, 4);
+                    player->enableAdaptiveThreading (true);
+                    auto testContext = createTestContext (std::move (player), ts, 1, 2.0);
+                    expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+                }
+            }
+        }
+
+        beginTest ("Thread affinity");
+        {
+            auto player = createLockFreePlayer (createWideSinGraph (16, 2), ts, ThreadPoolStrategy::lightweightSemHybrid, 3);
+            player->enablePooledMemoryAllocations (true);
+            player->setThreadAffinity (ThreadAffinity::forNUMANode (0));
+            TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 1.0, true);
+
+            // Changing the affinity whilst playing should just restart the threads
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setThreadAffinity ({});
+            expect (testProcess.getNodePlayer().getThreadAffinity().isEmpty());
+
+            auto testContext = testProcess.processAll();
+            expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+    }
+};
+
+static LockFreeMultiThreadedNodePlayerTests lockFreeMultiThreadedNodePlayerTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_NODEPLAYER
+
+//==============================================================================
+//==============================================================================
+class LockFreeMultiThreadedNodePlayerBenchmarks : public juce::UnitTest
+{
+public:
+    LockFreeMultiThreadedNodePlayerBenchmarks()
+        : juce::UnitTest ("LockFreeMultiThreadedNodePlayer", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        // Compares the single shared queue with per-thread work-stealing queues.
+        // Both use the same semaphore/spin suspension so only the queueing differs.
+        for (size_t numThreads : { 2u, 8u, 32u })
+            for (auto strategy : { ThreadPoolStrategy::lightweightSemHybrid, ThreadPoolStrategy::workStealing })
+                runBenchmark (strategy, numThreads, 128, 16);
+
+        // Compares FIFO ordering with critical-path prioritisation on a graph with uneven track lengths
+        for (size_t numThreads : { 2u, 8u })
+            for (bool prioritise : { false, true })
+                runUnevenBenchmark (ThreadPoolStrategy::lightweightSemHybrid, numThreads, prioritise);
+    }
+
+private:
+    void runBenchmark (ThreadPoolStrategy strategy, size_t numThreads, int numTracks, int numNodesPerTrack)
+    {
+        using namespace test_utilities;
+        TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        const auto numNodes = numTracks * (numNodesPerTrack + 1) + 1;
+        const auto description = juce::String ("{nodes} nodes, {threads} threads, {bs} block size")
+                                    .replace ("{nodes}", juce::String (numNodes))
+                                    .replace ("{threads}", juce::String (numThreads))
+                                    .replace ("{bs}", juce::String (ts.blockSize));
+
+        beginTest (test_utilities::getName (strategy) + ": " + description);
+
+        auto player = createLockFreePlayer (createWideSinGraph (numTracks, numNodesPerTrack), ts, strategy, numThreads);
+        TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 5.0, false);
+
+        // Warm up the threads and caches before measuring
+        testProcess.process (ts.blockSize * 16);
+        testProcess.getStatisticsAndReset();
+
+        testProcess.processAll();
+        const auto stats = testProcess.getStatisticsAndReset();
+
+        BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Graph",
+                                                                                                  ("LockFreeMultiThreadedNodePlayer: " + test_utilities::getName (strategy)).toStdString(),
+                                                                                                  description.toStdString()),
+                                                                       stats));
+        logMessage (stats.toString (test_utilities::getName (strategy).toStdString()));
+        expect (true);
+    }
+
+    void runUnevenBenchmark (ThreadPoolStrategy strategy, size_t numThreads, bool prioritise)
+    {
+        using namespace test_utilities;
+        TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        const auto playerName = test_utilities::getName (strategy) + (prioritise ? " (prioritised)" : " (FIFO)");
+        const auto description = juce::String ("Uneven graph, {threads} threads, {bs} block size")
+                                    .replace ("{threads}", juce::String (numThreads))
+                                    .replace ("{bs}", juce::String (ts.blockSize));
+
+        beginTest (playerName + ": " + description);
+
+        auto player = createLockFreePlayer (createUnevenSinGraph (64, 256), ts, strategy, numThreads);
+        player->enableNodePrioritisation (prioritise);
+        TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 1, 5.0, false);
+
+        // Warm up and let the Node costs settle before measuring
+        testProcess.process (ts.blockSize * 16);
+        testProcess.getStatisticsAndReset();
+
+        testProcess.processAll();
+        const auto stats = testProcess.getStatisticsAndReset();
+
+        BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Graph",
+                                                                                                  ("LockFreeMultiThreadedNodePlayer: " + playerName).toStdString(),
+                                                                                                  description.toStdString()),
+                                                                       stats));
+        logMessage (stats.toString (playerName.toStdString()));
+        expect (true);
+    }
+};
+
+static LockFreeMultiThreadedNodePlayerBenchmarks lockFreeMultiThreadedNodePlayerBenchmarks;
+
+#endif
+
+}}
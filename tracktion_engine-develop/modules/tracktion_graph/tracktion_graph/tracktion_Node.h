@@ -179,6 +179,16 @@ enum class AllocateAudioBuffer
     yes /**< Do allocate an audio buffer so your subclass use the dest buffer passed to process. */
 };
 
+/** Describes what is known about the audio a Node has output for a block.
+    This is only a hint that other Nodes can use to skip work, the audio buffer
+    must still contain the data it describes.
+*/
+enum class AudioContent
+{
+    unknown,    /**< Nothing is known about the audio so it should be processed as normal. */
+    silent      /**< Every sample in the block is zero. */
+};
+
 /** Holds some hints that _might_ be used by the Node or players to improve efficiency. */
 struct NodeOptimisations
 {
@@ -246,6 +256,11 @@ public:
     {
         choc::buffer::ChannelArrayView<float> audio;
         tracktion_engine::MidiMessageArray& midi;
+
+        /** Nodes can set this during their process call if they know their output is
+            silent so subsequent Nodes can skip summing, metering etc.
+        */
+        AudioContent audioContent = AudioContent::unknown;
     };
 
     /** Returns the processed audio and MIDI output.
@@ -319,6 +334,21 @@ public:
     */
     void release();
 
+    //==============================================================================
+    /** Can return a hash of the state that determines how this Node is prepared.
+        If this is non-zero and the graph being replaced contains a Node of the same
+        type and ID, with the same state hash and the same inputs properties,
+        transferPreparedState will be called instead of prepareToPlay.
+        This should include anything your prepareToPlay depends on apart from the
+        PlaybackInitialisationInfo, the Node's properties and its inputs' properties.
+    */
+    virtual size_t getStateHash()                   { return 0; }
+
+    /** Returns true if this Node took over the prepared state of the Node it
+        replaced rather than being prepared again.
+    */
+    bool hasReusedPreparedState() const             { return reusedPreparedState; }
+
     //==============================================================================
     /** @internal */
     void* internal = nullptr;
@@ -335,6 +365,14 @@ protected:
     */
     virtual void prepareToPlay (const PlaybackInitialisationInfo&) {}
 
+    /** Called instead of prepareToPlay if an unchanged Node exists in the graph being
+        replaced (see getStateHash).
+        Copy or share any prepared state from the old Node and return true or return
+        false to be prepared with prepareToPlay as normal.
+        N.B. The old Node may still be being processed so it shouldn't be modified.
+    */
+    virtual bool transferPreparedState (Node& /*oldNode*/, const PlaybackInitialisationInfo&)   { return false; }
+
     /** Called before once on all Nodes before they are processed.
         This can be used to prefetch audio data or update mute statuses etc..
     */
@@ -380,7 +418,9 @@ private:
     tracktion_engine::MidiMessageArray midiBuffer;
     std::atomic<int> numSamplesProcessed { 0 }, retainCount { 0 };
     NodeOptimisations nodeOptimisations;
-
+    AudioContent audioContent = AudioContent::unknown;
+    size_t preparedStateHash = 0;
+    bool reusedPreparedState = false;
 
     std::vector<Node*> directInputNodes;
     std::atomic<Node*> nodeToRelease { nullptr };
@@ -390,6 +430,8 @@ private:
    #if JUCE_DEBUG
     std::atomic<bool> isBeingProcessed { false };
    #endif
+
+    bool transferPreparedStateIfPossible (const PlaybackInitialisationInfo&);
 };
 
 //==============================================================================
@@ -463,7 +505,8 @@ static inline std::vector<Node*> transformNodes (Node& rootNode)
 //==============================================================================
 inline void Node::initialise (const PlaybackInitialisationInfo& info)
 {
-    prepareToPlay (info);
+    if (! transferPreparedStateIfPossible (info))
+        prepareToPlay (info);
 
     auto props = getNodeProperties();
     audioBufferSize = choc::buffer::Size::create ((choc::buffer::ChannelCount) props.numberOfChannels,
@@ -482,6 +525,72 @@ inline void Node::initialise (const PlaybackInitialisationInfo& info)
     directInputNodes = getDirectInputNodes();
 }
 
+inline bool Node::transferPreparedStateIfPossible (const PlaybackInitialisationInfo& info)
+{
+    reusedPreparedState = false;
+    preparedStateHash = getStateHash();
+
+    if (preparedStateHash == 0)
+        return false;
+
+    auto hashProperties = [] (size_t& seed, const NodeProperties& props)
+    {
+        hash_combine (seed, props.hasAudio);
+        hash_combine (seed, props.hasMidi);
+        hash_combine (seed, props.numberOfChannels);
+        hash_combine (seed, props.latencyNumSamples);
+        hash_combine (seed, props.nodeID);
+    };
+
+    const auto props = getNodeProperties();
+
+    if (props.nodeID == 0)
+    {
+        preparedStateHash = 0;
+        return false;
+    }
+
+    hash_combine (preparedStateHash, typeid (*this).hash_code());
+    hash_combine (preparedStateHash, info.sampleRate);
+    hash_combine (preparedStateHash, info.blockSize);
+    hash_combine (preparedStateHash, info.enableNodeMemorySharing);
+    hash_combine (preparedStateHash, numOutputNodes);
+    hashProperties (preparedStateHash, props);
+
+    for (auto inputNode : getDirectInputNodes())
+    {
+        hashProperties (preparedStateHash, inputNode->getNodeProperties());
+        hash_combine (preparedStateHash, inputNode->numOutputNodes);
+    }
+
+    if (info.nodeGraphToReplace == nullptr)
+        return false;
+
+    // sortedNodes is ordered by ID so this is a binary search
+    const auto& oldNodes = info.nodeGraphToReplace->sortedNodes;
+    const auto oldNodesWithID = std::equal_range (oldNodes.begin(), oldNodes.end(), NodeAndID { nullptr, props.nodeID });
+
+    for (auto iter = oldNodesWithID.first; iter != oldNodesWithID.second; ++iter)
+    {
+        auto& oldNode = *iter->node;
+
+        if (oldNode.preparedStateHash != preparedStateHash)
+            continue;
+
+        if (typeid (oldNode) != typeid (*this))
+            continue;
+
+        if (! transferPreparedState (oldNode, info))
+            return false;
+
+        nodeOptimisations = oldNode.nodeOptimisations;
+        reusedPreparedState = true;
+        return true;
+    }
+
+    return false;
+}
+
 inline void Node::prepareForNextBlock (juce::Range<int64_t> referenceSampleRange)
 {
     // Only do this once as prepare may be called multiple times
@@ -551,6 +660,7 @@ inline void Node::process (choc::buffer::FrameCount numSamples, juce::Range<int6
     auto destAudioView = audioView;
     ProcessContext pc { numSamples, referenceSampleRange, { destAudioView, midiBuffer } };
     process (pc);
+    audioContent = pc.buffers.audioContent;
     numSamplesProcessed.store ((int) numSamples, std::memory_order_release);
 
     jassert (numChannelsBeforeProcessing == audioBuffer.getNumChannels());
@@ -587,7 +697,7 @@ inline Node::AudioAndMidiBuffer Node::getProcessedOutput()
    #endif
 
     return { audioView.getStart ((choc::buffer::FrameCount) numSamplesProcessed.load (std::memory_order_acquire)),
-             midiBuffer };
+             midiBuffer, audioContent };
 }
 
 inline size_t Node::getAllocatedBytes() const
@@ -39,6 +39,7 @@ public:
             runSinTests (setup);
             runSinCancellingTests (setup);
             runSinOctaveTests (setup);
+            runSilenceTests (setup);
             runSendReturnTests (setup);
             runLatencyTests (setup);
 
@@ -121,6 +122,51 @@ private:
         }
     }
 
+    void runSilenceTests (TestSetup testSetup)
+    {
+        // Processes a single block and returns the AudioContent of the root Node
+        auto getRootAudioContent = [&testSetup] (std::unique_ptr<Node> node)
+        {
+            auto graph = node_player_utils::prepareToPlay (std::move (node), nullptr,
+                                                          testSetup.sampleRate, testSetup.blockSize);
+            const juce::Range<int64_t> referenceSampleRange (0, testSetup.blockSize);
+
+            for (auto n : graph->orderedNodes)
+                n->prepareForNextBlock (referenceSampleRange);
+
+            for (auto n : graph->orderedNodes)
+                n->process ((choc::buffer::FrameCount) testSetup.blockSize, referenceSampleRange);
+
+            return graph->rootNode->getProcessedOutput().audioContent;
+        };
+
+        beginTest ("Summing silent inputs");
+        {
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.push_back (makeNode<SilentNode> (2));
+            nodes.push_back (makeNode<SilentNode> (2));
+
+            expect (getRootAudioContent (makeNode<SummingNode> (std::move (nodes))) == AudioContent::silent);
+        }
+
+        beginTest ("Summing silent and non-silent inputs");
+        {
+            auto makeSumNode = []
+            {
+                std::vector<std::unique_ptr<Node>> nodes;
+                nodes.push_back (makeNode<SilentNode> (1));
+                nodes.push_back (makeNode<SinNode> (220.0f));
+
+                return makeNode<SummingNode> (std::move (nodes));
+            };
+
+            expect (getRootAudioContent (makeSumNode()) == AudioContent::unknown);
+
+            auto testContext = createBasicTestContext (makeSumNode(), testSetup, 1, 5.0);
+            test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+    }
+
     void runSendReturnTests (TestSetup testSetup)
     {
         beginTest ("Sin send/return");
@@ -639,6 +685,35 @@ private:
             test_utilities::expectAudioBuffer (*this, testContext->buffer, 0, latencyNumSamples,
                                                0.0f, 0.0f, 1.0f, 0.707f);
         }
+
+        beginTest ("Rebuild reusing prepared state");
+        {
+            // Unchanged Nodes should take over the prepared state of the Nodes they replace
+            // rather than being prepared again, changed Nodes should be prepared as normal
+            auto makeSinNode = [] (int latencyNumSamples)
+            {
+                size_t nodeID = 1234;
+                return makeNode<LatencyNode> (makeNode<SinNode> (220.0f, 1, nodeID), latencyNumSamples);
+            };
+
+            auto prepare = [&testSetup] (std::unique_ptr<Node> node, NodeGraph* oldGraph)
+            {
+                return node_player_utils::prepareToPlay (std::move (node), oldGraph,
+                                                         testSetup.sampleRate, testSetup.blockSize);
+            };
+
+            auto firstGraph = prepare (makeSinNode (100), nullptr);
+            expect (! firstGraph->rootNode->hasReusedPreparedState());
+
+            auto secondGraph = prepare (makeSinNode (100), firstGraph.get());
+            expect (secondGraph->rootNode->hasReusedPreparedState());
+            expect (findNodeWithID<LatencyNode> (*secondGraph, secondGraph->rootNode->getNodeProperties().nodeID)
+                     == secondGraph->rootNode.get());
+
+            auto thirdGraph = prepare (makeSinNode (200), secondGraph.get());
+            expect (! thirdGraph->rootNode->hasReusedPreparedState());
+            expectEquals (thirdGraph->rootNode->getNodeProperties().latencyNumSamples, 200);
+        }
     }
 
     void runCycleTests (TestSetup testSetup)
@@ -60,7 +60,7 @@ struct ThreadPoolCV : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -155,8 +155,10 @@ private:
         return shouldWait();
     }
 
-    void runThread()
+    void runThread (size_t threadIndex)
     {
+        applyThreadAffinity (threadIndex);
+
         juce::WorkgroupToken token;
         workgroup.join (token);
 
@@ -165,7 +167,9 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process())
                 wait();
         }
     }
@@ -195,7 +199,7 @@ struct ThreadPoolRT : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -259,8 +263,10 @@ private:
     std::vector<std::thread> threads;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t threadIndex)
     {
+        applyThreadAffinity (threadIndex);
+
         juce::WorkgroupToken token;
         workgroup.join (token);
 
@@ -269,7 +275,9 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process())
                 wait();
         }
     }
@@ -310,7 +318,7 @@ struct ThreadPoolHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -424,8 +432,10 @@ private:
         return shouldWait();
     }
 
-    void runThread()
+    void runThread (size_t threadIndex)
     {
+        applyThreadAffinity (threadIndex);
+
         juce::WorkgroupToken token;
         workgroup.join (token);
 
@@ -434,7 +444,9 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process())
                 wait();
         }
     }
@@ -466,7 +478,7 @@ struct ThreadPoolSem : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -531,8 +543,10 @@ private:
     std::unique_ptr<SemaphoreType> semaphore;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t threadIndex)
     {
+        applyThreadAffinity (threadIndex);
+
         juce::WorkgroupToken token;
         workgroup.join (token);
 
@@ -541,7 +555,9 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process())
                 wait();
         }
     }
@@ -573,7 +589,7 @@ struct ThreadPoolSemHybrid : public LockFreeMultiThreadedNodePlayer::ThreadPool
 
         for (size_t i = 0; i < numThreads; ++i)
         {
-            threads.emplace_back ([this] { runThread(); });
+            threads.emplace_back ([this, i] { runThread (i); });
             setThreadPriority (threads.back(), 10);
             tryToUpgradeCurrentThreadToRealtime (rtOpts);
         }
@@ -663,8 +679,10 @@ private:
     std::unique_ptr<SemaphoreType> semaphore;
     juce::AudioWorkgroup workgroup;
 
-    void runThread()
+    void runThread (size_t threadIndex)
     {
+        applyThreadAffinity (threadIndex);
+
         juce::WorkgroupToken token;
         workgroup.join (token);
         
@@ -675,11 +693,152 @@ private:
             if (shouldExit())
                 return;
 
-            if (! process())
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process())
                 wait();
         }
     }
 };
+
+
+//==============================================================================
+//==============================================================================
+template<typename SemaphoreType>
+struct ThreadPoolWorkStealing : public LockFreeMultiThreadedNodePlayer::ThreadPool
+{
+    ThreadPoolWorkStealing (LockFreeMultiThreadedNodePlayer& p)
+        : ThreadPool (p, LockFreeMultiThreadedNodePlayer::QueueType::workStealing)
+    {
+    }
+
+    void createThreads (size_t numThreads, juce::AudioWorkgroup workgroupToUse) override
+    {
+        if (threads.size() == numThreads)
+            return;
+
+        resetExitSignal();
+        semaphore = std::make_unique<SemaphoreType> ((int) numThreads);
+        workgroup = workgroupToUse;
+
+        const auto rtOpts = juce::Thread::RealtimeOptions()
+                      .withPriority (10)
+                      .withApproximateAudioProcessingTime (player.getBlockSize(), player.getSampleRate());
+
+        for (size_t i = 0; i < numThreads; ++i)
+        {
+            threads.emplace_back ([this, i] { runThread (i); });
+            setThreadPriority (threads.back(), 10);
+            tryToUpgradeCurrentThreadToRealtime (rtOpts);
+        }
+    }
+
+    void clearThreads() override
+    {
+        signalShouldExit();
+
+        for (auto& t : threads)
+            t.join();
+
+        threads.clear();
+        semaphore.reset();
+    }
+
+    void signalOne() override
+    {
+        if (semaphore) semaphore->signal();
+    }
+
+    void signal (int numToSignal) override
+    {
+        if (semaphore) semaphore->signal (std::min (numToSignal, (int) threads.size()));
+    }
+
+    void signalAll() override
+    {
+        if (semaphore) semaphore->signal ((int) threads.size());
+    }
+
+    void wait()
+    {
+        thread_local int pauseCount = 0;
+
+        if (shouldExit())
+            return;
+
+        if (shouldWait())
+        {
+            ++pauseCount;
+
+            if (pauseCount < 25)
+            {
+                pause();
+            }
+            else if (pauseCount < 50)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                pauseCount = 0;
+
+                // Fall back to locking
+                if (timeOutMilliseconds < 0)
+                {
+                    semaphore->wait();
+                }
+                else
+                {
+                    using namespace std::chrono;
+                    semaphore->timed_wait ((std::uint64_t) duration_cast<microseconds> (milliseconds (timeOutMilliseconds)).count());
+                }
+            }
+        }
+        else
+        {
+            pauseCount = 0;
+        }
+    }
+
+    void waitForFinalNode() override
+    {
+        if (isFinalNodeReady())
+            return;
+
+        if (! shouldWait())
+            return;
+
+        pause();
+        return;
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::unique_ptr<SemaphoreType> semaphore;
+    juce::AudioWorkgroup workgroup;
+
+    void runThread (size_t threadIndex)
+    {
+        applyThreadAffinity (threadIndex);
+
+        juce::WorkgroupToken token;
+        workgroup.join (token);
+
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport();
+
+        for (;;)
+        {
+            if (shouldExit())
+                return;
+
+            if (! isThreadActive (threadIndex))
+                waitUntilActive (threadIndex);
+            else if (! process (threadIndex))
+                wait();
+        }
+    }
+};
+
 //==============================================================================
 //==============================================================================
 LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getPoolCreatorFunction (ThreadPoolStrategy poolType)
@@ -696,6 +855,8 @@ LockFreeMultiThreadedNodePlayer::ThreadPoolCreator getPoolCreatorFunction (Threa
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolSem<LightweightSemaphore>> (p); };
         case ThreadPoolStrategy::lightweightSemHybrid:
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolSemHybrid<LightweightSemaphore>> (p); };
+        case ThreadPoolStrategy::workStealing:
+            return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolWorkStealing<LightweightSemaphore>> (p); };
         case ThreadPoolStrategy::realTime:
         default:
             return [] (LockFreeMultiThreadedNodePlayer& p) { return std::make_unique<ThreadPoolRT> (p); };
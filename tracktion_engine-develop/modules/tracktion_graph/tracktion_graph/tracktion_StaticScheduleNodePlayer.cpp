@@ -0,0 +1,360 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#include <thread>
+#if JUCE_INTEL
+ #include <emmintrin.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+StaticScheduleNodePlayer::StaticScheduleNodePlayer()
+{
+}
+
+StaticScheduleNodePlayer::~StaticScheduleNodePlayer()
+{
+    clearThreads();
+}
+
+void StaticScheduleNodePlayer::setNumThreads (size_t newNumThreads)
+{
+    if (newNumThreads == numThreadsToUse)
+        return;
+
+    clearThreads();
+    numThreadsToUse = newNumThreads;
+    recompileSchedule();
+    createThreads();
+}
+
+void StaticScheduleNodePlayer::setNode (std::unique_ptr<Node> newNode)
+{
+    setNode (std::move (newNode), sampleRate, blockSize);
+}
+
+void StaticScheduleNodePlayer::setNode (std::unique_ptr<Node> newNode, double sampleRateToUse, int blockSizeToUse)
+{
+    clearThreads();
+
+    sampleRate = sampleRateToUse;
+    blockSize = blockSizeToUse;
+
+    // Pass in the old graph so any state can be transferred before it's deleted
+    auto newGraph = node_player_utils::prepareToPlay (std::move (newNode), schedule.graph.get(),
+                                                      sampleRateToUse, blockSizeToUse);
+    schedule = compileSchedule (std::move (newGraph), numThreadsToUse);
+
+    createThreads();
+}
+
+void StaticScheduleNodePlayer::prepareToPlay (double sampleRateToUse, int blockSizeToUse)
+{
+    if (sampleRateToUse == sampleRate && blockSizeToUse == blockSize)
+        return;
+
+    std::unique_ptr<Node> currentRoot;
+
+    if (schedule.graph != nullptr)
+        currentRoot = std::move (schedule.graph->rootNode);
+
+    clearNode();
+    setNode (std::move (currentRoot), sampleRateToUse, blockSizeToUse);
+}
+
+int StaticScheduleNodePlayer::process (const Node::ProcessContext& pc)
+{
+    if (schedule.graph == nullptr || schedule.graph->rootNode == nullptr)
+        return -1;
+
+    const NodeProcessTracer::ScopedEvent blockEvent (nodeProcessTracer.load (std::memory_order_relaxed), nullptr);
+
+    if (processThreadAffinityPending.exchange (false, std::memory_order_acq_rel))
+        setCurrentThreadAffinity (processThreadCPUsToApply);
+
+    numSamplesToProcess = pc.numSamples;
+    referenceSampleRange = pc.referenceSampleRange;
+
+    // Prepare all the nodes to be played back
+    for (auto node : schedule.graph->orderedNodes)
+        node->prepareForNextBlock (referenceSampleRange);
+
+    // We need to retain the root so we can get the output from it
+    auto& rootNode = *schedule.graph->rootNode;
+    rootNode.retain();
+
+    // Start the other threads on their schedules and then process our own
+    const auto numThreadsToStart = threads.size();
+    numThreadsProcessing.store (numThreadsToStart, std::memory_order_release);
+
+    for (size_t i = 0; i < numThreadsToStart; ++i)
+        threadStartSemaphores[i]->signal();
+
+    processThreadSchedule (schedule.threadSchedules.front());
+
+    // Wait for the other threads to finish so none of them are still
+    // using the Nodes when the next block is prepared
+    waitUntil ([this] { return numThreadsProcessing.load (std::memory_order_acquire) == 0; });
+
+    jassert (rootNode.hasProcessed());
+
+    // Add output from graph to buffers
+    {
+        auto output = rootNode.getProcessedOutput();
+        auto numAudioChannels = std::min (output.audio.getNumChannels(), pc.buffers.audio.getNumChannels());
+
+        if (numAudioChannels > 0)
+            add (pc.buffers.audio.getFirstChannels (numAudioChannels),
+                 output.audio.getFirstChannels (numAudioChannels));
+
+        pc.buffers.midi.mergeFrom (output.midi);
+    }
+
+    // We need to release the root to match the previous retain
+    rootNode.release();
+
+    return 0;
+}
+
+void StaticScheduleNodePlayer::clearNode()
+{
+    clearThreads();
+    schedule = compileSchedule (nullptr, numThreadsToUse);
+    createThreads();
+}
+
+void StaticScheduleNodePlayer::setNodeProcessTracer (NodeProcessTracer* tracer)
+{
+    nodeProcessTracer.store (tracer, std::memory_order_release);
+}
+
+void StaticScheduleNodePlayer::setThreadAffinity (ThreadAffinity newAffinity)
+{
+    if (newAffinity == threadAffinity)
+        return;
+
+    clearThreads();
+
+    // If the process thread was pinned before, it needs to be allowed to run on any core again
+    processThreadCPUsToApply = newAffinity.processThreadCPUs;
+
+    if (processThreadCPUsToApply.empty() && ! threadAffinity.processThreadCPUs.empty())
+        for (auto& nodeCPUs : getNUMANodeCPUs())
+            processThreadCPUsToApply.insert (processThreadCPUsToApply.end(), nodeCPUs.begin(), nodeCPUs.end());
+
+    threadAffinity = std::move (newAffinity);
+    processThreadAffinityPending.store (! processThreadCPUsToApply.empty(), std::memory_order_release);
+
+    if (! schedule.threadSchedules.empty())
+        createThreads();
+}
+
+//==============================================================================
+std::vector<size_t> StaticScheduleNodePlayer::getNumNodesPerThread() const
+{
+    std::vector<size_t> numNodes;
+
+    for (auto& threadSchedule : schedule.threadSchedules)
+        numNodes.push_back (threadSchedule.steps.size());
+
+    return numNodes;
+}
+
+size_t StaticScheduleNodePlayer::getNumSyncPoints() const
+{
+    size_t numSyncPoints = 0;
+
+    for (auto& threadSchedule : schedule.threadSchedules)
+        numSyncPoints += threadSchedule.dependencies.size();
+
+    return numSyncPoints;
+}
+
+//==============================================================================
+void StaticScheduleNodePlayer::clearThreads()
+{
+    threadsShouldExit.store (true, std::memory_order_release);
+
+    for (auto& semaphore : threadStartSemaphores)
+        semaphore->signal();
+
+    for (auto& t : threads)
+        t.join();
+
+    threads.clear();
+    threadStartSemaphores.clear();
+    threadsShouldExit.store (false, std::memory_order_release);
+}
+
+void StaticScheduleNodePlayer::createThreads()
+{
+    jassert (threads.empty());
+
+    // The first schedule is processed by the thread calling process and empty
+    // schedules have been removed so there may be fewer than numThreadsToUse
+    jassert (! schedule.threadSchedules.empty());
+    const auto numThreadsToCreate = schedule.threadSchedules.size() - 1;
+
+    for (size_t i = 0; i < numThreadsToCreate; ++i)
+        threadStartSemaphores.push_back (std::make_unique<LightweightSemaphore>());
+
+    for (size_t i = 0; i < numThreadsToCreate; ++i)
+    {
+        threads.emplace_back ([this, i] { runThread (i); });
+        setThreadPriority (threads.back(), 10);
+    }
+}
+
+void StaticScheduleNodePlayer::runThread (size_t threadIndex)
+{
+    if (auto cpu = threadAffinity.getWorkerCPU (threadIndex))
+        setCurrentThreadAffinity ({ *cpu });
+
+    auto& startSemaphore = *threadStartSemaphores[threadIndex];
+
+    for (;;)
+    {
+        startSemaphore.wait();
+
+        if (threadsShouldExit.load (std::memory_order_acquire))
+            return;
+
+        // Index 0 is the thread calling process
+        processThreadSchedule (schedule.threadSchedules[threadIndex + 1]);
+        numThreadsProcessing.fetch_sub (1, std::memory_order_acq_rel);
+    }
+}
+
+inline void StaticScheduleNodePlayer::pause()
+{
+   #if JUCE_INTEL
+    _mm_pause();
+    _mm_pause();
+   #else
+    __asm__ __volatile__ ("yield");
+    __asm__ __volatile__ ("yield");
+   #endif
+}
+
+template<typename Predicate>
+void StaticScheduleNodePlayer::waitUntil (Predicate&& predicate)
+{
+    // Spin briefly as waits should be short but back off to sleeping
+    // in case there are more threads than cores and the thread being
+    // waited on needs this one to give up its time slice
+    for (int numSpins = 0; ! predicate(); ++numSpins)
+    {
+        if (numSpins < 100)
+            pause();
+        else if (numSpins < 200)
+            std::this_thread::yield();
+        else
+            std::this_thread::sleep_for (std::chrono::microseconds (50));
+    }
+}
+
+//==============================================================================
+StaticScheduleNodePlayer::Schedule StaticScheduleNodePlayer::compileSchedule (std::unique_ptr<NodeGraph> graph, size_t numThreads)
+{
+    Schedule newSchedule;
+    newSchedule.graph = std::move (graph);
+    newSchedule.threadSchedules.resize (newSchedule.graph != nullptr ? numThreads + 1 : 1);
+
+    if (newSchedule.graph == nullptr)
+        return newSchedule;
+
+    // This uses list scheduling with each Node having the same estimated cost.
+    // The orderedNodes are already sorted so that all inputs come before their outputs,
+    // so each Node is added to the thread where it can start the earliest. Waiting for an
+    // input from a different thread has a cost so serial chains tend to stay on the same thread.
+    struct NodeInfo
+    {
+        size_t threadIndex = 0;
+        double finishTime = 0.0;
+    };
+
+    constexpr double nodeCost = 1.0, syncCost = 0.5;
+    std::unordered_map<const Node*, NodeInfo> nodeInfos;
+    std::vector<double> threadFinishTimes (newSchedule.threadSchedules.size(), 0.0);
+
+    for (auto node : newSchedule.graph->orderedNodes)
+    {
+        const auto inputs = node->getDirectInputNodes();
+        size_t bestThreadIndex = 0;
+        double bestStartTime = std::numeric_limits<double>::max();
+
+        for (size_t threadIndex = 0; threadIndex < threadFinishTimes.size(); ++threadIndex)
+        {
+            auto startTime = threadFinishTimes[threadIndex];
+
+            for (auto input : inputs)
+            {
+                const auto& inputInfo = nodeInfos[input];
+                startTime = std::max (startTime, inputInfo.finishTime + (inputInfo.threadIndex == threadIndex ? 0.0 : syncCost));
+            }
+
+            if (startTime < bestStartTime)
+            {
+                bestStartTime = startTime;
+                bestThreadIndex = threadIndex;
+            }
+        }
+
+        const auto finishTime = bestStartTime + nodeCost;
+        nodeInfos[node] = { bestThreadIndex, finishTime };
+        threadFinishTimes[bestThreadIndex] = finishTime;
+
+        // Any inputs on other threads become sync points to wait for
+        auto& threadSchedule = newSchedule.threadSchedules[bestThreadIndex];
+        Step step { node, threadSchedule.dependencies.size(), 0 };
+
+        for (auto input : inputs)
+        {
+            const auto dependenciesBegin = threadSchedule.dependencies.begin() + (std::ptrdiff_t) step.firstDependency;
+
+            if (nodeInfos[input].threadIndex != bestThreadIndex
+                && std::find (dependenciesBegin, threadSchedule.dependencies.end(), input) == threadSchedule.dependencies.end())
+            {
+                threadSchedule.dependencies.push_back (input);
+                ++step.numDependencies;
+            }
+        }
+
+        threadSchedule.steps.push_back (step);
+    }
+
+    // Remove any empty schedules from the end so threads aren't started for them
+    while (newSchedule.threadSchedules.size() > 1 && newSchedule.threadSchedules.back().steps.empty())
+        newSchedule.threadSchedules.pop_back();
+
+    return newSchedule;
+}
+
+void StaticScheduleNodePlayer::recompileSchedule()
+{
+    schedule = compileSchedule (std::move (schedule.graph), numThreadsToUse);
+}
+
+void StaticScheduleNodePlayer::processThreadSchedule (const ThreadSchedule& threadSchedule)
+{
+    auto* tracer = nodeProcessTracer.load (std::memory_order_relaxed);
+
+    for (auto& step : threadSchedule.steps)
+    {
+        for (size_t i = 0; i < step.numDependencies; ++i)
+            waitUntil ([dependency = threadSchedule.dependencies[step.firstDependency + i]] { return dependency->hasProcessed(); });
+
+        const NodeProcessTracer::ScopedEvent nodeEvent (tracer, step.node);
+        step.node->process (numSamplesToProcess, referenceSampleRange);
+    }
+}
+
+}}
@@ -0,0 +1,164 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Plays back a Node with multiple threads using a schedule compiled when the Node is set.
+
+    Rather than counting the inputs of each Node and passing ready Nodes between
+    threads via a queue every block, the graph is partitioned once in to a static
+    list of Nodes for each thread. The only synchronisation during a block is when
+    a Node has an input on a different thread, in which case it waits for that input
+    to have been processed.
+
+    This is best suited to offline rendering where the graph doesn't change.
+    Calling setNode, setNumThreads or prepareToPlay will stop the threads and
+    recompile the schedule so there will be a gap in the audio.
+
+    @see LockFreeMultiThreadedNodePlayer
+*/
+class StaticScheduleNodePlayer
+{
+public:
+    //==============================================================================
+    /** Creates an empty StaticScheduleNodePlayer. */
+    StaticScheduleNodePlayer();
+
+    /** Destructor. */
+    ~StaticScheduleNodePlayer();
+
+    //==============================================================================
+    /** Sets the number of threads to use for rendering.
+        This can be 0 in which case only the process calling thread will be used for processing.
+        N.B. this will stop processing and recompile the schedule.
+    */
+    void setNumThreads (size_t);
+
+    /** Sets the Node to process. */
+    void setNode (std::unique_ptr<Node>);
+
+    /** Sets the Node to process with a new sample rate and block size. */
+    void setNode (std::unique_ptr<Node> newNode, double sampleRateToUse, int blockSizeToUse);
+
+    /** Prepares the current Node to be played. */
+    void prepareToPlay (double sampleRateToUse, int blockSizeToUse);
+
+    /** Returns the current Node. */
+    Node* getNode()
+    {
+        return schedule.graph != nullptr ? schedule.graph->rootNode.get() : nullptr;
+    }
+
+    /** Process a block of the Node. */
+    int process (const Node::ProcessContext&);
+
+    /** Clears the current Node. */
+    void clearNode();
+
+    /** Returns the current sample rate. */
+    double getSampleRate() const
+    {
+        return sampleRate;
+    }
+
+    /** Returns the current block size. */
+    int getBlockSize() const
+    {
+        return blockSize;
+    }
+
+    /** Sets a NodeProcessTracer to record the time each Node takes to process.
+        Pass nullptr to stop recording. The tracer must outlive its use by this player.
+    */
+    void setNodeProcessTracer (NodeProcessTracer*);
+
+    /** Sets the CPU cores the worker threads and the thread calling process should run on.
+        The thread calling process is pinned the next time it calls process.
+        @see ThreadAffinity, LockFreeMultiThreadedNodePlayer::setThreadAffinity
+    */
+    void setThreadAffinity (ThreadAffinity);
+
+    //==============================================================================
+    /** Returns the number of Nodes each thread has been scheduled to process.
+        The first entry is for the thread calling process.
+        This is mainly useful for testing.
+    */
+    std::vector<size_t> getNumNodesPerThread() const;
+
+    /** Returns the total number of times a Node will have to wait for an input
+        being processed on another thread each block.
+        This is mainly useful for testing.
+    */
+    size_t getNumSyncPoints() const;
+
+private:
+    //==============================================================================
+    struct Step
+    {
+        Node* node = nullptr;
+        size_t firstDependency = 0, numDependencies = 0;
+    };
+
+    /** The Nodes a single thread will process in order along with the inputs it
+        has to wait for from other threads.
+    */
+    struct ThreadSchedule
+    {
+        std::vector<Step> steps;
+        std::vector<Node*> dependencies;
+    };
+
+    struct Schedule
+    {
+        std::unique_ptr<NodeGraph> graph;
+        std::vector<ThreadSchedule> threadSchedules;
+    };
+
+    //==============================================================================
+    size_t numThreadsToUse = std::max ((size_t) 0, (size_t) std::thread::hardware_concurrency() - 1);
+    double sampleRate = 44100.0;
+    int blockSize = 512;
+    Schedule schedule;
+
+    choc::buffer::FrameCount numSamplesToProcess = 0;
+    juce::Range<int64_t> referenceSampleRange;
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<LightweightSemaphore>> threadStartSemaphores;
+    std::atomic<size_t> numThreadsProcessing { 0 };
+    std::atomic<bool> threadsShouldExit { false };
+    std::atomic<NodeProcessTracer*> nodeProcessTracer { nullptr };
+
+    ThreadAffinity threadAffinity;
+    std::vector<size_t> processThreadCPUsToApply;
+    std::atomic<bool> processThreadAffinityPending { false };
+
+    //==============================================================================
+    void clearThreads();
+    void createThreads();
+    void runThread (size_t threadIndex);
+    static void pause();
+
+    template<typename Predicate>
+    static void waitUntil (Predicate&&);
+
+    //==============================================================================
+    static Schedule compileSchedule (std::unique_ptr<NodeGraph>, size_t numThreads);
+    void recompileSchedule();
+    void processThreadSchedule (const ThreadSchedule&);
+};
+
+}}
@@ -0,0 +1,176 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+namespace test_utilities
+{
+    /** Creates a StaticScheduleNodePlayer using the given number of threads. */
+    static inline std::unique_ptr<StaticScheduleNodePlayer> createStaticSchedulePlayer (std::unique_ptr<Node> node, const TestSetup& ts,
+                                                                                          size_t numThreads)
+    {
+        auto player = std::make_unique<StaticScheduleNodePlayer>();
+        player->setNumThreads (numThreads);
+        player->setNode (std::move (node), ts.sampleRate, ts.blockSize);
+
+        return player;
+    }
+}
+
+#if GRAPH_UNIT_TESTS_STATICSCHEDULEPLAYER
+
+//==============================================================================
+//==============================================================================
+class StaticScheduleNodePlayerTests : public juce::UnitTest
+{
+public:
+    StaticScheduleNodePlayerTests()
+        : juce::UnitTest ("StaticScheduleNodePlayer", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        using namespace test_utilities;
+        TestSetup ts;
+        ts.randomiseBlockSizes = true;
+        ts.random = getRandom();
+
+        for (size_t numThreads : { 0u, 1u, 3u, 8u })
+        {
+            beginTest ("Wide graph: " + juce::String (numThreads) + " threads");
+            {
+                auto player = createStaticSchedulePlayer (createWideSinGraph (32, 4), ts, numThreads);
+                auto testContext = createTestContext (std::move (player), ts, 1, 1.0);
+                expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+            }
+
+            beginTest ("Uneven graph: " + juce::String (numThreads) + " threads");
+            {
+                auto player = createStaticSchedulePlayer (createUnevenSinGraph (16, 32), ts, numThreads);
+                auto testContext = createTestContext (std::move (player), ts, 1, 1.0);
+                expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+            }
+        }
+
+        beginTest ("Partitioning");
+        {
+            // A single chain shouldn't be split between threads
+            {
+                auto player = createStaticSchedulePlayer (createWideSinGraph (1, 8), ts, 4);
+                expectEquals (player->getNumNodesPerThread().size(), (size_t) 1);
+                expectEquals (player->getNumSyncPoints(), (size_t) 0);
+            }
+
+            // Parallel chains should be spread over all the threads with only the sum having to wait
+            {
+                auto player = createStaticSchedulePlayer (createWideSinGraph (4, 8), ts, 3);
+                const auto numNodesPerThread = player->getNumNodesPerThread();
+                expectEquals (numNodesPerThread.size(), (size_t) 4);
+                expectEquals (std::accumulate (numNodesPerThread.begin(), numNodesPerThread.end(), (size_t) 0), (size_t) (4 * 9 + 1));
+                expectEquals (player->getNumSyncPoints(), (size_t) 3);
+            }
+        }
+
+        beginTest ("Changing threads and Nodes");
+        {
+            auto player = createStaticSchedulePlayer (createWideSinGraph (8, 2), ts, 4);
+            TestProcess<StaticScheduleNodePlayer> testProcess (std::move (player), ts, 1, 2.0, true);
+
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setNumThreads (2);
+            testProcess.setNode (createWideSinGraph (64, 8));
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setNumThreads (0);
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            testProcess.getNodePlayer().setNumThreads (6);
+            testProcess.setNode (createUnevenSinGraph (16, 3));
+
+            auto testContext = testProcess.processAll();
+            expectAudioBuffer (*this, testContext->buffer, 0, 1.0f, 0.707f);
+        }
+    }
+};
+
+static StaticScheduleNodePlayerTests staticScheduleNodePlayerTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_NODEPLAYER
+
+//==============================================================================
+//==============================================================================
+class StaticScheduleNodePlayerBenchmarks : public juce::UnitTest
+{
+public:
+    StaticScheduleNodePlayerBenchmarks()
+        : juce::UnitTest ("StaticScheduleNodePlayer", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        // Compares the dynamically scheduled LockFreeMultiThreadedNodePlayer with the compiled schedule
+        for (size_t numThreads : { 2u, 8u })
+        {
+            runBenchmark<LockFreeMultiThreadedNodePlayer> (numThreads, 128, 16);
+            runBenchmark<StaticScheduleNodePlayer> (numThreads, 128, 16);
+        }
+    }
+
+private:
+    template<typename NodePlayerType>
+    void runBenchmark (size_t numThreads, int numTracks, int numNodesPerTrack)
+    {
+        using namespace test_utilities;
+        TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+
+        const auto numNodes = numTracks * (numNodesPerTrack + 1) + 1;
+        const juce::String playerName (std::is_same_v<NodePlayerType, StaticScheduleNodePlayer> ? "StaticScheduleNodePlayer"
+                                                                                                : "LockFreeMultiThreadedNodePlayer");
+        const auto description = juce::String ("{nodes} nodes, {threads} threads, {bs} block size")
+                                    .replace ("{nodes}", juce::String (numNodes))
+                                    .replace ("{threads}", juce::String (numThreads))
+                                    .replace ("{bs}", juce::String (ts.blockSize));
+
+        beginTest (playerName + ": " + description);
+
+        std::unique_ptr<NodePlayerType> player;
+
+        if constexpr (std::is_same_v<NodePlayerType, StaticScheduleNodePlayer>)
+            player = createStaticSchedulePlayer (createWideSinGraph (numTracks, numNodesPerTrack), ts, numThreads);
+        else
+            player = createLockFreePlayer (createWideSinGraph (numTracks, numNodesPerTrack), ts, ThreadPoolStrategy::lightweightSemHybrid, numThreads);
+
+        TestProcess<NodePlayerType> testProcess (std::move (player), ts, 1, 5.0, false);
+
+        // Warm up the threads and caches before measuring
+        testProcess.process (ts.blockSize * 16);
+        testProcess.getStatisticsAndReset();
+
+        testProcess.processAll();
+        const auto stats = testProcess.getStatisticsAndReset();
+
+        BenchmarkList::getInstance().addResult (createBenchmarkResult (createBenchmarkDescription ("Graph", playerName.toStdString(),
+                                                                                                  description.toStdString()),
+                                                                       stats));
+        logMessage (stats.toString (playerName.toStdString()));
+        expect (true);
+    }
+};
+
+static StaticScheduleNodePlayerBenchmarks staticScheduleNodePlayerBenchmarks;
+
+#endif
+
+}}
@@ -160,6 +160,7 @@ public:
     {
         pc.buffers.midi.clear();
         setAudioOutput (nullptr, audioBuffer.getView().getStart (pc.buffers.audio.getNumFrames()));
+        pc.buffers.audioContent = AudioContent::silent;
     }
 
 private:
@@ -219,6 +219,7 @@ namespace test_utilities
             case ThreadPoolStrategy::semaphore:             return "semaphore";
             case ThreadPoolStrategy::lightweightSemaphore:  return "lightweightSemaphore";
             case ThreadPoolStrategy::lightweightSemHybrid:  return "lightweightSemaphoreHybrid";
+            case ThreadPoolStrategy::workStealing:          return "workStealing";
         }
 
         jassertfalse;
@@ -232,7 +233,8 @@ namespace test_utilities
                  ThreadPoolStrategy::semaphore,
                  ThreadPoolStrategy::conditionVariable,
                  ThreadPoolStrategy::realTime,
-                 ThreadPoolStrategy::hybrid };
+                 ThreadPoolStrategy::hybrid,
+                 ThreadPoolStrategy::workStealing };
     }
 
     /** Logs the graph structure to the console. */
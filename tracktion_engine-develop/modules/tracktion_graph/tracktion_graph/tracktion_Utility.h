@@ -84,16 +84,14 @@ NodeType* findNode (NodeGraph& nodeGraph, Predicate pred)
 template<typename NodeType>
 NodeType* findNodeWithID (NodeGraph& nodeGraph, size_t nodeIDToLookFor)
 {
-    auto found = std::find_if (nodeGraph.sortedNodes.begin(),
-                               nodeGraph.sortedNodes.end(),
-                               [nodeIDToLookFor] (auto nodeAndID)
-                               {
-                                   return nodeAndID.id == nodeIDToLookFor
-                                       && dynamic_cast<NodeType*> (nodeAndID.node) != nullptr;
-                               });
-
-    if (found != nodeGraph.sortedNodes.end())
-        return dynamic_cast<NodeType*> (found->node);
+    // sortedNodes is ordered by ID so only the Nodes with a matching ID need to be checked
+    const auto nodesWithID = std::equal_range (nodeGraph.sortedNodes.begin(),
+                                               nodeGraph.sortedNodes.end(),
+                                               NodeAndID { nullptr, nodeIDToLookFor });
+
+    for (auto iter = nodesWithID.first; iter != nodesWithID.second; ++iter)
+        if (auto node = dynamic_cast<NodeType*> (iter->node))
+            return node;
 
     return nullptr;
 }
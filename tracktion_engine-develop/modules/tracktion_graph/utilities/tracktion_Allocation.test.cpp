@@ -26,6 +26,7 @@ public:
     void runTest() override
     {
         runRPMallocTests();
+        runAudioBufferPoolTests();
     }
 
 private:
@@ -218,6 +219,48 @@ private:
             expect (true);
         }
     }
+
+    void runAudioBufferPoolTests()
+    {
+        using namespace test_utilities;
+
+        beginTest ("AudioBufferPool allocations after warm-up");
+        {
+            TestSetup ts;
+            ts.sampleRate = 44100.0;
+            ts.blockSize = 256;
+
+            // A mix of mono and stereo tracks so more than one size class is used
+            std::vector<std::unique_ptr<Node>> tracks;
+
+            for (int i = 0; i < 32; ++i)
+            {
+                std::unique_ptr<Node> node = std::make_unique<SinNode> (220.0f, i % 2 == 0 ? 1 : 2);
+                node = makeGainNode (std::move (node), 1.0f / 32.0f);
+                node = makeGainNode (std::move (node), 1.0f);
+                tracks.push_back (std::move (node));
+            }
+
+            auto player = std::make_unique<LockFreeMultiThreadedNodePlayer> (getPoolCreatorFunction (ThreadPoolStrategy::lightweightSemHybrid));
+            player->setNumThreads (4);
+            player->enablePooledMemoryAllocations (true);
+            player->setNode (std::make_unique<BasicSummingNode> (std::move (tracks)), ts.sampleRate, ts.blockSize);
+            TestProcess<LockFreeMultiThreadedNodePlayer> testProcess (std::move (player), ts, 2, 2.0, false);
+
+            testProcess.process (juce::roundToInt (ts.sampleRate * 0.5));
+            const auto warmedUpStats = testProcess.getNodePlayer().getAudioBufferPoolStatistics();
+            expectGreaterThan ((int) warmedUpStats.sizeClasses.size(), 2);
+
+            testProcess.processAll();
+            const auto stats = testProcess.getNodePlayer().getAudioBufferPoolStatistics();
+            expectEquals (stats.numAllocations, warmedUpStats.numAllocations);
+
+            for (size_t i = 0; i < stats.sizeClasses.size(); ++i)
+                expectEquals (stats.sizeClasses[i].highWaterMark, warmedUpStats.sizeClasses[i].highWaterMark);
+
+            logMessage ("Allocations during warm-up: " + juce::String (warmedUpStats.numAllocations));
+        }
+    }
 };
 
 static AllocationTests allocationTests;
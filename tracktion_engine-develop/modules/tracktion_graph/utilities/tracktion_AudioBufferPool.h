@@ -24,11 +24,18 @@ namespace tracktion { inline namespace graph
     If you need to quickly create and then return some audio buffers this class
     enables you to do that in a lock free way.
 
+    Buffers are grouped in to size classes, one for each size passed to reserve.
+    A request is served from the smallest class that fits it so a graph with a
+    mix of channel counts doesn't need every buffer to be the size of the largest.
+    Each thread also keeps a small cache of buffers for each class, refilling it
+    from and returning it to the shared pool in batches, so threads don't all
+    contend on the same FIFO.
+
     Note that the buffers can be pre-allocated but if you ask for a buffer which
     isn't in the pool, it will either resize an existing one or allocate a new one.
 
     After processing a constant audio graph for a while though this should be
-    completely allocation and lock-free.
+    completely allocation and lock-free. You can check this with getStatistics.
 */
 class AudioBufferPool
 {
@@ -70,16 +77,30 @@ public:
     bool release (choc::buffer::ChannelArrayBuffer<float>&&);
 
     //==============================================================================
+    /** Sets the NUMA nodes the threads using this pool are pinned to.
+        If this isn't empty, a separate set of buffers is kept for each node. Threads
+        pinned with setCurrentThreadAffinity then allocate and release buffers from
+        their own node's set and reserve splits the buffers between the given nodes,
+        touching each share from a thread on its node so the memory is local to it.
+        This only has an effect on systems with more than one NUMA node.
+        N.B. This isn't safe to call concurrently with any other methods.
+        @see setCurrentThreadAffinity, ThreadAffinity::getNUMANodes
+    */
+    void setNUMANodesInUse (std::vector<size_t>);
+
     /** Releases all the internal allocated storage. */
     void reset();
 
-    /** Sets the maximum number of buffers this can store. */
+    /** Sets the maximum number of buffers this can store for each size class. */
     void setCapacity (size_t);
 
-    /** Returns the current maximum number of buffers this can store. */
+    /** Returns the current maximum number of buffers this can store for each size class. */
     size_t getCapacity() const                      { return capacity; }
 
-    /** Reserves a number of buffers of a given size, preallocating them. */
+    /** Reserves a number of buffers of a given size, preallocating them.
+        If there isn't already a size class for this size, one is added.
+        N.B. This isn't safe to call concurrently with any other methods.
+    */
     void reserve (size_t numBuffers, choc::buffer::Size);
 
     //==============================================================================
@@ -94,9 +115,73 @@ public:
     */
     size_t getAllocatedSize();
 
+    //==============================================================================
+    /** The number of buffers allocated for a size class. */
+    struct SizeClassStatistics
+    {
+        choc::buffer::Size size;    /**< The size of the class, empty for buffers that don't fit any other. */
+        size_t highWaterMark = 0;   /**< The most buffers the class has needed, i.e. those reserved plus any allocated because none were free. */
+    };
+
+    /** Statistics about the allocations the pool has made. */
+    struct Statistics
+    {
+        size_t numAllocations = 0;                      /**< The number of buffers allocate has had to allocate or resize. */
+        std::vector<SizeClassStatistics> sizeClasses;   /**< The high-water mark for each size class. */
+    };
+
+    /** Returns the current allocation statistics.
+        Once a constant graph has warmed up numAllocations should stop increasing.
+        N.B. This isn't safe to call concurrently with reserve, setCapacity or reset.
+    */
+    Statistics getStatistics() const;
+
 private:
-    std::unique_ptr<farbot::fifo<choc::buffer::ChannelArrayBuffer<float>>> fifo;
+    using Buffer = choc::buffer::ChannelArrayBuffer<float>;
+    using Fifo = farbot::fifo<Buffer>;
+
+    // The first class is unsized and holds any buffers that don't fit the others,
+    // the rest are in ascending order of the number of samples they hold
+    struct SizeClass
+    {
+        choc::buffer::Size size;
+        std::vector<std::unique_ptr<Fifo>> fifos; // One per NUMA node if enabled, otherwise just one
+        std::atomic<size_t> highWaterMark { 0 };
+    };
+
+    // A few buffers of each class kept for the threads that map to it.
+    // If another thread is using it, the shared FIFOs are used directly instead
+    struct ThreadCache
+    {
+        RealTimeSpinLock mutex;
+        std::vector<std::vector<Buffer>> buffers; // One per size class
+    };
+
+    static constexpr size_t threadCacheBatchSize = 4, threadCacheCapacity = threadCacheBatchSize * 2;
+
+    std::vector<std::unique_ptr<SizeClass>> sizeClasses;
+    std::vector<std::unique_ptr<ThreadCache>> threadCaches;
     size_t capacity = 0;
+    std::vector<size_t> numaNodesInUse;
+    std::atomic<size_t> numAllocations { 0 };
+
+    size_t getNumFifosToUse() const;
+    size_t getLocalFifoIndex() const;
+    ThreadCache& getThreadCache();
+    static size_t getCurrentThreadIndex();
+    size_t findSizeClassToAllocate (choc::buffer::Size) const;
+    size_t findSizeClassToRelease (choc::buffer::Size) const;
+    bool pop (ThreadCache*, size_t sizeClass, Buffer&);
+    bool popShared (size_t sizeClass, Buffer&);
+    bool steal (ThreadCache*, size_t firstSizeClass, choc::buffer::Size, Buffer&);
+    bool pushShared (size_t sizeClass, Buffer&&);
+    void flushThreadCaches();
+    void recreateFifos();
+    std::vector<Buffer> popAll();
+    static std::vector<Buffer> popAll (Fifo&);
+    void pushAll (std::vector<Buffer>&&);
+    static bool fits (choc::buffer::Size bufferSize, choc::buffer::Size size);
+    static void addBuffers (Fifo&, size_t numBuffers, choc::buffer::Size);
 };
 
 
@@ -117,31 +202,115 @@ inline AudioBufferPool::AudioBufferPool (size_t maxCapacity)
 
 inline choc::buffer::ChannelArrayBuffer<float> AudioBufferPool::allocate (choc::buffer::Size size)
 {
-    choc::buffer::ChannelArrayBuffer<float> buffer;
+    if (sizeClasses.empty())
+    {
+        numAllocations.fetch_add (1, std::memory_order_relaxed);
+        return Buffer (size);
+    }
+
+    auto& threadCache = getThreadCache();
+    std::unique_lock<RealTimeSpinLock> cacheLock (threadCache.mutex, std::try_to_lock);
+    auto cache = cacheLock.owns_lock() ? &threadCache : nullptr;
+
+    // Prefer the smallest class that fits, then any bigger ones, then the unsized class which
+    // may need resizing and then other threads' caches, before allocating a new buffer
+    const auto sizeClassToUse = findSizeClassToAllocate (size);
+    Buffer buffer;
+
+    if (sizeClassToUse > 0)
+        for (size_t i = sizeClassToUse; i < sizeClasses.size(); ++i)
+            if (fits (sizeClasses[i]->size, size) && pop (cache, i, buffer))
+                return buffer;
+
+    Buffer unsizedBuffer;
+    const bool hasUnsizedBuffer = pop (cache, 0, unsizedBuffer);
+
+    if (hasUnsizedBuffer && fits (unsizedBuffer.getSize(), size))
+        return unsizedBuffer;
 
-    if (fifo->pop (buffer))
+    if (steal (cache, sizeClassToUse, size, buffer))
     {
-        if (auto bufferSize = buffer.getSize();
-            bufferSize.numChannels < size.numChannels
-            || bufferSize.numFrames < size.numFrames)
+        // Put back the unsized buffer that didn't fit so it isn't lost from the pool.
+        // It's just been popped from the cache so there's room for it without allocating
+        if (hasUnsizedBuffer)
         {
-            buffer.resize (size);
+            if (cache != nullptr)
+                cache->buffers[0].push_back (std::move (unsizedBuffer));
+            else
+                pushShared (0, std::move (unsizedBuffer));
         }
+
+        return buffer;
     }
-    else
+
+    // Otherwise resize the unsized buffer rather than creating a new one
+    if (hasUnsizedBuffer)
+        buffer = std::move (unsizedBuffer);
+
+    numAllocations.fetch_add (1, std::memory_order_relaxed);
+
+    if (sizeClassToUse == 0)
     {
         buffer.resize (size);
+        return buffer;
     }
 
+    auto& sizeClass = *sizeClasses[sizeClassToUse];
+    sizeClass.highWaterMark.fetch_add (1, std::memory_order_relaxed);
+    buffer.resize (sizeClass.size);
+
     return buffer;
 }
 
 inline bool AudioBufferPool::release (choc::buffer::ChannelArrayBuffer<float>&& buffer)
 {
-    return fifo->push (std::move (buffer));
+    if (sizeClasses.empty())
+        return false;
+
+    const auto sizeClass = findSizeClassToRelease (buffer.getSize());
+    auto& threadCache = getThreadCache();
+    std::unique_lock<RealTimeSpinLock> cacheLock (threadCache.mutex, std::try_to_lock);
+
+    if (! cacheLock.owns_lock())
+        return pushShared (sizeClass, std::move (buffer));
+
+    // Return a batch to the shared FIFO when the cache is full
+    auto& cached = threadCache.buffers[sizeClass];
+
+    bool allReleased = true;
+
+    if (cached.size() >= threadCacheCapacity)
+    {
+        for (size_t i = 0; i < threadCacheBatchSize; ++i)
+        {
+            allReleased = pushShared (sizeClass, std::move (cached.back())) && allReleased;
+            cached.pop_back();
+        }
+    }
+
+    cached.push_back (std::move (buffer));
+    return allReleased;
 }
 
 //==============================================================================
+inline void AudioBufferPool::setNUMANodesInUse (std::vector<size_t> nodes)
+{
+    numaNodesInUse = std::move (nodes);
+
+    if (capacity == 0 || sizeClasses.front()->fifos.size() == getNumFifosToUse())
+        return;
+
+    recreateFifos();
+}
+
+inline void AudioBufferPool::reset()
+{
+    sizeClasses.clear();
+    threadCaches.clear();
+    capacity = 0;
+    numAllocations = 0;
+}
+
 inline void  AudioBufferPool::setCapacity (size_t maxCapacity)
 {
     maxCapacity = (size_t) juce::nextPowerOfTwo ((int) maxCapacity);
@@ -149,106 +318,355 @@ inline void  AudioBufferPool::setCapacity (size_t maxCapacity)
     if (maxCapacity <= capacity)
         return;
 
-    fifo = std::make_unique<farbot::fifo<choc::buffer::ChannelArrayBuffer<float>>> ((int) maxCapacity);
     capacity = maxCapacity;
+
+    if (sizeClasses.empty())
+    {
+        sizeClasses.push_back (std::make_unique<SizeClass>());
+
+        // There's a cache for each CPU plus the thread calling process so most threads get their own
+        const auto numThreadCaches = (size_t) juce::nextPowerOfTwo ((int) std::thread::hardware_concurrency() + 1);
+
+        for (size_t i = 0; i < numThreadCaches; ++i)
+        {
+            auto& cache = threadCaches.emplace_back (std::make_unique<ThreadCache>());
+            cache->buffers.resize (1);
+            cache->buffers.front().reserve (threadCacheCapacity);
+        }
+    }
+
+    recreateFifos();
 }
 
 inline void AudioBufferPool::reserve (size_t numBuffers, choc::buffer::Size size)
 {
-    std::vector<choc::buffer::ChannelArrayBuffer<float>> buffers;
+    jassert (! sizeClasses.empty()); // You need to set a capacity first!
 
-    // Remove all the buffers
-    for (;;)
+    if (sizeClasses.empty())
+        return;
+
+    // Find or add the class for this size
+    auto sizeClassIter = std::find_if (sizeClasses.begin() + 1, sizeClasses.end(),
+                                       [size] (auto& c) { return c->size == size; });
+
+    if (sizeClassIter == sizeClasses.end())
     {
-        choc::buffer::ChannelArrayBuffer<float> tempBuffer;
+        flushThreadCaches();
 
-        if (! fifo->pop (tempBuffer))
-            break;
+        sizeClassIter = std::find_if (sizeClasses.begin() + 1, sizeClasses.end(),
+                                      [size] (auto& c) { return c->size.numChannels * c->size.numFrames
+                                                                  > size.numChannels * size.numFrames; });
+        const auto index = std::distance (sizeClasses.begin(), sizeClassIter);
 
-        buffers.emplace_back (std::move (tempBuffer));
+        auto newClass = std::make_unique<SizeClass>();
+        newClass->size = size;
+
+        for (size_t i = 0; i < getNumFifosToUse(); ++i)
+            newClass->fifos.push_back (std::make_unique<Fifo> ((int) capacity));
+
+        sizeClassIter = sizeClasses.insert (sizeClassIter, std::move (newClass));
+
+        for (auto& cache : threadCaches)
+            cache->buffers.insert (cache->buffers.begin() + index, std::vector<Buffer>())->reserve (threadCacheCapacity);
+
+        // Any unsized buffers that now fit the new class should move to it
+        for (auto& fifo : sizeClasses.front()->fifos)
+            pushAll (popAll (*fifo));
     }
 
-    // Ensure their size is as big as required
-    for (auto& b : buffers)
+    auto& sizeClass = **sizeClassIter;
+
+    // Count the buffers already in the class
+    size_t numExisting = 0;
+
+    for (auto& cache : threadCaches)
+        numExisting += cache->buffers[(size_t) std::distance (sizeClasses.begin(), sizeClassIter)].size();
+
+    for (auto& fifo : sizeClass.fifos)
     {
-        if (auto bufferSize = b.getSize();
-            bufferSize.numChannels < size.numChannels
-            || bufferSize.numFrames < size.numFrames)
-        {
-            b.resize (size);
-        }
+        auto buffers = popAll (*fifo);
+        numExisting += buffers.size();
+
+        for (auto& b : buffers)
+            fifo->push (std::move (b));
     }
 
-    // Reset the fifo storage to hold the new number of buffers
-    const int numToAdd = static_cast<int> (numBuffers) - static_cast<int> (buffers.size());
+    if (numBuffers <= numExisting)
+        return;
 
-    // Push the temp buffers back
-    for (auto& b : buffers)
+    const auto numToAdd = numBuffers - numExisting;
+    sizeClass.highWaterMark.fetch_add (numToAdd, std::memory_order_relaxed);
+
+    if (sizeClass.fifos.size() == 1)
     {
-        [[ maybe_unused ]] bool succeeded = release (std::move (b));
-        assert (succeeded); // Capacity too small?
+        addBuffers (*sizeClass.fifos.front(), numToAdd, size);
+        return;
     }
 
-    // Push any additional buffers
-    for (int i = 0; i < numToAdd; ++i)
+    // Split the buffers between the nodes in use and touch each share from a
+    // thread on that node so the OS allocates their pages from its local memory
+    auto& nodeCPUs = getNUMANodeCPUs();
+    const auto numNodes = numaNodesInUse.size();
+
+    for (size_t i = 0; i < numNodes; ++i)
     {
-        [[ maybe_unused ]] bool succeeded = release (choc::buffer::ChannelArrayBuffer<float> (size));
-        assert (succeeded); // Capacity too small?
+        const auto node = numaNodesInUse[i];
+        const auto numBuffersForNode = numToAdd / numNodes + (i < numToAdd % numNodes ? 1 : 0);
+        jassert (node < sizeClass.fifos.size());
+
+        std::thread ([&, node, numBuffersForNode]
+                     {
+                         setCurrentThreadAffinity (nodeCPUs[node]);
+                         addBuffers (*sizeClass.fifos[node], numBuffersForNode, size);
+                     }).join();
     }
 }
 
+//==============================================================================
 inline size_t AudioBufferPool::getNumBuffers()
 {
-    std::vector<choc::buffer::ChannelArrayBuffer<float>> buffers;
+    auto buffers = popAll();
+    const auto numBuffers = buffers.size();
 
-    // Remove all the buffers
-    for (;;)
+    // Push the temp buffers back
+    pushAll (std::move (buffers));
+
+    return numBuffers;
+}
+
+inline size_t AudioBufferPool::getAllocatedSize()
+{
+    size_t size = 0;
+    auto buffers = popAll();
+
+    // Calculate the size of them
+    for (auto& b : buffers)
+        size +=  b.getView().data.getBytesNeeded (b.getSize());
+
+    // Then put them back in the fifo
+    pushAll (std::move (buffers));
+
+    return size;
+}
+
+inline AudioBufferPool::Statistics AudioBufferPool::getStatistics() const
+{
+    Statistics stats;
+    stats.numAllocations = numAllocations.load (std::memory_order_relaxed);
+
+    for (auto& sizeClass : sizeClasses)
+        stats.sizeClasses.push_back ({ sizeClass->size, sizeClass->highWaterMark.load (std::memory_order_relaxed) });
+
+    return stats;
+}
+
+//==============================================================================
+inline size_t AudioBufferPool::getNumFifosToUse() const
+{
+    return numaNodesInUse.empty() ? 1 : getNUMANodeCPUs().size();
+}
+
+inline size_t AudioBufferPool::getLocalFifoIndex() const
+{
+    const auto numFifos = sizeClasses.front()->fifos.size();
+    return numFifos > 1 ? getCurrentThreadNUMANode() % numFifos : 0;
+}
+
+inline AudioBufferPool::ThreadCache& AudioBufferPool::getThreadCache()
+{
+    return *threadCaches[getCurrentThreadIndex() % threadCaches.size()];
+}
+
+inline size_t AudioBufferPool::getCurrentThreadIndex()
+{
+    static std::atomic<size_t> nextThreadIndex { 0 };
+    thread_local const size_t threadIndex = nextThreadIndex++;
+    return threadIndex;
+}
+
+inline size_t AudioBufferPool::findSizeClassToAllocate (choc::buffer::Size size) const
+{
+    for (size_t i = 1; i < sizeClasses.size(); ++i)
+        if (fits (sizeClasses[i]->size, size))
+            return i;
+
+    return 0;
+}
+
+inline size_t AudioBufferPool::findSizeClassToRelease (choc::buffer::Size bufferSize) const
+{
+    for (size_t i = sizeClasses.size(); --i > 0;)
+        if (fits (bufferSize, sizeClasses[i]->size))
+            return i;
+
+    return 0;
+}
+
+inline bool AudioBufferPool::pop (ThreadCache* cache, size_t sizeClass, Buffer& buffer)
+{
+    if (cache == nullptr)
+        return popShared (sizeClass, buffer);
+
+    // Refill an empty cache with a batch from the shared FIFOs
+    auto& cached = cache->buffers[sizeClass];
+
+    if (cached.empty())
     {
-        choc::buffer::ChannelArrayBuffer<float> tempBuffer;
+        for (size_t i = 0; i < threadCacheBatchSize; ++i)
+        {
+            Buffer tempBuffer;
 
-        if (! fifo->pop (tempBuffer))
-            break;
+            if (! popShared (sizeClass, tempBuffer))
+                break;
 
-        buffers.emplace_back (std::move (tempBuffer));
+            cached.push_back (std::move (tempBuffer));
+        }
+
+        if (cached.empty())
+            return false;
     }
 
-    const auto numBuffers = buffers.size();
+    buffer = std::move (cached.back());
+    cached.pop_back();
+    return true;
+}
 
-    // Push the temp buffers back
-    for (auto& b : buffers)
+inline bool AudioBufferPool::popShared (size_t sizeClass, Buffer& buffer)
+{
+    // Prefer a buffer local to this thread's node but take any other before allocating a new one
+    auto& fifos = sizeClasses[sizeClass]->fifos;
+    const auto localIndex = getLocalFifoIndex();
+
+    for (size_t i = 0; i < fifos.size(); ++i)
+        if (fifos[(localIndex + i) % fifos.size()]->pop (buffer))
+            return true;
+
+    return false;
+}
+
+inline bool AudioBufferPool::steal (ThreadCache* cache, size_t firstSizeClass, choc::buffer::Size size, Buffer& buffer)
+{
+    // Threads that have stopped using the pool may have left buffers in their caches
+    for (auto& otherCache : threadCaches)
     {
-        [[ maybe_unused ]] bool succeeded = release (std::move (b));
-        assert (succeeded);
+        if (otherCache.get() == cache)
+            continue;
+
+        std::unique_lock<RealTimeSpinLock> otherCacheLock (otherCache->mutex, std::try_to_lock);
+
+        if (! otherCacheLock.owns_lock())
+            continue;
+
+        for (size_t i = firstSizeClass; i < sizeClasses.size(); ++i)
+        {
+            auto& cached = otherCache->buffers[i];
+
+            if (cached.empty() || ! fits (cached.back().getSize(), size))
+                continue;
+
+            buffer = std::move (cached.back());
+            cached.pop_back();
+            return true;
+        }
     }
 
-    return numBuffers;
+    return false;
 }
 
-inline size_t AudioBufferPool::getAllocatedSize()
+inline bool AudioBufferPool::pushShared (size_t sizeClass, Buffer&& buffer)
 {
-    size_t size = 0;
-    std::vector<choc::buffer::ChannelArrayBuffer<float>> buffers;
+    return sizeClasses[sizeClass]->fifos[getLocalFifoIndex()]->push (std::move (buffer));
+}
+
+inline void AudioBufferPool::flushThreadCaches()
+{
+    for (auto& cache : threadCaches)
+    {
+        for (size_t i = 0; i < cache->buffers.size(); ++i)
+        {
+            for (auto& b : cache->buffers[i])
+                sizeClasses[i]->fifos.front()->push (std::move (b));
+
+            cache->buffers[i].clear();
+        }
+    }
+}
+
+inline void AudioBufferPool::recreateFifos()
+{
+    // The existing buffers can't be moved between nodes so just keep them in the first
+    flushThreadCaches();
+
+    for (auto& sizeClass : sizeClasses)
+    {
+        std::vector<Buffer> buffers;
+
+        for (auto& fifo : sizeClass->fifos)
+            for (auto& b : popAll (*fifo))
+                buffers.push_back (std::move (b));
+
+        // Each FIFO can hold all the buffers as they may all end up released on one node
+        sizeClass->fifos.clear();
+
+        for (size_t i = 0; i < getNumFifosToUse(); ++i)
+            sizeClass->fifos.push_back (std::make_unique<Fifo> ((int) capacity));
+
+        for (auto& b : buffers)
+            sizeClass->fifos.front()->push (std::move (b));
+    }
+}
+
+inline std::vector<AudioBufferPool::Buffer> AudioBufferPool::popAll()
+{
+    flushThreadCaches();
+    std::vector<Buffer> buffers;
+
+    for (auto& sizeClass : sizeClasses)
+        for (auto& fifo : sizeClass->fifos)
+            for (auto& b : popAll (*fifo))
+                buffers.push_back (std::move (b));
+
+    return buffers;
+}
+
+inline std::vector<AudioBufferPool::Buffer> AudioBufferPool::popAll (Fifo& fifo)
+{
+    std::vector<Buffer> buffers;
 
-    // Remove all the buffers
     for (;;)
     {
-        choc::buffer::ChannelArrayBuffer<float> tempBuffer;
+        Buffer tempBuffer;
 
-        if (! fifo->pop (tempBuffer))
+        if (! fifo.pop (tempBuffer))
             break;
 
         buffers.emplace_back (std::move (tempBuffer));
     }
 
-    // Calculate the size of them
-    for (auto& b : buffers)
-        size +=  b.getView().data.getBytesNeeded (b.getSize());
+    return buffers;
+}
 
-    // Then put them back in the fifo
+inline void AudioBufferPool::pushAll (std::vector<Buffer>&& buffers)
+{
+    // Buffers returned from the thread caches can take a class over its capacity,
+    // if so the extra ones will be deallocated
     for (auto& b : buffers)
-        fifo->push (std::move (b));
+        sizeClasses[findSizeClassToRelease (b.getSize())]->fifos.front()->push (std::move (b));
+}
 
-    return size;
+inline bool AudioBufferPool::fits (choc::buffer::Size bufferSize, choc::buffer::Size size)
+{
+    return bufferSize.numChannels >= size.numChannels
+        && bufferSize.numFrames >= size.numFrames;
+}
+
+inline void AudioBufferPool::addBuffers (Fifo& fifo, size_t numBuffers, choc::buffer::Size size)
+{
+    for (size_t i = 0; i < numBuffers; ++i)
+    {
+        [[ maybe_unused ]] bool succeeded = fifo.push (Buffer (size));
+        assert (succeeded); // Capacity too small?
+    }
 }
 
 }} // namespace tracktion
@@ -23,6 +23,8 @@ public:
     void runTest() override
     {
         runAllocationTests();
+        runSizeClassTests();
+        runNUMATests();
     }
 
 private:
@@ -69,6 +71,190 @@ private:
             }
         }
     }
+
+    void runSizeClassTests()
+    {
+        using namespace choc::buffer;
+
+        beginTest ("Size classes");
+        {
+            const auto monoSize = Size::create (1, 128), stereoSize = Size::create (2, 128);
+
+            AudioBufferPool pool (8);
+            pool.reserve (2, stereoSize);
+            pool.reserve (2, monoSize);
+            expectEquals<int> ((int) pool.getNumBuffers(), 4);
+            expectEquals<int> ((int) pool.getAllocatedSize(), 2 * (int) SeparateChannelLayout<float>::getBytesNeeded (monoSize)
+                                                                + 2 * (int) SeparateChannelLayout<float>::getBytesNeeded (stereoSize));
+
+            // Smaller requests should come from the smallest class that fits
+            std::vector<ChannelArrayBuffer<float>> buffers;
+            buffers.push_back (pool.allocate (Size::create (1, 64)));
+            expect (buffers.back().getSize() == monoSize);
+            buffers.push_back (pool.allocate (Size::create (2, 100)));
+            expect (buffers.back().getSize() == stereoSize);
+
+            // And once a class is empty, bigger ones are used
+            buffers.push_back (pool.allocate (monoSize));
+            expect (buffers.back().getSize() == monoSize);
+            buffers.push_back (pool.allocate (monoSize));
+            expect (buffers.back().getSize() == stereoSize);
+            expectEquals<int> ((int) pool.getStatistics().numAllocations, 0);
+
+            // Only after that does a new buffer need to be allocated
+            buffers.push_back (pool.allocate (monoSize));
+            expect (buffers.back().getSize() == monoSize);
+
+            auto stats = pool.getStatistics();
+            expectEquals<int> ((int) stats.numAllocations, 1);
+            expectEquals<int> ((int) stats.sizeClasses.size(), 3);
+            expect (stats.sizeClasses[1].size == monoSize);
+            expectEquals<int> ((int) stats.sizeClasses[1].highWaterMark, 3);
+            expect (stats.sizeClasses[2].size == stereoSize);
+            expectEquals<int> ((int) stats.sizeClasses[2].highWaterMark, 2);
+
+            // Buffers should go back to the class they fit
+            for (auto& b : buffers)
+                expect (pool.release (std::move (b)));
+
+            expectEquals<int> ((int) pool.getNumBuffers(), 5);
+
+            for (int i = 0; i < 3; ++i)
+                expect (pool.allocate (monoSize).getSize() == monoSize);
+
+            expectEquals<int> ((int) pool.getStatistics().numAllocations, 1);
+
+            // Sizes that don't fit any class are allocated exactly
+            expect (pool.allocate (Size::create (4, 128)).getSize() == Size::create (4, 128));
+            expectEquals<int> ((int) pool.getStatistics().numAllocations, 2);
+        }
+
+        beginTest ("Thread caches");
+        {
+            const auto size = Size::create (2, 128);
+            AudioBufferPool pool (64);
+            pool.reserve (16, size);
+
+            // Buffers allocated on one thread and released on another should make their
+            // way back through the shared FIFOs or be taken from the releasing thread's cache
+            std::vector<ChannelArrayBuffer<float>> buffers;
+
+            for (int block = 0; block < 100; ++block)
+            {
+                std::thread ([&]
+                             {
+                                 for (int i = 0; i < 8; ++i)
+                                     buffers.push_back (pool.allocate (size));
+                             }).join();
+
+                std::thread ([&]
+                             {
+                                 for (auto& b : buffers)
+                                     pool.release (std::move (b));
+                             }).join();
+
+                buffers.clear();
+            }
+
+            const auto stats = pool.getStatistics();
+            expectEquals<int> ((int) stats.numAllocations, 0);
+            expectEquals<int> ((int) stats.sizeClasses[1].highWaterMark, 16);
+            expectEquals<int> ((int) pool.getNumBuffers(), 16);
+        }
+
+        beginTest ("Unsized buffers that don't fit");
+        {
+            const auto size = Size::create (2, 128);
+            AudioBufferPool pool (8);
+            pool.reserve (1, size);
+
+            // A small unsized buffer in this thread's cache and the sized one in another's
+            expect (pool.release (ChannelArrayBuffer<float> (Size::create (1, 16))));
+
+            std::thread ([&]
+                         {
+                             expect (pool.release (pool.allocate (size)));
+                         }).join();
+
+            // Taking the other thread's buffer shouldn't lose the unsized one
+            auto buffer = pool.allocate (size);
+            expect (buffer.getSize() == size);
+            expectEquals<int> ((int) pool.getStatistics().numAllocations, 0);
+            expectEquals<int> ((int) pool.getNumBuffers(), 1);
+        }
+
+        beginTest ("Releasing to a full pool");
+        {
+            const auto size = Size::create (2, 128);
+            AudioBufferPool pool (8);
+            pool.reserve (8, size);
+
+            // Once this thread's cache and the shared FIFO are full, buffers have to be deallocated
+            bool allReleased = true;
+
+            for (int i = 0; i < 32 && allReleased; ++i)
+                allReleased = pool.release (ChannelArrayBuffer<float> (size));
+
+            expect (! allReleased);
+        }
+    }
+
+    void runNUMATests()
+    {
+        using namespace choc::buffer;
+
+        beginTest ("NUMA nodes");
+        {
+            const auto size = Size::create (2, 128);
+            const auto numNodes = getNUMANodeCPUs().size();
+            expectGreaterOrEqual ((int) numNodes, 1);
+
+            std::vector<size_t> allNodes (numNodes);
+            std::iota (allNodes.begin(), allNodes.end(), (size_t) 0);
+
+            AudioBufferPool pool (16);
+            pool.setNUMANodesInUse (allNodes);
+            pool.reserve (8, size);
+            expectEquals<int> ((int) pool.getNumBuffers(), 8);
+
+            // Buffers allocated and released on a pinned thread should stay in the pool
+            std::thread ([&]
+                         {
+                             setCurrentThreadAffinity (getNUMANodeCPUs().back());
+                             expectEquals ((int) getCurrentThreadNUMANode(), (int) numNodes - 1);
+
+                             std::vector<ChannelArrayBuffer<float>> buffers;
+
+                             for (int i = 0; i < 8; ++i)
+                                 buffers.push_back (pool.allocate (size));
+
+                             for (auto& b : buffers)
+                                 expect (pool.release (std::move (b)));
+                         }).join();
+
+            expectEquals<int> ((int) pool.getNumBuffers(), 8);
+            expectEquals<int> ((int) pool.getAllocatedSize(), 8 * (int) SeparateChannelLayout<float>::getBytesNeeded (size));
+
+            pool.setNUMANodesInUse ({});
+            expectEquals<int> ((int) pool.getNumBuffers(), 8);
+        }
+
+        beginTest ("ThreadAffinity");
+        {
+            const auto affinity = ThreadAffinity::forNUMANode (0);
+            expectEquals (affinity.processThreadCPUs.size(), (size_t) 1);
+            expect (affinity.getNUMANodes() == std::vector<size_t> { 0 });
+
+            if (! affinity.workerCPUs.empty())
+            {
+                expect (affinity.getWorkerCPU (0) == affinity.workerCPUs.front());
+                expect (affinity.getWorkerCPU (affinity.workerCPUs.size()) == affinity.workerCPUs.front());
+            }
+
+            expect (! ThreadAffinity().getWorkerCPU (0));
+            expect (ThreadAffinity().isEmpty());
+        }
+    }
 };
 
 static AudioBufferPoolTests audioBufferPoolTests;
@@ -0,0 +1,124 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#include "../../3rd_party/choc/text/choc_JSON.h"
+
+#if __has_include (<cxxabi.h>)
+ #include <cxxabi.h>
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+NodeProcessTracer::NodeProcessTracer (size_t maxNumEvents)
+    : events (maxNumEvents)
+{
+}
+
+std::vector<NodeProcessTracer::Event> NodeProcessTracer::popEvents()
+{
+    std::vector<Event> poppedEvents;
+
+    for (Event event; popEvent (event);)
+        poppedEvents.push_back (event);
+
+    return poppedEvents;
+}
+
+std::string NodeProcessTracer::getNodeTypeName (const std::type_info& type)
+{
+   #if __has_include (<cxxabi.h>)
+    int status;
+
+    if (char* demangled = abi::__cxa_demangle (type.name(), nullptr, nullptr, &status); status == 0)
+    {
+        std::string demangledString (demangled);
+        free (demangled);
+        return demangledString;
+    }
+   #endif
+
+    return type.name();
+}
+
+double NodeProcessTracer::getCyclesPerMicrosecond() const
+{
+    const auto elapsedCycles = rdtsc() - referenceCycles;
+    const std::chrono::duration<double, std::micro> elapsedTime = std::chrono::steady_clock::now() - referenceTime;
+
+    if (elapsedTime.count() <= 0.0 || elapsedCycles == 0)
+        return 1.0;
+
+    return (double) elapsedCycles / elapsedTime.count();
+}
+
+std::string NodeProcessTracer::toChromeTraceJSON (const std::vector<Event>& eventsToConvert, const NodeProcessTracer& tracer)
+{
+    const auto cyclesPerMicrosecond = tracer.getCyclesPerMicrosecond();
+    const auto startCycles = eventsToConvert.empty() ? tracer.referenceCycles
+                                                      : std::min_element (eventsToConvert.begin(), eventsToConvert.end(),
+                                                                          [] (auto& e1, auto& e2) { return e1.startCycles < e2.startCycles; })->startCycles;
+
+    auto cyclesToMicroseconds = [&] (std::uint64_t cycles)
+    {
+        return choc::json::doubleToString ((double) (cycles - startCycles) / cyclesPerMicrosecond);
+    };
+
+    // Demangling is slow so cache the names
+    std::map<const std::type_info*, std::string> typeNames;
+    std::set<std::uint32_t> threadIndexes;
+
+    std::ostringstream json;
+    json << "{\"traceEvents\":[";
+    bool isFirst = true;
+
+    for (auto& e : eventsToConvert)
+    {
+        std::string name = "Block";
+
+        if (e.nodeType != nullptr)
+        {
+            auto& typeName = typeNames[e.nodeType];
+
+            if (typeName.empty())
+                typeName = getNodeTypeName (*e.nodeType);
+
+            name = typeName;
+        }
+
+        threadIndexes.insert (e.threadIndex);
+
+        json << (isFirst ? "\n" : ",\n")
+             << "{\"name\":" << choc::json::getEscapedQuotedString (name)
+             << ",\"cat\":\"" << (e.node != nullptr ? "node" : "block") << "\""
+             << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.threadIndex
+             << ",\"ts\":" << cyclesToMicroseconds (e.startCycles)
+             << ",\"dur\":" << choc::json::doubleToString ((double) (e.endCycles - e.startCycles) / cyclesPerMicrosecond)
+             << ",\"args\":{\"block\":" << e.blockNumber
+             << ",\"node\":\"" << e.node << "\"}}";
+        isFirst = false;
+    }
+
+    // Name the threads so they're easy to find in the viewer
+    for (auto threadIndex : threadIndexes)
+    {
+        json << (isFirst ? "\n" : ",\n")
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << threadIndex
+             << ",\"args\":{\"name\":\"Thread " << threadIndex << "\"}}";
+        isFirst = false;
+    }
+
+    json << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+    return json.str();
+}
+
+}}
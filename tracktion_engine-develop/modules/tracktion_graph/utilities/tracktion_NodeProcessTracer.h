@@ -0,0 +1,187 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+#include <typeinfo>
+
+#include "../../tracktion_core/utilities/tracktion_CPU.h"
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+//==============================================================================
+/**
+    Records the time each Node takes to process so it can be inspected later.
+
+    Set one of these on a player with setNodeProcessTracer and every call to
+    Node::process will be recorded along with the thread that processed it.
+    Each player block is also recorded so you can see how the Nodes were
+    spread across the threads and where threads were stalled.
+
+    Events are pushed to a fixed-size lock-free queue so recording is real-time
+    safe. If the queue fills up because it isn't being drained fast enough, new
+    events are dropped and counted by getNumDroppedEvents.
+
+    The events can then be exported to the Chrome trace-event format which can be
+    opened in chrome://tracing or https://ui.perfetto.dev
+    E.g. @code
+        NodeProcessTracer tracer;
+        player.setNodeProcessTracer (&tracer);
+        ...
+        player.setNodeProcessTracer (nullptr);
+        juce::File ("trace.json").replaceWithText (NodeProcessTracer::toChromeTraceJSON (tracer.popEvents(), tracer));
+    @endcode
+*/
+class NodeProcessTracer
+{
+public:
+    //==============================================================================
+    /** A single recorded process call. */
+    struct Event
+    {
+        const Node* node = nullptr;                 /**< The Node processed or nullptr if this is a whole player block. */
+        const std::type_info* nodeType = nullptr;   /**< The dynamic type of the Node. */
+        std::uint64_t startCycles = 0;              /**< The rdtsc value when processing started. */
+        std::uint64_t endCycles = 0;                /**< The rdtsc value when processing finished. */
+        std::uint32_t threadIndex = 0;              /**< A small, unique index for the thread that processed the Node. */
+        std::uint32_t blockNumber = 0;              /**< The player block this was processed in. */
+    };
+
+    //==============================================================================
+    /** Creates a tracer that can hold a number of Events before they need to be popped. */
+    NodeProcessTracer (size_t maxNumEvents = 65536);
+
+    //==============================================================================
+    /** Adds an Event to the queue.
+        [[ thread_safe, realtime ]]
+    */
+    void addEvent (const Event&);
+
+    /** Records an Event for the lifetime of this object.
+        Pass a nullptr Node to record a whole player block.
+        [[ thread_safe, realtime ]]
+    */
+    struct ScopedEvent
+    {
+        ScopedEvent (NodeProcessTracer*, const Node*);
+        ~ScopedEvent();
+
+        NodeProcessTracer* tracer;
+        Event event;
+    };
+
+    /** Returns the current block number. */
+    std::uint32_t getBlockNumber() const;
+
+    /** Returns the number of events dropped because the queue was full. */
+    size_t getNumDroppedEvents() const;
+
+    /** Returns an index for the calling thread. */
+    static std::uint32_t getCurrentThreadIndex();
+
+    //==============================================================================
+    /** Removes all the events currently in the queue and returns them.
+        [[ message_thread ]]
+    */
+    std::vector<Event> popEvents();
+
+    /** Removes the next event in the queue if there is one.
+        [[ thread_safe, realtime ]]
+    */
+    bool popEvent (Event&);
+
+    /** Converts some events to a Chrome trace-event JSON string.
+        The tracer is used to convert the cycle counts to microseconds.
+    */
+    static std::string toChromeTraceJSON (const std::vector<Event>&, const NodeProcessTracer&);
+
+    /** Returns the number of rdtsc cycles per microsecond, measured since this tracer was created. */
+    double getCyclesPerMicrosecond() const;
+
+    /** Returns a readable, demangled name for the type of a Node. */
+    static std::string getNodeTypeName (const std::type_info&);
+
+private:
+    //==============================================================================
+    rigtorp::MPMCQueue<Event> events;
+    std::atomic<size_t> numDroppedEvents { 0 };
+    std::atomic<std::uint32_t> blockNumber { 0 };
+
+    const std::chrono::steady_clock::time_point referenceTime { std::chrono::steady_clock::now() };
+    const std::uint64_t referenceCycles { rdtsc() };
+};
+
+
+//==============================================================================
+//        _        _           _  _
+//     __| |  ___ | |_   __ _ (_)| | ___
+//    / _` | / _ \| __| / _` || || |/ __|
+//   | (_| ||  __/| |_ | (_| || || |\__ \ _  _  _
+//    \__,_| \___| \__| \__,_||_||_||___/(_)(_)(_)
+//
+//   Code beyond this point is implementation detail...
+//
+//==============================================================================
+
+inline void NodeProcessTracer::addEvent (const Event& event)
+{
+    if (! events.try_push (event))
+        numDroppedEvents.fetch_add (1, std::memory_order_relaxed);
+}
+
+inline bool NodeProcessTracer::popEvent (Event& event)
+{
+    return events.try_pop (event);
+}
+
+inline std::uint32_t NodeProcessTracer::getBlockNumber() const
+{
+    return blockNumber.load (std::memory_order_relaxed);
+}
+
+inline size_t NodeProcessTracer::getNumDroppedEvents() const
+{
+    return numDroppedEvents.load (std::memory_order_relaxed);
+}
+
+inline std::uint32_t NodeProcessTracer::getCurrentThreadIndex()
+{
+    static std::atomic<std::uint32_t> nextThreadIndex { 0 };
+    thread_local const std::uint32_t threadIndex = nextThreadIndex++;
+    return threadIndex;
+}
+
+inline NodeProcessTracer::ScopedEvent::ScopedEvent (NodeProcessTracer* tracerToUse, const Node* node)
+    : tracer (tracerToUse)
+{
+    if (tracer == nullptr)
+        return;
+
+    // Starting a block increments the block number for all the Nodes in it
+    event.blockNumber = node == nullptr ? tracer->blockNumber.fetch_add (1, std::memory_order_relaxed) + 1
+                                        : tracer->getBlockNumber();
+    event.node = node;
+    event.nodeType = node != nullptr ? &typeid (*node) : nullptr;
+    event.threadIndex = getCurrentThreadIndex();
+    event.startCycles = rdtsc();
+}
+
+inline NodeProcessTracer::ScopedEvent::~ScopedEvent()
+{
+    if (tracer == nullptr)
+        return;
+
+    event.endCycles = rdtsc();
+    tracer->addEvent (event);
+}
+
+}}
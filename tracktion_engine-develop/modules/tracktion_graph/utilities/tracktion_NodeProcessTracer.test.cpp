@@ -0,0 +1,112 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_NODEPROCESSTRACER
+
+class NodeProcessTracerTests    : public juce::UnitTest
+{
+public:
+    NodeProcessTracerTests()
+        : juce::UnitTest ("NodeProcessTracer", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        using namespace test_utilities;
+
+        for (size_t numThreads : { 0u, 3u })
+        {
+            beginTest ("LockFreeMultiThreadedNodePlayer: " + juce::String (numThreads) + " threads");
+            runPlayerTest (createLockFreePlayer (createWideSinGraph (4, 2), getTestSetup(), ThreadPoolStrategy::lightweightSemHybrid, numThreads));
+
+            beginTest ("StaticScheduleNodePlayer: " + juce::String (numThreads) + " threads");
+            runPlayerTest (createStaticSchedulePlayer (createWideSinGraph (4, 2), getTestSetup(), numThreads));
+        }
+
+        beginTest ("Dropped events");
+        {
+            NodeProcessTracer tracer (4);
+
+            for (int i = 0; i < 6; ++i)
+                NodeProcessTracer::ScopedEvent event (&tracer, nullptr);
+
+            expectEquals ((int) tracer.getBlockNumber(), 6);
+            expectEquals (tracer.getNumDroppedEvents(), (size_t) 2);
+            expectEquals (tracer.popEvents().size(), (size_t) 4);
+            expect (tracer.popEvents().empty());
+
+            // Once popped, there's space for more
+            { NodeProcessTracer::ScopedEvent event (&tracer, nullptr); }
+            expectEquals (tracer.popEvents().size(), (size_t) 1);
+        }
+
+        beginTest ("Null tracer");
+        {
+            // This shouldn't do anything
+            NodeProcessTracer::ScopedEvent event (nullptr, nullptr);
+            expect (event.tracer == nullptr);
+        }
+    }
+
+private:
+    static test_utilities::TestSetup getTestSetup()
+    {
+        test_utilities::TestSetup ts;
+        ts.sampleRate = 44100.0;
+        ts.blockSize = 256;
+        return ts;
+    }
+
+    template<typename NodePlayerType>
+    void runPlayerTest (std::unique_ptr<NodePlayerType> player)
+    {
+        using namespace test_utilities;
+        constexpr size_t numNodes = 4 * (2 + 1) + 1;
+
+        NodeProcessTracer tracer;
+        player->setNodeProcessTracer (&tracer);
+
+        TestProcess<NodePlayerType> testProcess (std::move (player), getTestSetup(), 1, 1.0, false);
+        testProcess.processAll();
+        testProcess.getNodePlayer().setNodeProcessTracer (nullptr);
+
+        const auto events = tracer.popEvents();
+        const auto numBlocks = (size_t) std::count_if (events.begin(), events.end(),
+                                                       [] (auto& e) { return e.node == nullptr; });
+
+        expect (numBlocks > 0);
+        expectEquals (tracer.getNumDroppedEvents(), (size_t) 0);
+        expectEquals (numBlocks, (size_t) tracer.getBlockNumber());
+        expectEquals (events.size(), numBlocks * (numNodes + 1));
+
+        for (auto& e : events)
+        {
+            expect (e.endCycles >= e.startCycles);
+            expect (e.blockNumber > 0 && e.blockNumber <= numBlocks);
+            expect ((e.node == nullptr) == (e.nodeType == nullptr));
+        }
+
+        const auto json = NodeProcessTracer::toChromeTraceJSON (events, tracer);
+        const auto parsed = juce::JSON::parse (json);
+        expect (parsed.isObject(), "Trace should be valid JSON");
+        expect (parsed["traceEvents"].isArray());
+        expect (parsed["traceEvents"].size() > (int) events.size(), "Should contain all events plus thread names");
+        expect (json.find ("SinNode") != std::string::npos);
+    }
+};
+
+static NodeProcessTracerTests nodeProcessTracerTests;
+
+#endif
+
+}}
@@ -0,0 +1,79 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A fixed-capacity, lock-free multi-producer, multi-consumer FIFO with a number
+    of priority levels.
+
+    Each level is a separate FIFO and popping takes the oldest item from the
+    highest non-empty level, so items of the same priority come out in the order
+    they were pushed. Because the number of levels is fixed and small, pushing and
+    popping are both constant time, at the cost of priorities being quantised.
+
+    No allocations are made after construction so this is safe to use on real-time
+    threads. If a level is full, tryPush will return false.
+*/
+template<typename Type>
+class PriorityFifo
+{
+public:
+    /** Creates a FIFO with the given number of priority levels, each of which can
+        hold the given number of items.
+    */
+    PriorityFifo (size_t numPriorities, size_t capacityPerPriority)
+    {
+        jassert (numPriorities > 0);
+        fifos.reserve (numPriorities);
+
+        for (size_t i = 0; i < numPriorities; ++i)
+            fifos.push_back (std::make_unique<rigtorp::MPMCQueue<Type>> (std::max (capacityPerPriority, (size_t) 1)));
+    }
+
+    /** Returns the number of priority levels. */
+    size_t getNumPriorities() const     { return fifos.size(); }
+
+    //==============================================================================
+    /** Adds an item with a priority, where 0 is the lowest.
+        Priorities beyond the number of levels are given the highest one.
+        Returns false if that level is full.
+        [[ thread_safe ]]
+    */
+    bool tryPush (Type item, size_t priority)
+    {
+        return fifos[std::min (priority, fifos.size() - 1)]->try_push (std::move (item));
+    }
+
+    /** Removes the oldest item with the highest priority.
+        Only levels up to and including maxPriority are checked so if all the items
+        are known to be at lower priorities, the empty levels can be skipped.
+        Returns false if these were all empty.
+        [[ thread_safe ]]
+    */
+    bool tryPop (Type& item, size_t maxPriority = std::numeric_limits<size_t>::max())
+    {
+        for (auto i = std::min (maxPriority, fifos.size() - 1) + 1; i > 0; --i)
+            if (fifos[i - 1]->try_pop (item))
+                return true;
+
+        return false;
+    }
+
+private:
+    //==============================================================================
+    std::vector<std::unique_ptr<rigtorp::MPMCQueue<Type>>> fifos;
+};
+
+}}
@@ -0,0 +1,142 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_PRIORITYFIFO
+
+class PriorityFifoTests    : public juce::UnitTest
+{
+public:
+    PriorityFifoTests()
+        : juce::UnitTest ("PriorityFifo", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runOrderTests();
+        runConcurrentTests();
+    }
+
+private:
+    void runOrderTests()
+    {
+        beginTest ("Priority order");
+        {
+            PriorityFifo<int> fifo (3, 4);
+            expectEquals<int> ((int) fifo.getNumPriorities(), 3);
+
+            expect (fifo.tryPush (10, 0));
+            expect (fifo.tryPush (20, 1));
+            expect (fifo.tryPush (11, 0));
+            expect (fifo.tryPush (30, 2));
+
+            int item = -1;
+
+            // The highest priority comes out first
+            expect (fifo.tryPop (item));
+            expectEquals (item, 30);
+
+            // Items pushed between pops still jump ahead of lower priorities
+            expect (fifo.tryPush (21, 1));
+            expect (fifo.tryPush (31, 5));
+
+            for (auto expected : { 31, 20, 21, 10, 11 })
+            {
+                expect (fifo.tryPop (item));
+                expectEquals (item, expected);
+            }
+
+            expect (! fifo.tryPop (item));
+        }
+
+        beginTest ("Limited priorities");
+        {
+            PriorityFifo<int> fifo (2, 2);
+            expect (fifo.tryPush (1, 1));
+            expect (fifo.tryPush (0, 0));
+            expect (fifo.tryPush (2, 1));
+            expect (! fifo.tryPush (3, 1), "Level should be full");
+
+            int item = -1;
+            expect (fifo.tryPop (item, 0));
+            expectEquals (item, 0);
+            expect (! fifo.tryPop (item, 0));
+
+            expect (fifo.tryPop (item));
+            expectEquals (item, 1);
+        }
+    }
+
+    void runConcurrentTests()
+    {
+        beginTest ("Concurrent push and pop");
+        {
+            constexpr int numItems = 100'000;
+            constexpr int numThreads = 4;
+
+            PriorityFifo<int> fifo (4, 256);
+            std::vector<std::atomic<int>> timesTaken ((size_t) numItems);
+            std::atomic<int> numTaken { 0 };
+            std::atomic<bool> producerFinished { false };
+
+            std::vector<std::thread> consumers;
+
+            for (int i = 0; i < numThreads; ++i)
+            {
+                consumers.emplace_back ([&]
+                                        {
+                                            for (;;)
+                                            {
+                                                int item;
+
+                                                if (fifo.tryPop (item))
+                                                {
+                                                    ++timesTaken[(size_t) item];
+                                                    ++numTaken;
+                                                }
+                                                else if (producerFinished)
+                                                {
+                                                    return;
+                                                }
+                                            }
+                                        });
+            }
+
+            for (int i = 0; i < numItems;)
+                if (fifo.tryPush (i, (size_t) (i % 4)))
+                    ++i;
+
+            producerFinished = true;
+
+            for (auto& t : consumers)
+                t.join();
+
+            // A consumer may have seen the FIFO empty just before the last items were pushed
+            for (int item; fifo.tryPop (item);)
+            {
+                ++timesTaken[(size_t) item];
+                ++numTaken;
+            }
+
+            expectEquals (numTaken.load(), numItems);
+            expect (std::all_of (timesTaken.begin(), timesTaken.end(),
+                                 [] (auto& count) { return count.load() == 1; }),
+                    "Each item should be taken exactly once");
+        }
+    }
+};
+
+static PriorityFifoTests priorityFifoTests;
+
+#endif
+
+}} // namespace tracktion
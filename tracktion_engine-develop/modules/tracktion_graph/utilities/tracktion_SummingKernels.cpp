@@ -0,0 +1,252 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#if JUCE_INTEL && (defined (__GNUC__) || defined (_MSC_VER))
+ #include <immintrin.h>
+ #define TRACKTION_SUMMING_AVX2 1
+
+ #if defined (__GNUC__)
+  #define TRACKTION_SUMMING_AVX2_TARGET __attribute__ ((target ("avx2")))
+ #else
+  #define TRACKTION_SUMMING_AVX2_TARGET
+ #endif
+#endif
+
+#if JUCE_ARM && (defined (__ARM_NEON) || defined (_M_ARM64))
+ #include <arm_neon.h>
+ #define TRACKTION_SUMMING_NEON 1
+
+ #if defined (__aarch64__) || defined (_M_ARM64)
+  #define TRACKTION_SUMMING_NEON_DOUBLE 1
+ #endif
+#endif
+
+namespace tracktion { inline namespace graph
+{
+
+namespace summing
+{
+
+namespace detail
+{
+    // Each kernel adds exactly NumSources sources to dest in a single pass.
+    // The public functions split the sources in to groups of 8, then 4, then the remainder.
+
+    //==============================================================================
+    template<size_t NumSources, typename DestType>
+    void addScalar (DestType* dest, const float* const* sources, size_t startFrame, size_t numFrames) noexcept
+    {
+        for (size_t i = startFrame; i < numFrames; ++i)
+        {
+            auto sum = dest[i];
+
+            for (size_t s = 0; s < NumSources; ++s)
+                sum += static_cast<DestType> (sources[s][i]);
+
+            dest[i] = sum;
+        }
+    }
+
+    //==============================================================================
+   #if TRACKTION_SUMMING_AVX2
+    template<size_t NumSources>
+    TRACKTION_SUMMING_AVX2_TARGET
+    void addAVX2 (float* dest, const float* const* sources, size_t numFrames) noexcept
+    {
+        constexpr size_t vecSize = 8;
+        const auto numVecFrames = numFrames - (numFrames % vecSize);
+
+        for (size_t i = 0; i < numVecFrames; i += vecSize)
+        {
+            auto sum = _mm256_loadu_ps (dest + i);
+
+            for (size_t s = 0; s < NumSources; ++s)
+                sum = _mm256_add_ps (sum, _mm256_loadu_ps (sources[s] + i));
+
+            _mm256_storeu_ps (dest + i, sum);
+        }
+
+        addScalar<NumSources> (dest, sources, numVecFrames, numFrames);
+    }
+
+    template<size_t NumSources>
+    TRACKTION_SUMMING_AVX2_TARGET
+    void addAVX2 (double* dest, const float* const* sources, size_t numFrames) noexcept
+    {
+        constexpr size_t vecSize = 4;
+        const auto numVecFrames = numFrames - (numFrames % vecSize);
+
+        for (size_t i = 0; i < numVecFrames; i += vecSize)
+        {
+            auto sum = _mm256_loadu_pd (dest + i);
+
+            for (size_t s = 0; s < NumSources; ++s)
+                sum = _mm256_add_pd (sum, _mm256_cvtps_pd (_mm_loadu_ps (sources[s] + i)));
+
+            _mm256_storeu_pd (dest + i, sum);
+        }
+
+        addScalar<NumSources> (dest, sources, numVecFrames, numFrames);
+    }
+   #endif
+
+    //==============================================================================
+   #if TRACKTION_SUMMING_NEON
+    template<size_t NumSources>
+    void addNEON (float* dest, const float* const* sources, size_t numFrames) noexcept
+    {
+        constexpr size_t vecSize = 4;
+        const auto numVecFrames = numFrames - (numFrames % vecSize);
+
+        for (size_t i = 0; i < numVecFrames; i += vecSize)
+        {
+            auto sum = vld1q_f32 (dest + i);
+
+            for (size_t s = 0; s < NumSources; ++s)
+                sum = vaddq_f32 (sum, vld1q_f32 (sources[s] + i));
+
+            vst1q_f32 (dest + i, sum);
+        }
+
+        addScalar<NumSources> (dest, sources, numVecFrames, numFrames);
+    }
+
+    template<size_t NumSources>
+    void addNEON (double* dest, const float* const* sources, size_t numFrames) noexcept
+    {
+       #if TRACKTION_SUMMING_NEON_DOUBLE
+        constexpr size_t vecSize = 4;
+        const auto numVecFrames = numFrames - (numFrames % vecSize);
+
+        for (size_t i = 0; i < numVecFrames; i += vecSize)
+        {
+            auto sumLow = vld1q_f64 (dest + i);
+            auto sumHigh = vld1q_f64 (dest + i + 2);
+
+            for (size_t s = 0; s < NumSources; ++s)
+            {
+                const auto source = vld1q_f32 (sources[s] + i);
+                sumLow = vaddq_f64 (sumLow, vcvt_f64_f32 (vget_low_f32 (source)));
+                sumHigh = vaddq_f64 (sumHigh, vcvt_high_f64_f32 (source));
+            }
+
+            vst1q_f64 (dest + i, sumLow);
+            vst1q_f64 (dest + i + 2, sumHigh);
+        }
+
+        addScalar<NumSources> (dest, sources, numVecFrames, numFrames);
+       #else
+        addScalar<NumSources> (dest, sources, 0, numFrames);
+       #endif
+    }
+   #endif
+
+    //==============================================================================
+    template<size_t NumSources, typename DestType>
+    void addGroup (DestType* dest, const float* const* sources, size_t numFrames, InstructionSet instructionSet) noexcept
+    {
+        switch (instructionSet)
+        {
+           #if TRACKTION_SUMMING_AVX2
+            case InstructionSet::avx2:      addAVX2<NumSources> (dest, sources, numFrames); return;
+           #endif
+           #if TRACKTION_SUMMING_NEON
+            case InstructionSet::neon:      addNEON<NumSources> (dest, sources, numFrames); return;
+           #endif
+            case InstructionSet::scalar:
+            default:                        addScalar<NumSources> (dest, sources, 0, numFrames); return;
+        }
+    }
+
+    template<typename DestType>
+    void addChannels (DestType* dest, const float* const* sources, size_t numSources, size_t numFrames,
+                      InstructionSet instructionSet) noexcept
+    {
+        if (! isAvailable (instructionSet))
+            instructionSet = InstructionSet::scalar;
+
+        // Without explicit SIMD, JUCE's vectorised add is faster than a grouped scalar loop
+        if constexpr (std::is_same_v<DestType, float>)
+        {
+            if (instructionSet == InstructionSet::scalar)
+            {
+                for (size_t i = 0; i < numSources; ++i)
+                    juce::FloatVectorOperations::add (dest, sources[i], (int) numFrames);
+
+                return;
+            }
+        }
+
+        for (; numSources >= 8; numSources -= 8, sources += 8)
+            addGroup<8> (dest, sources, numFrames, instructionSet);
+
+        for (; numSources >= 4; numSources -= 4, sources += 4)
+            addGroup<4> (dest, sources, numFrames, instructionSet);
+
+        switch (numSources)
+        {
+            case 3:     addGroup<3> (dest, sources, numFrames, instructionSet); break;
+            case 2:     addGroup<2> (dest, sources, numFrames, instructionSet); break;
+            case 1:     addGroup<1> (dest, sources, numFrames, instructionSet); break;
+            default:    break;
+        }
+    }
+}
+
+//==============================================================================
+bool isAvailable (InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+        case InstructionSet::scalar:    return true;
+       #if TRACKTION_SUMMING_AVX2
+        case InstructionSet::avx2:      return juce::SystemStats::hasAVX2();
+       #endif
+       #if TRACKTION_SUMMING_NEON
+        case InstructionSet::neon:      return true;
+       #endif
+        default:                        return false;
+    }
+}
+
+InstructionSet getBestInstructionSet()
+{
+    static const auto best = []
+    {
+        for (auto instructionSet : { InstructionSet::avx2, InstructionSet::neon })
+            if (isAvailable (instructionSet))
+                return instructionSet;
+
+        return InstructionSet::scalar;
+    }();
+
+    return best;
+}
+
+void addChannels (float* dest, const float* const* sources, size_t numSources, size_t numFrames,
+                  InstructionSet instructionSet) noexcept
+{
+    detail::addChannels (dest, sources, numSources, numFrames, instructionSet);
+}
+
+void addChannels (double* dest, const float* const* sources, size_t numSources, size_t numFrames,
+                  InstructionSet instructionSet) noexcept
+{
+    detail::addChannels (dest, sources, numSources, numFrames, instructionSet);
+}
+
+}
+
+}}
+
+#undef TRACKTION_SUMMING_AVX2
+#undef TRACKTION_SUMMING_AVX2_TARGET
+#undef TRACKTION_SUMMING_NEON
+#undef TRACKTION_SUMMING_NEON_DOUBLE
@@ -0,0 +1,86 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+/**
+    Kernels for summing many source channels in to a single destination channel.
+
+    Rather than adding sources one at a time, which reads and writes the
+    destination once per source, these add the sources in groups of up to 8 so
+    the destination is only read and written once per group.
+*/
+namespace summing
+{
+    /** The instruction sets the kernels can use. */
+    enum class InstructionSet
+    {
+        scalar,     /**< No explicit SIMD, always available. */
+        avx2,       /**< x86 AVX2. */
+        neon        /**< ARM NEON. */
+    };
+
+    /** Returns true if the given instruction set was compiled in and is supported by this CPU. */
+    bool isAvailable (InstructionSet);
+
+    /** Returns the fastest instruction set available on this CPU.
+        This is determined once at runtime and then cached.
+    */
+    InstructionSet getBestInstructionSet();
+
+    /** Adds numSources channels of numFrames samples in to dest. */
+    void addChannels (float* dest, const float* const* sources, size_t numSources, size_t numFrames,
+                      InstructionSet = getBestInstructionSet()) noexcept;
+
+    /** Adds numSources channels of numFrames samples in to dest, accumulating in double precision. */
+    void addChannels (double* dest, const float* const* sources, size_t numSources, size_t numFrames,
+                      InstructionSet = getBestInstructionSet()) noexcept;
+
+    /** Adds all the source views in to dest.
+        Each source can have a different number of channels, only the channels that
+        are present in both the source and dest are added.
+        The sourceChannels array must be able to hold a pointer for each source and is
+        used as scratch space so this doesn't need to allocate.
+    */
+    template<typename DestSampleType>
+    void addViews (const choc::buffer::ChannelArrayView<DestSampleType>& dest,
+                   const choc::buffer::ChannelArrayView<float>* sources, size_t numSources,
+                   const float** sourceChannels) noexcept
+    {
+        const auto numFrames = (size_t) dest.getNumFrames();
+
+        if (numFrames == 0)
+            return;
+
+        for (choc::buffer::ChannelCount chan = 0; chan < dest.getNumChannels(); ++chan)
+        {
+            size_t numSourceChannels = 0;
+
+            for (size_t i = 0; i < numSources; ++i)
+            {
+                auto& source = sources[i];
+
+                if (chan >= source.getNumChannels())
+                    continue;
+
+                jassert (source.getNumFrames() == dest.getNumFrames());
+                sourceChannels[numSourceChannels++] = source.getIterator (chan).sample;
+            }
+
+            if (numSourceChannels > 0)
+                addChannels (dest.getIterator (chan).sample, sourceChannels, numSourceChannels, numFrames);
+        }
+    }
+}
+
+}}
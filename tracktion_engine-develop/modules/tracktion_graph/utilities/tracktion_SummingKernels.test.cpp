@@ -0,0 +1,216 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS || (TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING)
+namespace summing_test_utilities
+{
+    /** Holds a number of source channels filled with random samples. */
+    struct Sources
+    {
+        // choc won't allocate any channels for an empty buffer so always allocate at least one frame
+        Sources (size_t numSources, size_t numFrames, juce::Random& r)
+            : buffer ((choc::buffer::ChannelCount) numSources, (choc::buffer::FrameCount) std::max<size_t> (numFrames, 1))
+        {
+            choc::buffer::setAllSamples (buffer, [&r] { return r.nextFloat() * 2.0f - 1.0f; });
+
+            for (choc::buffer::ChannelCount i = 0; i < buffer.getNumChannels(); ++i)
+                channels.push_back (buffer.getIterator (i).sample);
+        }
+
+        choc::buffer::ChannelArrayBuffer<float> buffer;
+        std::vector<const float*> channels;
+    };
+
+    inline juce::String getName (summing::InstructionSet instructionSet)
+    {
+        switch (instructionSet)
+        {
+            case summing::InstructionSet::avx2:     return "AVX2";
+            case summing::InstructionSet::neon:     return "NEON";
+            case summing::InstructionSet::scalar:
+            default:                                return "scalar";
+        }
+    }
+}
+#endif
+
+#if GRAPH_UNIT_TESTS_SUMMINGKERNELS
+
+//==============================================================================
+//==============================================================================
+class SummingKernelsTests : public juce::UnitTest
+{
+public:
+    SummingKernelsTests()
+        : juce::UnitTest ("SummingKernels", "tracktion_graph")
+    {
+    }
+
+    void runTest() override
+    {
+        for (auto instructionSet : { summing::InstructionSet::scalar, summing::InstructionSet::avx2, summing::InstructionSet::neon })
+        {
+            if (! summing::isAvailable (instructionSet))
+                continue;
+
+            runSummingTests<float> (instructionSet);
+            runSummingTests<double> (instructionSet);
+        }
+
+        runViewTests();
+    }
+
+private:
+    template<typename DestType>
+    void runSummingTests (summing::InstructionSet instructionSet)
+    {
+        beginTest ("Summing " + summing_test_utilities::getName (instructionSet)
+                    + (std::is_same_v<DestType, float> ? " float" : " double"));
+
+        auto r = getRandom();
+
+        // Awkward numbers of sources and frames to exercise the grouping and remainders
+        for (size_t numSources : { 0u, 1u, 3u, 4u, 7u, 8u, 13u, 17u })
+        {
+            for (size_t numFrames : { 0u, 1u, 5u, 64u, 67u })
+            {
+                summing_test_utilities::Sources sources (numSources, numFrames, r);
+                std::vector<DestType> dest (numFrames), expected (numFrames);
+
+                for (size_t i = 0; i < numFrames; ++i)
+                {
+                    dest[i] = expected[i] = static_cast<DestType> (r.nextFloat());
+
+                    for (auto source : sources.channels)
+                        expected[i] += static_cast<DestType> (source[i]);
+                }
+
+                summing::addChannels (dest.data(), sources.channels.data(), numSources, numFrames, instructionSet);
+
+                bool allMatch = true;
+
+                for (size_t i = 0; i < numFrames; ++i)
+                    allMatch = allMatch && std::abs (dest[i] - expected[i]) < static_cast<DestType> (1.0e-4);
+
+                expect (allMatch, juce::String (numSources) + " sources, " + juce::String (numFrames) + " frames");
+            }
+        }
+    }
+
+    void runViewTests()
+    {
+        beginTest ("Summing views with different channel counts");
+
+        choc::buffer::ChannelArrayBuffer<float> dest (2, 16);
+        choc::buffer::ChannelArrayBuffer<float> mono (1, 16), stereo (2, 16);
+        dest.clear();
+        choc::buffer::setAllSamples (mono, [] { return 0.25f; });
+        choc::buffer::setAllSamples (stereo, [] { return 0.5f; });
+
+        const std::array<choc::buffer::ChannelArrayView<float>, 2> views { mono.getView(), stereo.getView() };
+        std::array<const float*, 2> scratch {};
+        summing::addViews (dest.getView(), views.data(), views.size(), scratch.data());
+
+        expectEquals (dest.getSample (0, 0), 0.75f);
+        expectEquals (dest.getSample (0, 15), 0.75f);
+        expectEquals (dest.getSample (1, 0), 0.5f);
+        expectEquals (dest.getSample (1, 15), 0.5f);
+    }
+};
+
+static SummingKernelsTests summingKernelsTests;
+
+#endif
+
+#if TRACKTION_BENCHMARKS && GRAPH_BENCHMARKS_SUMMING
+
+//==============================================================================
+//==============================================================================
+class SummingKernelsBenchmarks : public juce::UnitTest
+{
+public:
+    SummingKernelsBenchmarks()
+        : juce::UnitTest ("SummingKernels", "tracktion_benchmarks")
+    {
+    }
+
+    void runTest() override
+    {
+        for (size_t numSources : { 16u, 64u, 256u })
+            for (size_t numFrames : { 64u, 128u, 256u, 512u, 1024u, 2048u })
+                runBenchmark (numSources, numFrames);
+    }
+
+private:
+    void runBenchmark (size_t numSources, size_t numFrames)
+    {
+        const auto description = juce::String ("{sources} sources, {frames} frames")
+                                    .replace ("{sources}", juce::String (numSources))
+                                    .replace ("{frames}", juce::String (numFrames));
+        beginTest (description);
+
+        auto r = getRandom();
+        summing_test_utilities::Sources sources (numSources, numFrames, r);
+        std::vector<float> dest (numFrames);
+        constexpr int numIterations = 1000;
+
+        auto addResult = [&] (juce::String benchmarkName, Benchmark& benchmark)
+        {
+            BenchmarkList::getInstance().addResult (benchmark.getResult());
+            logMessage (benchmarkName + ": " + juce::String (benchmark.getResult().totalSeconds * 1000.0, 3) + "ms");
+        };
+
+        // Adding each source one at a time as SummingNode used to
+        {
+            Benchmark benchmark (createBenchmarkDescription ("Summing", "One input at a time", description.toStdString()));
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                benchmark.start();
+
+                for (auto source : sources.channels)
+                    juce::FloatVectorOperations::add (dest.data(), source, (int) numFrames);
+
+                benchmark.stop();
+            }
+
+            addResult ("One input at a time", benchmark);
+        }
+
+        for (auto instructionSet : { summing::InstructionSet::scalar, summing::InstructionSet::avx2, summing::InstructionSet::neon })
+        {
+            if (! summing::isAvailable (instructionSet))
+                continue;
+
+            const auto kernelName = "Kernel " + summing_test_utilities::getName (instructionSet);
+            Benchmark benchmark (createBenchmarkDescription ("Summing", kernelName.toStdString(), description.toStdString()));
+
+            for (int i = 0; i < numIterations; ++i)
+            {
+                benchmark.start();
+                summing::addChannels (dest.data(), sources.channels.data(), numSources, numFrames, instructionSet);
+                benchmark.stop();
+            }
+
+            addResult (kernelName, benchmark);
+        }
+
+        expect (true);
+    }
+};
+
+static SummingKernelsBenchmarks summingKernelsBenchmarks;
+
+#endif
+
+}}
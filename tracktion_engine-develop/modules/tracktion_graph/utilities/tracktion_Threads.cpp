@@ -119,4 +119,166 @@ bool setThreadPriority (std::thread& t, int priority)
     return setThreadPriority (t.native_handle(), priority);
 }
 
+//==============================================================================
+#if JUCE_LINUX
+    template<typename HandleType>
+    bool setThreadAffinity (HandleType handle, const std::vector<size_t>& cpus)
+    {
+        cpu_set_t cpuSet;
+        CPU_ZERO (&cpuSet);
+
+        for (auto cpu : cpus)
+            if (cpu < CPU_SETSIZE)
+                CPU_SET (cpu, &cpuSet);
+
+        return pthread_setaffinity_np ((pthread_t) handle, sizeof (cpuSet), &cpuSet) == 0;
+    }
+#elif JUCE_WINDOWS
+    bool setThreadAffinity (void* handle, const std::vector<size_t>& cpus)
+    {
+        DWORD_PTR mask = 0;
+
+        for (auto cpu : cpus)
+            if (cpu < sizeof (DWORD_PTR) * 8)
+                mask |= ((DWORD_PTR) 1) << cpu;
+
+        return mask != 0 && SetThreadAffinityMask (handle, mask) != 0;
+    }
+#else
+    // macOS only supports affinity tags which are hints to share caches rather than pinning
+    template<typename HandleType>
+    bool setThreadAffinity (HandleType, const std::vector<size_t>&)
+    {
+        return false;
+    }
+#endif
+
+namespace
+{
+    thread_local size_t currentThreadNUMANode = 0;
+
+    std::vector<std::vector<size_t>> findNUMANodeCPUs()
+    {
+        std::vector<std::vector<size_t>> nodes;
+
+       #if JUCE_LINUX
+        // The cpulist files contain comma separated ranges e.g. "0-7,16-23"
+        for (int nodeIndex = 0;; ++nodeIndex)
+        {
+            const auto cpuListFile = juce::File ("/sys/devices/system/node/node" + juce::String (nodeIndex) + "/cpulist");
+
+            if (! cpuListFile.existsAsFile())
+                break;
+
+            std::vector<size_t> cpus;
+
+            for (auto range : juce::StringArray::fromTokens (cpuListFile.loadFileAsString().trim(), ",", {}))
+            {
+                const auto first = range.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+                const auto last = range.containsChar ('-') ? range.fromFirstOccurrenceOf ("-", false, false).getIntValue()
+                                                           : first;
+
+                for (int cpu = first; cpu <= last; ++cpu)
+                    cpus.push_back ((size_t) cpu);
+            }
+
+            nodes.push_back (std::move (cpus));
+        }
+       #endif
+
+        if (nodes.empty())
+        {
+            std::vector<size_t> cpus (std::max (1u, std::thread::hardware_concurrency()));
+            std::iota (cpus.begin(), cpus.end(), (size_t) 0);
+            nodes.push_back (std::move (cpus));
+        }
+
+        return nodes;
+    }
+}
+
+bool setThreadAffinity (std::thread& t, const std::vector<size_t>& cpus)
+{
+    if (cpus.empty())
+        return false;
+
+    return setThreadAffinity (t.native_handle(), cpus);
+}
+
+bool setCurrentThreadAffinity (const std::vector<size_t>& cpus)
+{
+    if (cpus.empty())
+        return false;
+
+    currentThreadNUMANode = getNUMANodeForCPU (cpus.front());
+
+   #if JUCE_WINDOWS
+    return setThreadAffinity (GetCurrentThread(), cpus);
+   #else
+    return setThreadAffinity (pthread_self(), cpus);
+   #endif
+}
+
+const std::vector<std::vector<size_t>>& getNUMANodeCPUs()
+{
+    static const auto nodes = findNUMANodeCPUs();
+    return nodes;
+}
+
+size_t getNUMANodeForCPU (size_t cpu)
+{
+    auto& nodes = getNUMANodeCPUs();
+
+    for (size_t nodeIndex = 0; nodeIndex < nodes.size(); ++nodeIndex)
+        if (std::find (nodes[nodeIndex].begin(), nodes[nodeIndex].end(), cpu) != nodes[nodeIndex].end())
+            return nodeIndex;
+
+    return 0;
+}
+
+size_t getCurrentThreadNUMANode()
+{
+    return currentThreadNUMANode;
+}
+
+//==============================================================================
+ThreadAffinity ThreadAffinity::forNUMANode (size_t nodeIndex)
+{
+    auto& nodes = getNUMANodeCPUs();
+    jassert (nodeIndex < nodes.size());
+    auto& cpus = nodes[std::min (nodeIndex, nodes.size() - 1)];
+
+    ThreadAffinity affinity;
+
+    if (cpus.empty())
+        return affinity;
+
+    affinity.processThreadCPUs = { cpus.front() };
+    affinity.workerCPUs.assign (cpus.begin() + 1, cpus.end());
+
+    return affinity;
+}
+
+std::vector<size_t> ThreadAffinity::getNUMANodes() const
+{
+    std::vector<size_t> nodes;
+
+    for (auto cpus : { &processThreadCPUs, &workerCPUs })
+        for (auto cpu : *cpus)
+            nodes.push_back (getNUMANodeForCPU (cpu));
+
+    std::sort (nodes.begin(), nodes.end());
+    nodes.erase (std::unique (nodes.begin(), nodes.end()), nodes.end());
+
+    return nodes;
+}
+
+std::optional<size_t> ThreadAffinity::getWorkerCPU (size_t workerIndex) const
+{
+    if (workerCPUs.empty())
+        return {};
+
+    return workerCPUs[workerIndex % workerCPUs.size()];
+}
+
 }} // namespace tracktion_engine
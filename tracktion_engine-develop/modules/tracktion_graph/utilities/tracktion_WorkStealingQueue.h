@@ -0,0 +1,136 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+#pragma once
+
+namespace tracktion { inline namespace graph
+{
+
+//==============================================================================
+/**
+    A fixed-capacity, lock-free work-stealing deque.
+
+    This is a bounded version of the Chase-Lev deque. A single owning thread
+    pushes and pops items from the bottom (in LIFO order, which keeps recently
+    produced work hot in that thread's cache) whilst any number of other threads
+    can steal items from the top.
+
+    Because the capacity is fixed no allocations are made after construction so
+    this is safe to use on real-time threads. If the queue is full, tryPush will
+    return false and the caller should hand the item off some other way.
+
+    Type must be trivially copyable, it's intended to hold pointers or indexes.
+*/
+template<typename Type>
+class WorkStealingQueue
+{
+public:
+    /** Creates a queue that can hold at least the given number of items. */
+    WorkStealingQueue (size_t minCapacity)
+        : capacity ((size_t) juce::nextPowerOfTwo ((int) std::max (minCapacity, (size_t) 2))),
+          mask (capacity - 1),
+          buffer (std::make_unique<std::atomic<Type>[]> (capacity))
+    {
+        static_assert (std::is_trivially_copyable_v<Type>);
+    }
+
+    /** Returns the number of items this queue can hold. */
+    size_t getCapacity() const      { return capacity; }
+
+    /** Returns the approximate number of items in the queue. */
+    size_t getNumItems() const
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_relaxed);
+        return b > t ? static_cast<size_t> (b - t) : 0;
+    }
+
+    //==============================================================================
+    /** Adds an item to the bottom of the queue.
+        Returns false if the queue is full.
+        [[ owner_thread_only ]]
+    */
+    bool tryPush (Type item)
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_acquire);
+
+        if (static_cast<size_t> (b - t) >= capacity)
+            return false;
+
+        buffer[static_cast<size_t> (b) & mask].store (item, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+
+        return true;
+    }
+
+    /** Removes the most recently pushed item from the bottom of the queue.
+        Returns false if the queue was empty.
+        [[ owner_thread_only ]]
+    */
+    bool tryPop (Type& item)
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            // Empty
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = buffer[static_cast<size_t> (b) & mask].load (std::memory_order_relaxed);
+
+        if (t == b)
+        {
+            // Last item so race any thieves for it
+            const bool won = top.compare_exchange_strong (t, t + 1,
+                                                          std::memory_order_seq_cst,
+                                                          std::memory_order_relaxed);
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    /** Removes the oldest item from the top of the queue.
+        Returns false if the queue was empty or another thread took the item first.
+        [[ thread_safe ]]
+    */
+    bool trySteal (Type& item)
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return false;
+
+        item = buffer[static_cast<size_t> (t) & mask].load (std::memory_order_relaxed);
+
+        return top.compare_exchange_strong (t, t + 1,
+                                            std::memory_order_seq_cst,
+                                            std::memory_order_relaxed);
+    }
+
+private:
+    //==============================================================================
+    const size_t capacity, mask;
+    std::unique_ptr<std::atomic<Type>[]> buffer;
+
+    std::atomic<int64_t> top { 0 }, bottom { 0 };
+};
+
+}}
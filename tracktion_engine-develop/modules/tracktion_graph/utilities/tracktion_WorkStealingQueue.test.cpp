@@ -0,0 +1,139 @@
+/*
+    ,--.                     ,--.     ,--.  ,--.
+  ,-'  '-.,--.--.,--,--.,---.|  |,-.,-'  '-.`--' ,---. ,--,--,      Copyright 2024
+  '-.  .-'|  .--' ,-.  | .--'|     /'-.  .-',--.| .-. ||      \   Tracktion Software
+    |  |  |  |  \ '-'  \ `--.|  \  \  |  |  |  |' '-' '|  ||  |       Corporation
+    `---' `--'   `--`--'`---'`--'`--' `---' `--' `---' `--''--'    www.tracktion.com
+
+    Tracktion Engine uses a GPL/commercial licence - see LICENCE.md for details.
+*/
+
+namespace tracktion { inline namespace graph
+{
+
+#if GRAPH_UNIT_TESTS_WORKSTEALINGQUEUE
+
+class WorkStealingQueueTests    : public juce::UnitTest
+{
+public:
+    WorkStealingQueueTests()
+        : juce::UnitTest ("WorkStealingQueue", "tracktion_graph") {}
+
+    //==============================================================================
+    void runTest() override
+    {
+        runSingleThreadedTests();
+        runStealingTests();
+    }
+
+private:
+    void runSingleThreadedTests()
+    {
+        beginTest ("Push/pop/steal");
+        {
+            WorkStealingQueue<int> queue (3);
+            expectEquals<int> ((int) queue.getCapacity(), 4);
+
+            for (int i = 0; i < 4; ++i)
+                expect (queue.tryPush (i));
+
+            expect (! queue.tryPush (4), "Queue should be full");
+            expectEquals<int> ((int) queue.getNumItems(), 4);
+
+            int item = -1;
+
+            // Owner pops the newest
+            expect (queue.tryPop (item));
+            expectEquals (item, 3);
+
+            // Thieves take the oldest
+            expect (queue.trySteal (item));
+            expectEquals (item, 0);
+
+            expect (queue.tryPop (item));
+            expectEquals (item, 2);
+            expect (queue.tryPop (item));
+            expectEquals (item, 1);
+
+            expect (! queue.tryPop (item));
+            expect (! queue.trySteal (item));
+            expectEquals<int> ((int) queue.getNumItems(), 0);
+
+            // Space should be available again after wrapping around
+            for (int i = 0; i < 4; ++i)
+                expect (queue.tryPush (i));
+        }
+    }
+
+    void runStealingTests()
+    {
+        beginTest ("Concurrent stealing");
+        {
+            constexpr int numItems = 100'000;
+            constexpr int numThieves = 4;
+
+            WorkStealingQueue<int> queue (256);
+            std::vector<std::atomic<int>> timesTaken ((size_t) numItems);
+            std::atomic<int> numTaken { 0 };
+            std::atomic<bool> ownerFinished { false };
+
+            std::vector<std::thread> thieves;
+
+            for (int i = 0; i < numThieves; ++i)
+            {
+                thieves.emplace_back ([&]
+                                      {
+                                          for (;;)
+                                          {
+                                              int item;
+
+                                              if (queue.trySteal (item))
+                                              {
+                                                  ++timesTaken[(size_t) item];
+                                                  ++numTaken;
+                                              }
+                                              else if (ownerFinished)
+                                              {
+                                                  return;
+                                              }
+                                          }
+                                      });
+            }
+
+            // The owner pushes everything, popping some back itself
+            for (int i = 0; i < numItems;)
+            {
+                if (queue.tryPush (i))
+                    ++i;
+
+                if (int item; (i % 3) == 0 && queue.tryPop (item))
+                {
+                    ++timesTaken[(size_t) item];
+                    ++numTaken;
+                }
+            }
+
+            for (int item; queue.tryPop (item);)
+            {
+                ++timesTaken[(size_t) item];
+                ++numTaken;
+            }
+
+            ownerFinished = true;
+
+            for (auto& t : thieves)
+                t.join();
+
+            expectEquals (numTaken.load(), numItems);
+            expect (std::all_of (timesTaken.begin(), timesTaken.end(),
+                                 [] (auto& count) { return count.load() == 1; }),
+                    "Each item should be taken exactly once");
+        }
+    }
+};
+
+static WorkStealingQueueTests workStealingQueueTests;
+
+#endif
+
+}} // namespace tracktion